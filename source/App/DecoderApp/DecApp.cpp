@@ -37,8 +37,18 @@
 
 #include <list>
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <stdio.h>
 #include <fcntl.h>
+#if defined( _WIN32 )
+#include <windows.h>
+#include <psapi.h>
+#pragma comment( lib, "psapi.lib" )
+#else
+#include <sys/resource.h>
+#endif
 
 #include "DecApp.h"
 #include "DecoderLib/AnnexBread.h"
@@ -47,11 +57,17 @@
 #include "CommonLib/CodingStatistics.h"
 #endif
 #include "CommonLib/dtrace_codingstruct.h"
+#include "CommonLib/Profiler.h"
 
 
 //! \ingroup DecoderApp
 //! \{
 
+#if ENABLE_PROFILING
+/// profiled stages reported by the benchmark, in the order of DecRunStats::stageTimes
+static const ProfStage g_benchmarkStages[NUM_DEC_BENCHMARK_STAGES] = { PROF_DEC_PARSE, PROF_DEC_RECON, PROF_DEBLOCK, PROF_SAO, PROF_ALF };
+#endif
+
 // ====================================================================================================================
 // Constructor / destructor / initialization / destroy
 // ====================================================================================================================
@@ -78,6 +94,15 @@ UInt DecApp::decode()
   Int                 poc;
   PicList* pcListPic = NULL;
 
+  m_runStats = DecRunStats();
+  const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+#if ENABLE_PROFILING
+  for( Int i = 0; i < NUM_DEC_BENCHMARK_STAGES; i++ )
+  {
+    m_runStats.stageTimes[i] = -Profiler::getStageSeconds( g_benchmarkStages[i] );
+  }
+#endif
+
   ifstream bitstreamFile(m_bitstreamFileName.c_str(), ifstream::in | ifstream::binary);
   if (!bitstreamFile)
   {
@@ -178,6 +203,7 @@ UInt DecApp::decode()
       {
         m_cDecLib.executeLoopFilters();
         m_cDecLib.finishPicture(poc, pcListPic);
+        m_runStats.numPics++;
       }
       loopFiltered = (nalu.m_nalUnitType == NAL_UNIT_EOS);
       if (nalu.m_nalUnitType == NAL_UNIT_EOS)
@@ -248,6 +274,16 @@ UInt DecApp::decode()
   // get the number of checksum errors
   UInt nRet = m_cDecLib.getNumberOfChecksumErrorsDetected();
 
+  m_runStats.numHashErrors = nRet;
+#if ENABLE_PROFILING
+  for( Int i = 0; i < NUM_DEC_BENCHMARK_STAGES; i++ )
+  {
+    m_runStats.stageTimes[i] += Profiler::getStageSeconds( g_benchmarkStages[i] );
+  }
+#endif
+
+  m_cDecLib.getBufferPool()->printStats( VERBOSE );
+
   // delete buffers
   m_cDecLib.deletePicBuffer();
   // destroy internal classes
@@ -259,9 +295,122 @@ UInt DecApp::decode()
 
   destroyROM();
 
+  m_runStats.time = std::chrono::duration<Double>( std::chrono::steady_clock::now() - startTime ).count();
+
   return nRet;
 }
 
+/** peak resident set size of the process in KiB, 0 if unknown
+ */
+static size_t xGetPeakRss()
+{
+#if defined( _WIN32 )
+  PROCESS_MEMORY_COUNTERS pmc;
+  if( GetProcessMemoryInfo( GetCurrentProcess(), &pmc, sizeof( pmc ) ) )
+  {
+    return pmc.PeakWorkingSetSize / 1024;
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+  {
+    return 0;
+  }
+#if defined( __APPLE__ )
+  return size_t( usage.ru_maxrss ) / 1024; // bytes
+#else
+  return size_t( usage.ru_maxrss );        // KiB
+#endif
+#endif
+}
+
+/** median of the given values
+ */
+static Double xMedian( std::vector<Double> values )
+{
+  std::sort( values.begin(), values.end() );
+  const size_t n = values.size();
+  return n == 0 ? 0 : ( n & 1 ) ? values[n / 2] : 0.5 * ( values[n / 2 - 1] + values[n / 2] );
+}
+
+/**
+ - write the measured decoding runs, the median frame rate, the stage times of the median run and the peak memory usage as JSON
+ - the median run is the run with the median total time (the lower one for an even number of runs), so its stage times add
+   up to its total time, it is used for the comparison of two benchmark files
+ */
+Bool DecApp::writeBenchmarkFile( const std::vector<DecRunStats>& runs ) const
+{
+  std::ofstream os( m_benchmarkFileName.c_str() );
+  if( !os.is_open() || !os.good() )
+  {
+    msg( ERROR, "Unable to open file %s for writing the benchmark results\n", m_benchmarkFileName.c_str() );
+    return false;
+  }
+
+  static const char* const stageNames[] = { "parse", "reconstruct", "deblock", "sao", "alf", "other" };
+  static const Int         numStages    = NUM_DEC_BENCHMARK_STAGES + 1;
+
+  std::vector<Double> fps, total, stages[numStages];
+  UInt numHashErrors = 0;
+
+  for( const DecRunStats& run : runs )
+  {
+    Double other = run.time;
+    for( Int i = 0; i < NUM_DEC_BENCHMARK_STAGES; i++ )
+    {
+      stages[i].push_back( run.stageTimes[i] );
+      other -= run.stageTimes[i];
+    }
+    stages[NUM_DEC_BENCHMARK_STAGES].push_back( std::max( 0.0, other ) );
+    fps  .push_back( run.time > 0 ? run.numPics / run.time : 0 );
+    total.push_back( run.time );
+    numHashErrors += run.numHashErrors;
+  }
+
+  os << "{\n";
+  os << "  \"bitstream\": \"" << m_bitstreamFileName << "\",\n";
+#if HHI_SIMD_OPT
+  os << "  \"simd\": \"" << read_x86_extension( "" ) << "\",\n";
+#endif
+  os << "  \"frames\": " << ( runs.empty() ? 0 : runs.front().numPics ) << ",\n";
+  os << "  \"warmupRuns\": " << m_benchmarkWarmupRuns << ",\n";
+  os << "  \"runs\": " << runs.size() << ",\n";
+  os << "  \"hashMismatches\": " << numHashErrors << ",\n";
+  os << "  \"peakRssKiB\": " << xGetPeakRss() << ",\n";
+  os << "  \"fps\": { \"median\": " << xMedian( fps ) << ", \"min\": " << *std::min_element( fps.begin(), fps.end() )
+     << ", \"max\": " << *std::max_element( fps.begin(), fps.end() ) << " },\n";
+  std::vector<size_t> order( runs.size() );
+  for( size_t r = 0; r < runs.size(); r++ )
+  {
+    order[r] = r;
+  }
+  std::sort( order.begin(), order.end(), [&]( size_t a, size_t b ) { return total[a] < total[b]; } );
+  const size_t medianRun = order[( order.size() - 1 ) / 2];
+
+  os << "  \"medianRun\": " << medianRun << ",\n";
+  os << "  \"seconds\": { \"total\": " << total[medianRun];
+  for( Int i = 0; i < numStages; i++ )
+  {
+    os << ", \"" << stageNames[i] << "\": " << stages[i][medianRun];
+  }
+  os << " },\n";
+  os << "  \"perRun\": [\n";
+  for( size_t r = 0; r < runs.size(); r++ )
+  {
+    os << "    { \"fps\": " << fps[r] << ", \"total\": " << total[r];
+    for( Int i = 0; i < numStages; i++ )
+    {
+      os << ", \"" << stageNames[i] << "\": " << stages[i][r];
+    }
+    os << " }" << ( r + 1 < runs.size() ? ",\n" : "\n" );
+  }
+  os << "  ]\n";
+  os << "}\n";
+
+  return os.good();
+}
+
 // ====================================================================================================================
 // Protected member functions
 // ====================================================================================================================
@@ -275,6 +424,14 @@ Void DecApp::xCreateDecLib()
   // initialize decoder class
   m_cDecLib.init();
   m_cDecLib.setDecodedPictureHashSEIEnabled(m_decodedPictureHashSEIEnabled);
+  m_cDecLib.setAsyncPictureHash(m_asyncPictureHash);
+  m_cDecLib.setLowMemoryDecoding(m_lowMemoryDecoding);
+#if ENABLE_BIT_STATISTICS
+  if( !m_bitStatisticsFileName.empty() && !m_cDecLib.openBitStatistics( m_bitStatisticsFileName, m_bitStatisticsPerCtu ) )
+  {
+    EXIT( "Unable to open file " << m_bitStatisticsFileName.c_str() << " for writing the bit statistics" );
+  }
+#endif
   if (!m_outputDecodedSEIMessagesFilename.empty())
   {
     std::ostream &os=m_seiMessageFileStream.is_open() ? m_seiMessageFileStream : std::cout;
@@ -55,6 +55,19 @@
 // Class definition
 // ====================================================================================================================
 
+static const Int NUM_DEC_BENCHMARK_STAGES = 5;   ///< parse, reconstruct, deblock, SAO, ALF
+
+/// measurements of one decoding run of the bitstream
+struct DecRunStats
+{
+  UInt          numPics;          ///< number of decoded pictures
+  UInt          numHashErrors;    ///< number of pictures not matching the decoded picture hash SEI
+  Double        time;             ///< wall clock time of the run in seconds
+  Double        stageTimes[NUM_DEC_BENCHMARK_STAGES];   ///< time per stage in seconds, taken from the stage profiler
+
+  DecRunStats() : numPics( 0 ), numHashErrors( 0 ), time( 0 ) { std::fill( stageTimes, stageTimes + NUM_DEC_BENCHMARK_STAGES, 0.0 ); }
+};
+
 /// decoder application class
 class DecApp : public DecAppCfg
 {
@@ -68,6 +81,7 @@ private:
   std::ofstream   m_seiMessageFileStream;         ///< Used for outputing SEI messages.
   ColourRemapping m_cColourRemapping;             ///< colour remapping handler
 
+  DecRunStats     m_runStats;                     ///< measurements of the last decode() call
 
 public:
   DecApp();
@@ -75,6 +89,9 @@ public:
 
   UInt  decode            (); ///< main decoding function
 
+  const DecRunStats& getRunStats() const { return m_runStats; }
+  Bool  writeBenchmarkFile( const std::vector<DecRunStats>& runs ) const; ///< write the measured runs to the benchmark file
+
 private:
   Void  xCreateDecLib     (); ///< create internal classes
   Void  xDestroyDecLib    (); ///< destroy internal classes
@@ -42,6 +42,7 @@
 #include "Utilities/program_options_lite.h"
 #include "CommonLib/ChromaFormat.h"
 #include "CommonLib/dtrace_next.h"
+#include "CommonLib/Profiler.h"
 
 using namespace std;
 namespace po = df::program_options_lite;
@@ -67,6 +68,9 @@ Bool DecAppCfg::parseCfg( Int argc, TChar* argv[] )
   string sTracingFile;
   bool   bTracingChannelsList = false;
 #endif
+#if ENABLE_PROFILING
+  string sProfileFile;
+#endif
 #if HHI_SIMD_OPT
   std::string ignore;
 #endif
@@ -90,16 +94,29 @@ Bool DecAppCfg::parseCfg( Int argc, TChar* argv[] )
   ("SEIDecodedPictureHash,-dph",m_decodedPictureHashSEIEnabled,        1,          "Control handling of decoded picture hash SEI messages\n"
                                                                                    "\t1: check hash in SEI messages if available in the bitstream\n"
                                                                                    "\t0: ignore SEI message")
+  ("AsyncPictureHash",          m_asyncPictureHash,                    false,      "check the decoded picture hash concurrently with the decoding of the next picture (on multi-core systems), the picture line is printed when the check is done")
   ("SEINoDisplay",              m_decodedNoDisplaySEIEnabled,          true,       "Control handling of decoded no display SEI messages")
   ("TarDecLayerIdSetFile,l",    cfg_TargetDecLayerIdSetFile,           string(""), "targetDecLayerIdSet file name. The file should include white space separated LayerId values to be decoded. Omitting the option or a value of -1 in the file decodes all layers.")
   ("RespectDefDispWindow,w",    m_respectDefDispWindow,                0,          "Only output content inside the default display window\n")
   ("SEIColourRemappingInfoFilename",  m_colourRemapSEIFileName,        string(""), "Colour Remapping YUV output file name. If empty, no remapping is applied (ignore SEI message)\n")
   ("OutputDecodedSEIMessagesFilename",  m_outputDecodedSEIMessagesFilename,    string(""), "When non empty, output decoded SEI messages to the indicated file. If file is '-', then output to stdout\n")
   ("ClipOutputVideoToRec709Range",      m_bClipOutputVideoToRec709Range,  false, "If true then clip output video to the Rec. 709 Range on saving")
+  ("LowMemoryDecoding",         m_lowMemoryDecoding,                   false,      "Reconstruct with CTU sized prediction, residual and coefficient buffers instead of picture sized ones")
+  ("BenchmarkFile",             m_benchmarkFileName,                   string(""), "write the decoding throughput, the decoding time per stage and the peak memory usage as JSON to this file")
+  ("BenchmarkRuns",             m_benchmarkRuns,                       1,          "number of measured decoding runs of the bitstream (with BenchmarkFile)")
+  ("BenchmarkWarmupRuns",       m_benchmarkWarmupRuns,                 0,          "number of decoding runs before the measured runs (with BenchmarkFile)")
+#if ENABLE_BIT_STATISTICS
+  ("BitStatisticsFile",         m_bitStatisticsFileName,               string(""), "write the bits per syntax element of the slice data to this file, as JSON if the name ends with .json, as CSV otherwise")
+  ("BitStatisticsPerCtu",       m_bitStatisticsPerCtu,                 false,      "write the bits per syntax element per CTU instead of per picture (with BitStatisticsFile)")
+#endif
 #if ENABLE_TRACING
   ("TraceChannelsList",         bTracingChannelsList,                        false, "List all available tracing channels" )
   ("TraceRule",                 sTracingRule,                         string( "" ), "Tracing rule (ex: \"D_CABAC:poc==8\" or \"D_REC_CB_LUMA:poc==8\")" )
   ("TraceFile",                 sTracingFile,                         string( "" ), "Tracing file" )
+#endif
+#if ENABLE_PROFILING
+  ("StageProfile",              m_stageProfile,                       false, "print the time spent in the decoding stages at the end of decoding")
+  ("StageProfileFile",          sProfileFile,                         string( "" ), "also write the stage profile as JSON to this file (with StageProfile)")
 #endif
   ;
 
@@ -127,6 +144,14 @@ Bool DecAppCfg::parseCfg( Int argc, TChar* argv[] )
     }
   }
 
+#if ENABLE_PROFILING
+  // the benchmark takes its stage times from the profiler
+  if( m_stageProfile || !m_benchmarkFileName.empty() )
+  {
+    Profiler::enable( sProfileFile );
+  }
+#endif
+
 #if ENABLE_TRACING
   g_trace_ctx = tracing_init( sTracingFile, sTracingRule );
   if( bTracingChannelsList && g_trace_ctx )
@@ -156,6 +181,12 @@ Bool DecAppCfg::parseCfg( Int argc, TChar* argv[] )
     return false;
   }
 
+  if( m_benchmarkRuns < 1 || m_benchmarkWarmupRuns < 0 )
+  {
+    msg( ERROR, "BenchmarkRuns must be positive and BenchmarkWarmupRuns must not be negative, aborting\n" );
+    return false;
+  }
+
   if ( !cfg_TargetDecLayerIdSetFile.empty() )
   {
     FILE* targetDecLayerIdSetFile = fopen ( cfg_TargetDecLayerIdSetFile.c_str(), "r" );
@@ -211,12 +242,21 @@ DecAppCfg::DecAppCfg()
 , m_outputColourSpaceConvert(IPCOLOURSPACE_UNCHANGED)
 , m_iMaxTemporalLayer(-1)
 , m_decodedPictureHashSEIEnabled(0)
+, m_asyncPictureHash(false)
 , m_decodedNoDisplaySEIEnabled(false)
 , m_colourRemapSEIFileName()
 , m_targetDecLayerIdSet()
 , m_respectDefDispWindow(0)
 , m_outputDecodedSEIMessagesFilename()
 , m_bClipOutputVideoToRec709Range(false)
+, m_benchmarkFileName()
+, m_benchmarkRuns(1)
+, m_benchmarkWarmupRuns(0)
+, m_stageProfile(false)
+#if ENABLE_BIT_STATISTICS
+, m_bitStatisticsFileName()
+, m_bitStatisticsPerCtu(false)
+#endif
 {
   for (UInt channelTypeIndex = 0; channelTypeIndex < MAX_NUM_CHANNEL_TYPE; channelTypeIndex++)
   {
@@ -64,18 +64,33 @@ protected:
 
   Int           m_iMaxTemporalLayer;                  ///< maximum temporal layer to be decoded
   Int           m_decodedPictureHashSEIEnabled;       ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
+  Bool          m_asyncPictureHash;                   ///< check the picture hash while the next picture is decoded
   Bool          m_decodedNoDisplaySEIEnabled;         ///< Enable(true)/disable(false) writing only pictures that get displayed based on the no display SEI message
   std::string   m_colourRemapSEIFileName;             ///< output Colour Remapping file name
   std::vector<Int> m_targetDecLayerIdSet;             ///< set of LayerIds to be included in the sub-bitstream extraction process.
   Int           m_respectDefDispWindow;               ///< Only output content inside the default display window
   std::string   m_outputDecodedSEIMessagesFilename;   ///< filename to output decoded SEI messages to. If '-', then use stdout. If empty, do not output details.
   Bool          m_bClipOutputVideoToRec709Range;      ///< If true, clip the output video to the Rec 709 range on saving.
+  Bool          m_lowMemoryDecoding;                  ///< Use CTU sized prediction/residual/coefficient buffers
+  std::string   m_benchmarkFileName;                  ///< JSON file receiving the decoding throughput and the time per stage, empty: no benchmark
+  Int           m_benchmarkRuns;                      ///< number of measured decoding runs
+  Int           m_benchmarkWarmupRuns;                ///< number of decoding runs before the measurement
+  Bool          m_stageProfile;                       ///< print the stage profile at the end of decoding
+#if ENABLE_BIT_STATISTICS
+  std::string   m_bitStatisticsFileName;              ///< CSV or JSON file receiving the bits per syntax element, empty: not counted
+  Bool          m_bitStatisticsPerCtu;                ///< bits per syntax element per CTU instead of per picture
+#endif
 
 public:
   DecAppCfg();
   virtual ~DecAppCfg(); 
 
   Bool  parseCfg        ( Int argc, TChar* argv[] );   ///< initialize option class from configuration
+
+  Bool  getBenchmark        () const { return !m_benchmarkFileName.empty(); }
+  Int   getBenchmarkRuns    () const { return m_benchmarkRuns; }
+  Int   getBenchmarkWarmupRuns() const { return m_benchmarkWarmupRuns; }
+  Bool  getStageProfile     () const { return m_stageProfile; }
 };
 
 //! \}
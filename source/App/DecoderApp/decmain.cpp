@@ -38,8 +38,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
+#include <vector>
 #include "DecApp.h"
 #include "program_options_lite.h"
+#include "CommonLib/Profiler.h"
 
 #include "svnrevision.h"
 
@@ -85,38 +87,69 @@ int main(int argc, char* argv[])
     return returnCode;
   }
 
+  // decode the bitstream once, or the warm up and the measured runs of the benchmark, each with a new decoder
+  const Int numRuns = pcDecApp->getBenchmark() ? pcDecApp->getBenchmarkWarmupRuns() + pcDecApp->getBenchmarkRuns() : 1;
+  std::vector<DecRunStats> benchmarkRuns;
+
   // starting time
   Double dResult;
   clock_t lBefore = clock();
 
-  // call decoding function
-#ifndef _DEBUG
-  try
+  for( Int run = 0; run < numRuns && returnCode == EXIT_SUCCESS; run++ )
   {
+    if( run > 0 )
+    {
+      delete pcDecApp;
+      pcDecApp = new DecApp;
+      pcDecApp->parseCfg( argc, argv );
+    }
+
+    // call decoding function
+#ifndef _DEBUG
+    try
+    {
 #endif // !_DEBUG
-    if( 0 != pcDecApp->decode() )
+      if( 0 != pcDecApp->decode() )
+      {
+        printf( "\n\n***ERROR*** A decoding mismatch occured: signalled md5sum does not match\n" );
+        returnCode = EXIT_FAILURE;
+      }
+#ifndef _DEBUG
+    }
+    catch( Exception &e )
     {
-      printf( "\n\n***ERROR*** A decoding mismatch occured: signalled md5sum does not match\n" );
+      std::cerr << e.what() << std::endl;
       returnCode = EXIT_FAILURE;
     }
-#ifndef _DEBUG
-  }
-  catch( Exception &e )
-  {
-    std::cerr << e.what() << std::endl;
-    returnCode = EXIT_FAILURE;
+    catch( ... )
+    {
+      std::cerr << "Unspecified error occurred" << std::endl;
+      returnCode = EXIT_FAILURE;
+    }
+#endif
+
+    if( run >= pcDecApp->getBenchmarkWarmupRuns() )
+    {
+      benchmarkRuns.push_back( pcDecApp->getRunStats() );
+    }
   }
-  catch( ... )
+
+  if( pcDecApp->getBenchmark() && !benchmarkRuns.empty() && !pcDecApp->writeBenchmarkFile( benchmarkRuns ) )
   {
-    std::cerr << "Unspecified error occurred" << std::endl;
     returnCode = EXIT_FAILURE;
   }
-#endif
 
   // ending time
   dResult = (Double)(clock()-lBefore) / CLOCKS_PER_SEC;
   printf("\n Total Time: %12.3f sec.\n", dResult);
 
+#if ENABLE_PROFILING
+  if( pcDecApp->getStageProfile() )
+  {
+    Profiler::report();
+  }
+#endif
+
   delete pcDecApp;
 
   return returnCode;
@@ -97,6 +97,7 @@ Void EncApp::xInitLibCfg()
   m_cEncLib.setPrintMSEBasedSequencePSNR                         ( m_printMSEBasedSequencePSNR);
   m_cEncLib.setPrintFrameMSE                                     ( m_printFrameMSE);
   m_cEncLib.setPrintSequenceMSE                                  ( m_printSequenceMSE);
+  m_cEncLib.setPrintSSIM                                         ( m_printSSIM );
   m_cEncLib.setCabacZeroWordPaddingEnabled                       ( m_cabacZeroWordPaddingEnabled );
 
   m_cEncLib.setFrameRate                                         ( m_iFrameRate );
@@ -111,6 +112,8 @@ Void EncApp::xInitLibCfg()
   m_cEncLib.setIntraPeriod                                       ( m_iIntraPeriod );
   m_cEncLib.setDecodingRefreshType                               ( m_iDecodingRefreshType );
   m_cEncLib.setGOPSize                                           ( m_iGOPSize );
+  m_cEncLib.setLookaheadFrames                                   ( m_lookaheadFrames );
+  m_cEncLib.setSceneCutThreshold                                 ( m_sceneCutThreshold );
   m_cEncLib.setGopList                                           ( m_GOPList );
   m_cEncLib.setExtraRPSs                                         ( m_extraRPSs );
   for(Int i = 0; i < MAX_TLAYER; i++)
@@ -147,6 +150,7 @@ Void EncApp::xInitLibCfg()
   m_cEncLib.setLoopFilterTcOffset                                ( m_loopFilterTcOffsetDiv2    );
 #if W0038_DB_OPT
   m_cEncLib.setDeblockingFilterMetric                            ( m_deblockingFilterMetric );
+  m_cEncLib.setDeblockingFilterMetricThreads                     ( m_deblockingFilterMetricThreads );
 #else
   m_cEncLib.setDeblockingFilterMetric                            ( m_DeblockingFilterMetric );
 #endif
@@ -160,6 +164,10 @@ Void EncApp::xInitLibCfg()
   m_cEncLib.setFastMEAssumingSmootherMVEnabled                   ( m_bFastMEAssumingSmootherMVEnabled );
   m_cEncLib.setMinSearchWindow                                   ( m_minSearchWindow );
   m_cEncLib.setRestrictMESampling                                ( m_bRestrictMESampling );
+  m_cEncLib.setSubPelMECache                                     ( m_bSubPelMECache );
+  m_cEncLib.setUseHierarchicalME                                 ( m_bUseHierarchicalME );
+  m_cEncLib.setHierarchicalMESearchRange                         ( m_iHierarchicalMESearchRange );
+  m_cEncLib.setMergePredCache                                    ( m_iMergePredCache );
 
   //====== Quality control ========
   m_cEncLib.setMaxDeltaQP                                        ( m_iMaxDeltaQP  );
@@ -176,6 +184,7 @@ Void EncApp::xInitLibCfg()
   m_cEncLib.setChromaFormatIdc                                   ( m_chromaFormatIDC  );
   m_cEncLib.setUseAdaptiveQP                                     ( m_bUseAdaptiveQP  );
   m_cEncLib.setQPAdaptationRange                                 ( m_iQPAdaptationRange );
+  m_cEncLib.setPreanalysisThreads                                ( m_preanalysisThreads );
 #if HHI_HLM_USE_QPA
   m_cEncLib.setUsePerceptQPA                                     ( m_bUsePerceptQPA && !m_bUseAdaptiveQP );
   m_cEncLib.setUseANSNR                                          ( m_bUseANSNR );
@@ -436,6 +445,7 @@ Void EncApp::xInitLibCfg()
   m_cEncLib.setUseLCUSeparateModel                               ( m_RCUseLCUSeparateModel );
   m_cEncLib.setInitialQP                                         ( m_RCInitialQP );
   m_cEncLib.setForceIntraQP                                      ( m_RCForceIntraQP );
+  m_cEncLib.setRCLookahead                                       ( m_RCLookahead );
 #if U0132_TARGET_BITS_SATURATION
   m_cEncLib.setCpbSaturationEnabled                              ( m_RCCpbSaturationEnabled );
   m_cEncLib.setCpbSize                                           ( m_RCCpbSize );
@@ -514,6 +524,68 @@ Void EncApp::xCreateLib( std::list<PelUnitBuf*>& recBuflist )
   }
 }
 
+/** First pass of the two-pass rate control, the whole input sequence is read once and analysed by a separate lookahead.
+ *  Only the picture costs are kept, the block estimates of each picture are released once its cost is taken.
+ */
+Void EncApp::xAnalyzeSequence()
+{
+  VideoIOYuv cInputFile;
+  cInputFile.open( m_inputFileName, false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );
+  cInputFile.skipFrames( m_FrameSkip, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC );
+
+  PelStorage orgPic;
+  PelStorage trueOrgPic;
+  UnitArea   unitArea( m_chromaFormatIDC, Area( 0, 0, m_iSourceWidth, m_iSourceHeight ) );
+  orgPic    .create( unitArea );
+  trueOrgPic.create( unitArea );
+
+  EncLookahead               cLookahead;
+  std::vector<LookaheadCost> costs;
+  cLookahead.create( m_iSourceWidth, m_iSourceHeight, m_internalBitDepth[CHANNEL_TYPE_LUMA], m_sceneCutThreshold );
+
+  // the picture costs without the block estimates
+  auto addCost = [&]( const LookaheadCost& cost )
+  {
+    costs.push_back( LookaheadCost() );
+    costs.back().intraCost = cost.intraCost;
+    costs.back().interCost = cost.interCost;
+    costs.back().sceneCut  = cost.sceneCut;
+  };
+
+  for( Int i = 0; i < m_framesToBeEncoded; i++ )
+  {
+    cInputFile.read( orgPic, trueOrgPic, m_inputColourSpaceConvert, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+    if( cInputFile.isEof() )
+    {
+      break;
+    }
+    cLookahead.addPicture( orgPic.get( COMPONENT_Y ) );
+
+    const Int iNumPics = cLookahead.getNumPicsAdded();
+    if( iNumPics > 1 )
+    {
+      addCost( cLookahead.getCost( iNumPics - 2 ) );
+      cLookahead.release( iNumPics - 1 );
+    }
+
+    if( m_temporalSubsampleRatio > 1 )
+    {
+      cInputFile.skipFrames( m_temporalSubsampleRatio - 1, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC );
+    }
+  }
+
+  if( cLookahead.getNumPicsAdded() > 0 )
+  {
+    addCost( cLookahead.getCost( cLookahead.getNumPicsAdded() - 1 ) );
+  }
+  cLookahead.destroy();
+  m_cEncLib.setRCSeqCosts( costs );
+
+  cInputFile.close();
+  orgPic    .destroy();
+  trueOrgPic.destroy();
+}
+
 Void EncApp::xDestroyLib()
 {
   // Video I/O
@@ -555,6 +627,11 @@ Void EncApp::encode()
   xCreateLib( recBuflist );
   xInitLib(m_isField);
 
+  if( m_RCEnableRateControl && m_RCLookahead == 2 )
+  {
+    xAnalyzeSequence();
+  }
+
   printChromaFormat();
 
   // main encoder loop
@@ -566,42 +643,81 @@ Void EncApp::encode()
 
   list<AccessUnit> outputAccessUnits; ///< list of access units to write out.  is populated by the encoding process
 
-  PelStorage trueOrgPic;
-  PelStorage orgPic;
+  // input pictures, with lookahead the pictures are read up to LookaheadFrames pictures ahead of the encoder
+  const Int numInputBufs = 1 + m_lookaheadFrames;
+  std::vector<PelStorage> trueOrgPics( numInputBufs );
+  std::vector<PelStorage> orgPics    ( numInputBufs );
   const Int sourceHeight = m_isField ? m_iSourceHeightOrg : m_iSourceHeight;
   UnitArea unitArea( m_chromaFormatIDC, Area( 0, 0, m_iSourceWidth, sourceHeight ) );
 
-  orgPic.create( unitArea );
-  trueOrgPic.create( unitArea );
+  for( Int i = 0; i < numInputBufs; i++ )
+  {
+    orgPics    [i].create( unitArea );
+    trueOrgPics[i].create( unitArea );
+  }
+
+  Int  firstInputBuf = 0;
+  Int  numInputPics  = 0;
+  Bool inputDone     = false;
 
   while ( !bEos )
   {
-    // read input YUV file
-    m_cVideoIOYuvInputFile.read( orgPic, trueOrgPic, ipCSC, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+    while( !inputDone && numInputPics < numInputBufs )
+    {
+      PelStorage& orgPic     = orgPics    [( firstInputBuf + numInputPics ) % numInputBufs];
+      PelStorage& trueOrgPic = trueOrgPics[( firstInputBuf + numInputPics ) % numInputBufs];
 
-    // increase number of received frames
-    m_iFrameRcvd++;
+      // read input YUV file
+      m_cVideoIOYuvInputFile.read( orgPic, trueOrgPic, ipCSC, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
 
-    bEos = (m_isField && (m_iFrameRcvd == (m_framesToBeEncoded >> 1) )) || ( !m_isField && (m_iFrameRcvd == m_framesToBeEncoded) );
+      // increase number of received frames
+      m_iFrameRcvd++;
 
-    Bool flush = 0;
-    // if end of file (which is only detected on a read failure) flush the encoder of any queued pictures
-    if (m_cVideoIOYuvInputFile.isEof())
-    {
-      flush = true;
-      bEos = true;
-      m_iFrameRcvd--;
-      m_cEncLib.setFramesToBeEncoded(m_iFrameRcvd);
+      inputDone = (m_isField && (m_iFrameRcvd == (m_framesToBeEncoded >> 1) )) || ( !m_isField && (m_iFrameRcvd == m_framesToBeEncoded) );
+
+      // if end of file (which is only detected on a read failure) flush the encoder of any queued pictures
+      if (m_cVideoIOYuvInputFile.isEof())
+      {
+        inputDone = true;
+        m_iFrameRcvd--;
+        m_cEncLib.setFramesToBeEncoded(m_iFrameRcvd);
+      }
+      else
+      {
+        if( m_lookaheadFrames > 0 )
+        {
+          m_cEncLib.addLookaheadPicture( orgPic );
+        }
+        numInputPics++;
+      }
+
+      // temporally skip frames
+      if( m_temporalSubsampleRatio > 1 )
+      {
+        m_cVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC);
+      }
     }
 
+    const Bool  flush      = numInputPics == 0;
+    PelStorage* orgPic     = flush ? 0 : &orgPics    [firstInputBuf];
+    PelStorage* trueOrgPic = flush ? 0 : &trueOrgPics[firstInputBuf];
+
+    bEos = inputDone && numInputPics <= 1;
+
     // call encoding function for one frame
     if ( m_isField )
     {
-      m_cEncLib.encode( bEos, flush ? 0 : &orgPic, flush ? 0 : &trueOrgPic, snrCSC, recBuflist, outputAccessUnits, iNumEncoded, m_isTopFieldFirst );
+      m_cEncLib.encode( bEos, orgPic, trueOrgPic, snrCSC, recBuflist, outputAccessUnits, iNumEncoded, m_isTopFieldFirst );
     }
     else
     {
-      m_cEncLib.encode( bEos, flush ? 0 : &orgPic, flush ? 0 : &trueOrgPic, snrCSC, recBuflist, outputAccessUnits, iNumEncoded );
+      m_cEncLib.encode( bEos, orgPic, trueOrgPic, snrCSC, recBuflist, outputAccessUnits, iNumEncoded );
+    }
+
+    if( !flush )
+    {
+      firstInputBuf = ( firstInputBuf + 1 ) % numInputBufs;
+      numInputPics--;
     }
 
     // write bistream to file if necessary
@@ -610,11 +726,6 @@ Void EncApp::encode()
       xWriteOutput(bitstreamFile, iNumEncoded, outputAccessUnits, recBuflist);
       outputAccessUnits.clear();
     }
-    // temporally skip frames
-    if( m_temporalSubsampleRatio > 1 )
-    {
-      m_cVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC);
-    }
   }
 
   m_cEncLib.printSummary(m_isField);
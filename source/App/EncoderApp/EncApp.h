@@ -71,6 +71,7 @@ private:
   Void xInitLibCfg ();                           ///< initialize internal variables
   Void xInitLib    (Bool isFieldCoding);         ///< initialize encoder class
   Void xDestroyLib ();                           ///< destroy encoder class
+  Void xAnalyzeSequence();                       ///< pass all input pictures to the lookahead for two-pass rate control
 
   // file I/O
   Void xWriteOutput     ( std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits, std::list<PelUnitBuf*>& recBuflist ); ///< write bitstream to file
@@ -47,6 +47,7 @@
 #include "EncoderLib/RateCtrl.h"
 
 #include "CommonLib/dtrace_next.h"
+#include "CommonLib/Profiler.h"
 
 #define MACRO_TO_STRING_HELPER(val) #val
 #define MACRO_TO_STRING(val) MACRO_TO_STRING_HELPER(val)
@@ -675,6 +676,10 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
   string sTracingFile;
   bool   bTracingChannelsList = false;
 #endif
+#if ENABLE_PROFILING
+  bool   bProfile = false;
+  string sProfileFile;
+#endif
 #if HHI_SIMD_OPT
   std::string ignore;
 #endif
@@ -711,6 +716,7 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
   ("MSEBasedSequencePSNR",                            m_printMSEBasedSequencePSNR,                      false, "0 (default) emit sequence PSNR only as a linear average of the frame PSNRs, 1 = also emit a sequence PSNR based on an average of the frame MSEs")
   ("PrintFrameMSE",                                   m_printFrameMSE,                                  false, "0 (default) emit only bit count and PSNRs for each frame, 1 = also emit MSE values")
   ("PrintSequenceMSE",                                m_printSequenceMSE,                               false, "0 (default) emit only bit rate and PSNRs for the whole sequence, 1 = also emit MSE values")
+  ("PrintSSIM",                                       m_printSSIM,                                      false, "0 (default) emit no structural metrics, 1 = also emit SSIM and MS-SSIM values for each frame and the whole sequence")
   ("CabacZeroWordPaddingEnabled",                     m_cabacZeroWordPaddingEnabled,                     true, "0 do not add conforming cabac-zero-words to bit streams, 1 (default) = add cabac-zero-words as required")
   ("ChromaFormatIDC,-cf",                             tmpChromaFormat,                                      0, "ChromaFormatIDC (400|420|422|444 or set 0 (default) for same as InputChromaFormat)")
   ("ConformanceMode",                                 m_conformanceWindowMode,                              0, "Deprecated alias of ConformanceWindowMode")
@@ -851,6 +857,8 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
   ("IntraPeriod,-ip",                                 m_iIntraPeriod,                                      -1, "Intra period in frames, (-1: only first frame)")
   ("DecodingRefreshType,-dr",                         m_iDecodingRefreshType,                               0, "Intra refresh type (0:none 1:CRA 2:IDR 3:RecPointSEI)")
   ("GOPSize,g",                                       m_iGOPSize,                                           1, "GOP size of temporal structure")
+  ("LookaheadFrames",                                 m_lookaheadFrames,                                    0, "Number of input pictures analysed ahead of the encoder (0: no lookahead)")
+  ("SceneCutThreshold",                               m_sceneCutThreshold,                                 40, "Scene cut sensitivity of the lookahead in percent, an intra picture is inserted at scene cuts (0: disabled)")
 
   // motion search options
   ("DisableIntraInInter",                             m_bDisableIntraPUsInInterSlices,                  false, "Flag to disable intra PUs in inter slices")
@@ -859,6 +867,10 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
   ("BipredSearchRange",                               m_bipredSearchRange,                                  4, "Motion search range for bipred refinement")
   ("MinSearchWindow",                                 m_minSearchWindow,                                    8, "Minimum motion search window size for the adaptive window ME")
   ("RestrictMESampling",                              m_bRestrictMESampling,                            false, "Restrict ME Sampling for selective inter motion search")
+  ("SubPelMECache",                                   m_bSubPelMECache,                                 false, "Interpolate reference pictures once per CTU row for fractional ME instead of per block (needs 15 extra luma planes per picture)")
+  ("HierarchicalME",                                  m_bUseHierarchicalME,                             false, "Run a block matching pre-pass on 2:1/4:1 downsampled pictures and use its vectors as start points of the TZ search")
+  ("HierarchicalMESearchRange",                       m_iHierarchicalMESearchRange,                         0, "TZ search range used when a hierarchical ME start point exists (0: SearchRange)")
+  ("MergePredCache",                                  m_iMergePredCache,                                    0, "Size in KB of the per-CTU cache of merge candidate predictions reused across CU sizes (0: off)")
   ("ClipForBiPredMEEnabled",                          m_bClipForBiPredMeEnabled,                        false, "Enables clipping in the Bi-Pred ME. It is disabled to reduce encoder run-time")
   ("FastMEAssumingSmootherMVEnabled",                 m_bFastMEAssumingSmootherMVEnabled,                true, "Enables fast ME assuming a smoother MV.")
 
@@ -912,6 +924,7 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
 
   ("AdaptiveQP,-aq",                                  m_bUseAdaptiveQP,                                 false, "QP adaptation based on a psycho-visual model")
   ("MaxQPAdaptationRange,-aqr",                       m_iQPAdaptationRange,                                 6, "QP adaptation range")
+  ("PreanalysisThreads",                              m_preanalysisThreads,                                 0, "Number of threads analysing the input pictures for QP adaptation and weighted prediction ahead of the coding (0: analysis in the encoding thread)")
 #if HHI_HLM_USE_QPA
   ("PerceptQPA,-qpa",                                 m_bUsePerceptQPA,                                 false, "perceptually motivated input-adaptive QP modification (default: 0 = off, ignored if -aq is set)")
   ("ANSNR,-ansnr",                                    m_bUseANSNR,                                      false, "output activity normalized SNR (ANSNR) instead of PSNR")
@@ -931,6 +944,7 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
   ("LoopFilterTcOffset_div2",                         m_loopFilterTcOffsetDiv2,                             0)
 #if W0038_DB_OPT
   ("DeblockingFilterMetric",                          m_deblockingFilterMetric,                             0)
+  ("DeblockingFilterMetricThreads",                   m_deblockingFilterMetricThreads,                      0, "Number of threads evaluating the deblocking parameters with DeblockingFilterMetric=2, at most 4 (0: number of cores)")
 #else
   ("DeblockingFilterMetric",                          m_DeblockingFilterMetric,                         false)
 #endif
@@ -1017,6 +1031,7 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
   ( "RCLCUSeparateModel",                             m_RCUseLCUSeparateModel,                           true, "Rate control: use CTU level separate R-lambda model" )
   ( "InitialQP",                                      m_RCInitialQP,                                        0, "Rate control: initial QP" )
   ( "RCForceIntraQP",                                 m_RCForceIntraQP,                                 false, "Rate control: force intra QP to be equal to initial QP" )
+  ( "RCLookahead",                                    m_RCLookahead,                                        0, "Rate control: 0: no lookahead; 1: bit allocation and CTU QP offsets from the lookahead pictures; 2: two-pass, analyse the whole sequence first" )
 #if U0132_TARGET_BITS_SATURATION
   ( "RCCpbSaturation",                                m_RCCpbSaturationEnabled,                         false, "Rate control: enable target bits saturation to avoid CPB overflow and underflow" )
   ( "RCCpbSize",                                      m_RCCpbSize,                                         0u, "Rate control: CPB size" )
@@ -1179,6 +1194,10 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
   ("TraceRule",                                       sTracingRule,                               string( "" ), "Tracing rule (ex: \"D_CABAC:poc==8\" or \"D_REC_CB_LUMA:poc==8\")")
   ("TraceFile",                                       sTracingFile,                               string( "" ), "Tracing file")
 #endif
+#if ENABLE_PROFILING
+  ("StageProfile",                                    bProfile,                                          false, "print the time spent in the encoding stages per mode and block size at the end of encoding")
+  ("StageProfileFile",                                sProfileFile,                               string( "" ), "also write the stage profile as JSON to this file (with StageProfile)")
+#endif
 
   ("DebugBitstream",                                  m_decodeBitstreams[0],             string( "" ), "Assume the frames up to POC DebugPOC will be the same as in this bitstream. Load those frames from the bitstream instead of encoding them." )
   ("DebugPOC",                                        m_switchPOC,                                 -1, "If DebugBitstream is present, load frames up to this POC from this bitstream. Starting with DebugPOC, return to normal encoding." )
@@ -1659,6 +1678,13 @@ Bool EncAppCfg::parseCfg( Int argc, TChar* argv[] )
     }
   }
 
+#if ENABLE_PROFILING
+  if( bProfile )
+  {
+    Profiler::enable( sProfileFile );
+  }
+#endif
+
 #if ENABLE_TRACING
   g_trace_ctx = tracing_init(sTracingFile, sTracingRule);
   if( bTracingChannelsList && g_trace_ctx )
@@ -1941,6 +1967,9 @@ Bool EncAppCfg::xCheckParameter()
   xConfirmPara( m_iGOPSize > 1 &&  m_iGOPSize % 2,                                          "GOP Size must be a multiple of 2, if GOP Size is greater than 1" );
   xConfirmPara( (m_iIntraPeriod > 0 && m_iIntraPeriod < m_iGOPSize) || m_iIntraPeriod == 0, "Intra period must be more than GOP size, or -1 , not 0" );
   xConfirmPara( m_iDecodingRefreshType < 0 || m_iDecodingRefreshType > 3,                   "Decoding Refresh Type must be comprised between 0 and 3 included" );
+  xConfirmPara( m_lookaheadFrames < 0,                                                      "Lookahead frames must not be negative" );
+  xConfirmPara( m_lookaheadFrames > 0 && m_isField,                                         "Lookahead is not supported with field coding" );
+  xConfirmPara( m_sceneCutThreshold < 0 || m_sceneCutThreshold > 99,                        "Scene cut threshold must be in the range of 0 to 99" );
   if(m_iDecodingRefreshType == 3)
   {
     xConfirmPara( !m_recoveryPointSEIEnabled,                                               "When using RecoveryPointSEI messages as RA points, recoveryPointSEI must be enabled" );
@@ -2013,6 +2042,7 @@ Bool EncAppCfg::xCheckParameter()
   xConfirmPara( m_iQP < -6 * (m_internalBitDepth[CHANNEL_TYPE_LUMA] - 8) || m_iQP > MAX_QP, "QP exceeds supported range (-QpBDOffsety to 51)" );
 #if W0038_DB_OPT
   xConfirmPara( m_deblockingFilterMetric!=0 && (m_bLoopFilterDisable || m_loopFilterOffsetInPPS), "If DeblockingFilterMetric is non-zero then both LoopFilterDisable and LoopFilterOffsetInPPS must be 0");
+  xConfirmPara( m_deblockingFilterMetricThreads < 0, "DeblockingFilterMetricThreads must not be negative" );
 #else
   xConfirmPara( m_DeblockingFilterMetric && (m_bLoopFilterDisable || m_loopFilterOffsetInPPS), "If DeblockingFilterMetric is true then both LoopFilterDisable and LoopFilterOffsetInPPS must be 0");
 #endif
@@ -2036,6 +2066,7 @@ Bool EncAppCfg::xCheckParameter()
   xConfirmPara( m_crQpOffset >  12,   "Max. Chroma Cr QP Offset is  12" );
 
   xConfirmPara( m_iQPAdaptationRange <= 0,                                                  "QP Adaptation Range must be more than 0" );
+  xConfirmPara( m_preanalysisThreads < 0,                                                   "PreanalysisThreads must not be negative" );
   if (m_iDecodingRefreshType == 2)
   {
     xConfirmPara( m_iIntraPeriod > 0 && m_iIntraPeriod <= m_iGOPSize ,                      "Intra period must be larger than GOP size for periodic IDR pictures");
@@ -2603,6 +2634,7 @@ Bool EncAppCfg::xCheckParameter()
     xConfirmPara(m_vuiParametersPresentFlag && m_chromaLocInfoPresentFlag && (m_chromaSampleLocTypeTopField != m_chromaSampleLocTypeBottomField ), "When chromaResamplingFilterSEI is enabled, ChromaSampleLocTypeTopField has to be equal to ChromaSampleLocTypeBottomField" );
   }
 
+  xConfirmPara( m_RCLookahead != 0 && !m_RCEnableRateControl, "RCLookahead cannot be used without Rate control" );
   if ( m_RCEnableRateControl )
   {
     if ( m_RCForceIntraQP )
@@ -2614,6 +2646,9 @@ Bool EncAppCfg::xCheckParameter()
       }
     }
     xConfirmPara( m_uiDeltaQpRD > 0, "Rate control cannot be used together with slice level multiple-QP optimization!\n" );
+    xConfirmPara( m_RCLookahead < 0 || m_RCLookahead > 2, "RCLookahead must be in the range 0 to 2" );
+    xConfirmPara( m_RCLookahead == 1 && m_lookaheadFrames == 0, "RCLookahead 1 requires LookaheadFrames to be greater than 0" );
+    xConfirmPara( m_RCLookahead > 0 && m_isField, "RCLookahead is not supported with field coding" );
 #if U0132_TARGET_BITS_SATURATION
     if ((m_RCCpbSaturationEnabled) && (m_level!=Level::NONE) && (m_profile!=Profile::NONE))
     {
@@ -2707,6 +2742,7 @@ Void EncAppCfg::xPrintParameter()
   msg( DETAILS, "Sequence PSNR output                   : %s\n", ( m_printMSEBasedSequencePSNR ? "Linear average, MSE-based" : "Linear average only" ) );
   msg( DETAILS, "Sequence MSE output                    : %s\n", ( m_printSequenceMSE ? "Enabled" : "Disabled" ) );
   msg( DETAILS, "Frame MSE output                       : %s\n", ( m_printFrameMSE ? "Enabled" : "Disabled" ) );
+  msg( DETAILS, "SSIM output                            : %s\n", ( m_printSSIM ? "Enabled" : "Disabled" ) );
   msg( DETAILS, "Cabac-zero-word-padding                : %s\n", ( m_cabacZeroWordPaddingEnabled ? "Enabled" : "Disabled" ) );
   if (m_isField)
   {
@@ -2763,7 +2799,9 @@ Void EncAppCfg::xPrintParameter()
   msg( DETAILS, "Cb QP Offset                           : %d\n", m_cbQpOffset   );
   msg( DETAILS, "Cr QP Offset                           : %d\n", m_crQpOffset);
   msg( DETAILS, "QP adaptation                          : %d (range=%d)\n", m_bUseAdaptiveQP, (m_bUseAdaptiveQP ? m_iQPAdaptationRange : 0) );
+  msg( DETAILS, "Pre-analysis threads                   : %d\n", m_preanalysisThreads );
   msg( DETAILS, "GOP size                               : %d\n", m_iGOPSize );
+  msg( DETAILS, "Lookahead frames                       : %d (scene cut threshold %d)\n", m_lookaheadFrames, m_sceneCutThreshold );
   msg( DETAILS, "Input bit depth                        : (Y:%d, C:%d)\n", m_inputBitDepth[CHANNEL_TYPE_LUMA], m_inputBitDepth[CHANNEL_TYPE_CHROMA] );
   msg( DETAILS, "MSB-extended bit depth                 : (Y:%d, C:%d)\n", m_MSBExtendedBitDepth[CHANNEL_TYPE_LUMA], m_MSBExtendedBitDepth[CHANNEL_TYPE_CHROMA] );
   msg( DETAILS, "Internal bit depth                     : (Y:%d, C:%d)\n", m_internalBitDepth[CHANNEL_TYPE_LUMA], m_internalBitDepth[CHANNEL_TYPE_CHROMA] );
@@ -2806,6 +2844,7 @@ Void EncAppCfg::xPrintParameter()
     msg( DETAILS, "UseLCUSeparateModel                    : %d\n", m_RCUseLCUSeparateModel );
     msg( DETAILS, "InitialQP                              : %d\n", m_RCInitialQP );
     msg( DETAILS, "ForceIntraQP                           : %d\n", m_RCForceIntraQP );
+    msg( DETAILS, "RCLookahead                            : %d\n", m_RCLookahead );
 #if U0132_TARGET_BITS_SATURATION
     msg( DETAILS, "CpbSaturation                          : %d\n", m_RCCpbSaturationEnabled );
     if (m_RCCpbSaturationEnabled)
@@ -2832,6 +2871,9 @@ Void EncAppCfg::xPrintParameter()
   msg( VERBOSE, "ASR:%d ", m_bUseASR                            );
   msg( VERBOSE, "MinSearchWindow:%d ", m_minSearchWindow        );
   msg( VERBOSE, "RestrictMESampling:%d ", m_bRestrictMESampling );
+  msg( VERBOSE, "SubPelMECache:%d ", m_bSubPelMECache           );
+  msg( VERBOSE, "HME:%d(%d) ", m_bUseHierarchicalME, m_iHierarchicalMESearchRange );
+  msg( VERBOSE, "MergePredCache:%d ", m_iMergePredCache );
   msg( VERBOSE, "FEN:%d ", Int(m_fastInterSearchMode)           );
   msg( VERBOSE, "ECU:%d ", m_bUseEarlyCU                        );
   msg( VERBOSE, "FDM:%d ", m_useFastDecisionForMerge            );
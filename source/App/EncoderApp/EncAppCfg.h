@@ -94,6 +94,7 @@ protected:
   Bool      m_printMSEBasedSequencePSNR;
   Bool      m_printFrameMSE;
   Bool      m_printSequenceMSE;
+  Bool      m_printSSIM;
   Bool      m_cabacZeroWordPaddingEnabled;
   Bool      m_bClipInputVideoToRec709Range;
   Bool      m_bClipOutputVideoToRec709Range;
@@ -116,6 +117,8 @@ protected:
   Int       m_iIntraPeriod;                                   ///< period of I-slice (random access period)
   Int       m_iDecodingRefreshType;                           ///< random access type
   Int       m_iGOPSize;                                       ///< GOP size of hierarchical structure
+  Int       m_lookaheadFrames;                                ///< number of input pictures read and analysed ahead of the encoder
+  Int       m_sceneCutThreshold;                              ///< scene cut sensitivity of the lookahead in percent
   Int       m_extraRPSs;                                      ///< extra RPSs added to handle CRA
   GOPEntry  m_GOPList[MAX_GOP];                               ///< the coding structure entries from the config file
   Int       m_numReorderPics[MAX_TLAYER];                     ///< total number of reorder pictures
@@ -164,6 +167,7 @@ protected:
 
   Bool      m_bUseAdaptiveQP;                                 ///< Flag for enabling QP adaptation based on a psycho-visual model
   Int       m_iQPAdaptationRange;                             ///< dQP range by QP adaptation
+  Int       m_preanalysisThreads;                             ///< number of threads analysing the pictures for QP adaptation and weighted prediction
 #if HHI_HLM_USE_QPA
   Bool      m_bUsePerceptQPA;                                 ///< Flag to enable perceptually motivated input-adaptive QP modification
   Bool      m_bUseANSNR;                                      ///< Flag to output activity normalized SNR (ANSNR) instead of PSNR
@@ -264,6 +268,7 @@ protected:
   Int       m_loopFilterTcOffsetDiv2;                       ///< tc offset for deblocking filter
 #if W0038_DB_OPT
   Int       m_deblockingFilterMetric;                         ///< blockiness metric in encoder
+  Int       m_deblockingFilterMetricThreads;                  ///< number of threads evaluating the deblocking parameters, 0: number of cores
 #else
   Bool      m_DeblockingFilterMetric;                         ///< blockiness metric in encoder
 #endif
@@ -286,6 +291,10 @@ protected:
   Bool      m_bDisableIntraPUsInInterSlices;                  ///< Flag for disabling intra predicted PUs in inter slices.
   MESearchMethod m_motionEstimationSearchMethod;
   Bool      m_bRestrictMESampling;                            ///< Restrict sampling for the Selective ME
+  Bool      m_bSubPelMECache;                                 ///< Use precomputed sub-pel reference planes in fractional ME
+  Bool      m_bUseHierarchicalME;                             ///< Seed the integer ME with a motion search on downsampled pictures
+  Int       m_iHierarchicalMESearchRange;                     ///< TZ search range around a hierarchical ME seed (0: SearchRange)
+  Int       m_iMergePredCache;                                ///< Size of the per-CTU merge candidate prediction cache in KB (0: off)
   Int       m_iSearchRange;                                   ///< ME search range
   Int       m_bipredSearchRange;                              ///< ME search range for bipred refinement
   Int       m_minSearchWindow;                                ///< ME minimum search window size for the Adaptive Window ME
@@ -403,6 +412,7 @@ protected:
   Bool      m_RCUseLCUSeparateModel;              ///< use separate R-lambda model at LCU level                        NOTE: code-tidy - rename to m_RCUseCtuSeparateModel
   Int       m_RCInitialQP;                        ///< inital QP for rate control
   Bool      m_RCForceIntraQP;                     ///< force all intra picture to use initial QP or not
+  Int       m_RCLookahead;                        ///< 0: no lookahead; 1: bit allocation and CTU QP offsets from the lookahead; 2: two-pass
 #if U0132_TARGET_BITS_SATURATION
   Bool      m_RCCpbSaturationEnabled;             ///< enable target bits saturation to avoid CPB overflow and underflow
   UInt      m_RCCpbSize;                          ///< CPB size
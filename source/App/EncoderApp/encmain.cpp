@@ -39,6 +39,7 @@
 #include <iostream>
 #include "EncApp.h"
 #include "Utilities/program_options_lite.h"
+#include "CommonLib/Profiler.h"
 
 #include "svnrevision.h"
 
@@ -153,6 +154,12 @@ int main(int argc, char* argv[])
   // ending time
   dResult = (Double)(clock()-lBefore) / CLOCKS_PER_SEC;
   printf("\n Total Time: %12.3f sec.\n", dResult);
+#if ENABLE_PROFILING
+  if( Profiler::isEnabled() )
+  {
+    Profiler::report();
+  }
+#endif
   // destroy application encoder class
   pcEncApp->destroy();
 
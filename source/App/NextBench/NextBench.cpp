@@ -0,0 +1,1147 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     NextBench.cpp
+    \brief    kernel micro benchmark
+*/
+
+#include "NextBench.h"
+#include "Utilities/program_options_lite.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+namespace po = df::program_options_lite;
+
+//! \ingroup NextBench
+//! \{
+
+#if HHI_SIMD_OPT && defined( TARGET_SIMD_X86 )
+
+static const Int BENCH_MARGIN        = 96;                                ///< border around the benchmarked block, covers the filter taps and the angular references
+static const Int BENCH_STRIDE        = MAX_CU_SIZE + 2 * BENCH_MARGIN;
+static const Int BENCH_BIF_QP        = 32;
+static const Int BENCH_MOTION_LOG2   = 2;                                 ///< motion storage granularity of the motion access benchmarks
+static const Int BENCH_MOTION_STRIDE = MAX_CU_SIZE >> BENCH_MOTION_LOG2;
+
+static const char* const g_vextNames[] = { "SCALAR", "SSE41", "SSE42", "AVX", "AVX2", "AVX512" };
+
+// interpolation filter coefficients, half sample positions of the luma and chroma filters and the bilinear filter
+static const TFilterCoeff g_benchCoeff8[8] = { -1, 4, -11, 40, 40, -11, 4, -1 };
+static const TFilterCoeff g_benchCoeff4[4] = { -4, 54, 16, -2 };
+static const TFilterCoeff g_benchCoeff2[2] = { 32, 32 };
+
+// ====================================================================================================================
+// Kernel sets
+// ====================================================================================================================
+
+Void BenchKernelSet::init( X86_VEXT _vext )
+{
+  vext = _vext;
+
+  // the constructors of the kernel classes have set up the C kernels, see NextBench::run()
+  RdCost rdCost;
+  switch( vext )
+  {
+  case SSE41:
+  case SSE42:
+    rdCost              ._initRdCostX86              <SSE41>();
+    interpolationFilter ._initInterpolationFilterX86 <SSE41>();
+    pelBufOps           ._initPelBufOpsX86           <SSE41>();
+    intraPrediction     ._initIntraPredictionX86     <SSE41>();
+    loopFilter          ._initLoopFilterX86          <SSE41>();
+    sampleAdaptiveOffset._initSampleAdaptiveOffsetX86<SSE41>();
+    adaptiveLoopFilter  ._initAdaptiveLoopFilterX86  <SSE41>();
+    BilateralFilter::instance()->_initBilateralFilterX86<SSE41>();
+    break;
+  case AVX:
+    rdCost              ._initRdCostX86              <AVX>();
+    interpolationFilter ._initInterpolationFilterX86 <AVX>();
+    pelBufOps           ._initPelBufOpsX86           <AVX>();
+    intraPrediction     ._initIntraPredictionX86     <AVX>();
+    loopFilter          ._initLoopFilterX86          <AVX>();
+    sampleAdaptiveOffset._initSampleAdaptiveOffsetX86<AVX>();
+    adaptiveLoopFilter  ._initAdaptiveLoopFilterX86  <AVX>();
+    BilateralFilter::instance()->_initBilateralFilterX86<AVX>();
+    break;
+  case AVX2:
+  case AVX512:
+    rdCost              ._initRdCostX86              <AVX2>();
+    interpolationFilter ._initInterpolationFilterX86 <AVX2>();
+    pelBufOps           ._initPelBufOpsX86           <AVX2>();
+    intraPrediction     ._initIntraPredictionX86     <AVX2>();
+    loopFilter          ._initLoopFilterX86          <AVX2>();
+    sampleAdaptiveOffset._initSampleAdaptiveOffsetX86<AVX2>();
+    adaptiveLoopFilter  ._initAdaptiveLoopFilterX86  <AVX2>();
+    BilateralFilter::instance()->_initBilateralFilterX86<AVX2>();
+    break;
+  default:
+    rdCost.init();
+    BilateralFilter::instance()->m_smoothBlock = BilateralFilter::xSmoothBlock;
+    break;
+  }
+
+  // the distortion kernels and the bilateral filter kernel are shared by all instances, keep a copy of the pointers
+  for( Int i = 0; i < DF_TOTAL_FUNCTIONS; i++ )
+  {
+    distFunc  [i] = RdCost::getDistFunc  ( DFunc( i ) );
+    distFuncX4[i] = RdCost::getDistFuncX4( DFunc( i ) );
+  }
+  smoothBlock = BilateralFilter::instance()->m_smoothBlock;
+}
+
+// ====================================================================================================================
+// Constructor / destructor / configuration
+// ====================================================================================================================
+
+NextBench::NextBench()
+  : m_bitDepth    ( 0 )
+  , m_minTime     ( 5.0 )
+  , m_curBitDepth ( 8 )
+  , m_dist        ( 0 )
+  , m_motionCs    ( nullptr )
+{
+  m_clpRng.min = 0;
+  m_clpRng.max = 255;
+  m_clpRng.bd  = 8;
+  m_clpRng.n   = 0;
+}
+
+NextBench::~NextBench()
+{
+  for( auto kernelSet : m_kernelSets )
+  {
+    delete kernelSet;
+  }
+  m_kernelSets.clear();
+
+  if( m_motionCs )
+  {
+    m_motionCs->destroy();
+    delete m_motionCs;
+    m_motionCs = nullptr;
+  }
+}
+
+Bool NextBench::parseCfg( Int argc, TChar* argv[] )
+{
+  Bool do_help = false;
+
+  po::Options opts;
+  opts.addOptions()
+
+  ("help",                      do_help,                               false,      "this help text")
+  ("SIMD",                      m_simd,                                std::string(""), "highest SIMD extension to benchmark (SCALAR, SSE41, AVX, AVX2), default: the highest supported extension")
+  ("BitDepth,d",                m_bitDepth,                            0,          "bit depth of the test data (8, 10 or 12), 0: all")
+  ("Kernels,k",                 m_kernelFilter,                        std::string(""), "only benchmark the kernels whose name contains this string")
+  ("MinTime,t",                 m_minTime,                             5.0,        "minimum measurement time per kernel, block size and extension in ms")
+  ("JsonFile,o",                m_jsonFileName,                        std::string(""), "write the results as JSON to this file, '-' for stdout")
+  ;
+
+  po::setDefaults( opts );
+  po::ErrorReporter err;
+  const std::list<const TChar*>& argv_unhandled = po::scanArgv( opts, argc, ( const TChar** ) argv, err );
+
+  for( std::list<const TChar*>::const_iterator it = argv_unhandled.begin(); it != argv_unhandled.end(); it++ )
+  {
+    msg( ERROR, "Unhandled argument ignored: `%s'\n", *it );
+  }
+
+  if( do_help )
+  {
+    po::doHelp( std::cout, opts );
+    return false;
+  }
+
+  if( err.is_errored )
+  {
+    return false;
+  }
+
+  if( m_bitDepth != 0 && m_bitDepth != 8 && m_bitDepth != 10 && m_bitDepth != 12 )
+  {
+    msg( ERROR, "Unsupported bit depth %d\n", m_bitDepth );
+    return false;
+  }
+
+  return true;
+}
+
+// ====================================================================================================================
+// Test data
+// ====================================================================================================================
+
+Int NextBench::xOffset( Int x, Int y ) const
+{
+  return ( y + BENCH_MARGIN ) * BENCH_STRIDE + x + BENCH_MARGIN;
+}
+
+Void NextBench::xInitData( Int bitDepth )
+{
+  m_curBitDepth  = bitDepth;
+  m_clpRng.min   = 0;
+  m_clpRng.max   = ( 1 << bitDepth ) - 1;
+  m_clpRng.bd    = bitDepth;
+
+  const Int size = BENCH_STRIDE * BENCH_STRIDE;
+  m_src     .resize( size );
+  m_org     .resize( size );
+  m_inter   .resize( size );
+  m_interOrg.resize( size );
+  m_dst     .resize( size );
+  m_intSrc  .resize( size );
+  m_intOrg  .resize( size );
+  m_intTag  .resize( size );
+  m_alfE    .resize( AdaptiveLoopFilter::m_MAX_SQR_FILT_LENGTH * AdaptiveLoopFilter::m_MAX_SQR_FILT_LENGTH );
+  m_alfY    .resize( AdaptiveLoopFilter::m_MAX_SQR_FILT_LENGTH );
+
+  // deterministic test data: smooth gradients with a little noise for the reconstruction, more noise for the original,
+  // such that the deblocking decisions and the SAO edge classes take all branches
+  UInt seed       = 0x1234567u;
+  auto rnd        = [&seed]() { seed = seed * 1664525u + 1013904223u; return Int( seed >> 16 ); };
+  const Int scale = 1 << ( bitDepth - 8 );
+
+  for( Int y = 0; y < BENCH_STRIDE; y++ )
+  {
+    for( Int x = 0; x < BENCH_STRIDE; x++ )
+    {
+      const Int i      = y * BENCH_STRIDE + x;
+      const Int smooth = 128 + ( ( ( x / 13 ) * 17 + ( y / 11 ) * 23 ) % 96 ) - 48 + ( ( x + 2 * y ) & 15 );
+      const Int src    = Clip3( 0, m_clpRng.max, smooth * scale + ( rnd() % ( 3 * scale ) ) - scale );
+      const Int org    = Clip3( 0, m_clpRng.max, src + ( rnd() % ( 9 * scale ) ) - 4 * scale );
+      m_src     [i] = Pel( src );
+      m_org     [i] = Pel( org );
+      m_inter   [i] = Pel( ( src << ( IF_INTERNAL_PREC - bitDepth ) ) - IF_INTERNAL_OFFS );
+      m_interOrg[i] = Pel( ( org << ( IF_INTERNAL_PREC - bitDepth ) ) - IF_INTERNAL_OFFS );
+      m_intSrc  [i] = src;
+      m_intOrg  [i] = org;
+      m_intTag  [i] = src > ( 128 << ( bitDepth - 8 ) ) ? 1 : 0;
+    }
+  }
+}
+
+Void NextBench::xResetDst()
+{
+  std::copy( m_src.begin(), m_src.end(), m_dst.begin() );
+  m_dist = 0;
+  std::fill( m_saoDiff,  m_saoDiff  + NUM_SAO_BO_CLASSES, 0 );
+  std::fill( m_saoCount, m_saoCount + NUM_SAO_BO_CLASSES, 0 );
+  std::fill( m_alfE.begin(), m_alfE.end(), 0 );
+  std::fill( m_alfY.begin(), m_alfY.end(), 0 );
+}
+
+UInt64 NextBench::xDigestDst( Int width, Int height )
+{
+  // FNV-1a over the block including a border, the in place kernels (deblocking) modify samples left of and above the block
+  UInt64 hash = 14695981039346656037ull;
+  auto add    = [&hash]( UInt64 v ) { for( Int b = 0; b < 8; b++ ) { hash = ( hash ^ ( ( v >> ( 8 * b ) ) & 0xff ) ) * 1099511628211ull; } };
+
+  for( Int y = -8; y < height + 8; y++ )
+  {
+    const Pel* dst = xDst( 0, y );
+    for( Int x = -8; x < width + 8; x++ )
+    {
+      add( UInt64( UShort( dst[x] ) ) );
+    }
+  }
+  add( m_dist );
+  for( Int i = 0; i < NUM_SAO_BO_CLASSES; i++ )
+  {
+    add( UInt64( m_saoDiff[i] ) );
+    add( UInt64( m_saoCount[i] ) );
+  }
+  for( const Int64 e : m_alfE )
+  {
+    add( UInt64( e ) );
+  }
+  for( const Int64 y : m_alfY )
+  {
+    add( UInt64( y ) );
+  }
+  return hash;
+}
+
+// ====================================================================================================================
+// Benchmark cases
+// ====================================================================================================================
+
+Void NextBench::xAddCase( const std::string& kernel, Int width, Int height, std::function<Void( BenchKernelSet& )> run )
+{
+  if( !m_kernelFilter.empty() && kernel.find( m_kernelFilter ) == std::string::npos )
+  {
+    return;
+  }
+
+  BenchCase benchCase;
+  benchCase.kernel = kernel;
+  benchCase.width  = width;
+  benchCase.height = height;
+  benchCase.run    = run;
+  benchCase.reset  = [this]() { xResetDst(); };
+  benchCase.digest = [this, width, height]() { return xDigestDst( width, height ); };
+  m_cases.push_back( benchCase );
+}
+
+Void NextBench::xAddDistortionCases()
+{
+  static const struct { const char* name; DFunc base; } distKernels[] =
+  {
+    { "SAD",   DF_SAD   },
+    { "SSE",   DF_SSE   },
+    { "HAD",   DF_HAD   },
+    { "MRSAD", DF_MRSAD },
+  };
+
+  for( const auto& distKernel : distKernels )
+  {
+    for( Int log2Size = 2; log2Size <= 6; log2Size++ )
+    {
+      const Int   size  = 1 << log2Size;
+      const DFunc dFunc = DFunc( distKernel.base + log2Size );
+
+      xAddCase( distKernel.name, size, size, [this, size, dFunc]( BenchKernelSet& ks )
+      {
+        DistParam distParam;
+        distParam.org      = CPelBuf( xOrg(), BENCH_STRIDE, size, size );
+        distParam.cur      = CPelBuf( xSrc(), BENCH_STRIDE, size, size );
+        distParam.bitDepth = m_curBitDepth;
+        distParam.compID   = COMPONENT_Y;
+        distParam.distFunc = ks.distFunc[dFunc];
+        m_dist            += distParam.distFunc( distParam );
+      } );
+    }
+  }
+
+  // four candidate positions around the block, as in the TZ search
+  for( Int log2Size = 2; log2Size <= 6; log2Size++ )
+  {
+    const Int   size  = 1 << log2Size;
+    const DFunc dFunc = DFunc( DF_SAD + log2Size );
+
+    xAddCase( "SADX4", size, size, [this, size, dFunc]( BenchKernelSet& ks )
+    {
+      DistParam distParam;
+      distParam.org        = CPelBuf( xOrg(), BENCH_STRIDE, size, size );
+      distParam.cur        = CPelBuf( xSrc(), BENCH_STRIDE, size, size );
+      distParam.bitDepth   = m_curBitDepth;
+      distParam.compID     = COMPONENT_Y;
+      distParam.distFunc   = ks.distFunc[dFunc];
+      distParam.distFuncX4 = ks.distFuncX4[dFunc];
+
+      const Pel* const cur[4] = { xSrc( 0, -1 ), xSrc( -1, 0 ), xSrc( 1, 0 ), xSrc( 0, 1 ) };
+      Distortion       dist[4];
+      distParam.distFuncX4( distParam, cur, dist );
+      m_dist += dist[0] + 3 * dist[1] + 5 * dist[2] + 7 * dist[3];
+    } );
+  }
+}
+
+Void NextBench::xAddInterpolationCases()
+{
+  static const struct { const char* name; Int idx; Int taps; const TFilterCoeff* coeff; } filters[] =
+  {
+    { "8",  0, 8, g_benchCoeff8 },
+    { "4",  1, 4, g_benchCoeff4 },
+    { "2",  2, 2, g_benchCoeff2 },
+  };
+
+  for( Int log2Size = 2; log2Size <= 6; log2Size++ )
+  {
+    const Int size = 1 << log2Size;
+
+    for( const auto& filter : filters )
+    {
+      const Int idx                = filter.idx;
+      const Int taps               = filter.taps;
+      const TFilterCoeff* coeff    = filter.coeff;
+
+      // first stage of the separable filter: samples to intermediate precision
+      xAddCase( std::string( "InterpHor" ) + filter.name, size, size, [this, size, idx, taps, coeff]( BenchKernelSet& ks )
+      {
+        ks.interpolationFilter.m_filterHor[idx][1][0]( m_clpRng, xSrc( -( taps / 2 - 1 ), 0 ), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, coeff );
+      } );
+      // second stage of the separable filter: intermediate precision to samples
+      xAddCase( std::string( "InterpVer" ) + filter.name, size, size, [this, size, idx, taps, coeff]( BenchKernelSet& ks )
+      {
+        ks.interpolationFilter.m_filterVer[idx][0][1]( m_clpRng, xInter( 0, -( taps / 2 - 1 ) ), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, coeff );
+      } );
+    }
+
+    xAddCase( "InterpCopy", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      ks.interpolationFilter.m_filterCopy[1][0]( m_clpRng, xSrc(), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size );
+    } );
+  }
+}
+
+Void NextBench::xAddBufferCases()
+{
+  for( Int log2Size = 2; log2Size <= 6; log2Size++ )
+  {
+    const Int  size   = 1 << log2Size;
+    const Bool is8    = ( size & 7 ) == 0;
+
+    xAddCase( "AddAvg", size, size, [this, size, is8]( BenchKernelSet& ks )
+    {
+      const Int shift  = std::max<Int>( 2, IF_INTERNAL_PREC - m_curBitDepth ) + 1;
+      const Int offset = ( 1 << ( shift - 1 ) ) + 2 * IF_INTERNAL_OFFS;
+      ( is8 ? ks.pelBufOps.addAvg8 : ks.pelBufOps.addAvg4 )( xInter(), BENCH_STRIDE, xInterOrg(), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, shift, offset, m_clpRng );
+    } );
+    xAddCase( "Reco", size, size, [this, size, is8]( BenchKernelSet& ks )
+    {
+      // the difference of the original and the reconstruction serves as residual
+      ( is8 ? ks.pelBufOps.reco8 : ks.pelBufOps.reco4 )( xSrc(), BENCH_STRIDE, xOrg( 0, 1 ), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, m_clpRng );
+    } );
+    xAddCase( "LinTf", size, size, [this, size, is8]( BenchKernelSet& ks )
+    {
+      ( is8 ? ks.pelBufOps.linTf8 : ks.pelBufOps.linTf4 )( xSrc(), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, 37, 5, 1 << ( m_curBitDepth - 6 ), m_clpRng, true );
+    } );
+  }
+}
+
+Void NextBench::xAddIntraCases()
+{
+  for( Int log2Size = 2; log2Size <= 6; log2Size++ )
+  {
+    const Int size = 1 << log2Size;
+
+    // the reference samples are at pSrc[1..] (above) and pSrc[( k + 1 ) * stride] (left), see IntraPrediction::xPredPlanarCore
+    xAddCase( "IntraPlanar", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      ks.intraPrediction.m_predPlanar( xSrc( -1, -1 ), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size );
+    } );
+    xAddCase( "IntraDC", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      ks.intraPrediction.m_predDc( xSrc( -1, -1 ), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size );
+    } );
+
+    // the kernels predict in the vertical direction, horizontal modes are predicted transposed, see
+    // IntraPrediction::xPredIntraAng: pure vertical/horizontal, fractional angles on both sides and both diagonals
+    static const Int angles[] = { 0, 13, -13, 32, -32 };
+    for( const Int angle : angles )
+    {
+      xAddCase( "IntraAngLinear" + std::to_string( angle ), size, size, [this, size, angle]( BenchKernelSet& ks )
+      {
+        ks.intraPrediction.m_predAngLinear( xDst(), BENCH_STRIDE, xSrc( -1, -1 ), size, size, angle );
+      } );
+      xAddCase( "IntraAng4Tap" + std::to_string( angle ), size, size, [this, size, angle]( BenchKernelSet& ks )
+      {
+        ks.intraPrediction.m_predAng4Tap( xDst(), BENCH_STRIDE, xSrc( -1, -1 ), size, size, angle, m_clpRng );
+      } );
+    }
+    xAddCase( "IntraTranspose", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      ks.intraPrediction.m_transposeBlk( xSrc(), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size );
+    } );
+    // the above reference row of a block, see IntraPrediction::xFilterReferenceSamples
+    xAddCase( "IntraFilterRefRow", 2 * size, 1, [this, size]( BenchKernelSet& ks )
+    {
+      ks.intraPrediction.m_filterRefRow( xSrc(), xDst(), 2 * size );
+    } );
+  }
+}
+
+Void NextBench::xAddLMCases()
+{
+  for( Int log2Size = 2; log2Size <= 6; log2Size++ )
+  {
+    const Int size = 1 << log2Size;
+
+    // chroma block size, the luma reconstruction is twice the size
+    xAddCase( "LMLumaDownsample", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      ks.intraPrediction.m_lumaDownsample( xSrc(), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, true );
+    } );
+    // one template row of the parameter derivation
+    xAddCase( "LMSumsRow", size, 1, [this, size]( BenchKernelSet& ks )
+    {
+      Int x = 0, y = 0, xx = 0, xy = 0;
+      ks.intraPrediction.m_lmSumsRow( xSrc(), xOrg(), size, x, y, xx, xy );
+      m_dist += Distortion( x ) + 3 * Distortion( y ) + 5 * Distortion( xx ) + 7 * Distortion( xy );
+    } );
+    // the above and the left template of the multi model derivation with two classes
+    xAddCase( "LMClassSums", 2 * size, 1, [this, size]( BenchKernelSet& ks )
+    {
+      const Int offset = xOffset( 0, 0 );
+      Int x[2], y[2], xx[2], xy[2];
+      ks.intraPrediction.m_lmClassSums( &m_intSrc[offset], &m_intOrg[offset], &m_intTag[offset], 2 * size, 2, x, y, xx, xy );
+      for( Int group = 0; group < 2; group++ )
+      {
+        m_dist = m_dist * 31 + Distortion( x[group] ) + 3 * Distortion( y[group] ) + 5 * Distortion( xx[group] ) + 7 * Distortion( xy[group] );
+      }
+    } );
+    xAddCase( "LMApply2", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      const Int scale = 1 << ( m_curBitDepth - 8 );
+      IntraPrediction::MMLM_parameter parameters[2];
+      parameters[0].Inf   = 0;
+      parameters[0].Sup   = 128 * scale;
+      parameters[0].a     = 45;
+      parameters[0].b     = 20 * scale;
+      parameters[0].shift = 6;
+      parameters[1].Inf   = 128 * scale + 1;
+      parameters[1].Sup   = m_clpRng.max;
+      parameters[1].a     = -19;
+      parameters[1].b     = 190 * scale;
+      parameters[1].shift = 6;
+      ks.intraPrediction.m_lmApply2( xSrc(), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, parameters, m_clpRng );
+    } );
+  }
+}
+
+Void NextBench::xAddLoopFilterCases()
+{
+  // all edges on the 8x8 grid of the block, including the left and the top block boundary, in segments of 4 lines
+  for( Int log2Size = 3; log2Size <= 6; log2Size++ )
+  {
+    const Int size = 1 << log2Size;
+
+    for( Int dir = 0; dir < 2; dir++ )
+    {
+      const Bool ver = dir == 0;
+
+      xAddCase( ver ? "DeblockLumaVer" : "DeblockLumaHor", size, size, [this, size, ver]( BenchKernelSet& ks )
+      {
+        const Int scale         = 1 << ( m_curBitDepth - 8 );
+        const Int tc            = 6 * scale;
+        const Int beta          = 48 * scale;
+        const Int sideThreshold = ( beta + ( beta >> 1 ) ) >> 3;
+        const Int thrCut        = tc * 10;
+        const Int offset        = ver ? 1 : BENCH_STRIDE;
+        const Int step          = ver ? BENCH_STRIDE : 1;
+
+        for( Int edge = 0; edge < size; edge += 8 )
+        {
+          for( Int seg = 0; seg < size; seg += 4 )
+          {
+            Pel* piSrc = ver ? xDst( edge, seg ) : xDst( seg, edge );
+            ks.loopFilter.m_filterLumaSeg( piSrc, offset, step, tc, beta, sideThreshold, thrCut, false, false, m_clpRng );
+          }
+        }
+      } );
+      xAddCase( ver ? "DeblockChromaVer" : "DeblockChromaHor", size, size, [this, size, ver]( BenchKernelSet& ks )
+      {
+        const Int tc     = 4 << ( m_curBitDepth - 8 );
+        const Int offset = ver ? 1 : BENCH_STRIDE;
+        const Int step   = ver ? BENCH_STRIDE : 1;
+
+        for( Int edge = 0; edge < size; edge += 8 )
+        {
+          for( Int seg = 0; seg < size; seg += 4 )
+          {
+            Pel* piSrc = ver ? xDst( edge, seg ) : xDst( seg, edge );
+            ks.loopFilter.m_filterChromaSeg( piSrc, offset, step, 4, tc, false, false, m_clpRng );
+          }
+        }
+      } );
+    }
+  }
+}
+
+Void NextBench::xAddSaoCases()
+{
+  for( Int log2Size = 3; log2Size <= 6; log2Size++ )
+  {
+    const Int size = 1 << log2Size;
+
+    // 135 degree class, the neighbours are in the previous and the next line
+    xAddCase( "SaoEO", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      static const Int offset[NUM_SAO_EO_CLASSES] = { 3, 1, 0, -1, -3 };
+      const Int scale = 1 << ( m_curBitDepth - 8 );
+      const Int scaledOffset[NUM_SAO_EO_CLASSES] = { offset[0] * scale, offset[1] * scale, 0, offset[3] * scale, offset[4] * scale };
+      ks.sampleAdaptiveOffset.m_offsetEO( xSrc(), BENCH_STRIDE, xDst(), BENCH_STRIDE, 0, size, size, -BENCH_STRIDE + 1, BENCH_STRIDE - 1, scaledOffset + 2, m_clpRng );
+    } );
+    xAddCase( "SaoBO", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      Int offset[NUM_SAO_BO_CLASSES];
+      for( Int i = 0; i < NUM_SAO_BO_CLASSES; i++ )
+      {
+        offset[i] = ( ( i % 7 ) - 3 ) << ( m_curBitDepth - 8 );
+      }
+      ks.sampleAdaptiveOffset.m_offsetBO( xSrc(), BENCH_STRIDE, xDst(), BENCH_STRIDE, size, size, m_curBitDepth - NUM_SAO_BO_CLASSES_LOG2, offset, m_clpRng );
+    } );
+    xAddCase( "SaoStatsEO", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      ks.sampleAdaptiveOffset.m_statsEO( xSrc(), BENCH_STRIDE, xOrg(), BENCH_STRIDE, 0, size, size, -1, 1, m_saoDiff + 2, m_saoCount + 2 );
+    } );
+    xAddCase( "SaoStatsBO", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      ks.sampleAdaptiveOffset.m_statsBO( xSrc(), BENCH_STRIDE, xOrg(), BENCH_STRIDE, 0, size, size, m_curBitDepth - NUM_SAO_BO_CLASSES_LOG2, m_saoDiff, m_saoCount );
+    } );
+  }
+}
+
+Void NextBench::xAddBilateralCases()
+{
+  for( Int log2Size = 2; log2Size <= 6; log2Size++ )
+  {
+    const Int size = 1 << log2Size;
+
+    xAddCase( "BilateralIntra", size, size, [this, size]( BenchKernelSet& ks )
+    {
+      BilateralFilter* bilateralFilter = BilateralFilter::instance();
+      PelBuf           recoBuf( xDst(), BENCH_STRIDE, size, size );
+      bilateralFilter->m_smoothBlock = ks.smoothBlock;
+      bilateralFilter->bilateralFilterIntra( recoBuf, BENCH_BIF_QP );
+    } );
+  }
+}
+
+Void NextBench::xAddAlfCases()
+{
+  // statistics of the encoder filter estimation, a block of samples with the symmetric filter shapes
+  static const Int sqrFiltLengths[] = { AdaptiveLoopFilter::m_SQR_FILT_LENGTH_5SYM, AdaptiveLoopFilter::m_SQR_FILT_LENGTH_7SYM, AdaptiveLoopFilter::m_SQR_FILT_LENGTH_9SYM };
+
+  for( const Int sqrFiltLength : sqrFiltLengths )
+  {
+    const Int size = 8;
+
+    xAddCase( "AlfCovariance" + std::to_string( sqrFiltLength ), size, size, [this, size, sqrFiltLength]( BenchKernelSet& ks )
+    {
+      for( Int y = 0; y < size; y++ )
+      {
+        for( Int x = 0; x < size; x++ )
+        {
+          // the local sample vector of the filter taps, taken from a row of the source
+          const Int offset = xOffset( x, y );
+          ks.adaptiveLoopFilter.m_accumulateCovariance( &m_intSrc[offset], m_intOrg[offset], sqrFiltLength, &m_alfE[0], &m_alfY[0] );
+        }
+      }
+    } );
+  }
+}
+
+// ====================================================================================================================
+// Motion access
+// ====================================================================================================================
+
+// the spatial merge candidates and the boundary strength read the motion of the neighbouring blocks, both are run on the
+// motion of one CTU through CodingStructure::getMotionInfo(), the former access, and on the block motion field now read
+
+// reference pictures of the boundary strength, the lists share pictures as in random access
+static const Int g_benchRefPoc[NUM_REF_PIC_LIST_01][4] = { { 8, 4, 2, 16 }, { 16, 8, 4, 2 } };
+
+static inline UChar xBenchBs( const Int refP0, const Int refP1, const Int refQ0, const Int refQ1, const Mv& mvP0, const Mv& mvP1, const Mv& mvQ0, const Mv& mvQ1 )
+{
+  static const Int threshold = 4;
+  auto differ = [] ( const Mv& a, const Mv& b ) { return abs( a.getHor() - b.getHor() ) >= threshold || abs( a.getVer() - b.getVer() ) >= threshold; };
+
+  if( !( ( refP0 == refQ0 && refP1 == refQ1 ) || ( refP0 == refQ1 && refP1 == refQ0 ) ) )
+  {
+    return 1;
+  }
+  if( refP0 != refP1 )
+  {
+    return refP0 == refQ0 ? ( differ( mvQ0, mvP0 ) || differ( mvQ1, mvP1 ) ) : ( differ( mvQ1, mvP0 ) || differ( mvQ0, mvP1 ) );
+  }
+  return ( differ( mvQ0, mvP0 ) || differ( mvQ1, mvP1 ) ) && ( differ( mvQ1, mvP0 ) || differ( mvQ0, mvP1 ) );
+}
+
+Void NextBench::xInitMotion()
+{
+  const Int  numBlks = BENCH_MOTION_STRIDE * BENCH_MOTION_STRIDE;
+  const Area ctuArea( 0, 0, MAX_CU_SIZE, MAX_CU_SIZE );
+
+  if( !m_motionCs )
+  {
+    m_motionCs = new CodingStructure( m_unitCache.cuCache, m_unitCache.puCache, m_unitCache.tuCache );
+    m_motionCs->create( CHROMA_420, ctuArea, true );
+  }
+
+  MotionBuf mb = m_motionCs->getMotionBuf( ctuArea );
+
+  // prediction units of 8x8 to 32x32 samples, a third of them sharing the motion of their left neighbour such that the
+  // merge pruning finds identical candidates, a few intra blocks
+  UInt seed = 0x7654321u;
+  auto rnd  = [&seed]() { seed = seed * 1664525u + 1013904223u; return Int( seed >> 16 ); };
+
+  for( Int y = 0; y < BENCH_MOTION_STRIDE; y += 2 )
+  {
+    for( Int x = 0; x < BENCH_MOTION_STRIDE; )
+    {
+      const Int  puSize = 2 << ( rnd() % 3 );
+      MotionInfo mi;
+
+      if( x > 0 && rnd() % 3 == 0 )
+      {
+        mi = mb.at( x - 1, y );
+      }
+      else
+      {
+        mi.isInter  = rnd() % 16 != 0;
+        mi.usesLIC  = mi.isInter && rnd() % 8 == 0;
+        mi.interDir = mi.isInter ? 1 + rnd() % 3 : 0;
+        for( Int i = 0; i < NUM_REF_PIC_LIST_01; i++ )
+        {
+          const Bool used = ( mi.interDir & ( 1 << i ) ) != 0;
+          mi.refIdx[i]    = used ? rnd() % 4 : NOT_VALID;
+          mi.mv    [i]    = used ? Mv( rnd() % 64 - 32, rnd() % 64 - 32, true ) : Mv();
+        }
+      }
+
+      for( Int j = y; j < std::min( y + 2, BENCH_MOTION_STRIDE ); j++ )
+      {
+        for( Int i = x; i < std::min( x + puSize, BENCH_MOTION_STRIDE ); i++ )
+        {
+          mb.at( i, j ) = mi;
+        }
+      }
+      x += puSize;
+    }
+  }
+
+  m_motionCs->updateBlockMotion( ctuArea );
+
+  m_mergeCands.resize( numBlks * 2 * 5 );
+  m_bs        .resize( numBlks * 2 );
+}
+
+Int NextBench::xRunMotionCases()
+{
+  const Int size = MAX_CU_SIZE;
+
+  struct MotionCase
+  {
+    std::string kernel;
+    BenchCase   layouts[2];
+  };
+  std::vector<MotionCase> motionCases( 2 );
+
+  auto digest = [this]()
+  {
+    UInt64 hash = 14695981039346656037ull;
+    auto add    = [&hash]( UInt64 v ) { for( Int b = 0; b < 8; b++ ) { hash = ( hash ^ ( ( v >> ( 8 * b ) ) & 0xff ) ) * 1099511628211ull; } };
+
+    for( const MvField& mvField : m_mergeCands )
+    {
+      add( UInt64( UInt( mvField.mv.getHor() ) ) | ( UInt64( UInt( mvField.mv.getVer() ) ) << 32 ) );
+      add( UInt64( mvField.refIdx ) );
+    }
+    for( const UChar bs : m_bs )
+    {
+      add( bs );
+    }
+    return hash;
+  };
+  auto reset = [this]()
+  {
+    std::fill( m_mergeCands.begin(), m_mergeCands.end(), MvField() );
+    std::fill( m_bs        .begin(), m_bs        .end(), 0 );
+  };
+
+  // spatial merge candidates of all 8x8 prediction units with available neighbours: left, above, above right, below left
+  // and above left, each compared with the candidates the merge list derivation prunes it against
+  motionCases[0].kernel = "MergeSpatial";
+  motionCases[0].layouts[0].run = [this, size]( BenchKernelSet& )
+  {
+    const CodingStructure& cs = *m_motionCs;
+
+    for( Int y = 8; y < size - 8; y += 8 )
+    {
+      for( Int x = 8; x < size - 8; x += 8 )
+      {
+        MvField* cands = &m_mergeCands[( ( y >> BENCH_MOTION_LOG2 ) * BENCH_MOTION_STRIDE + ( x >> BENCH_MOTION_LOG2 ) ) * 10];
+        Int      cnt   = 0;
+
+        const MotionInfo miLeft       = cs.getMotionInfo( Position( x - 1, y + 7 ) );
+        const MotionInfo miAbove      = cs.getMotionInfo( Position( x + 7, y - 1 ) );
+        const MotionInfo miAboveRight = cs.getMotionInfo( Position( x + 8, y - 1 ) );
+        const MotionInfo miBelowLeft  = cs.getMotionInfo( Position( x - 1, y + 8 ) );
+        const MotionInfo miAboveLeft  = cs.getMotionInfo( Position( x - 1, y - 1 ) );
+
+        const MotionInfo* neighbours[5] = { &miLeft, &miAbove, &miAboveRight, &miBelowLeft, &miAboveLeft };
+        const Bool        added     [5] = { miLeft.isInter,
+                                            miAbove.isInter      && miAbove      != miLeft,
+                                            miAboveRight.isInter && miAboveRight != miAbove,
+                                            miBelowLeft.isInter  && miBelowLeft  != miLeft,
+                                            miAboveLeft.isInter  && miAboveLeft  != miLeft && miAboveLeft != miAbove };
+
+        for( Int i = 0; i < 5; i++ )
+        {
+          if( added[i] )
+          {
+            cands[2 * cnt    ].setMvField( neighbours[i]->mv[0], neighbours[i]->refIdx[0] );
+            cands[2 * cnt + 1].setMvField( neighbours[i]->mv[1], neighbours[i]->refIdx[1] );
+            cnt++;
+          }
+        }
+      }
+    }
+  };
+  motionCases[0].layouts[1].run = [this, size]( BenchKernelSet& )
+  {
+    MotionField::RowCache rowCache;
+
+    for( Int y = 8; y < size - 8; y += 8 )
+    {
+      for( Int x = 8; x < size - 8; x += 8 )
+      {
+        MvField* cands = &m_mergeCands[( ( y >> BENCH_MOTION_LOG2 ) * BENCH_MOTION_STRIDE + ( x >> BENCH_MOTION_LOG2 ) ) * 10];
+        Int      cnt   = 0;
+
+        const MotionField& mf            = m_motionCs->getBlockMotion();
+        const UInt         idxLeft       = rowCache.idx( mf, x - 1, y + 7 );
+        const UInt         idxAbove      = rowCache.idx( mf, x + 7, y - 1 );
+        const UInt         idxAboveRight = rowCache.idx( mf, x + 8, y - 1 );
+        const UInt         idxAboveLeft  = rowCache.idx( mf, x - 1, y - 1 );
+        const UInt         idxBelowLeft  = rowCache.idx( mf, x - 1, y + 8 );
+
+        const UInt neighbours[5] = { idxLeft, idxAbove, idxAboveRight, idxBelowLeft, idxAboveLeft };
+        const Bool added     [5] = { mf.isInter( idxLeft ),
+                                     mf.isInter( idxAbove )      && !mf.sameMotion( idxAbove,      mf, idxLeft ),
+                                     mf.isInter( idxAboveRight ) && !mf.sameMotion( idxAboveRight, mf, idxAbove ),
+                                     mf.isInter( idxBelowLeft )  && !mf.sameMotion( idxBelowLeft,  mf, idxLeft ),
+                                     mf.isInter( idxAboveLeft )  && !mf.sameMotion( idxAboveLeft,  mf, idxLeft ) && !mf.sameMotion( idxAboveLeft, mf, idxAbove ) };
+
+        for( Int i = 0; i < 5; i++ )
+        {
+          if( added[i] )
+          {
+            cands[2 * cnt    ] = mf.mvField( neighbours[i], REF_PIC_LIST_0 );
+            cands[2 * cnt + 1] = mf.mvField( neighbours[i], REF_PIC_LIST_1 );
+            cnt++;
+          }
+        }
+      }
+    }
+  };
+
+  // boundary strength of all vertical and horizontal edges of the 4x4 blocks from the motion of both sides
+  motionCases[1].kernel = "BsMotion";
+  motionCases[1].layouts[0].run = [this, size]( BenchKernelSet& )
+  {
+    const CodingStructure& cs = *m_motionCs;
+
+    for( Int dir = 0; dir < 2; dir++ )
+    {
+      for( Int y = 4; y < size; y += 4 )
+      {
+        for( Int x = 4; x < size; x += 4 )
+        {
+          const MotionInfo& miQ = cs.getMotionInfo( Position( x, y ) );
+          const MotionInfo& miP = cs.getMotionInfo( dir == 0 ? Position( x - 1, y ) : Position( x, y - 1 ) );
+
+          const Int refP0 = 0 > miP.refIdx[0] ? 0 : g_benchRefPoc[0][miP.refIdx[0]];
+          const Int refP1 = 0 > miP.refIdx[1] ? 0 : g_benchRefPoc[1][miP.refIdx[1]];
+          const Int refQ0 = 0 > miQ.refIdx[0] ? 0 : g_benchRefPoc[0][miQ.refIdx[0]];
+          const Int refQ1 = 0 > miQ.refIdx[1] ? 0 : g_benchRefPoc[1][miQ.refIdx[1]];
+
+          m_bs[2 * ( ( y >> BENCH_MOTION_LOG2 ) * BENCH_MOTION_STRIDE + ( x >> BENCH_MOTION_LOG2 ) ) + dir] =
+            xBenchBs( refP0, refP1, refQ0, refQ1, 0 <= miP.refIdx[0] ? miP.mv[0] : Mv(), 0 <= miP.refIdx[1] ? miP.mv[1] : Mv(),
+                                                  0 <= miQ.refIdx[0] ? miQ.mv[0] : Mv(), 0 <= miQ.refIdx[1] ? miQ.mv[1] : Mv() );
+        }
+      }
+    }
+  };
+  motionCases[1].layouts[1].run = [this, size]( BenchKernelSet& )
+  {
+    const MotionField&    mf = m_motionCs->getBlockMotion();
+    MotionField::RowCache rowCacheQ, rowCacheP;
+
+    for( Int dir = 0; dir < 2; dir++ )
+    {
+      for( Int y = 4; y < size; y += 4 )
+      {
+        for( Int x = 4; x < size; x += 4 )
+        {
+          const UInt idxQ = rowCacheQ.idx( mf, x, y );
+          const UInt idxP = dir == 0 ? rowCacheP.idx( mf, x - 1, y ) : rowCacheP.idx( mf, x, y - 1 );
+
+          const Int refIdxP0 = mf.refIdx( idxP, REF_PIC_LIST_0 ), refIdxP1 = mf.refIdx( idxP, REF_PIC_LIST_1 );
+          const Int refIdxQ0 = mf.refIdx( idxQ, REF_PIC_LIST_0 ), refIdxQ1 = mf.refIdx( idxQ, REF_PIC_LIST_1 );
+
+          m_bs[2 * ( ( y >> BENCH_MOTION_LOG2 ) * BENCH_MOTION_STRIDE + ( x >> BENCH_MOTION_LOG2 ) ) + dir] =
+            xBenchBs( 0 > refIdxP0 ? 0 : g_benchRefPoc[0][refIdxP0], 0 > refIdxP1 ? 0 : g_benchRefPoc[1][refIdxP1],
+                      0 > refIdxQ0 ? 0 : g_benchRefPoc[0][refIdxQ0], 0 > refIdxQ1 ? 0 : g_benchRefPoc[1][refIdxQ1],
+                      0 <= refIdxP0 ? mf.mv( idxP, REF_PIC_LIST_0 ) : Mv(), 0 <= refIdxP1 ? mf.mv( idxP, REF_PIC_LIST_1 ) : Mv(),
+                      0 <= refIdxQ0 ? mf.mv( idxQ, REF_PIC_LIST_0 ) : Mv(), 0 <= refIdxQ1 ? mf.mv( idxQ, REF_PIC_LIST_1 ) : Mv() );
+        }
+      }
+    }
+  };
+
+  static const char* const layoutNames[2] = { "AoS", "SoA" };
+
+  Int numMismatches = 0;
+
+  for( MotionCase& motionCase : motionCases )
+  {
+    if( !m_kernelFilter.empty() && motionCase.kernel.find( m_kernelFilter ) == std::string::npos )
+    {
+      continue;
+    }
+
+    UInt64 refDigest = 0;
+    Double refTime   = 0;
+
+    for( Int layout = 0; layout < 2; layout++ )
+    {
+      BenchCase& benchCase = motionCase.layouts[layout];
+      benchCase.kernel = motionCase.kernel;
+      benchCase.width  = size;
+      benchCase.height = size;
+      benchCase.reset  = reset;
+      benchCase.digest = digest;
+
+      benchCase.reset();
+      benchCase.run( *m_kernelSets[0] );
+      const UInt64 layoutDigest = benchCase.digest();
+
+      BenchResult result;
+      result.kernel    = benchCase.kernel;
+      result.width     = size;
+      result.height    = size;
+      result.bitDepth  = 0;
+      result.vext      = SCALAR;
+      result.layout    = layoutNames[layout];
+      result.nsPerCall = xTime( benchCase, *m_kernelSets[0] );
+
+      if( layout == 0 )
+      {
+        refDigest = layoutDigest;
+        refTime   = result.nsPerCall;
+      }
+      result.speedup  = refTime / result.nsPerCall;
+      result.bitExact = layoutDigest == refDigest;
+
+      if( !result.bitExact )
+      {
+        numMismatches++;
+      }
+
+      xPrintResult( result );
+      m_results.push_back( result );
+    }
+  }
+
+  return numMismatches;
+}
+
+// ====================================================================================================================
+// Measurement
+// ====================================================================================================================
+
+Double NextBench::xTime( BenchCase& benchCase, BenchKernelSet& kernelSet )
+{
+  typedef std::chrono::steady_clock clock;
+
+  benchCase.reset();
+  benchCase.run( kernelSet ); // warm up
+
+  // double the number of calls until the minimum measurement time is reached
+  for( Int64 numCalls = 1; ; numCalls <<= 1 )
+  {
+    const clock::time_point start = clock::now();
+    for( Int64 i = 0; i < numCalls; i++ )
+    {
+      benchCase.run( kernelSet );
+    }
+    const Double elapsed = std::chrono::duration<Double, std::nano>( clock::now() - start ).count();
+
+    if( elapsed >= m_minTime * 1e6 || numCalls >= ( Int64( 1 ) << 40 ) )
+    {
+      return elapsed / Double( numCalls );
+    }
+  }
+}
+
+Void NextBench::xPrintResult( const BenchResult& result ) const
+{
+  if( !result.layout.empty() )
+  {
+    msg( INFO, "%-18s %2dx%-2d motion  %-6s %10.1f ns  %6.2fx  %s\n", result.kernel.c_str(), result.width, result.height,
+         result.layout.c_str(), result.nsPerCall, result.speedup, result.bitExact ? "ok" : "MISMATCH" );
+    return;
+  }
+
+  msg( INFO, "%-18s %2dx%-2d %2d bit  %-6s %10.1f ns  %6.2fx  %s\n", result.kernel.c_str(), result.width, result.height, result.bitDepth,
+       g_vextNames[result.vext], result.nsPerCall, result.speedup, result.bitExact ? "ok" : "MISMATCH" );
+}
+
+Void NextBench::xWriteJson( std::ostream& os ) const
+{
+  os << "[\n";
+  for( size_t i = 0; i < m_results.size(); i++ )
+  {
+    const BenchResult& r = m_results[i];
+    os << "  { \"kernel\": \"" << r.kernel << "\", \"width\": " << r.width << ", \"height\": " << r.height;
+    if( r.layout.empty() )
+    {
+      os << ", \"bitDepth\": " << r.bitDepth << ", \"isa\": \"" << g_vextNames[r.vext] << "\"";
+    }
+    else
+    {
+      os << ", \"layout\": \"" << r.layout << "\"";
+    }
+    os << ", \"nsPerCall\": " << r.nsPerCall
+       << ", \"speedup\": " << r.speedup << ", \"bitExact\": " << ( r.bitExact ? "true" : "false" ) << " }"
+       << ( i + 1 < m_results.size() ? ",\n" : "\n" );
+  }
+  os << "]\n";
+}
+
+Int NextBench::run()
+{
+  // select the C kernels in all constructors, the SIMD kernels are set up explicitly per extension level
+  read_x86_extension_flags( "SCALAR" );
+
+  X86_VEXT maxVext = _get_x86_extensions();
+  if( !m_simd.empty() )
+  {
+    X86_VEXT simd  = maxVext;
+    Bool     found = false;
+    for( Int i = SCALAR; i <= AVX512; i++ )
+    {
+      if( m_simd == g_vextNames[i] )
+      {
+        simd  = X86_VEXT( i );
+        found = true;
+      }
+    }
+    if( !found )
+    {
+      msg( ERROR, "Unsupported SIMD extension %s\n", m_simd.c_str() );
+      return 1;
+    }
+    maxVext = std::min( maxVext, simd );
+  }
+
+  BilateralFilter::instance()->createdivToMulLUTs();
+  BilateralFilter::instance()->createBilateralFilterTable( BENCH_BIF_QP );
+
+  // SSE42 and AVX512 have no kernels of their own
+  static const X86_VEXT levels[] = { SCALAR, SSE41, AVX, AVX2 };
+  for( X86_VEXT vext : levels )
+  {
+    if( vext <= maxVext )
+    {
+      m_kernelSets.push_back( new BenchKernelSet );
+      m_kernelSets.back()->init( vext );
+    }
+  }
+
+  Int numMismatches = 0;
+
+  for( Int bitDepth = 8; bitDepth <= 12; bitDepth += 2 )
+  {
+    if( m_bitDepth != 0 && bitDepth != m_bitDepth )
+    {
+      continue;
+    }
+
+    xInitData( bitDepth );
+
+    m_cases.clear();
+    xAddDistortionCases();
+    xAddInterpolationCases();
+    xAddBufferCases();
+    xAddIntraCases();
+    xAddLMCases();
+    xAddLoopFilterCases();
+    xAddSaoCases();
+    xAddBilateralCases();
+    xAddAlfCases();
+
+    for( BenchCase& benchCase : m_cases )
+    {
+      UInt64 refDigest = 0;
+      Double refTime   = 0;
+
+      for( BenchKernelSet* kernelSet : m_kernelSets )
+      {
+        benchCase.reset();
+        benchCase.run( *kernelSet );
+        const UInt64 digest = benchCase.digest();
+
+        BenchResult result;
+        result.kernel    = benchCase.kernel;
+        result.width     = benchCase.width;
+        result.height    = benchCase.height;
+        result.bitDepth  = bitDepth;
+        result.vext      = kernelSet->vext;
+        result.nsPerCall = xTime( benchCase, *kernelSet );
+
+        if( kernelSet->vext == SCALAR )
+        {
+          refDigest = digest;
+          refTime   = result.nsPerCall;
+        }
+        result.speedup  = refTime / result.nsPerCall;
+        result.bitExact = digest == refDigest;
+
+        if( !result.bitExact )
+        {
+          numMismatches++;
+        }
+
+        xPrintResult( result );
+        m_results.push_back( result );
+      }
+    }
+  }
+
+  // the motion access does not depend on the bit depth or the extension level
+  xInitMotion();
+  numMismatches += xRunMotionCases();
+
+  if( !m_jsonFileName.empty() )
+  {
+    if( m_jsonFileName == "-" )
+    {
+      xWriteJson( std::cout );
+    }
+    else
+    {
+      std::ofstream os( m_jsonFileName );
+      if( !os )
+      {
+        msg( ERROR, "Cannot open %s\n", m_jsonFileName.c_str() );
+        return numMismatches + 1;
+      }
+      xWriteJson( os );
+    }
+  }
+
+  msg( INFO, "\n%d kernel results, %d bit exactness mismatches\n", Int( m_results.size() ), numMismatches );
+
+  return numMismatches;
+}
+
+#endif
+
+//! \}
@@ -0,0 +1,191 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     NextBench.h
+    \brief    kernel micro benchmark (header)
+*/
+
+#ifndef __NEXTBENCH__
+#define __NEXTBENCH__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "CommonLib/CommonDef.h"
+#include "CommonLib/RdCost.h"
+#include "CommonLib/InterpolationFilter.h"
+#include "CommonLib/IntraPrediction.h"
+#include "CommonLib/LoopFilter.h"
+#include "CommonLib/SampleAdaptiveOffset.h"
+#include "CommonLib/BilateralFilter.h"
+#include "CommonLib/AdaptiveLoopFilter.h"
+#include "CommonLib/Buffer.h"
+#include "CommonLib/CodingStructure.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+
+//! \ingroup NextBench
+//! \{
+
+#if HHI_SIMD_OPT && defined( TARGET_SIMD_X86 )
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// the dispatched kernels of one instruction set extension level
+struct BenchKernelSet
+{
+  X86_VEXT             vext;
+  FpDistFunc           distFunc[DF_TOTAL_FUNCTIONS];
+  FpDistFuncX4         distFuncX4[DF_TOTAL_FUNCTIONS];
+  InterpolationFilter  interpolationFilter;
+  PelBufferOps         pelBufOps;
+  IntraPrediction      intraPrediction;
+  LoopFilter           loopFilter;
+  SampleAdaptiveOffset sampleAdaptiveOffset;
+  AdaptiveLoopFilter   adaptiveLoopFilter;
+  void ( *smoothBlock )( short block[], int width, int height, int centerWeight, const UShort* lookupTable, int maxPos, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift );
+
+  Void init( X86_VEXT _vext );
+};
+
+/// one benchmarked kernel call
+struct BenchCase
+{
+  std::string                             kernel;
+  Int                                     width;
+  Int                                     height;
+  std::function<Void( BenchKernelSet& )>  run;      ///< calls the kernel once
+  std::function<Void()>                   reset;    ///< restores the input of in place kernels and clears the output
+  std::function<UInt64()>                 digest;   ///< hash of the kernel output, used for the bit exactness check
+};
+
+/// result of one kernel at one extension level
+struct BenchResult
+{
+  std::string kernel;
+  Int         width;
+  Int         height;
+  Int         bitDepth;
+  X86_VEXT    vext;
+  Double      nsPerCall;
+  Double      speedup;
+  Bool        bitExact;
+  std::string layout;    ///< motion storage layout of the motion access benchmarks, empty for the kernels
+};
+
+/// kernel micro benchmark class
+class NextBench
+{
+public:
+  NextBench();
+  ~NextBench();
+
+  Bool parseCfg ( Int argc, TChar* argv[] );  ///< parse the command line
+  Int  run      ();                           ///< runs all benchmarks, returns the number of bit exactness mismatches
+
+private:
+  // configuration
+  std::string               m_simd;           ///< highest extension to benchmark
+  Int                       m_bitDepth;       ///< bit depth to benchmark, 0: all supported bit depths
+  std::string               m_kernelFilter;   ///< only benchmark kernels whose name contains this string
+  Double                    m_minTime;        ///< minimum measurement time per kernel and extension [ms]
+  std::string               m_jsonFileName;   ///< result file, "-" for stdout
+
+  // kernels of the benchmarked extension levels, the first one is the scalar reference
+  std::vector<BenchKernelSet*> m_kernelSets;
+  std::vector<BenchCase>       m_cases;
+  std::vector<BenchResult>     m_results;
+
+  // test data
+  Int                       m_curBitDepth;
+  ClpRng                    m_clpRng;
+  std::vector<Pel>          m_src;            ///< smooth picture content
+  std::vector<Pel>          m_org;            ///< source with noise added
+  std::vector<Pel>          m_inter;          ///< source at the intermediate (high precision) sample precision
+  std::vector<Pel>          m_interOrg;       ///< noisy source at the intermediate sample precision
+  std::vector<Pel>          m_dst;            ///< kernel output
+  std::vector<Int>          m_intSrc;         ///< source samples as Int, input of the CCLM class sums and the ALF statistics
+  std::vector<Int>          m_intOrg;
+  std::vector<Int>          m_intTag;         ///< CCLM class of the samples
+  Distortion                m_dist;           ///< kernel output of the distortion kernels
+  Int64                     m_saoDiff [NUM_SAO_BO_CLASSES];  ///< kernel output of the SAO statistics kernels
+  Int64                     m_saoCount[NUM_SAO_BO_CLASSES];
+  std::vector<Int64>        m_alfE;           ///< kernel output of the ALF statistics kernel
+  std::vector<Int64>        m_alfY;
+
+  // motion test data, a coding structure of one CTU with the MotionInfo buffer and the block motion field filled
+  XUCache                   m_unitCache;
+  CodingStructure*          m_motionCs;
+  std::vector<MvField>      m_mergeCands;     ///< output of the merge candidate benchmark
+  std::vector<UChar>        m_bs;             ///< output of the boundary strength benchmark
+
+  Pel*  xSrc  ( Int x = 0, Int y = 0 )        { return &m_src  [xOffset( x, y )]; }
+  Pel*  xOrg  ( Int x = 0, Int y = 0 )        { return &m_org  [xOffset( x, y )]; }
+  Pel*  xInter( Int x = 0, Int y = 0 )        { return &m_inter[xOffset( x, y )]; }
+  Pel*  xInterOrg( Int x = 0, Int y = 0 )     { return &m_interOrg[xOffset( x, y )]; }
+  Pel*  xDst  ( Int x = 0, Int y = 0 )        { return &m_dst  [xOffset( x, y )]; }
+  Int   xOffset( Int x, Int y ) const;
+
+  Void  xInitData         ( Int bitDepth );
+  Void   xResetDst        ();
+  UInt64 xDigestDst       ( Int width, Int height );
+  Void   xAddCase         ( const std::string& kernel, Int width, Int height, std::function<Void( BenchKernelSet& )> run );
+
+  Void  xAddDistortionCases  ();
+  Void  xAddInterpolationCases();
+  Void  xAddBufferCases      ();
+  Void  xAddIntraCases       ();
+  Void  xAddLMCases          ();
+  Void  xAddLoopFilterCases  ();
+  Void  xAddSaoCases         ();
+  Void  xAddBilateralCases   ();
+  Void  xAddAlfCases         ();
+
+  Void  xInitMotion          ();
+  Int   xRunMotionCases      ();
+
+  Double xTime            ( BenchCase& benchCase, BenchKernelSet& kernelSet );
+  Void   xPrintResult     ( const BenchResult& result ) const;
+  Void   xWriteJson       ( std::ostream& os ) const;
+};
+
+#endif
+
+//! \}
+
+#endif // __NEXTBENCH__
@@ -38,6 +38,7 @@
 #include "AdaptiveLoopFilter.h"
 
 #include "UnitTools.h"
+#include "Profiler.h"
 
 #include "dtrace_next.h"
 
@@ -957,6 +958,28 @@ AdaptiveLoopFilter::AdaptiveLoopFilter()
   m_isGALF        = false;
   m_wasCreated    = false;
   m_isDec           = true;
+
+  m_accumulateCovariance = xAccumulateCovariance;
+
+#if HHI_SIMD_OPT_ALF
+#ifdef TARGET_SIMD_X86
+  initAdaptiveLoopFilterX86();
+#endif
+#endif
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void AdaptiveLoopFilter::xAccumulateCovariance( const Int* ELocal, Int yLocal, Int sqrFiltLength, Int64* E, Int64* y )
+{
+  for( Int k = 0; k < sqrFiltLength; k++ )
+  {
+    Int64* pE = E + k * m_MAX_SQR_FILT_LENGTH;
+    for( Int l = k; l < sqrFiltLength; l++ )
+    {
+      pE[l] += ELocal[k] * ELocal[l];
+    }
+    y[k] += ELocal[k] * yLocal;
+  }
 }
 
 Void AdaptiveLoopFilter:: xError(const char *text, int code)
@@ -1525,6 +1548,8 @@ Void AdaptiveLoopFilter::resetALFParam(ALFParam* pDesAlfParam)
 */
 Void AdaptiveLoopFilter::ALFProcess( CodingStructure& cs, ALFParam* pcAlfParam )
 {
+  PROFILE_SCOPE( PROF_ALF );
+
   if(!pcAlfParam->alf_flag)
   {
     return;
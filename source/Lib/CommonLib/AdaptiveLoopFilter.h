@@ -273,6 +273,18 @@ public:
   static Int ALFTapHToTapV     ( Int tapH );
   static Int ALFTapHToNumCoeff ( Int tapH );
   static Int ALFFlHToFlV       ( Int flH  );
+
+  // accumulation of the autocorrelation (upper triangle, row stride m_MAX_SQR_FILT_LENGTH) and cross-correlation of one sample
+  // for the encoder statistics (C reference implementation, replaced by SIMD versions where available)
+  static Void xAccumulateCovariance( const Int* ELocal, Int yLocal, Int sqrFiltLength, Int64* E, Int64* y );
+
+  Void ( *m_accumulateCovariance ) ( const Int* ELocal, Int yLocal, Int sqrFiltLength, Int64* E, Int64* y );
+
+#ifdef TARGET_SIMD_X86
+  Void initAdaptiveLoopFilterX86();
+  template <X86_VEXT vext>
+  Void _initAdaptiveLoopFilterX86();
+#endif
 };
 #endif
 
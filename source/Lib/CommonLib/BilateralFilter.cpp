@@ -51,17 +51,26 @@ BilateralFilter::BilateralFilter()
   m_bilateralFilterTable = new UShort*[numQP];
   for(int i = 0; i < numQP; i++)
   {
-    m_bilateralFilterTable[i] = new UShort[maxPosList[i]+1];
+    // padded to a multiple of 16 entries for the SIMD table lookup
+    m_bilateralFilterTable[i] = new UShort[( maxPosList[i] + 16 ) & ~15];
   }
 
   // initialization
   for(int i = 0; i < numQP; i++)
   {
-    for(int k = 0; k < (maxPosList[i]+1); k++)
+    for(int k = 0; k < ( ( maxPosList[i] + 16 ) & ~15 ); k++)
     {
       m_bilateralFilterTable[i][k] = 0;
     }
   }
+
+  m_smoothBlock = xSmoothBlock;
+
+#if HHI_SIMD_OPT_BIF
+#ifdef TARGET_SIMD_X86
+  initBilateralFilterX86();
+#endif
+#endif
 }
 
 BilateralFilter::~BilateralFilter()
@@ -143,14 +152,8 @@ void BilateralFilter::createBilateralFilterTable(int qp)
 void BilateralFilter::smoothBlockBilateralFilter(unsigned uiWidth, unsigned uiHeight, short block[], int isInterBlock, int qp)
 {
   Int length = (Int)std::min(uiWidth, uiHeight);
-  Int rightPixel, centerPixel;
-  Int rightWeight, bottomWeight, centerWeight;
-  Int sumWeights[MAX_CU_SIZE];
-  Int sumDelta[MAX_CU_SIZE];
   Int blockLengthIndex;
-  
-  Int dIB, dIR;
-    
+
   switch (length)
   {
     case 4:
@@ -163,13 +166,19 @@ void BilateralFilter::smoothBlockBilateralFilter(unsigned uiWidth, unsigned uiHe
       blockLengthIndex = 2;
       break;
   }
-  
-  UShort *lookupTablePtr;
-  
-  centerWeight = m_bilateralCenterWeightTable[blockLengthIndex + 3 * isInterBlock];
-  
-  Int theMaxPos = maxPosList[qp-18];
-  lookupTablePtr = m_bilateralFilterTable[qp-18];
+
+  m_smoothBlock( block, uiWidth, uiHeight, m_bilateralCenterWeightTable[blockLengthIndex + 3 * isInterBlock], m_bilateralFilterTable[qp-18], maxPosList[qp-18], divToMulOneOverN, divToMulShift );
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+void BilateralFilter::xSmoothBlock( short block[], int uiWidth, int uiHeight, int centerWeight, const UShort* lookupTablePtr, int theMaxPos, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift )
+{
+  Int rightPixel, centerPixel;
+  Int rightWeight, bottomWeight;
+  Int sumWeights[MAX_CU_SIZE];
+  Int sumDelta[MAX_CU_SIZE];
+
+  Int dIB, dIR;
 
   // for each pixel in block
   
@@ -64,6 +64,18 @@ public:
   void createBilateralFilterTable(int qp);
   void bilateralFilterInter(PelBuf& resiBuf, const CPelBuf& predBuf, int qp, const ClpRng& clpRng);
   void bilateralFilterIntra(PelBuf& recoBuf, int qp);
+
+  // filter kernel (C reference implementation, replaced by a SIMD version where available), the block is filtered in place,
+  // the lookup table is zero padded to a multiple of 16 entries
+  static void xSmoothBlock( short block[], int width, int height, int centerWeight, const UShort* lookupTable, int maxPos, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift );
+
+  void ( *m_smoothBlock )( short block[], int width, int height, int centerWeight, const UShort* lookupTable, int maxPos, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift );
+
+#ifdef TARGET_SIMD_X86
+  void initBilateralFilterX86();
+  template <X86_VEXT vext>
+  void _initBilateralFilterX86();
+#endif
 };
 
 #endif /* BILATERALFILTER_H */
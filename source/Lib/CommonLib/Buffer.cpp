@@ -93,6 +93,77 @@ void linTfCore( const T* src, int srcStride, Pel *dst, int dstStride, int width,
 #undef LINTF_CORE_INC
 }
 
+void packLowBytesCore( const Pel* src, UChar* dst, int num )
+{
+  for( int i = 0; i < num; i++ )
+  {
+    dst[i] = UChar( src[i] );
+  }
+}
+
+void sumAndSqrCore( const Pel* src, int srcStride, int width, int height, UInt64& sum, UInt64& sumSqr )
+{
+  sum    = 0;
+  sumSqr = 0;
+
+  for( int y = 0; y < height; y++ )
+  {
+    for( int x = 0; x < width; x++ )
+    {
+      sum    += src[x];
+      sumSqr += src[x] * src[x];
+    }
+    src += srcStride;
+  }
+}
+
+void histogramCore( const Pel* src, int srcStride, int width, int height, int* hist, int numBins )
+{
+  for( int y = 0; y < height; y++ )
+  {
+    for( int x = 0; x < width; x++ )
+    {
+      hist[Clip3( 0, numBins - 1, Int( src[x] ) )]++;
+    }
+    src += srcStride;
+  }
+}
+
+Int64 sadWeightedCore( const Pel* org, int orgStride, const Pel* ref, int refStride, int width, int height, int orgShift, int weight, int offset )
+{
+  Int64 sad = 0;
+
+  for( int y = 0; y < height; y++ )
+  {
+    for( int x = 0; x < width; x++ )
+    {
+      sad += abs( ( Int( org[x] ) << orgShift ) - ( ref[x] * weight + offset ) );
+    }
+    org += orgStride;
+    ref += refStride;
+  }
+
+  return sad;
+}
+
+Int64 sadWeightedClipCore( const Pel* org, int orgStride, const Pel* ref, int refStride, int width, int height, int shift, int weight, int offset, int maxVal )
+{
+  const int round = shift == 0 ? 0 : 1 << ( shift - 1 );
+  Int64 sad = 0;
+
+  for( int y = 0; y < height; y++ )
+  {
+    for( int x = 0; x < width; x++ )
+    {
+      sad += abs( org[x] - Clip3( 0, maxVal, ( ( ref[x] * weight + round ) >> shift ) + offset ) );
+    }
+    org += orgStride;
+    ref += refStride;
+  }
+
+  return sad;
+}
+
 PelBufferOps::PelBufferOps()
 {
   addAvg4 = addAvgCore<Pel>;
@@ -103,6 +174,15 @@ PelBufferOps::PelBufferOps()
 
   linTf4 = linTfCore<Pel>;
   linTf8 = linTfCore<Pel>;
+
+  packLowBytes = packLowBytesCore;
+
+  sse = sseCore;
+
+  sumAndSqr       = sumAndSqrCore;
+  histogram       = histogramCore;
+  sadWeighted     = sadWeightedCore;
+  sadWeightedClip = sadWeightedClipCore;
 }
 
 PelBufferOps g_pelBufOP = PelBufferOps();
@@ -110,6 +190,24 @@ PelBufferOps g_pelBufOP = PelBufferOps();
 #endif
 #endif
 
+UInt64 sseCore( const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, int width, int height )
+{
+  UInt64 sum = 0;
+
+  for( int y = 0; y < height; y++ )
+  {
+    for( int x = 0; x < width; x++ )
+    {
+      const Int diff = src0[x] - src1[x];
+      sum += UInt64( diff * diff );
+    }
+    src0 += src0Stride;
+    src1 += src1Stride;
+  }
+
+  return sum;
+}
+
 template<>
 Void AreaBuf<Pel>::addAvg( const AreaBuf<const Pel> &other1, const AreaBuf<const Pel> &other2, const ClpRng& clpRng)
 {
@@ -421,6 +519,23 @@ void PelStorage::swap( PelStorage& other )
   }
 }
 
+void PelStorage::takeOver( PelStorage& other )
+{
+  CHECK( !bufs.empty(), "Trying to take over into an already initialized buffer" );
+
+  chromaFormat = other.chromaFormat;
+  bufs         = other.bufs;
+
+  for( UInt i = 0; i < MAX_NUM_COMPONENT; i++ )
+  {
+    m_origin[i]       = other.m_origin[i];
+    other.m_origin[i] = nullptr;
+  }
+
+  other.chromaFormat = NUM_CHROMA_FORMAT;
+  other.bufs.clear();
+}
+
 void PelStorage::destroy()
 {
   chromaFormat = NUM_CHROMA_FORMAT;
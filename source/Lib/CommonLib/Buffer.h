@@ -68,6 +68,12 @@ struct PelBufferOps
   void ( *reco8 )         ( const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, Pel *dst, int dstStride, int width, int height, const ClpRng& clpRng );
   void ( *linTf4 )        ( const Pel* src0, int src0Stride,                                  Pel *dst, int dstStride, int width, int height, int scale, int shift, int offset, const ClpRng& clpRng, bool bClip );
   void ( *linTf8 )        ( const Pel* src0, int src0Stride,                                  Pel *dst, int dstStride, int width, int height, int scale, int shift, int offset, const ClpRng& clpRng, bool bClip );
+  void ( *packLowBytes )  ( const Pel* src, UChar* dst, int num );                            ///< stores the low byte of each sample, e.g. for hashing 8 bit pictures
+  UInt64 ( *sse )         ( const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, int width, int height ); ///< sum of squared differences of two pictures
+  void ( *sumAndSqr )     ( const Pel* src, int srcStride, int width, int height, UInt64& sum, UInt64& sumSqr );    ///< sum and sum of squares of the samples of a block
+  void ( *histogram )     ( const Pel* src, int srcStride, int width, int height, int* hist, int numBins );         ///< adds the samples, clipped to the bins, to a histogram
+  Int64 ( *sadWeighted )  ( const Pel* org, int orgStride, const Pel* ref, int refStride, int width, int height, int orgShift, int weight, int offset ); ///< sum of |(org << orgShift) - (ref * weight + offset)|, the terms must fit in 32 bit
+  Int64 ( *sadWeightedClip )( const Pel* org, int orgStride, const Pel* ref, int refStride, int width, int height, int shift, int weight, int offset, int maxVal ); ///< sum of |org - clip(0, maxVal, ((ref * weight + round) >> shift) + offset)|, the terms must fit in 32 bit
 };
 
 extern PelBufferOps g_pelBufOP;
@@ -75,6 +81,8 @@ extern PelBufferOps g_pelBufOP;
 #endif
 #endif
 
+UInt64 sseCore( const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, int width, int height ); ///< sum of squared differences of two sample arrays, C version of g_pelBufOP.sse
+
 template<typename T>
 struct AreaBuf : public Size
 {
@@ -760,6 +768,7 @@ struct PelStorage : public PelUnitBuf
   ~PelStorage();
 
   void swap( PelStorage& other );
+  void takeOver( PelStorage& other );
   void createFromBuf( PelUnitBuf buf );
   void create( const UnitArea &_unit );
   void create( const ChromaFormat &_chromaFormat, const Area& _area, const unsigned _maxCUSize = 0, const unsigned _margin = 0, const unsigned _alignment = 0, const bool _scaleChromaMargin = true );
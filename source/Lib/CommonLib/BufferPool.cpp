@@ -0,0 +1,270 @@
+/* The copyright in this software is being made available under the BSD
+* License, included below. This software may be subject to other third party
+* and contributor rights, including patent rights, and no such rights are
+* granted under this license.
+*
+* Copyright (c) 2010-2017, ITU/ISO/IEC
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*  * Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following disclaimer.
+*  * Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+* THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/** \file     BufferPool.cpp
+ *  \brief    Pool recycling picture sized buffers across pictures
+ */
+
+#include "BufferPool.h"
+#include "ChromaFormat.h"
+
+#include <algorithm>
+#include <iterator>
+
+Bool BufferPool::PelStorageKey::operator<( const PelStorageKey& other ) const
+{
+  if( chromaFormat != other.chromaFormat ) return chromaFormat < other.chromaFormat;
+  if( width        != other.width        ) return width        < other.width;
+  if( height       != other.height       ) return height       < other.height;
+  if( maxCUSize    != other.maxCUSize    ) return maxCUSize    < other.maxCUSize;
+  return margin < other.margin;
+}
+
+BufferPool::BufferPool()
+  : m_bytesInUse    ( 0 )
+  , m_bytesCached   ( 0 )
+  , m_peakBytesInUse( 0 )
+  , m_peakBytesHeld ( 0 )
+  , m_numRequests   ( 0 )
+  , m_numReused     ( 0 )
+{
+}
+
+BufferPool::~BufferPool()
+{
+  clear();
+}
+
+Void BufferPool::createPelStorage( PelStorage& buf, const ChromaFormat chromaFormat, const Area& area, const unsigned maxCUSize, const unsigned margin )
+{
+  const PelStorageKey key = { chromaFormat, area.width, area.height, maxCUSize, margin };
+  PelStorage*         stored = nullptr;
+
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  m_numRequests++;
+
+  auto cached = m_freeStorages.find( key );
+  if( cached != m_freeStorages.end() && !cached->second.items.empty() )
+  {
+    FreeList<PelStorage*>& list = cached->second;
+    stored = list.items.back();
+    list.items.pop_back();
+    list.numIdle = std::min( list.numIdle, list.items.size() );
+    m_numReused++;
+  }
+
+  if( stored )
+  {
+    buf.takeOver( *stored );
+    delete stored;
+    m_bytesCached -= xGetSize( key );
+  }
+  else
+  {
+    buf.create( chromaFormat, area, maxCUSize, margin );
+  }
+
+  m_usedStorages[&buf] = key;
+  m_bytesInUse        += xGetSize( key );
+  xUpdatePeaks();
+}
+
+Void BufferPool::destroyPelStorage( PelStorage& buf )
+{
+  if( buf.bufs.empty() )
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  auto used = m_usedStorages.find( &buf );
+  if( used == m_usedStorages.end() )
+  {
+    // not handed out by the pool
+    buf.destroy();
+    return;
+  }
+
+  const PelStorageKey key  = used->second;
+  const size_t        size = xGetSize( key );
+  m_usedStorages.erase( used );
+
+  PelStorage* stored = new PelStorage;
+  stored->takeOver( buf );
+  m_freeStorages[key].items.push_back( stored );
+
+  m_bytesInUse  -= size;
+  m_bytesCached += size;
+}
+
+Void* BufferPool::xAllocate( const size_t size )
+{
+  if( size == 0 )
+  {
+    return nullptr;
+  }
+
+  Void* ptr = nullptr;
+
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  m_numRequests++;
+
+  auto cached = m_freeBlocks.find( size );
+  if( cached != m_freeBlocks.end() && !cached->second.items.empty() )
+  {
+    FreeList<Void*>& list = cached->second;
+    ptr = list.items.back();
+    list.items.pop_back();
+    list.numIdle = std::min( list.numIdle, list.items.size() );
+    m_bytesCached -= size;
+    m_numReused++;
+  }
+  else
+  {
+    ptr = xMalloc( char, size );
+  }
+
+  m_bytesInUse += size;
+  xUpdatePeaks();
+
+  return ptr;
+}
+
+Void BufferPool::xRelease( Void* ptr, const size_t size )
+{
+  if( !ptr )
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  m_freeBlocks[size].items.push_back( ptr );
+  m_bytesInUse  -= size;
+  m_bytesCached += size;
+}
+
+Void BufferPool::clear()
+{
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  for( auto& cached : m_freeBlocks )
+  {
+    for( Void* ptr : cached.second.items )
+    {
+      xFree( ptr );
+    }
+  }
+  m_freeBlocks.clear();
+
+  for( auto& cached : m_freeStorages )
+  {
+    for( PelStorage* stored : cached.second.items )
+    {
+      stored->destroy();
+      delete stored;
+    }
+  }
+  m_freeStorages.clear();
+
+  m_bytesCached = 0;
+}
+
+Void BufferPool::trim()
+{
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  // the items at the front of a list are handed out last, so the idle ones are freed from the front
+  for( auto cached = m_freeBlocks.begin(); cached != m_freeBlocks.end(); )
+  {
+    FreeList<Void*>& list = cached->second;
+    for( size_t i = 0; i < list.numIdle; i++ )
+    {
+      xFree( list.items[i] );
+    }
+    m_bytesCached -= list.numIdle * cached->first;
+    list.items.erase( list.items.begin(), list.items.begin() + list.numIdle );
+    list.numIdle = list.items.size();
+
+    cached = list.items.empty() ? m_freeBlocks.erase( cached ) : std::next( cached );
+  }
+
+  for( auto cached = m_freeStorages.begin(); cached != m_freeStorages.end(); )
+  {
+    FreeList<PelStorage*>& list = cached->second;
+    for( size_t i = 0; i < list.numIdle; i++ )
+    {
+      list.items[i]->destroy();
+      delete list.items[i];
+    }
+    m_bytesCached -= list.numIdle * xGetSize( cached->first );
+    list.items.erase( list.items.begin(), list.items.begin() + list.numIdle );
+    list.numIdle = list.items.size();
+
+    cached = list.items.empty() ? m_freeStorages.erase( cached ) : std::next( cached );
+  }
+}
+
+Void BufferPool::printStats( const MsgLevel msgl ) const
+{
+  std::lock_guard<std::mutex> lock( m_mutex );
+
+  msg( msgl, "\nBuffer pool: %llu requests, %llu served from the pool, peak %.1f MB in use, peak %.1f MB allocated\n",
+       ( unsigned long long ) m_numRequests, ( unsigned long long ) m_numReused, m_peakBytesInUse / 1048576.0, m_peakBytesHeld / 1048576.0 );
+}
+
+Void BufferPool::xUpdatePeaks()
+{
+  m_peakBytesInUse = std::max( m_peakBytesInUse, m_bytesInUse );
+  m_peakBytesHeld  = std::max( m_peakBytesHeld,  m_bytesInUse + m_bytesCached );
+}
+
+size_t BufferPool::xGetSize( const PelStorageKey& key )
+{
+  // same geometry as PelStorage::create
+  const UInt extWidth  = key.maxCUSize ? ( ( key.width  + key.maxCUSize - 1 ) / key.maxCUSize ) * key.maxCUSize : key.width;
+  const UInt extHeight = key.maxCUSize ? ( ( key.height + key.maxCUSize - 1 ) / key.maxCUSize ) * key.maxCUSize : key.height;
+  size_t     size      = 0;
+
+  for( UInt i = 0; i < getNumberValidComponents( key.chromaFormat ); i++ )
+  {
+    const UInt scaleX = getComponentScaleX( ComponentID( i ), key.chromaFormat );
+    const UInt scaleY = getComponentScaleY( ComponentID( i ), key.chromaFormat );
+    size += sizeof( Pel ) * ( ( extWidth >> scaleX ) + 2 * ( key.margin >> scaleX ) ) * ( ( extHeight >> scaleY ) + 2 * ( key.margin >> scaleY ) );
+  }
+
+  return size;
+}
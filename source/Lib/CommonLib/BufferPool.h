@@ -0,0 +1,113 @@
+/* The copyright in this software is being made available under the BSD
+* License, included below. This software may be subject to other third party
+* and contributor rights, including patent rights, and no such rights are
+* granted under this license.
+*
+* Copyright (c) 2010-2017, ITU/ISO/IEC
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*  * Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following disclaimer.
+*  * Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+* THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/** \file     BufferPool.h
+ *  \brief    Pool recycling picture sized buffers across pictures
+ */
+
+#ifndef __BUFFERPOOL__
+#define __BUFFERPOOL__
+
+#include "CommonDef.h"
+#include "Unit.h"
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+/// Pool of the per-picture temporary buffers (prediction/residual planes, coefficient and PCM arrays).
+/// Released buffers are kept and handed out again for a request of the same geometry, so decoding a picture does
+/// not allocate and free them again. The pool is thread safe and can be shared by several decoder instances, it has
+/// to outlive the pictures holding its buffers. trim() frees the cached buffers not handed out since the last call.
+class BufferPool
+{
+public:
+  BufferPool();
+  ~BufferPool();
+
+  Void      createPelStorage  ( PelStorage& buf, const ChromaFormat chromaFormat, const Area& area, const unsigned maxCUSize = 0, const unsigned margin = 0 );
+  Void      destroyPelStorage ( PelStorage& buf );
+
+  template<typename T>
+  T*        allocate          ( const size_t len )              { return ( T* ) xAllocate( sizeof( T ) * len ); }
+  template<typename T>
+  Void      release           ( T* ptr, const size_t len )      { xRelease( ptr, sizeof( T ) * len ); }
+
+  Void      clear             ();                               ///< free the cached buffers, buffers in use are not affected
+  Void      trim              ();                               ///< free the cached buffers that stayed unused since the last trim()
+  Void      printStats        ( const MsgLevel msgl ) const;
+
+  size_t    getBytesInUse     () const                          { return m_bytesInUse; }
+  size_t    getPeakBytesInUse () const                          { return m_peakBytesInUse; }
+  size_t    getPeakBytesHeld  () const                          { return m_peakBytesHeld; }
+
+private:
+  struct PelStorageKey
+  {
+    ChromaFormat  chromaFormat;
+    UInt          width;
+    UInt          height;
+    UInt          maxCUSize;
+    UInt          margin;
+
+    Bool operator<( const PelStorageKey& other ) const;
+  };
+
+  template<typename T>
+  struct FreeList
+  {
+    std::vector<T>  items;
+    size_t          numIdle;                                    ///< smallest length since the last trim(), that many items were not used
+
+    FreeList() : numIdle( 0 ) {}
+  };
+
+  Void*     xAllocate         ( const size_t size );
+  Void      xRelease          ( Void* ptr, const size_t size );
+  Void      xUpdatePeaks      ();
+  static size_t xGetSize      ( const PelStorageKey& key );
+
+  mutable std::mutex                                  m_mutex;
+  std::map<size_t, FreeList<Void*>>                   m_freeBlocks;
+  std::map<PelStorageKey, FreeList<PelStorage*>>      m_freeStorages;
+  std::map<const PelStorage*, PelStorageKey>          m_usedStorages;
+
+  size_t    m_bytesInUse;
+  size_t    m_bytesCached;
+  size_t    m_peakBytesInUse;
+  size_t    m_peakBytesHeld;
+  UInt64    m_numRequests;
+  UInt64    m_numReused;
+};
+
+#endif
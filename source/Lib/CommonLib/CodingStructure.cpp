@@ -42,6 +42,7 @@
 #include "Picture.h"
 #include "UnitTools.h"
 #include "UnitPartitioner.h"
+#include "BufferPool.h"
 
 XUCache g_globalUnitCache = XUCache();
 
@@ -66,6 +67,9 @@ CodingStructure::CodingStructure()
   , m_cuCache ( g_globalUnitCache.cuCache )
   , m_puCache ( g_globalUnitCache.puCache )
   , m_tuCache ( g_globalUnitCache.tuCache )
+  , m_ctuScratch( false )
+  , m_ctuCoeffs ( false )
+  , m_bufferPool( nullptr )
 {
   for( UInt i = 0; i < MAX_NUM_COMPONENT; i++ )
   {
@@ -101,6 +105,9 @@ CodingStructure::CodingStructure(CUCache& cuCache, PUCache& puCache, TUCache& tu
   , m_cuCache ( cuCache )
   , m_puCache ( puCache )
   , m_tuCache ( tuCache )
+  , m_ctuScratch( false )
+  , m_ctuCoeffs ( false )
+  , m_bufferPool( nullptr )
 {
   for( UInt i = 0; i < MAX_NUM_COMPONENT; i++ )
   {
@@ -132,33 +139,17 @@ void CodingStructure::destroy()
   picture   = nullptr;
   parent    = nullptr;
 
+  destroyCtuScratch();
+  destroyCoeffs();
+
   m_pred.destroy();
   m_resi.destroy();
   m_reco.destroy();
   m_orgr.destroy();
 
-  destroyCoeffs();
-
-  for( UInt i = 0; i < MAX_NUM_CHANNEL_TYPE; i++ )
-  {
-    delete[] m_isDecomp[ i ];
-    m_isDecomp[ i ] = nullptr;
-
-    delete[] m_cuIdx[ i ];
-    m_cuIdx[ i ] = nullptr;
-
-    delete[] m_puIdx[ i ];
-    m_puIdx[ i ] = nullptr;
-
-    delete[] m_tuIdx[ i ];
-    m_tuIdx[ i ] = nullptr;
-  }
-
-  delete[] m_motionBuf;
-  m_motionBuf = nullptr;
+  xDestroyMaps();
 
-  delete[] m_motionBufFRUC;
-  m_motionBufFRUC = nullptr;
+  m_motionField.destroy();
 
   m_tuCache.cache( tus );
   m_puCache.cache( pus );
@@ -638,6 +629,22 @@ void CodingStructure::createInternals( const UnitArea& _unit, const bool _create
   picture = nullptr;
   parent  = nullptr;
 
+  xCreateMaps();
+
+  unsigned numCh = getNumberValidComponents(area.chromaFormat);
+
+  for (unsigned i = 0; i < numCh; i++)
+  {
+    m_offsets[i] = 0;
+  }
+
+  if( _createCoeffs ) createCoeffs();
+
+  initStructData();
+}
+
+void CodingStructure::xCreateMaps()
+{
   unsigned numCh = ::getNumberValidChannels(area.chromaFormat);
 
   for (unsigned i = 0; i < numCh; i++)
@@ -650,20 +657,70 @@ void CodingStructure::createInternals( const UnitArea& _unit, const bool _create
     m_tuIdx[i]    = _area > 0 ? new unsigned[_area] : nullptr;
   }
 
-  numCh = getNumberValidComponents(area.chromaFormat);
+  unsigned _lumaAreaScaled = g_miScaling.scale( area.lumaSize() ).area();
+  m_motionBuf     = new MotionInfo[_lumaAreaScaled];
+  m_motionBufFRUC = new MotionInfo[_lumaAreaScaled];
 
-  for (unsigned i = 0; i < numCh; i++)
+  m_blockMotion.create( area.lumaSize().width, area.lumaSize().height, g_miScaling.posx, area.lumaPos().x, area.lumaPos().y );
+}
+
+void CodingStructure::xDestroyMaps()
+{
+  for( UInt i = 0; i < MAX_NUM_CHANNEL_TYPE; i++ )
   {
-    m_offsets[i] = 0;
+    delete[] m_isDecomp[ i ];
+    m_isDecomp[ i ] = nullptr;
+
+    delete[] m_cuIdx[ i ];
+    m_cuIdx[ i ] = nullptr;
+
+    delete[] m_puIdx[ i ];
+    m_puIdx[ i ] = nullptr;
+
+    delete[] m_tuIdx[ i ];
+    m_tuIdx[ i ] = nullptr;
   }
 
-  if( _createCoeffs ) createCoeffs();
+  delete[] m_motionBuf;
+  m_motionBuf = nullptr;
 
-  unsigned _lumaAreaScaled = g_miScaling.scale( area.lumaSize() ).area();
-  m_motionBuf     = new MotionInfo[_lumaAreaScaled];
-  m_motionBufFRUC = new MotionInfo[_lumaAreaScaled];
+  delete[] m_motionBufFRUC;
+  m_motionBufFRUC = nullptr;
 
-  initStructData();
+  m_blockMotion.destroy();
+}
+
+void CodingStructure::compactMotion()
+{
+  CHECK( parent, "Motion compaction can only be used for the top level CodingStructure" );
+  CHECK( m_numCUs || m_numPUs || m_numTUs, "Coding units have to be released before compacting the motion" );
+
+  if( isMotionCompacted() )
+  {
+    return;
+  }
+
+  // the collocated motion is read at the top-left position of each compression block only
+  const unsigned scale = pcv->noMotComp ? ( 1 << g_miScaling.posx ) : 4 * std::max<Int>( 1, 4 * AMVP_DECIMATION_FACTOR / 4 );
+  const unsigned shift = g_aucLog2[scale];
+
+  const CompArea& luma   = area.Y();
+  const unsigned  width  = ( luma.width  + scale - 1 ) >> shift;
+  const unsigned  height = ( luma.height + scale - 1 ) >> shift;
+
+  m_motionField.create( luma.width, luma.height, shift );
+
+  for( unsigned y = 0; y < height; y++ )
+  {
+    const MotionField::Row src = m_blockMotion.row( luma.y + ( y << shift ) );
+
+    for( unsigned x = 0; x < width; x++ )
+    {
+      m_motionField.set( y * width + x, src.get( luma.x + ( x << shift ) ) );
+    }
+  }
+
+  xDestroyMaps();
 }
 
 
@@ -687,16 +744,39 @@ void CodingStructure::rebindPicBufs()
   }
 }
 
-void CodingStructure::createCoeffs()
+unsigned CodingStructure::xGetCoeffArea( const UInt compID ) const
+{
+  if( m_ctuCoeffs )
+  {
+    const ComponentID compId = ComponentID( compID );
+
+    return ( pcv->maxCUWidth  >> getComponentScaleX( compId, area.chromaFormat ) )
+         * ( pcv->maxCUHeight >> getComponentScaleY( compId, area.chromaFormat ) );
+  }
+
+  return area.blocks[compID].area();
+}
+
+void CodingStructure::createCoeffs( BufferPool* pool )
 {
   const unsigned numCh = getNumberValidComponents( area.chromaFormat );
 
+  m_bufferPool = pool;
+
   for( unsigned i = 0; i < numCh; i++ )
   {
-    unsigned _area = area.blocks[i].area();
+    unsigned _area = xGetCoeffArea( i );
 
-    m_coeffs[i] = _area > 0 ? ( TCoeff* ) xMalloc( TCoeff, _area ) : nullptr;
-    m_pcmbuf[i] = _area > 0 ? ( Pel*    ) xMalloc( Pel,    _area ) : nullptr;
+    if( pool )
+    {
+      m_coeffs[i] = pool->allocate<TCoeff>( _area );
+      m_pcmbuf[i] = pool->allocate<Pel>   ( _area );
+    }
+    else
+    {
+      m_coeffs[i] = _area > 0 ? ( TCoeff* ) xMalloc( TCoeff, _area ) : nullptr;
+      m_pcmbuf[i] = _area > 0 ? ( Pel*    ) xMalloc( Pel,    _area ) : nullptr;
+    }
   }
 }
 
@@ -704,11 +784,85 @@ void CodingStructure::destroyCoeffs()
 {
   for( UInt i = 0; i < MAX_NUM_COMPONENT; i++ )
   {
+    if( m_bufferPool && i < area.blocks.size() )
+    {
+      // the pool needs the size the arrays were created with
+      const unsigned _area = xGetCoeffArea( i );
+
+      m_bufferPool->release( m_coeffs[i], _area ); m_coeffs[i] = nullptr;
+      m_bufferPool->release( m_pcmbuf[i], _area ); m_pcmbuf[i] = nullptr;
+    }
     if( m_coeffs[i] ) { xFree( m_coeffs[i] ); m_coeffs[i] = nullptr; }
     if( m_pcmbuf[i] ) { xFree( m_pcmbuf[i] ); m_pcmbuf[i] = nullptr; }
   }
 }
 
+void CodingStructure::createCtuScratch( const bool ctuCoeffs, BufferPool* pool )
+{
+  CHECK( parent, "CTU scratch buffers can only be used for the top level CodingStructure" );
+
+  const Area ctuSize( 0, 0, pcv->maxCUWidth, pcv->maxCUHeight );
+
+  m_ctuScratch = true;
+  m_ctuCoeffs  = ctuCoeffs;
+
+  // binds the reconstruction to the picture, the picture has no prediction/residual buffers
+  rebindPicBufs();
+
+  if( pool )
+  {
+    pool->createPelStorage( m_pred, area.chromaFormat, ctuSize );
+    pool->createPelStorage( m_resi, area.chromaFormat, ctuSize );
+  }
+  else
+  {
+    m_pred.create( area.chromaFormat, ctuSize );
+    m_resi.create( area.chromaFormat, ctuSize );
+  }
+
+  createCoeffs( pool );
+
+  m_scratchArea = UnitArea( area.chromaFormat, ctuSize );
+}
+
+void CodingStructure::destroyCtuScratch()
+{
+  if( !m_ctuScratch )
+  {
+    return;
+  }
+
+  destroyCoeffs();
+
+  if( m_bufferPool )
+  {
+    m_bufferPool->destroyPelStorage( m_pred );
+    m_bufferPool->destroyPelStorage( m_resi );
+  }
+  else
+  {
+    m_pred.destroy();
+    m_resi.destroy();
+  }
+
+  m_ctuScratch = false;
+  m_ctuCoeffs  = false;
+}
+
+void CodingStructure::initCtuScratch( const UnitArea& ctuArea )
+{
+  m_scratchArea = ctuArea;
+
+  if( m_ctuCoeffs )
+  {
+    // the coefficients of the previous CTUs are not needed anymore
+    for( UInt i = 0; i < MAX_NUM_COMPONENT; i++ )
+    {
+      m_offsets[i] = 0;
+    }
+  }
+}
+
 void CodingStructure::initSubStructure( CodingStructure& subStruct, const UnitArea &subArea, const bool &isTuEnc, const ChannelType &_chType )
 {
   CHECK( this == &subStruct, "Trying to init self as sub-structure" );
@@ -720,6 +874,8 @@ void CodingStructure::initSubStructure( CodingStructure& subStruct, const UnitAr
     subStruct.area.blocks[i].pos() = subArea.blocks[i].pos();
   }
 
+  subStruct.m_blockMotion.setOrigin( subStruct.area.lumaPos().x, subStruct.area.lumaPos().y );
+
   if( parent )
   {
     // allow this to be false at the top level (need for edge CTU's)
@@ -856,6 +1012,9 @@ void CodingStructure::useSubStructure( const CodingStructure& subStruct, const U
     CMotionBuf subMB = subStruct.getMotionBuf( clippedArea );
 
     ownMB.copyFrom( subMB );
+
+    const CompArea& luma = clippedArea.Y();
+    m_blockMotion.copyFrom( subStruct.m_blockMotion, luma.x, luma.y, luma.width, luma.height );
   }
 }
 
@@ -898,6 +1057,9 @@ void CodingStructure::copyStructure( const CodingStructure& other, const bool co
     CMotionBuf subMB = other.getMotionBuf();
 
     ownMB.copyFrom( subMB );
+
+    const CompArea& luma = area.Y();
+    m_blockMotion.copyFrom( other.m_blockMotion, luma.x, luma.y, luma.width, luma.height );
   }
 
   if( copyTUs )
@@ -932,6 +1094,14 @@ void CodingStructure::copyStructure( const CodingStructure& other, const bool co
 
 void CodingStructure::initStructData( const int &QP, const bool &_isLosses )
 {
+  if( isMotionCompacted() )
+  {
+    // the picture is reused after having been a reference picture
+    m_motionField.destroy();
+
+    xCreateMaps();
+  }
+
   m_cuCache.cache( cus );
   m_puCache.cache( pus );
   m_tuCache.cache( tus );
@@ -969,6 +1139,7 @@ void CodingStructure::initStructData( const int &QP, const bool &_isLosses )
   if( !parent || ( ( slice->getSliceType() != I_SLICE ) && !m_isTuEnc ) )
   {
     getMotionBuf()      .memset( 0 );
+    m_blockMotion       .clear();
     if( !parent )
     {
       getMotionBufFRUC().memset( 0 );
@@ -1020,6 +1191,7 @@ MotionBuf CodingStructure::getMotionBuf( const Area& _area )
   const CompArea& _luma = area.Y();
 
   CHECKD( !_luma.contains( _area ), "Trying to access motion information outside of this coding structure" );
+  CHECKD( isMotionCompacted(), "The motion of a compacted coding structure has to be read through getMotionField()" );
 
   const Area miArea   = g_miScaling.scale( _area );
   const Area selfArea = g_miScaling.scale( _luma );
@@ -1032,6 +1204,7 @@ const CMotionBuf CodingStructure::getMotionBuf( const Area& _area ) const
   const CompArea& _luma = area.Y();
 
   CHECKD( !_luma.contains( _area ), "Trying to access motion information outside of this coding structure" );
+  CHECKD( isMotionCompacted(), "The motion of a compacted coding structure has to be read through getMotionField()" );
 
   const Area miArea   = g_miScaling.scale( _area );
   const Area selfArea = g_miScaling.scale( _luma );
@@ -1042,6 +1215,7 @@ const CMotionBuf CodingStructure::getMotionBuf( const Area& _area ) const
 MotionInfo& CodingStructure::getMotionInfo( const Position& pos )
 {
   CHECKD( !area.Y().contains( pos ), "Trying to access motion information outside of this coding structure" );
+  CHECKD( isMotionCompacted(), "The motion of a compacted coding structure has to be read through getMotionField()" );
 
   //return getMotionBuf().at( g_miScaling.scale( pos - area.lumaPos() ) );
   // bypass the motion buf calling and get the value directly
@@ -1054,6 +1228,7 @@ MotionInfo& CodingStructure::getMotionInfo( const Position& pos )
 const MotionInfo& CodingStructure::getMotionInfo( const Position& pos ) const
 {
   CHECKD( !area.Y().contains( pos ), "Trying to access motion information outside of this coding structure" );
+  CHECKD( isMotionCompacted(), "The motion of a compacted coding structure has to be read through getMotionField()" );
 
   //return getMotionBuf().at( g_miScaling.scale( pos - area.lumaPos() ) );
   // bypass the motion buf calling and get the value directly
@@ -1063,6 +1238,21 @@ const MotionInfo& CodingStructure::getMotionInfo( const Position& pos ) const
   return *( m_motionBuf + miPos.y * stride + miPos.x );
 }
 
+void CodingStructure::updateBlockMotion( const Area& _area )
+{
+  const CMotionBuf mb = getMotionBuf( _area );
+
+  for( Int y = 0; y < mb.height; y++ )
+  {
+    const MotionField::Row row = m_blockMotion.row( _area.y + ( y << g_miScaling.posy ) );
+
+    for( Int x = 0; x < mb.width; x++ )
+    {
+      m_blockMotion.set( row.idx( _area.x + ( x << g_miScaling.posx ) ), mb.at( x, y ) );
+    }
+  }
+}
+
 MotionBuf CodingStructure::getMotionBufFRUC( const Area& _area )
 {
   if( parent )
@@ -1184,11 +1374,14 @@ PelBuf CodingStructure::getBuf( const CompArea &blk, const PictureType &type )
 
   CHECK( !buf, "Unknown buffer requested" );
 
+  // with CTU scratch buffers, prediction and residual only cover the current CTU
+  const CompArea& bufArea = m_ctuScratch && ( type == PIC_PREDICTION || type == PIC_RESIDUAL ) ? m_scratchArea.blocks[compID] : area.blocks[compID];
+
       // no parent fetching for buffers
-  CHECKD( !area.blocks[compID].contains(blk), "Buffer not contained in self requested" );
+  CHECKD( !bufArea.contains(blk), "Buffer not contained in self requested" );
 
   CompArea cFinal = blk;
-  cFinal.relativeTo( area.blocks[compID] );
+  cFinal.relativeTo( bufArea );
   return buf->getBuf( cFinal );
 }
 
@@ -1210,10 +1403,12 @@ const CPelBuf CodingStructure::getBuf( const CompArea &blk, const PictureType &t
 
   CHECK( !buf, "Unknown buffer requested" );
 
-  CHECKD( !area.blocks[compID].contains( blk ), "Buffer not contained in self requested" );
+  const CompArea& bufArea = m_ctuScratch && ( type == PIC_PREDICTION || type == PIC_RESIDUAL ) ? m_scratchArea.blocks[compID] : area.blocks[compID];
+
+  CHECKD( !bufArea.contains( blk ), "Buffer not contained in self requested" );
 
   CompArea cFinal = blk;
-  cFinal.relativeTo( area.blocks[compID] );
+  cFinal.relativeTo( bufArea );
   return buf->getBuf( cFinal );
 }
 
@@ -47,6 +47,7 @@
 
 
 struct Picture;
+class BufferPool;
 
 
 enum PictureType
@@ -99,9 +100,27 @@ public:
   void releaseIntermediateData();
 
   void rebindPicBufs();
-  void createCoeffs();
+  // buffers taken from a pool are returned to it by the destroy functions and destroy()
+  void createCoeffs( BufferPool* pool = nullptr );
   void destroyCoeffs();
 
+  // low memory decoding: CTU sized prediction, residual and (if ctuCoeffs) coefficient/PCM buffers, reused per CTU
+  void createCtuScratch ( const bool ctuCoeffs, BufferPool* pool = nullptr );
+  void destroyCtuScratch();
+  void initCtuScratch   ( const UnitArea& ctuArea );
+  bool hasCtuScratch    () const { return m_ctuScratch; }
+
+  // reference picture storage: keeps only the motion field at the granularity read by TMVP/sub-PU MVP/FRUC
+  // (16x16 unless motion compression is disabled) and releases the index maps, undone by the next initStructData()
+  void compactMotion();
+  bool isMotionCompacted() const { return !m_motionField.empty(); }
+  const MotionField& getMotionField() const { return m_motionField; }
+
+  // motion of the coded blocks as read by the spatial merge/AMVP candidates and the deblocking, kept in step with the
+  // MotionInfo buffer by the PU motion setters and the sub-structure copies
+  const MotionField& getBlockMotion() const { return m_blockMotion; }
+  void updateBlockMotion( const Area& _area );
+
   // ---------------------------------------------------------------------------
   // global accessors
   // ---------------------------------------------------------------------------
@@ -207,9 +226,22 @@ private:
 
   int     m_offsets[ MAX_NUM_COMPONENT ];
 
+  bool     m_ctuScratch;
+  bool     m_ctuCoeffs;
+  BufferPool* m_bufferPool; ///< pool of the coefficient/PCM arrays and the CTU scratch buffers, null if not pooled
+  UnitArea m_scratchArea;   ///< area covered by m_pred/m_resi with CTU scratch buffers
+
+  unsigned xGetCoeffArea( const UInt compID ) const;
+
   MotionInfo *m_motionBuf;
   MotionInfo *m_motionBufFRUC;
 
+  MotionField m_blockMotion;  ///< motion of the coded blocks at the motion storage granularity
+  MotionField m_motionField;
+
+  void xCreateMaps();
+  void xDestroyMaps();
+
 public:
 
   MotionBuf getMotionBuf( const     Area& _area );
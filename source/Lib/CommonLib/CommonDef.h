@@ -293,6 +293,7 @@ static const Int AFFINE_MIN_BLOCK_SIZE =                            4; ///< Mini
 
 #if W0038_DB_OPT
 static const Int MAX_ENCODER_DEBLOCKING_QUALITY_LAYERS =           8 ;
+static const Int MAX_ENCODER_DEBLOCKING_THREADS =                  4 ; ///< max number of threads of the deblocking parameter selection, each one needs a picture buffer
 #endif
 
 #if SHARP_LUMA_DELTA_QP
@@ -477,6 +478,7 @@ typedef enum{
 #ifdef TARGET_SIMD_X86
 X86_VEXT read_x86_extension_flags(const std::string &extStrId = std::string());
 const char* read_x86_extension(const std::string &extStrId);
+X86_VEXT _get_x86_extensions(); ///< extensions supported by the CPU, independent of the selected extension
 #endif
 
 #endif //HHI_SIMD_OPT
@@ -2230,14 +2230,15 @@ Void InterPrediction::xFrucCollectSubBlkStartMv( PredictionUnit& pu, MergeCtx me
 
       const Position pos = Position{ PosType( _pos.x & mask ), PosType( _pos.y & mask ) };
 
-      const MotionInfo &colMi = pColPic->cs->getMotionInfo( pos );
+      const MotionField& colField = pColPic->cs->getMotionField();
+      const UInt         colIdx   = colField.idx( pos.x, pos.y );
 
       for( Int nRefListColPic = 0; nRefListColPic < 2; nRefListColPic++ )
       {
-        if( colMi.interDir & ( 1 << nRefListColPic ) ) // TODO: check if refIdx is always NOT_VALID, not 0 as set
+        if( colField.interDir( colIdx ) & ( 1 << nRefListColPic ) ) // TODO: check if refIdx is always NOT_VALID, not 0 as set
         {
-          CHECK( colMi.isInter == false, "invalid motion info" );
-          Mv rColMv = colMi.mv[nRefListColPic];
+          CHECK( !colField.isInter( colIdx ), "invalid motion info" );
+          Mv rColMv = colField.mv( colIdx, RefPicList( nRefListColPic ) );
 
           if( pu.cs->sps->getSpsNext().getUseHighPrecMv() )
           {
@@ -2245,7 +2246,7 @@ Void InterPrediction::xFrucCollectSubBlkStartMv( PredictionUnit& pu, MergeCtx me
           }
 
           mvCand.refIdx = rMvStart.refIdx;
-          mvCand.mv     = PU::scaleMv( rColMv , nCurPOC , nCurRefPOC , pColPic->getPOC(), pColPic->cs->slice->getRefPOC( ( RefPicList )nRefListColPic , colMi.refIdx[nRefListColPic] ), pu.cs->slice );
+          mvCand.mv     = PU::scaleMv( rColMv , nCurPOC , nCurRefPOC , pColPic->getPOC(), pColPic->cs->slice->getRefPOC( ( RefPicList )nRefListColPic , colField.refIdx( colIdx, RefPicList( nRefListColPic ) ) ), pu.cs->slice );
           if( mvCand.refIdx < 0 )
           {
             printf( "base" );
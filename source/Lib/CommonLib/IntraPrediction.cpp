@@ -94,6 +94,23 @@ IntraPrediction::IntraPrediction() : m_currChromaFormat(NUM_CHROMA_FORMAT)
   {
     m_pLumaRecBufferMul[i] = nullptr;
   }
+
+  m_predAngLinear  = xPredAngLinear;
+  m_predAng4Tap    = xPredAng4Tap;
+  m_predPlanar     = xPredPlanarCore;
+  m_predDc         = xPredDcCore;
+  m_filterRefRow   = xFilterRefRow;
+  m_transposeBlk   = xTransposeBlk;
+  m_lumaDownsample = xLumaDownsample;
+  m_lmSumsRow      = xLMSumsRow;
+  m_lmClassSums    = xLMClassSums;
+  m_lmApply2       = xLMApply2;
+
+#if HHI_SIMD_OPT_INTRA_PRED
+#ifdef TARGET_SIMD_X86
+  initIntraPredictionX86();
+#endif
+#endif
 }
 
 IntraPrediction::~IntraPrediction()
@@ -374,30 +391,7 @@ Void IntraPrediction::predIntraChromaLM(const ComponentID &compID, PelBuf &piPre
     UInt uiCWidth = chromaArea.width;
     UInt uiCHeight = chromaArea.height;
 
-    for (Int i = 0; i < uiCHeight; i++)
-    {
-      for (Int j = 0; j < uiCWidth; j++)
-      {
-        Int a, b, iShift;
-        if (pLuma[j] <= parameters[0].Sup)
-        {
-          a = parameters[0].a;
-          b = parameters[0].b;
-          iShift = parameters[0].shift;
-        }
-        else
-        {
-          a = parameters[1].a;
-          b = parameters[1].b;
-          iShift = parameters[1].shift;
-        }
-
-        pPred[j] = ( Pel ) ClipPel( ( ( a * pLuma[j] ) >> iShift ) + b, pu.cs->slice->clpRng( compID ) );
-      }
-
-      pPred += uiPredStride;
-      pLuma += iLumaStride;
-    }
+    m_lmApply2( pLuma, iLumaStride, pPred, uiPredStride, uiCWidth, uiCHeight, parameters, pu.cs->slice->clpRng( compID ) );
 
     if (pu.cs->sps->getSpsNext().isELMModeMFLM())
     {
@@ -521,26 +515,29 @@ Void IntraPrediction::xPredIntraDPCM( const CPelBuf &pSrc, PelBuf &pDst, PelBuf
 //NOTE: Bit-Limit - 24-bit source
 Void IntraPrediction::xPredIntraPlanar( const CPelBuf &pSrc, PelBuf &pDst, const SPS& sps )
 {
-  const UInt width = pDst.width;
-  const UInt height = pDst.height;
+  m_predPlanar( pSrc.buf, pSrc.stride, pDst.buf, pDst.stride, pDst.width, pDst.height );
+}
 
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xPredPlanarCore( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
   Int leftColumn[MAX_CU_SIZE + 1], topRow[MAX_CU_SIZE + 1], bottomRow[MAX_CU_SIZE], rightColumn[MAX_CU_SIZE];
   const UInt offset = width * height;
 
   // Get left and above reference column and row
   for( Int k = 0; k < width + 1; k++ )
   {
-    topRow[k] = pSrc.at( k + 1, 0 );
+    topRow[k] = pSrc[k + 1];
   }
 
   for( Int k = 0; k < height + 1; k++ )
   {
-    leftColumn[k] = pSrc.at( 0, k + 1 );
+    leftColumn[k] = pSrc[( k + 1 ) * srcStride];
   }
 
   // Prepare intermediate variables used in interpolation
-  Int bottomLeft = leftColumn[height];
-  Int topRight = topRow[width];
+  Int bottomLeft = pSrc[( height + 1 ) * srcStride];
+  Int topRight = pSrc[width + 1];
 
   for( Int k = 0; k < width; k++ )
   {
@@ -556,7 +553,7 @@ Void IntraPrediction::xPredIntraPlanar( const CPelBuf &pSrc, PelBuf &pDst, const
     //leftColumn[k] <<= shift1Dhor;
   }
 
-  for( Int y = 0; y < height; y++ )
+  for( Int y = 0; y < height; y++, pDst += dstStride )
   {
     Int horPred = leftColumn[y];
 
@@ -566,15 +563,14 @@ Void IntraPrediction::xPredIntraPlanar( const CPelBuf &pSrc, PelBuf &pDst, const
       topRow[x] += bottomRow[x];
 
       Int vertPred = topRow[x];
-      pDst.at( x, y ) = ( ( horPred * height ) + ( vertPred * width ) + offset ) / ( width * height * 2 );
+      pDst[x] = ( ( horPred * height ) + ( vertPred * width ) + offset ) / ( width * height * 2 );
     }
   }
 }
 
 Void IntraPrediction::xPredIntraDc( const CPelBuf &pSrc, PelBuf &pDst, const ChannelType &channelType, const bool &enableBoundaryFilter )
 {
-  const Pel dcval = xGetPredValDc( pSrc, pDst );
-  pDst.fill( dcval );
+  m_predDc( pSrc.buf, pSrc.stride, pDst.buf, pDst.stride, pDst.width, pDst.height );
 
   if( enableBoundaryFilter )
   {
@@ -611,6 +607,14 @@ Void IntraPrediction::xDCPredFiltering(const CPelBuf &pSrc, PelBuf &pDst, const
   return;
 }
 
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xPredDcCore( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
+  const Pel dcval = xGetPredValDc( CPelBuf( pSrc, srcStride, srcStride ), Size( width, height ) );
+
+  PelBuf( pDst, dstStride, width, height ).fill( dcval );
+}
+
 // Function for deriving the angular Intra predictions
 
 /** Function for deriving the simplified angular intra predictions.
@@ -697,13 +701,7 @@ Void IntraPrediction::xPredIntraAng( const CPelBuf &pSrc, PelBuf &pDst, const Ch
 
   if( intraPredAngle == 0 )  // pure vertical or pure horizontal
   {
-    for( Int y = 0; y < height; y++ )
-    {
-      for( Int x = 0; x < width; x++ )
-      {
-        pDstBuf[y*dstStride + x] = refMain[x + 1];
-      }
-    }
+    m_predAngLinear( pDstBuf, dstStride, refMain, width, height, 0 );
 
     if (edgeFilter)
     {
@@ -715,60 +713,15 @@ Void IntraPrediction::xPredIntraAng( const CPelBuf &pSrc, PelBuf &pDst, const Ch
   }
   else
   {
-    Pel *pDsty=pDstBuf;
-
-    for (Int y=0, deltaPos=intraPredAngle; y<height; y++, deltaPos+=intraPredAngle, pDsty+=dstStride)
+    if( sps.getSpsNext().getUseIntra4Tap() )
     {
-      const Int deltaInt   = deltaPos >> 5;
-      const Int deltaFract = deltaPos & (32 - 1);
-
-      if (deltaFract)
-      {
-        if( sps.getSpsNext().getUseIntra4Tap() )
-        {
-          Int   p[4];
-          Bool  useCubicFilter = (width <= 8);
-          Int  *f              = (useCubicFilter) ? intraCubicFilter[deltaFract] : intraGaussFilter[deltaFract];
-          Int   refMainIndex   = deltaInt + 1;
-
-          for( Int x = 0; x < width; x++, refMainIndex++ )
-          {
-            p[1] = refMain[refMainIndex];
-            p[2] = refMain[refMainIndex + 1];
-
-            p[0] = x == 0 ? p[1] : refMain[refMainIndex - 1];
-            p[3] = x == (width - 1) ? p[2] : refMain[refMainIndex + 2];
-
-            pDstBuf[y*dstStride + x] =  (Pel)((f[0] * p[0] + f[1] * p[1] + f[2] * p[2] + f[3] * p[3] + 128) >> 8);
-
-            if( useCubicFilter ) // only cubic filter has negative coefficients and requires clipping
-            {
-              pDstBuf[y*dstStride + x] = ClipPel( pDstBuf[y*dstStride + x], clpRng );
-            }
-          }
-        }
-        else
-        {
-          // Do linear filtering
-          const Pel *pRM = refMain + deltaInt + 1;
-          Int lastRefMainPel = *pRM++;
-          for( Int x = 0; x < width; pRM++, x++ )
-          {
-            Int thisRefMainPel = *pRM;
-            pDsty[x + 0] = ( Pel ) ( ( ( 32 - deltaFract )*lastRefMainPel + deltaFract*thisRefMainPel + 16 ) >> 5 );
-            lastRefMainPel = thisRefMainPel;
-          }
-        }
-      }
-      else
-      {
-        // Just copy the integer samples
-        for( Int x = 0; x < width; x++ )
-        {
-          pDsty[x] = refMain[x + deltaInt + 1];
-        }
-      }
+      m_predAng4Tap( pDstBuf, dstStride, refMain, width, height, intraPredAngle, clpRng );
     }
+    else
+    {
+      m_predAngLinear( pDstBuf, dstStride, refMain, width, height, intraPredAngle );
+    }
+
     if( edgeFilter && absAng <= 1 )
     {
       for( Int y = 0; y < height; y++ )
@@ -781,14 +734,7 @@ Void IntraPrediction::xPredIntraAng( const CPelBuf &pSrc, PelBuf &pDst, const Ch
   // Flip the block if this is the horizontal mode
   if( !bIsModeVer )
   {
-    for( Int y = 0; y < height; y++ )
-    {
-      for( Int x = 0; x < width; x++ )
-      {
-        pDst.at( y, x ) = pDstBuf[x];
-      }
-      pDstBuf += dstStride;
-    }
+    m_transposeBlk( pDstBuf, dstStride, pDst.buf, pDst.stride, width, height );
   }
 
   if( sps.getSpsNext().getUseIntraBoundaryFilter() && enableBoundaryFilter && isLuma( channelType ) && width > 2 && height > 2 )
@@ -808,6 +754,92 @@ Void IntraPrediction::xPredIntraAng( const CPelBuf &pSrc, PelBuf &pDst, const Ch
   }
 }
 
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xPredAngLinear( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle )
+{
+  for( Int y = 0, deltaPos = intraPredAngle; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const Int deltaInt   = deltaPos >> 5;
+    const Int deltaFract = deltaPos & ( 32 - 1 );
+
+    if( deltaFract )
+    {
+      // Do linear filtering
+      const Pel *pRM = refMain + deltaInt + 1;
+      Int lastRefMainPel = *pRM++;
+      for( Int x = 0; x < width; pRM++, x++ )
+      {
+        Int thisRefMainPel = *pRM;
+        pDst[x + 0] = ( Pel ) ( ( ( 32 - deltaFract )*lastRefMainPel + deltaFract*thisRefMainPel + 16 ) >> 5 );
+        lastRefMainPel = thisRefMainPel;
+      }
+    }
+    else
+    {
+      // Just copy the integer samples
+      for( Int x = 0; x < width; x++ )
+      {
+        pDst[x] = refMain[x + deltaInt + 1];
+      }
+    }
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xPredAng4Tap( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle, const ClpRng& clpRng )
+{
+  const Bool useCubicFilter = ( width <= 8 );
+
+  for( Int y = 0, deltaPos = intraPredAngle; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const Int deltaInt   = deltaPos >> 5;
+    const Int deltaFract = deltaPos & ( 32 - 1 );
+
+    if( deltaFract )
+    {
+      Int   p[4];
+      Int  *f              = ( useCubicFilter ) ? intraCubicFilter[deltaFract] : intraGaussFilter[deltaFract];
+      Int   refMainIndex   = deltaInt + 1;
+
+      for( Int x = 0; x < width; x++, refMainIndex++ )
+      {
+        p[1] = refMain[refMainIndex];
+        p[2] = refMain[refMainIndex + 1];
+
+        p[0] = x == 0 ? p[1] : refMain[refMainIndex - 1];
+        p[3] = x == ( width - 1 ) ? p[2] : refMain[refMainIndex + 2];
+
+        pDst[x] = ( Pel ) ( ( f[0] * p[0] + f[1] * p[1] + f[2] * p[2] + f[3] * p[3] + 128 ) >> 8 );
+
+        if( useCubicFilter ) // only cubic filter has negative coefficients and requires clipping
+        {
+          pDst[x] = ClipPel( pDst[x], clpRng );
+        }
+      }
+    }
+    else
+    {
+      // Just copy the integer samples
+      for( Int x = 0; x < width; x++ )
+      {
+        pDst[x] = refMain[x + deltaInt + 1];
+      }
+    }
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xTransposeBlk( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
+  for( Int y = 0; y < height; y++, pSrc += srcStride )
+  {
+    for( Int x = 0; x < width; x++ )
+    {
+      pDst[x * dstStride + y] = pSrc[x];
+    }
+  }
+}
+
 Void IntraPrediction::xIntraPredFilteringMode34(const CPelBuf &pSrc, PelBuf &pDst)
 {
   UInt iWidth  = pDst.width;
@@ -1220,14 +1252,22 @@ void IntraPrediction::xFilterReferenceSamples( const Pel* refBufUnfiltered, Pel*
   piDestPtr++;
   piSrcPtr++;
   //top row (left-to-right)
-  for( UInt i=1; i < predSize; i++, piDestPtr++, piSrcPtr++ )
-  {
-    *piDestPtr = (piSrcPtr[1] + 2 * piSrcPtr[0] + piSrcPtr[-1] + 2) >> 2;
-  }
+  m_filterRefRow( piSrcPtr, piDestPtr, predSize - 1 );
+  piDestPtr += predSize - 1;
+  piSrcPtr  += predSize - 1;
   // top right (not filtered)
   *piDestPtr=*piSrcPtr;
 }
 
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xFilterRefRow( const Pel* pSrc, Pel* pDst, Int num )
+{
+  for( Int i = 0; i < num; i++ )
+  {
+    pDst[i] = ( pSrc[i + 1] + 2 * pSrc[i] + pSrc[i - 1] + 2 ) >> 2;
+  }
+}
+
 bool IntraPrediction::useFilteredIntraRefSamples( const ComponentID &compID, const PredictionUnit &pu, const bool &modeSpecific, const UnitArea &tuArea )
 {
   const SPS         &sps    = *pu.cs->sps;
@@ -1500,19 +1540,7 @@ Void IntraPrediction::xGetLumaRecPixels(const PredictionUnit &pu, CompArea chrom
     pDst  = pDst0    - iDstStride;
     piSrc = pRecSrc0 - iRecStride2;
 
-    for( Int i = 0; i < uiCWidth; i++ )
-    {
-      if( i == 0 && !bLeftAvaillable )
-      {
-        pDst[i] = ( piSrc[2 * i] + piSrc[2 * i + iRecStride] + 1 ) >> 1;
-      }
-      else
-      {
-        pDst[i] = ( ( ( piSrc[2 * i             ] * 2 ) + piSrc[2 * i - 1             ] + piSrc[2 * i + 1             ] )
-                  + ( ( piSrc[2 * i + iRecStride] * 2 ) + piSrc[2 * i - 1 + iRecStride] + piSrc[2 * i + 1 + iRecStride] )
-                  + 4 ) >> 3;
-      }
-    }
+    m_lumaDownsample( piSrc, iRecStride, pDst, iDstStride, uiCWidth, 1, bLeftAvaillable );
 
     if (pu.cs->sps->getSpsNext().isELMModeMMLM())
     {
@@ -1521,19 +1549,7 @@ Void IntraPrediction::xGetLumaRecPixels(const PredictionUnit &pu, CompArea chrom
         pDst = pDst0 - iDstStride * line;
         piSrc = pRecSrc0 - iRecStride2 * line;
 
-        for (Int i = 0; i < uiCWidth; i++)
-        {
-          if (i == 0 && !bLeftAvaillable)
-          {
-            pDst[i] = (piSrc[2 * i] + piSrc[2 * i + iRecStride] + 1) >> 1;
-          }
-          else
-          {
-            pDst[i] = (((piSrc[2 * i] * 2) + piSrc[2 * i - 1] + piSrc[2 * i + 1])
-              + ((piSrc[2 * i + iRecStride] * 2) + piSrc[2 * i - 1 + iRecStride] + piSrc[2 * i + 1 + iRecStride])
-              + 4) >> 3;
-          }
-        }
+        m_lumaDownsample( piSrc, iRecStride, pDst, iDstStride, uiCWidth, 1, bLeftAvaillable );
       }
     }
 
@@ -1659,25 +1675,7 @@ Void IntraPrediction::xGetLumaRecPixels(const PredictionUnit &pu, CompArea chrom
 
 
   // inner part from reconstructed picture buffer
-  for( Int j = 0; j < uiCHeight; j++ )
-  {
-    for( Int i = 0; i < uiCWidth; i++ )
-    {
-      if( i == 0 && !bLeftAvaillable )
-      {
-        pDst0[i] = ( pRecSrc0[2 * i] + pRecSrc0[2 * i + iRecStride] + 1 ) >> 1;
-      }
-      else
-      {
-        pDst0[i] = ( pRecSrc0[2 * i             ] * 2 + pRecSrc0[2 * i + 1             ] + pRecSrc0[2 * i - 1             ]
-                   + pRecSrc0[2 * i + iRecStride] * 2 + pRecSrc0[2 * i + 1 + iRecStride] + pRecSrc0[2 * i - 1 + iRecStride]
-                   + 4 ) >> 3;
-      }
-    }
-
-    pDst0    += iDstStride;
-    pRecSrc0 += iRecStride2;
-  }
+  m_lumaDownsample( pRecSrc0, iRecStride, pDst0, iDstStride, uiCWidth, uiCHeight, bLeftAvaillable );
 
   if (pu.cs->sps->getSpsNext().isELMModeMFLM())
   {
@@ -1699,6 +1697,76 @@ Void IntraPrediction::xGetLumaRecPixels(const PredictionUnit &pu, CompArea chrom
   }
 }
 
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xLumaDownsample( const Pel* pRec, Int recStride, Pel* pDst, Int dstStride, Int width, Int height, Bool bLeftAvail )
+{
+  for( Int j = 0; j < height; j++ )
+  {
+    for( Int i = 0; i < width; i++ )
+    {
+      if( i == 0 && !bLeftAvail )
+      {
+        pDst[i] = ( pRec[2 * i] + pRec[2 * i + recStride] + 1 ) >> 1;
+      }
+      else
+      {
+        pDst[i] = ( pRec[2 * i            ] * 2 + pRec[2 * i + 1            ] + pRec[2 * i - 1            ]
+                  + pRec[2 * i + recStride] * 2 + pRec[2 * i + 1 + recStride] + pRec[2 * i - 1 + recStride]
+                  + 4 ) >> 3;
+      }
+    }
+
+    pDst += dstStride;
+    pRec += recStride << 1;
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xLMSumsRow( const Pel* pSrc, const Pel* pCur, Int num, Int& x, Int& y, Int& xx, Int& xy )
+{
+  for( Int j = 0; j < num; j++ )
+  {
+    x  += pSrc[j];
+    y  += pCur[j];
+    xx += pSrc[j] * pSrc[j];
+    xy += pSrc[j] * pCur[j];
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xLMClassSums( const Int* pLuma, const Int* pChroma, const Int* pTag, Int count, Int numGroups, Int x[], Int y[], Int xx[], Int xy[] )
+{
+  for( Int group = 0; group < numGroups; group++ )
+  {
+    x[group] = y[group] = xy[group] = xx[group] = 0;
+  }
+  for( Int i = 0; i < count; i++ )
+  {
+    Int group = pTag[i];
+    x[group]  += pLuma[i];
+    y[group]  += pChroma[i];
+    xx[group] += pLuma[i] * pLuma[i];
+    xy[group] += pLuma[i] * pChroma[i];
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void IntraPrediction::xLMApply2( const Pel* pLuma, Int lumaStride, Pel* pPred, Int predStride, Int width, Int height, const MMLM_parameter parameters[2], const ClpRng& clpRng )
+{
+  for( Int i = 0; i < height; i++ )
+  {
+    for( Int j = 0; j < width; j++ )
+    {
+      const MMLM_parameter& param = pLuma[j] <= parameters[0].Sup ? parameters[0] : parameters[1];
+
+      pPred[j] = ( Pel ) ClipPel( ( ( param.a * pLuma[j] ) >> param.shift ) + param.b, clpRng );
+    }
+
+    pPred += predStride;
+    pLuma += lumaStride;
+  }
+}
+
 static int GetFloorLog2( unsigned x )
 {
   int bits = -1;
@@ -1950,18 +2018,7 @@ Int IntraPrediction::xLMSampleClassifiedTraining(Int count, Int LumaSamples[], I
 
 
   Int x[3], y[3], xy[3], xx[3];
-  for (Int group = 0; group < GroupNum; group++)
-  {
-    x[group] = y[group] = xy[group] = xx[group] = 0;
-  }
-  for (Int i = 0; i < count; i++)
-  {
-    Int group = GroupTag[i];
-    x[group] += LumaSamples[i];
-    y[group] += ChrmSamples[i];
-    xx[group] += LumaSamples[i] * LumaSamples[i];
-    xy[group] += LumaSamples[i] * ChrmSamples[i];
-  }
+  m_lmClassSums( LumaSamples, ChrmSamples, GroupTag, count, GroupNum, x, y, xx, xy );
 
   for (Int group = 0; group < GroupNum; group++)
   {
@@ -2215,14 +2272,21 @@ Void IntraPrediction::xGetLMParameters(const PredictionUnit &pu, const Component
 
   if( bAboveAvaillable )
   {
-    for( int j = 0; j < numSteps; j++ )
+    if( minDim == uiCWidth && minStep == 1 )
     {
-      int idx = ( j * minStep * uiCWidth ) / minDim;
+      m_lmSumsRow( pSrc, pCur, numSteps, x, y, xx, xy );
+    }
+    else
+    {
+      for( int j = 0; j < numSteps; j++ )
+      {
+        int idx = ( j * minStep * uiCWidth ) / minDim;
 
-      x  += pSrc[idx];
-      y  += pCur[idx];
-      xx += pSrc[idx] * pSrc[idx];
-      xy += pSrc[idx] * pCur[idx];
+        x  += pSrc[idx];
+        y  += pCur[idx];
+        xx += pSrc[idx] * pSrc[idx];
+        xy += pSrc[idx] * pCur[idx];
+      }
     }
 
     iCountShift = g_aucLog2[minDim / minStep];
@@ -63,6 +63,16 @@ static const UInt MAX_INTRA_FILTER_DEPTHS=8;
 
 class IntraPrediction
 {
+public:
+  struct MMLM_parameter
+  {
+    Int Inf;  // Inferio boundary
+    Int Sup;  // Superior bounday
+    Int a;
+    Int b;
+    Int shift;
+  };
+
 private:
 
   Pel* m_piYuvExt[MAX_NUM_COMPONENT][NUM_PRED_BUF];
@@ -83,7 +93,7 @@ protected:
   Void xPredIntraPlanar           ( const CPelBuf &pSrc, PelBuf &pDst,                                                                                                           const SPS& sps );
   Void xPredIntraDc               ( const CPelBuf &pSrc, PelBuf &pDst, const ChannelType &channelType,                                                                                            const bool &enableBoundaryFilter = true );
   Void xPredIntraAng              ( const CPelBuf &pSrc, PelBuf &pDst, const ChannelType &channelType, const UInt &dirMode, const ClpRng& clpRng, const Bool &bEnableEdgeFilters, const SPS& sps, const bool &enableBoundaryFilter = true );
-  Pel  xGetPredValDc              ( const CPelBuf &pSrc, const Size &dstSize );
+  static Pel xGetPredValDc        ( const CPelBuf &pSrc, const Size &dstSize );
 
   void xFillReferenceSamples      ( const CPelBuf &recoBuf,      Pel* refBufUnfiltered, const CompArea &area, const CodingUnit &cu );
   void xFilterReferenceSamples    ( const Pel* refBufUnfiltered, Pel* refBufFiltered,   const CompArea &area, const SPS &sps );
@@ -102,15 +112,6 @@ protected:
 
   Void xFilterGroup               ( Pel* pMulDst[], Int i, Pel const* const piSrc, Int iRecStride, Bool bAboveAvaillable, Bool bLeftAvaillable);
 
-  struct MMLM_parameter
-  {
-    Int Inf;  // Inferio boundary
-    Int Sup;  // Superior bounday
-    Int a;
-    Int b;
-    Int shift;
-  };
-
   Int xCalcLMParametersGeneralized(Int x, Int y, Int xx, Int xy, Int count, Int bitDepth, Int &a, Int &b, Int &iShift);
   Int xLMSampleClassifiedTraining (Int count, Int LumaSamples[], Int ChrmSamples[], Int GroupNum, Int bitDepth, MMLM_parameter parameters[]);
   Int xGetMMLMParameters          (const PredictionUnit& pu, const ComponentID compID, CompArea chromaArea,  /*UInt uiWidth, UInt uiHeight,*/ Int &numClass, MMLM_parameter parameters[]);
@@ -120,6 +121,35 @@ public:
   IntraPrediction();
   virtual ~IntraPrediction();
 
+  // prediction kernels (C reference implementations, replaced by SIMD versions where available)
+  static Void xPredAngLinear      ( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle );
+  static Void xPredAng4Tap        ( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle, const ClpRng& clpRng );
+  static Void xPredPlanarCore     ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  static Void xPredDcCore         ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  static Void xFilterRefRow       ( const Pel* pSrc, Pel* pDst, Int num );
+  static Void xTransposeBlk       ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  static Void xLumaDownsample     ( const Pel* pRec, Int recStride, Pel* pDst, Int dstStride, Int width, Int height, Bool bLeftAvail );
+  static Void xLMSumsRow          ( const Pel* pSrc, const Pel* pCur, Int num, Int& x, Int& y, Int& xx, Int& xy );
+  static Void xLMClassSums        ( const Int* pLuma, const Int* pChroma, const Int* pTag, Int count, Int numGroups, Int x[], Int y[], Int xx[], Int xy[] );
+  static Void xLMApply2           ( const Pel* pLuma, Int lumaStride, Pel* pPred, Int predStride, Int width, Int height, const MMLM_parameter parameters[2], const ClpRng& clpRng );
+
+  Void ( *m_predAngLinear ) ( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle );
+  Void ( *m_predAng4Tap )   ( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle, const ClpRng& clpRng );
+  Void ( *m_predPlanar )    ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  Void ( *m_predDc )        ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  Void ( *m_filterRefRow )  ( const Pel* pSrc, Pel* pDst, Int num );
+  Void ( *m_transposeBlk )  ( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height );
+  Void ( *m_lumaDownsample )( const Pel* pRec, Int recStride, Pel* pDst, Int dstStride, Int width, Int height, Bool bLeftAvail );
+  Void ( *m_lmSumsRow )     ( const Pel* pSrc, const Pel* pCur, Int num, Int& x, Int& y, Int& xx, Int& xy );
+  Void ( *m_lmClassSums )   ( const Int* pLuma, const Int* pChroma, const Int* pTag, Int count, Int numGroups, Int x[], Int y[], Int xx[], Int xy[] );
+  Void ( *m_lmApply2 )      ( const Pel* pLuma, Int lumaStride, Pel* pPred, Int predStride, Int width, Int height, const MMLM_parameter parameters[2], const ClpRng& clpRng );
+
+#ifdef TARGET_SIMD_X86
+  Void initIntraPredictionX86();
+  template <X86_VEXT vext>
+  Void _initIntraPredictionX86();
+#endif
+
   Void init                       (ChromaFormat chromaFormatIDC, const unsigned bitDepthY);
 
   // Angular Intra
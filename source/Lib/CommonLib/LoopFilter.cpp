@@ -41,6 +41,7 @@
 #include "Unit.h"
 #include "UnitTools.h"
 #include "UnitPartitioner.h"
+#include "Profiler.h"
 #include "dtrace_codingstruct.h"
 
 //! \ingroup CommonLib
@@ -97,7 +98,16 @@ static bool isAvailableAbove( const CodingUnit& cu, const CodingUnit& cu2, const
 // ====================================================================================================================
 
 LoopFilter::LoopFilter()
+  : m_edgeSegments( nullptr )
 {
+  m_filterLumaSeg   = xFilterLumaSeg;
+  m_filterChromaSeg = xFilterChromaSeg;
+
+#if HHI_SIMD_OPT_DEBLOCK
+#ifdef TARGET_SIMD_X86
+  initLoopFilterX86();
+#endif
+#endif
 }
 
 LoopFilter::~LoopFilter()
@@ -133,6 +143,67 @@ void LoopFilter::destroy()
  \param  pcPic   picture class (Pic) pointer
  */
 void LoopFilter::loopFilterPic( CodingStructure& cs )
+{
+  PROFILE_SCOPE( PROF_DEBLOCK );
+
+  xDeblockPic( cs );
+
+  DTRACE_UPDATE  (g_trace_ctx, (std::make_pair("poc", cs.slice->getPOC())));
+
+  DTRACE_PIC_COMP(D_REC_CB_LUMA_LF,   cs, cs.getRecoBuf(), COMPONENT_Y);
+  DTRACE_PIC_COMP(D_REC_CB_CHROMA_LF, cs, cs.getRecoBuf(), COMPONENT_Cb);
+  DTRACE_PIC_COMP(D_REC_CB_CHROMA_LF, cs, cs.getRecoBuf(), COMPONENT_Cr);
+}
+
+/**
+ - collect the edge segments which loopFilterPic would filter with the current slice settings
+ .
+ The boundary strengths, the edge availability and the QPs do not depend on the beta and tc offsets, the segments
+ can thus be filtered with several offsets by filterEdgeSegments without traversing the CUs again.
+ */
+void LoopFilter::getEdgeSegments( CodingStructure& cs, std::vector<DeblockEdgeSegment>& edgeSegments )
+{
+  edgeSegments.clear();
+
+  m_edgeSegments = &edgeSegments;
+  xDeblockPic( cs );
+  m_edgeSegments = nullptr;
+}
+
+void LoopFilter::filterEdgeSegments( const CodingStructure& cs, const std::vector<DeblockEdgeSegment>& edgeSegments, PelUnitBuf& buf, const int betaOffsetDiv2, const int tcOffsetDiv2 ) const
+{
+  const SPS& sps = *cs.sps;
+  const int  bitdepthScale[MAX_NUM_CHANNEL_TYPE] = { 1 << ( sps.getBitDepth( CHANNEL_TYPE_LUMA ) - 8 ), 1 << ( sps.getBitDepth( CHANNEL_TYPE_CHROMA ) - 8 ) };
+
+  for( const auto& seg : edgeSegments )
+  {
+    const ComponentID compID   = ComponentID( seg.compID );
+    PelBuf            plane    = buf.get( compID );
+    Pel*              piSrc    = plane.bufAt( seg.x, seg.y );
+    const int         iOffset  = seg.edgeDir == EDGE_VER ? 1 : plane.stride;
+    const int         iSrcStep = seg.edgeDir == EDGE_VER ? plane.stride : 1;
+    const int         scale    = bitdepthScale[toChannelType( compID )];
+    const ClpRng&     clpRng   = cs.slice->clpRng( compID );
+
+    const int iIndexTC = Clip3<int>( 0, MAX_QP + DEFAULT_INTRA_TC_OFFSET, seg.qp + DEFAULT_INTRA_TC_OFFSET * ( seg.bs - 1 ) + ( tcOffsetDiv2 << 1 ) );
+    const int iTc      = sm_tcTable[iIndexTC] * scale;
+
+    if( compID == COMPONENT_Y )
+    {
+      const int iIndexB        = Clip3( 0, MAX_QP, seg.qp + ( betaOffsetDiv2 << 1 ) );
+      const int iBeta          = sm_betaTable[iIndexB] * scale;
+      const int iSideThreshold = ( iBeta + ( iBeta >> 1 ) ) >> 3;
+
+      m_filterLumaSeg( piSrc, iOffset, iSrcStep, iTc, iBeta, iSideThreshold, iTc * 10, seg.partPNoFilter, seg.partQNoFilter, clpRng );
+    }
+    else
+    {
+      m_filterChromaSeg( piSrc, iOffset, iSrcStep, seg.numLines, iTc, seg.partPNoFilter, seg.partQNoFilter, clpRng );
+    }
+  }
+}
+
+void LoopFilter::xDeblockPic( CodingStructure& cs )
 {
   const PreCalcValues& pcv = *cs.pcv;
 
@@ -200,12 +271,6 @@ void LoopFilter::loopFilterPic( CodingStructure& cs )
       }
     }
   }
-
-  DTRACE_UPDATE  (g_trace_ctx, (std::make_pair("poc", cs.slice->getPOC())));
-
-  DTRACE_PIC_COMP(D_REC_CB_LUMA_LF,   cs, cs.getRecoBuf(), COMPONENT_Y);
-  DTRACE_PIC_COMP(D_REC_CB_CHROMA_LF, cs, cs.getRecoBuf(), COMPONENT_Cb);
-  DTRACE_PIC_COMP(D_REC_CB_CHROMA_LF, cs, cs.getRecoBuf(), COMPONENT_Cr);
 }
 
 
@@ -273,6 +338,9 @@ void LoopFilter::xDeblockCU( CodingUnit& cu, const DeblockEdgeDir edgeDir )
 
   const unsigned uiPelsInPart = pcv.minCUWidth;
 
+  // the motion of both sides is read along the rows of the block motion
+  MotionField::RowCache rowCacheQ, rowCacheP;
+
   for( int y = 0; y < area.height; y += uiPelsInPart )
   {
     for( int x = 0; x < area.width; x += uiPelsInPart )
@@ -287,7 +355,7 @@ void LoopFilter::xDeblockCU( CodingUnit& cu, const DeblockEdgeDir edgeDir )
 
       if( m_aapbEdgeFilter[edgeDir][rasterIdx] && uiBSCheck )
       {
-        m_aapucBS[edgeDir][rasterIdx] = xGetBoundaryStrengthSingle( cu, edgeDir, localPos );
+        m_aapucBS[edgeDir][rasterIdx] = xGetBoundaryStrengthSingle( cu, edgeDir, localPos, rowCacheQ, rowCacheP );
       }
     }
   }
@@ -372,7 +440,7 @@ void LoopFilter::xSetLoopfilterParam( const CodingUnit& cu )
   m_stLFCUParam.topEdge  = ( 0 < pos.y ) && isAvailableAbove( cu, *cu.cs->getCU( pos.offset(  0, -1 ), cu.cs->chType ), !slice.getLFCrossSliceBoundaryFlag(), !pps.getLoopFilterAcrossTilesEnabledFlag() );
 }
 
-unsigned LoopFilter::xGetBoundaryStrengthSingle ( const CodingUnit& cu, const DeblockEdgeDir edgeDir, const Position& localPos ) const
+unsigned LoopFilter::xGetBoundaryStrengthSingle ( const CodingUnit& cu, const DeblockEdgeDir edgeDir, const Position& localPos, MotionField::RowCache& rowCacheQ, MotionField::RowCache& rowCacheP ) const
 {
   const Slice& sliceQ = *cu.slice;
 
@@ -404,23 +472,25 @@ unsigned LoopFilter::xGetBoundaryStrengthSingle ( const CodingUnit& cu, const De
   }
 
   // and now the pred
-  const MotionInfo&     miQ = cuQ.cs->getMotionInfo( posQ );
-  const MotionInfo&     miP = cuP.cs->getMotionInfo( posP );
-  const Slice&       sliceP = *cuP.slice;
+  const MotionField& motionQ = cuQ.cs->getBlockMotion();
+  const MotionField& motionP = cuP.cs->getBlockMotion();
+  const UInt         idxQ    = rowCacheQ.idx( motionQ, posQ.x, posQ.y );
+  const UInt         idxP    = rowCacheP.idx( motionP, posP.x, posP.y );
+  const Slice&       sliceP  = *cuP.slice;
 
   if (sliceQ.isInterB() || sliceP.isInterB())
   {
-    const Picture *piRefP0 = ( 0 > miP.refIdx[0] ) ? NULL : sliceP.getRefPic( REF_PIC_LIST_0, miP.refIdx[0] );
-    const Picture *piRefP1 = ( 0 > miP.refIdx[1] ) ? NULL : sliceP.getRefPic( REF_PIC_LIST_1, miP.refIdx[1] );
-    const Picture *piRefQ0 = ( 0 > miQ.refIdx[0] ) ? NULL : sliceQ.getRefPic( REF_PIC_LIST_0, miQ.refIdx[0] );
-    const Picture *piRefQ1 = ( 0 > miQ.refIdx[1] ) ? NULL : sliceQ.getRefPic( REF_PIC_LIST_1, miQ.refIdx[1] );
+    const Picture *piRefP0 = ( 0 > motionP.refIdx( idxP, REF_PIC_LIST_0 ) ) ? NULL : sliceP.getRefPic( REF_PIC_LIST_0, motionP.refIdx( idxP, REF_PIC_LIST_0 ) );
+    const Picture *piRefP1 = ( 0 > motionP.refIdx( idxP, REF_PIC_LIST_1 ) ) ? NULL : sliceP.getRefPic( REF_PIC_LIST_1, motionP.refIdx( idxP, REF_PIC_LIST_1 ) );
+    const Picture *piRefQ0 = ( 0 > motionQ.refIdx( idxQ, REF_PIC_LIST_0 ) ) ? NULL : sliceQ.getRefPic( REF_PIC_LIST_0, motionQ.refIdx( idxQ, REF_PIC_LIST_0 ) );
+    const Picture *piRefQ1 = ( 0 > motionQ.refIdx( idxQ, REF_PIC_LIST_1 ) ) ? NULL : sliceQ.getRefPic( REF_PIC_LIST_1, motionQ.refIdx( idxQ, REF_PIC_LIST_1 ) );
 
     Mv mvP0, mvP1, mvQ0, mvQ1;
 
-    if( 0 <= miP.refIdx[0] ) { mvP0 = miP.mv[0]; }
-    if( 0 <= miP.refIdx[1] ) { mvP1 = miP.mv[1]; }
-    if( 0 <= miQ.refIdx[0] ) { mvQ0 = miQ.mv[0]; }
-    if( 0 <= miQ.refIdx[1] ) { mvQ1 = miQ.mv[1]; }
+    if( 0 <= motionP.refIdx( idxP, REF_PIC_LIST_0 ) ) { mvP0 = motionP.mv( idxP, REF_PIC_LIST_0 ); }
+    if( 0 <= motionP.refIdx( idxP, REF_PIC_LIST_1 ) ) { mvP1 = motionP.mv( idxP, REF_PIC_LIST_1 ); }
+    if( 0 <= motionQ.refIdx( idxQ, REF_PIC_LIST_0 ) ) { mvQ0 = motionQ.mv( idxQ, REF_PIC_LIST_0 ); }
+    if( 0 <= motionQ.refIdx( idxQ, REF_PIC_LIST_1 ) ) { mvQ1 = motionQ.mv( idxQ, REF_PIC_LIST_1 ); }
 
     Int nThreshold = 4;
     if( cu.cs->sps->getSpsNext().getUseHighPrecMv() )
@@ -471,18 +541,18 @@ unsigned LoopFilter::xGetBoundaryStrengthSingle ( const CodingUnit& cu, const De
 
 
   // pcSlice->isInterP()
-  CHECK(0 > miP.refIdx[0], "Invalid reference picture list index");
-  CHECK(0 > miQ.refIdx[0], "Invalid reference picture list index");
-  const Picture *piRefP0 = sliceP.getRefPic(REF_PIC_LIST_0, miP.refIdx[0]);
-  const Picture *piRefQ0 = sliceQ.getRefPic(REF_PIC_LIST_0, miQ.refIdx[0]);
+  CHECK(0 > motionP.refIdx( idxP, REF_PIC_LIST_0 ), "Invalid reference picture list index");
+  CHECK(0 > motionQ.refIdx( idxQ, REF_PIC_LIST_0 ), "Invalid reference picture list index");
+  const Picture *piRefP0 = sliceP.getRefPic(REF_PIC_LIST_0, motionP.refIdx( idxP, REF_PIC_LIST_0 ));
+  const Picture *piRefQ0 = sliceQ.getRefPic(REF_PIC_LIST_0, motionQ.refIdx( idxQ, REF_PIC_LIST_0 ));
 
   if (piRefP0 != piRefQ0)
   {
     return 1;
   }
 
-  Mv mvP0 = miP.mv[0];
-  Mv mvQ0 = miQ.mv[0];
+  Mv mvP0 = motionP.mv( idxP, REF_PIC_LIST_0 );
+  Mv mvQ0 = motionQ.mv( idxQ, REF_PIC_LIST_0 );
 
   Int nThreshold = 4;
   if( cu.cs->sps->getSpsNext().getUseHighPrecMv() )
@@ -582,46 +652,36 @@ Void LoopFilter::xEdgeFilterLuma(const CodingUnit& cu, const DeblockEdgeDir edge
 
       const unsigned uiBlocksInPart = pelsInPart / 4 ? pelsInPart / 4 : 1;
 
-      for( int iBlkIdx = 0; iBlkIdx < uiBlocksInPart; iBlkIdx++ )
+      bPartPNoFilter = bPartQNoFilter = false;
+      if( bPCMFilter )
       {
-        const int dp0 = xCalcDP(piTmpSrc + iSrcStep*(iIdx*pelsInPart + iBlkIdx * 4 + 0), iOffset);
-        const int dq0 = xCalcDQ(piTmpSrc + iSrcStep*(iIdx*pelsInPart + iBlkIdx * 4 + 0), iOffset);
-        const int dp3 = xCalcDP(piTmpSrc + iSrcStep*(iIdx*pelsInPart + iBlkIdx * 4 + 3), iOffset);
-        const int dq3 = xCalcDQ(piTmpSrc + iSrcStep*(iIdx*pelsInPart + iBlkIdx * 4 + 3), iOffset);
-        const int d0 = dp0 + dq0;
-        const int d3 = dp3 + dq3;
-
-        const int dp = dp0 + dp3;
-        const int dq = dq0 + dq3;
-        const int d  = d0  + d3;
-
-        bPartPNoFilter = bPartQNoFilter = false;
-        if( bPCMFilter )
-        {
-          // Check if each of PUs is I_PCM with LF disabling
-          bPartPNoFilter = cuP.ipcm;
-          bPartQNoFilter = cuQ.ipcm;
-        }
-        if( ppsTransquantBypassEnabledFlag )
-        {
-          // check if each of PUs is lossless coded
-          bPartPNoFilter = bPartPNoFilter || cuP.transQuantBypass;
-          bPartQNoFilter = bPartQNoFilter || cuQ.transQuantBypass;
-        }
+        // Check if each of PUs is I_PCM with LF disabling
+        bPartPNoFilter = cuP.ipcm;
+        bPartQNoFilter = cuQ.ipcm;
+      }
+      if( ppsTransquantBypassEnabledFlag )
+      {
+        // check if each of PUs is lossless coded
+        bPartPNoFilter = bPartPNoFilter || cuP.transQuantBypass;
+        bPartQNoFilter = bPartQNoFilter || cuQ.transQuantBypass;
+      }
 
-        if( d < iBeta )
+      if( m_edgeSegments )
+      {
+        for( int iBlkIdx = 0; iBlkIdx < uiBlocksInPart; iBlkIdx++ )
         {
-          const bool bFilterP = (dp < iSideThreshold);
-          const bool bFilterQ = (dq < iSideThreshold);
+          const int along = iIdx * pelsInPart + iBlkIdx * 4;
+          const int x     = lumaArea.x + ( edgeDir == EDGE_VER ? iEdge * pelsInPart : along );
+          const int y     = lumaArea.y + ( edgeDir == EDGE_VER ? along : iEdge * pelsInPart );
 
-          const bool sw = xUseStrongFiltering( piTmpSrc + iSrcStep * ( iIdx*pelsInPart + iBlkIdx * 4 + 0 ), iOffset, 2 * d0, iBeta, iTc )
-                       && xUseStrongFiltering( piTmpSrc + iSrcStep * ( iIdx*pelsInPart + iBlkIdx * 4 + 3 ), iOffset, 2 * d3, iBeta, iTc );
-
-          for( int i = 0; i < DEBLOCK_SMALLEST_BLOCK / 2; i++ )
-          {
-            xPelFilterLuma( piTmpSrc + iSrcStep*( iIdx*pelsInPart + iBlkIdx * 4 + i ), iOffset, iTc, sw, bPartPNoFilter, bPartQNoFilter, iThrCut, bFilterP, bFilterQ, clpRng );
-          }
+          m_edgeSegments->push_back( DeblockEdgeSegment{ x, y, iQP, COMPONENT_Y, UChar( edgeDir ), UChar( uiBs ), 4, bPartPNoFilter, bPartQNoFilter } );
         }
+        continue;
+      }
+
+      for( int iBlkIdx = 0; iBlkIdx < uiBlocksInPart; iBlkIdx++ )
+      {
+        m_filterLumaSeg( piTmpSrc + iSrcStep * ( iIdx*pelsInPart + iBlkIdx * 4 ), iOffset, iSrcStep, iTc, iBeta, iSideThreshold, iThrCut, bPartPNoFilter, bPartQNoFilter, clpRng );
       }
     }
   }
@@ -764,13 +824,20 @@ void LoopFilter::xEdgeFilterChroma(const CodingUnit& cu, const DeblockEdgeDir ed
           iQP = getScaledChromaQP(iQP, sps.getChromaFormatIdc());
         }
 
+        if( m_edgeSegments )
+        {
+          const CompArea& chromaArea = cu.block( COMPONENT_Cb );
+          const int        x         = chromaArea.x + ( edgeDir == EDGE_VER ? iEdge * uiPelsInPartChromaH : iIdx * uiLoopLength );
+          const int        y         = chromaArea.y + ( edgeDir == EDGE_VER ? iIdx * uiLoopLength : iEdge * uiPelsInPartChromaV );
+
+          m_edgeSegments->push_back( DeblockEdgeSegment{ x, y, iQP, UChar( chromaIdx + 1 ), UChar( edgeDir ), UChar( ucBs ), UChar( uiLoopLength ), bPartPNoFilter, bPartQNoFilter } );
+          continue;
+        }
+
         const int iIndexTC = Clip3<int>( 0, MAX_QP + DEFAULT_INTRA_TC_OFFSET, iQP + DEFAULT_INTRA_TC_OFFSET*( ucBs - 1 ) + ( tcOffsetDiv2 << 1 ) );
         const int iTc      = sm_tcTable[iIndexTC] * iBitdepthScale;
 
-        for( unsigned uiStep = 0; uiStep < uiLoopLength; uiStep++ )
-        {
-          xPelFilterChroma( piTmpSrcChroma + iSrcStep*( uiStep + iIdx*uiLoopLength ), iOffset, iTc, bPartPNoFilter, bPartQNoFilter, clpRng );
-        }
+        m_filterChromaSeg( piTmpSrcChroma + iSrcStep*( iIdx*uiLoopLength ), iOffset, iSrcStep, uiLoopLength, iTc, bPartPNoFilter, bPartQNoFilter, clpRng );
       }
     }
   }
@@ -778,6 +845,66 @@ void LoopFilter::xEdgeFilterChroma(const CodingUnit& cu, const DeblockEdgeDir ed
 
 
 
+/**
+ - Deblocking of one 4-line segment of a luma edge, including the filter decisions
+ .
+ \param piSrc           pointer to the first line of the segment at the edge
+ \param iOffset         offset across the edge
+ \param iSrcStep        offset between the lines of the segment
+ \param tc              tc value
+ \param beta            beta value
+ \param sideThreshold   threshold for the decision to filter the second sample of each side
+ \param thrCut          threshold value for weak filter decision
+ \param bPartPNoFilter  indicator to disable filtering on partP
+ \param bPartQNoFilter  indicator to disable filtering on partQ
+ */
+void LoopFilter::xFilterLumaSeg( Pel* piSrc, const int iOffset, const int iSrcStep, const int tc, const int beta, const int sideThreshold, const int thrCut, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng )
+{
+  const int dp0 = xCalcDP( piSrc + iSrcStep * 0, iOffset );
+  const int dq0 = xCalcDQ( piSrc + iSrcStep * 0, iOffset );
+  const int dp3 = xCalcDP( piSrc + iSrcStep * 3, iOffset );
+  const int dq3 = xCalcDQ( piSrc + iSrcStep * 3, iOffset );
+  const int d0  = dp0 + dq0;
+  const int d3  = dp3 + dq3;
+
+  const int dp  = dp0 + dp3;
+  const int dq  = dq0 + dq3;
+  const int d   = d0  + d3;
+
+  if( d < beta )
+  {
+    const bool bFilterP = ( dp < sideThreshold );
+    const bool bFilterQ = ( dq < sideThreshold );
+
+    const bool sw = xUseStrongFiltering( piSrc + iSrcStep * 0, iOffset, 2 * d0, beta, tc )
+                 && xUseStrongFiltering( piSrc + iSrcStep * 3, iOffset, 2 * d3, beta, tc );
+
+    for( int i = 0; i < DEBLOCK_SMALLEST_BLOCK / 2; i++ )
+    {
+      xPelFilterLuma( piSrc + iSrcStep * i, iOffset, tc, sw, bPartPNoFilter, bPartQNoFilter, thrCut, bFilterP, bFilterQ, clpRng );
+    }
+  }
+}
+
+/**
+ - Deblocking of a segment of a chroma edge
+ .
+ \param piSrc           pointer to the first line of the segment at the edge
+ \param iOffset         offset across the edge
+ \param iSrcStep        offset between the lines of the segment
+ \param numLines        number of lines of the segment
+ \param tc              tc value
+ \param bPartPNoFilter  indicator to disable filtering on partP
+ \param bPartQNoFilter  indicator to disable filtering on partQ
+ */
+void LoopFilter::xFilterChromaSeg( Pel* piSrc, const int iOffset, const int iSrcStep, const int numLines, const int tc, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng )
+{
+  for( int i = 0; i < numLines; i++ )
+  {
+    xPelFilterChroma( piSrc + iSrcStep * i, iOffset, tc, bPartPNoFilter, bPartQNoFilter, clpRng );
+  }
+}
+
 /**
  - Deblocking for the luminance component with strong or weak filter
  .
@@ -792,7 +919,7 @@ void LoopFilter::xEdgeFilterChroma(const CodingUnit& cu, const DeblockEdgeDir ed
  \param bFilterSecondQ  decision weak filter/no filter for partQ
  \param bitDepthLuma    luma bit depth
 */
-inline void LoopFilter::xPelFilterLuma( Pel* piSrc, const int iOffset, const int tc, const bool sw, const bool bPartPNoFilter, const bool bPartQNoFilter, const int iThrCut, const bool bFilterSecondP, const bool bFilterSecondQ, const ClpRng& clpRng ) const
+inline void LoopFilter::xPelFilterLuma( Pel* piSrc, const int iOffset, const int tc, const bool sw, const bool bPartPNoFilter, const bool bPartQNoFilter, const int iThrCut, const bool bFilterSecondP, const bool bFilterSecondQ, const ClpRng& clpRng )
 {
   int delta;
 
@@ -864,7 +991,7 @@ inline void LoopFilter::xPelFilterLuma( Pel* piSrc, const int iOffset, const int
  \param bPartQNoFilter  indicator to disable filtering on partQ
  \param bitDepthChroma  chroma bit depth
  */
-inline void LoopFilter::xPelFilterChroma( Pel* piSrc, const int iOffset, const int tc, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng ) const
+inline void LoopFilter::xPelFilterChroma( Pel* piSrc, const int iOffset, const int tc, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng )
 {
   int delta;
 
@@ -896,7 +1023,7 @@ inline void LoopFilter::xPelFilterChroma( Pel* piSrc, const int iOffset, const i
  \param tc              tc value
  \param piSrc           pointer to picture data
  */
-inline bool LoopFilter::xUseStrongFiltering( Pel* piSrc, const int iOffset, const int d, const int beta, const int tc ) const
+inline bool LoopFilter::xUseStrongFiltering( Pel* piSrc, const int iOffset, const int d, const int beta, const int tc )
 {
   const Pel m4 = piSrc[ 0          ];
   const Pel m3 = piSrc[-iOffset    ];
@@ -908,12 +1035,12 @@ inline bool LoopFilter::xUseStrongFiltering( Pel* piSrc, const int iOffset, cons
   return ( ( d_strong < ( beta >> 3 ) ) && ( d < ( beta >> 2 ) ) && ( abs( m3 - m4 ) < ( ( tc * 5 + 1 ) >> 1 ) ) );
 }
 
-inline int LoopFilter::xCalcDP( Pel* piSrc, const int iOffset ) const
+inline int LoopFilter::xCalcDP( Pel* piSrc, const int iOffset )
 {
   return abs( piSrc[-iOffset * 3] - 2 * piSrc[-iOffset * 2] + piSrc[-iOffset] );
 }
 
-inline int LoopFilter::xCalcDQ( Pel* piSrc, const int iOffset ) const
+inline int LoopFilter::xCalcDQ( Pel* piSrc, const int iOffset )
 {
   return abs( piSrc[0] - 2 * piSrc[iOffset] + piSrc[iOffset * 2] );
 }
@@ -42,11 +42,34 @@
 #include "Unit.h"
 #include "Picture.h"
 
+#include <vector>
+
 //! \ingroup CommonLib
 //! \{
 
 #define DEBLOCK_SMALLEST_BLOCK  8
 
+/// edge segment of the deblocking filter with the parameters not depending on the beta and tc offsets of the slices
+struct DeblockEdgeSegment
+{
+  Int   x;                ///< position of the first sample on the Q side of the edge, in samples of the component
+  Int   y;
+  Int   qp;               ///< average QP of the P and Q sides, mapped to the chroma QP for the chroma components
+  UChar compID;
+  UChar edgeDir;
+  UChar bs;
+  UChar numLines;         ///< length of the segment along the edge
+  Bool  partPNoFilter;
+  Bool  partQNoFilter;
+
+  /// samples read or modified by the filtering of the segment
+  Area  area() const
+  {
+    const Int side = compID == COMPONENT_Y ? 4 : 2;
+    return edgeDir == EDGE_VER ? Area( x - side, y, 2 * side, numLines ) : Area( x, y - side, numLines, 2 * side );
+  }
+};
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -58,8 +81,12 @@ private:
   static_vector<char, MAX_NUM_PARTS_IN_CTU> m_aapucBS       [NUM_EDGE_DIR];         ///< Bs for [Ver/Hor][Y/U/V][Blk_Idx]
   static_vector<bool, MAX_NUM_PARTS_IN_CTU> m_aapbEdgeFilter[NUM_EDGE_DIR];
   LFCUParam m_stLFCUParam;                   ///< status structure
+  std::vector<DeblockEdgeSegment>* m_edgeSegments;                                  ///< when set, the edge segments are collected instead of filtered
 
 private:
+  /// picture-level deblocking, or collection of the edge segments
+  void xDeblockPic                ( CodingStructure& cs );
+
   /// CU-level deblocking function
   void xDeblockCU                 (       CodingUnit& cu, const DeblockEdgeDir edgeDir );
 
@@ -68,7 +95,7 @@ private:
 
   // filtering functions
   unsigned
-  xGetBoundaryStrengthSingle      ( const CodingUnit& cu, const DeblockEdgeDir edgeDir, const Position& localPos ) const;
+  xGetBoundaryStrengthSingle      ( const CodingUnit& cu, const DeblockEdgeDir edgeDir, const Position& localPos, MotionField::RowCache& rowCacheQ, MotionField::RowCache& rowCacheP ) const;
 
   void xSetEdgefilterMultiple     ( const CodingUnit&     cu,
                                     const DeblockEdgeDir  edgeDir,
@@ -86,12 +113,12 @@ private:
   void xEdgeFilterLuma            ( const CodingUnit& cu, const DeblockEdgeDir edgeDir, const int iEdge );
   void xEdgeFilterChroma          ( const CodingUnit& cu, const DeblockEdgeDir edgeDir, const int iEdge );
 
-  inline void xPelFilterLuma      ( Pel* piSrc, const int iOffset, const int tc, const bool sw, const bool bPartPNoFilter, const bool bPartQNoFilter, const int iThrCut, const bool bFilterSecondP, const bool bFilterSecondQ, const ClpRng& clpRng ) const;
-  inline void xPelFilterChroma    ( Pel* piSrc, const int iOffset, const int tc,                const bool bPartPNoFilter, const bool bPartQNoFilter,                                                                          const ClpRng& clpRng ) const;
+  static inline void xPelFilterLuma      ( Pel* piSrc, const int iOffset, const int tc, const bool sw, const bool bPartPNoFilter, const bool bPartQNoFilter, const int iThrCut, const bool bFilterSecondP, const bool bFilterSecondQ, const ClpRng& clpRng );
+  static inline void xPelFilterChroma    ( Pel* piSrc, const int iOffset, const int tc,                const bool bPartPNoFilter, const bool bPartQNoFilter,                                                                          const ClpRng& clpRng );
 
-  inline bool xUseStrongFiltering ( Pel* piSrc, const int iOffset, const int d, const int beta, const int tc ) const;
-  inline int xCalcDP              ( Pel* piSrc, const int iOffset ) const;
-  inline int xCalcDQ              ( Pel* piSrc, const int iOffset ) const;
+  static inline bool xUseStrongFiltering ( Pel* piSrc, const int iOffset, const int d, const int beta, const int tc );
+  static inline int xCalcDP              ( Pel* piSrc, const int iOffset );
+  static inline int xCalcDQ              ( Pel* piSrc, const int iOffset );
 
   static const UChar sm_tcTable[54];
   static const UChar sm_betaTable[52];
@@ -107,6 +134,24 @@ public:
   /// picture-level deblocking filter
   void loopFilterPic              ( CodingStructure& cs );
 
+  /// collects the edge segments of the picture in filtering order, without modifying the reconstruction
+  void getEdgeSegments            ( CodingStructure& cs, std::vector<DeblockEdgeSegment>& edgeSegments );
+  /// filters the collected edge segments in the buffer with the given beta and tc offsets, may run concurrently
+  void filterEdgeSegments         ( const CodingStructure& cs, const std::vector<DeblockEdgeSegment>& edgeSegments, PelUnitBuf& buf, const int betaOffsetDiv2, const int tcOffsetDiv2 ) const;
+
+  /// edge segment filters (C reference implementations, replaced by SIMD versions where available)
+  static void xFilterLumaSeg      ( Pel* piSrc, const int iOffset, const int iSrcStep, const int tc, const int beta, const int sideThreshold, const int thrCut, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng );
+  static void xFilterChromaSeg    ( Pel* piSrc, const int iOffset, const int iSrcStep, const int numLines, const int tc, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng );
+
+  void ( *m_filterLumaSeg )       ( Pel* piSrc, const int iOffset, const int iSrcStep, const int tc, const int beta, const int sideThreshold, const int thrCut, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng );
+  void ( *m_filterChromaSeg )     ( Pel* piSrc, const int iOffset, const int iSrcStep, const int numLines, const int tc, const bool bPartPNoFilter, const bool bPartQNoFilter, const ClpRng& clpRng );
+
+#ifdef TARGET_SIMD_X86
+  void initLoopFilterX86();
+  template <X86_VEXT vext>
+  void _initLoopFilterX86();
+#endif
+
   static int getBeta              ( const int qp )
   {
     const int indexB = Clip3( 0, MAX_QP, qp );
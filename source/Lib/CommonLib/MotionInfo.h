@@ -144,6 +144,234 @@ struct MotionInfo
   }
 };
 
+/// motion field stored as structure of arrays in blocks of ( 1 << log2BlkSize ) luma samples: the vectors, the
+/// reference indices, the flags and the slice indices are packed in separate arrays, the affine MVDs are not kept.
+/// Each coding structure keeps the motion of its coded blocks in a field at the motion storage granularity, read by
+/// the spatial merge and AMVP candidates and the deblocking boundary strength, and a finished picture keeps the
+/// field read by the temporal predictors (TMVP, sub-PU MVP, FRUC) at the motion compression granularity.
+class MotionField
+{
+  enum Flags
+  {
+    IS_INTER   = 1,
+    USES_LIC   = 2,
+    INTER_L0   = 4,
+    INTER_L1   = 8,
+    HIGH_PREC0 = 16,
+    HIGH_PREC1 = 32,
+  };
+
+  struct PackedMv
+  {
+    Int hor;
+    Int ver;
+  };
+
+public:
+  MotionField() : m_log2BlkSize( 0 ), m_stride( 0 ), m_originOffset( 0 ) {}
+
+  /// the field covers lumaWidth x lumaHeight samples starting at the origin, the positions are given in picture coordinates
+  void create( const UInt lumaWidth, const UInt lumaHeight, const UInt log2BlkSize, const Int originX = 0, const Int originY = 0 )
+  {
+    const UInt blkSize = 1 << log2BlkSize;
+
+    m_log2BlkSize = log2BlkSize;
+    m_stride      = ( lumaWidth + blkSize - 1 ) >> log2BlkSize;
+
+    const size_t size = m_stride * ( ( lumaHeight + blkSize - 1 ) >> log2BlkSize );
+
+    m_mv    [0].resize( size );
+    m_mv    [1].resize( size );
+    m_refIdx[0].resize( size );
+    m_refIdx[1].resize( size );
+    m_flags    .resize( size );
+    m_sliceIdx .resize( size );
+
+    setOrigin( originX, originY );
+  }
+
+  void destroy()
+  {
+    for( UInt i = 0; i < NUM_REF_PIC_LIST_01; i++ )
+    {
+      std::vector<PackedMv>().swap( m_mv    [i] );
+      std::vector<SChar>   ().swap( m_refIdx[i] );
+    }
+    std::vector<UChar> ().swap( m_flags );
+    std::vector<UShort>().swap( m_sliceIdx );
+  }
+
+  bool empty() const { return m_flags.empty(); }
+
+  /// moves the field to another position of the picture, for coding structures reused at several positions
+  void setOrigin( const Int originX, const Int originY ) { m_originOffset = Int( ( originY >> m_log2BlkSize ) * m_stride ) + ( originX >> m_log2BlkSize ); }
+
+  /// same content as a memset( 0 ) of MotionInfo: not inter, reference indices 0
+  void clear()
+  {
+    for( UInt i = 0; i < NUM_REF_PIC_LIST_01; i++ )
+    {
+      std::fill( m_mv    [i].begin(), m_mv    [i].end(), PackedMv{ 0, 0 } );
+      std::fill( m_refIdx[i].begin(), m_refIdx[i].end(), 0 );
+    }
+    std::fill( m_flags   .begin(), m_flags   .end(), 0 );
+    std::fill( m_sliceIdx.begin(), m_sliceIdx.end(), 0 );
+  }
+
+  UInt getLog2BlkSize() const { return m_log2BlkSize; }
+  UInt getStride()      const { return m_stride; }
+
+  UInt idx( const Int x, const Int y ) const { return UInt( Int( ( y >> m_log2BlkSize ) * m_stride ) + ( x >> m_log2BlkSize ) - m_originOffset ); }
+
+  void set( const UInt idx, const MotionInfo& mi )
+  {
+    m_flags[idx] = ( mi.isInter            ? IS_INTER   : 0 ) | ( mi.usesLIC            ? USES_LIC   : 0 )
+                 | ( mi.interDir & 1       ? INTER_L0   : 0 ) | ( mi.interDir & 2       ? INTER_L1   : 0 )
+                 | ( mi.mv[0].highPrec     ? HIGH_PREC0 : 0 ) | ( mi.mv[1].highPrec     ? HIGH_PREC1 : 0 );
+
+    for( UInt i = 0; i < NUM_REF_PIC_LIST_01; i++ )
+    {
+      m_mv    [i][idx].hor = mi.mv[i].hor;
+      m_mv    [i][idx].ver = mi.mv[i].ver;
+      m_refIdx[i][idx]     = SChar( mi.refIdx[i] );
+    }
+
+    m_sliceIdx[idx] = mi.sliceIdx;
+  }
+
+  /// copies the blocks of a luma area from a field of the same granularity, both fields have to cover the area
+  void copyFrom( const MotionField& src, const Int x, const Int y, const UInt width, const UInt height )
+  {
+    CHECKD( src.m_log2BlkSize != m_log2BlkSize, "The motion fields have to have the same granularity" );
+
+    const UInt numBlks = width >> m_log2BlkSize;
+
+    for( Int yPos = y; yPos < y + Int( height ); yPos += 1 << m_log2BlkSize )
+    {
+      const UInt dst = idx( x, yPos );
+      const UInt org = src.idx( x, yPos );
+
+      for( UInt i = 0; i < NUM_REF_PIC_LIST_01; i++ )
+      {
+        std::copy_n( &src.m_mv    [i][org], numBlks, &m_mv    [i][dst] );
+        std::copy_n( &src.m_refIdx[i][org], numBlks, &m_refIdx[i][dst] );
+      }
+      std::copy_n( &src.m_flags   [org], numBlks, &m_flags   [dst] );
+      std::copy_n( &src.m_sliceIdx[org], numBlks, &m_sliceIdx[dst] );
+    }
+  }
+
+  bool   isInter ( const UInt idx )                       const { return ( m_flags[idx] & IS_INTER ) != 0; }
+  bool   usesLIC ( const UInt idx )                       const { return ( m_flags[idx] & USES_LIC ) != 0; }
+  Int    interDir( const UInt idx )                       const { return ( m_flags[idx] & ( INTER_L0 | INTER_L1 ) ) >> 2; }
+  UShort sliceIdx( const UInt idx )                       const { return m_sliceIdx[idx]; }
+  Int    refIdx  ( const UInt idx, const RefPicList list ) const { return m_refIdx[list][idx]; }
+  Mv     mv      ( const UInt idx, const RefPicList list ) const
+  {
+    return Mv( m_mv[list][idx].hor, m_mv[list][idx].ver, ( m_flags[idx] & ( list == REF_PIC_LIST_0 ? HIGH_PREC0 : HIGH_PREC1 ) ) != 0 );
+  }
+  MvField mvField( const UInt idx, const RefPicList list ) const { return MvField( mv( idx, list ), refIdx( idx, list ) ); }
+
+  /// same comparison as MotionInfo::operator==, between blocks of this and another field
+  bool sameMotion( const UInt idx, const MotionField& other, const UInt otherIdx ) const
+  {
+    const UChar flags      = m_flags[idx];
+    const UChar otherFlags = other.m_flags[otherIdx];
+
+    if( ( flags & IS_INTER ) != ( otherFlags & IS_INTER ) ) return false;
+    if( !( flags & IS_INTER ) )                             return true;
+
+    if( m_sliceIdx[idx] != other.m_sliceIdx[otherIdx] )                                       return false;
+    if( ( flags & ( USES_LIC | INTER_L0 | INTER_L1 ) ) != ( otherFlags & ( USES_LIC | INTER_L0 | INTER_L1 ) ) ) return false;
+
+    const Int dir = interDir( idx );
+
+    for( UInt i = 0; i < NUM_REF_PIC_LIST_01; i++ )
+    {
+      if( dir != 2 - Int( i ) )
+      {
+        if( m_refIdx[i][idx] != other.m_refIdx[i][otherIdx] )                    return false;
+        if( mv( idx, RefPicList( i ) ) != other.mv( otherIdx, RefPicList( i ) ) ) return false;
+      }
+    }
+
+    return true;
+  }
+
+  MotionInfo get( const UInt idx ) const
+  {
+    MotionInfo mi;
+
+    mi.isInter  = isInter ( idx );
+    mi.usesLIC  = usesLIC ( idx );
+    mi.interDir = interDir( idx );
+    mi.sliceIdx = sliceIdx( idx );
+
+    for( UInt i = 0; i < NUM_REF_PIC_LIST_01; i++ )
+    {
+      mi.mv    [i] = mv( idx, RefPicList( i ) );
+      mi.refIdx[i] = m_refIdx[i][idx];
+    }
+
+    return mi;
+  }
+
+  MotionInfo get( const Int x, const Int y ) const { return get( idx( x, y ) ); }
+
+  /// accessor for one row of blocks, for scans reading horizontally neighbouring positions
+  class Row
+  {
+  public:
+    Row( const MotionField& field, const Int y ) : m_field( field ), m_offset( field.idx( 0, y ) ) {}
+
+    UInt       idx( const Int x ) const { return m_offset + ( x >> m_field.m_log2BlkSize ); }
+    bool       isInter( const Int x ) const { return m_field.isInter( idx( x ) ); }
+    MotionInfo get    ( const Int x ) const { return m_field.get    ( idx( x ) ); }
+
+  private:
+    const MotionField& m_field;
+    const UInt         m_offset;
+  };
+
+  Row row( const Int y ) const { return Row( *this, y ); }
+
+  /// block indices of neighbouring positions, the row offset is kept while the reads stay in one row of one field
+  class RowCache
+  {
+  public:
+    RowCache() : m_field( nullptr ), m_row( 0 ), m_offset( 0 ) {}
+
+    UInt idx( const MotionField& field, const Int x, const Int y )
+    {
+      const Int row = y >> field.m_log2BlkSize;
+
+      if( &field != m_field || row != m_row )
+      {
+        m_field  = &field;
+        m_row    = row;
+        m_offset = field.idx( 0, y );
+      }
+
+      return m_offset + ( x >> field.m_log2BlkSize );
+    }
+
+  private:
+    const MotionField* m_field;
+    Int                m_row;
+    UInt               m_offset;
+  };
+
+private:
+  UInt                  m_log2BlkSize;
+  UInt                  m_stride;
+  Int                   m_originOffset;  ///< block index of the picture origin relative to the first block
+
+  std::vector<PackedMv> m_mv      [NUM_REF_PIC_LIST_01];
+  std::vector<SChar>    m_refIdx  [NUM_REF_PIC_LIST_01];
+  std::vector<UChar>    m_flags;
+  std::vector<UShort>   m_sliceIdx;
+};
+
 
 
 #endif // __MOTIONINFO__
@@ -35,28 +35,43 @@
 #include "SEI.h"
 #include "libmd5/MD5.h"
 
+#include <thread>
+
 //! \ingroup CommonLib
 //! \{
 
+/// minimum number of luma samples for hashing the planes concurrently, for smaller pictures starting the threads costs more than it saves
+static const UInt PARALLEL_HASH_MIN_LUMA_SAMPLES = 1 << 18;
+
 /**
- * Update md5 using n samples from plane, each sample is adjusted to
- * OUTBIT_BITDEPTH_DIV8.
+ * Run planeHash for each plane of pic. For large pictures on multi-core
+ * systems the chroma planes are hashed on worker threads while the calling
+ * thread hashes the luma plane.
  */
-template<UInt OUTPUT_BITDEPTH_DIV8>
-static Void md5_block(MD5& md5, const Pel* plane, UInt n)
+template<typename PlaneHashFunc>
+static Void hashPlanes(const CPelUnitBuf& pic, PlaneHashFunc planeHash)
 {
-  /* create a 64 byte buffer for packing Pel's into */
-  UChar buf[64/OUTPUT_BITDEPTH_DIV8][OUTPUT_BITDEPTH_DIV8];
-  for (UInt i = 0; i < n; i++)
+  const UInt numComp = (UInt)pic.bufs.size();
+
+  if (numComp == 1 || pic.get(COMPONENT_Y).area() < PARALLEL_HASH_MIN_LUMA_SAMPLES || std::thread::hardware_concurrency() <= 1)
   {
-    Pel pel = plane[i];
-    /* perform bitdepth and endian conversion */
-    for (UInt d = 0; d < OUTPUT_BITDEPTH_DIV8; d++)
+    for (UInt chan = 0; chan < numComp; chan++)
     {
-      buf[i][d] = pel >> (d*8);
+      planeHash(ComponentID(chan));
     }
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  for (UInt chan = 1; chan < numComp; chan++)
+  {
+    workers.push_back(std::thread(planeHash, ComponentID(chan)));
+  }
+  planeHash(COMPONENT_Y);
+  for (auto &worker : workers)
+  {
+    worker.join();
   }
-  md5.update((UChar*)buf, n * OUTPUT_BITDEPTH_DIV8);
 }
 
 /**
@@ -66,61 +81,98 @@ static Void md5_block(MD5& md5, const Pel* plane, UInt n)
 template<UInt OUTPUT_BITDEPTH_DIV8>
 static Void md5_plane(MD5& md5, const Pel* plane, UInt width, UInt height, UInt stride)
 {
-  /* N is the number of samples to process per md5 update.
-   * All N samples must fit in buf */
-  UInt N = 32;
-  UInt width_modN = width % N;
-  UInt width_less_modN = width - width_modN;
+  /* 16 bit samples in little endian byte order are already in the byte order of the hash */
+  static const UShort endianTest = 1;
+  if (OUTPUT_BITDEPTH_DIV8 == 2 && sizeof(Pel) == 2 && *(const UChar*)&endianTest == 1)
+  {
+    for (UInt y = 0; y < height; y++)
+    {
+      md5.update((UChar*)&plane[y*stride], width * 2);
+    }
+    return;
+  }
+
+  /* convert each line into unsigned chars in little endian byte order.
+   * NB, for 8bit data, data is truncated to 8bits. */
+  std::vector<UChar> buf(width * OUTPUT_BITDEPTH_DIV8);
 
   for (UInt y = 0; y < height; y++)
   {
-    /* convert pels into unsigned chars in little endian byte order.
-     * NB, for 8bit data, data is truncated to 8bits. */
-    for (UInt x = 0; x < width_less_modN; x += N)
+    const Pel* line = &plane[y*stride];
+    if (OUTPUT_BITDEPTH_DIV8 == 1)
     {
-      md5_block<OUTPUT_BITDEPTH_DIV8>(md5, &plane[y*stride + x], N);
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+      g_pelBufOP.packLowBytes(line, buf.data(), width);
+#else
+      for (UInt x = 0; x < width; x++)
+      {
+        buf[x] = UChar(line[x]);
+      }
+#endif
     }
-
-    /* mop up any of the remaining line */
-    md5_block<OUTPUT_BITDEPTH_DIV8>(md5, &plane[y*stride + width_less_modN], width_modN);
+    else
+    {
+      for (UInt x = 0; x < width; x++)
+      {
+        for (UInt d = 0; d < OUTPUT_BITDEPTH_DIV8; d++)
+        {
+          buf[x * OUTPUT_BITDEPTH_DIV8 + d] = line[x] >> (d*8);
+        }
+      }
+    }
+    md5.update(buf.data(), width * OUTPUT_BITDEPTH_DIV8);
   }
 }
 
+/**
+ * CRC register after shifting the byte in its upper 8 bits out without input,
+ * the CRC is thus updated a byte at a time instead of bit by bit.
+ */
+struct CRCTable
+{
+  UShort entry[256];
+
+  CRCTable()
+  {
+    for (UInt byte = 0; byte < 256; byte++)
+    {
+      UInt crcVal = byte << 8;
+      for (UInt bitIdx = 0; bitIdx < 8; bitIdx++)
+      {
+        const UInt crcMsb = (crcVal >> 15) & 1;
+        crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
+      }
+      entry[byte] = UShort(crcVal);
+    }
+  }
+};
+
+static const CRCTable g_crcTable;
+
+static inline UInt crcUpdate(UInt crcVal, UInt byte)
+{
+  return ((crcVal << 8) & 0xffff) ^ byte ^ g_crcTable.entry[crcVal >> 8];
+}
 
 UInt compCRC(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, PictureHash &digest)
 {
-  UInt crcMsb;
-  UInt bitVal;
   UInt crcVal = 0xffff;
-  UInt bitIdx;
   for (UInt y = 0; y < height; y++)
   {
+    const Pel* line = &plane[y*stride];
     for (UInt x = 0; x < width; x++)
     {
       // take CRC of first pictureData byte
-      for(bitIdx=0; bitIdx<8; bitIdx++)
-      {
-        crcMsb = (crcVal >> 15) & 1;
-        bitVal = (plane[y*stride+x] >> (7 - bitIdx)) & 1;
-        crcVal = (((crcVal << 1) + bitVal) & 0xffff) ^ (crcMsb * 0x1021);
-      }
+      crcVal = crcUpdate(crcVal, line[x] & 0xff);
       // take CRC of second pictureData byte if bit depth is greater than 8-bits
       if(bitdepth > 8)
       {
-        for(bitIdx=0; bitIdx<8; bitIdx++)
-        {
-          crcMsb = (crcVal >> 15) & 1;
-          bitVal = (plane[y*stride+x] >> (15 - bitIdx)) & 1;
-          crcVal = (((crcVal << 1) + bitVal) & 0xffff) ^ (crcMsb * 0x1021);
-        }
+        crcVal = crcUpdate(crcVal, (line[x] >> 8) & 0xff);
       }
     }
   }
-  for(bitIdx=0; bitIdx<16; bitIdx++)
-  {
-    crcMsb = (crcVal >> 15) & 1;
-    crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
-  }
+  crcVal = crcUpdate(crcVal, 0);
+  crcVal = crcUpdate(crcVal, 0);
 
   digest.hash.push_back((crcVal>>8)  & 0xff);
   digest.hash.push_back( crcVal      & 0xff);
@@ -129,34 +181,51 @@ UInt compCRC(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt strid
 
 UInt calcCRC(const CPelUnitBuf& pic, PictureHash &digest, const BitDepths &bitDepths)
 {
-  UInt digestLen=0;
+  PictureHash planeDigest[MAX_NUM_COMPONENT];
+  UInt        planeDigestLen[MAX_NUM_COMPONENT] = { 0 };
+
+  hashPlanes(pic, [&](const ComponentID compID)
+  {
+    const CPelBuf area = pic.get(compID);
+    planeDigestLen[compID] = compCRC(bitDepths.recon[toChannelType(compID)], area.bufAt(0, 0), area.width, area.height, area.stride, planeDigest[compID] );
+  });
+
   digest.hash.clear();
   for (UInt chan = 0; chan< (UInt)pic.bufs.size(); chan++)
   {
-    const ComponentID compID = ComponentID(chan);
-    const CPelBuf area = pic.get(compID);
-    digestLen = compCRC(bitDepths.recon[toChannelType(compID)], area.bufAt(0, 0), area.width, area.height, area.stride, digest );
+    digest.hash.insert(digest.hash.end(), planeDigest[chan].hash.begin(), planeDigest[chan].hash.end());
   }
-  return digestLen;
+  return planeDigestLen[COMPONENT_Y];
 }
 
 UInt compChecksum(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, PictureHash &digest, const BitDepths &/*bitDepths*/)
 {
   UInt checksum = 0;
-  UChar xor_mask;
 
   for (UInt y = 0; y < height; y++)
   {
-    for (UInt x = 0; x < width; x++)
-    {
-      xor_mask = (x & 0xff) ^ (y & 0xff) ^ (x >> 8) ^ (y >> 8);
-      checksum = (checksum + ((plane[y*stride+x] & 0xff) ^ xor_mask)) & 0xffffffff;
+    const Pel* line   = &plane[y*stride];
+    const UInt yMask  = (y & 0xff) ^ (y >> 8);
+    UInt       lineSum = 0;
 
-      if(bitdepth > 8)
+    // the sum of a line does not overflow, the checksum is accumulated modulo 2^32
+    if (bitdepth > 8)
+    {
+      for (UInt x = 0; x < width; x++)
+      {
+        const UInt xor_mask = ((x & 0xff) ^ (x >> 8) ^ yMask) & 0xff;
+        lineSum += ((line[x] & 0xff) ^ xor_mask) + ((line[x] >> 8) ^ xor_mask);
+      }
+    }
+    else
+    {
+      for (UInt x = 0; x < width; x++)
       {
-        checksum = (checksum + ((plane[y*stride+x]>>8) ^ xor_mask)) & 0xffffffff;
+        const UInt xor_mask = ((x & 0xff) ^ (x >> 8) ^ yMask) & 0xff;
+        lineSum += (line[x] & 0xff) ^ xor_mask;
       }
     }
+    checksum += lineSum;
   }
 
   digest.hash.push_back((checksum>>24) & 0xff);
@@ -168,15 +237,21 @@ UInt compChecksum(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt
 
 UInt calcChecksum(const CPelUnitBuf& pic, PictureHash &digest, const BitDepths &bitDepths)
 {
-  UInt digestLen=0;
-  digest.hash.clear();
-  for(UInt chan=0; chan< (UInt)pic.bufs.size(); chan++)
+  PictureHash planeDigest[MAX_NUM_COMPONENT];
+  UInt        planeDigestLen[MAX_NUM_COMPONENT] = { 0 };
+
+  hashPlanes(pic, [&](const ComponentID compID)
   {
-    const ComponentID compID=ComponentID(chan);
     const CPelBuf area = pic.get(compID);
-    digestLen=compChecksum(bitDepths.recon[toChannelType(compID)], area.bufAt(0,0), area.width, area.height, area.stride, digest, bitDepths);
+    planeDigestLen[compID] = compChecksum(bitDepths.recon[toChannelType(compID)], area.bufAt(0,0), area.width, area.height, area.stride, planeDigest[compID], bitDepths);
+  });
+
+  digest.hash.clear();
+  for (UInt chan = 0; chan< (UInt)pic.bufs.size(); chan++)
+  {
+    digest.hash.insert(digest.hash.end(), planeDigest[chan].hash.begin(), planeDigest[chan].hash.end());
   }
-  return digestLen;
+  return planeDigestLen[COMPONENT_Y];
 }
 /**
  * Calculate the MD5sum of pic, storing the result in digest.
@@ -187,25 +262,26 @@ UInt calcChecksum(const CPelUnitBuf& pic, PictureHash &digest, const BitDepths &
  */
 UInt calcMD5(const CPelUnitBuf& pic, PictureHash &digest, const BitDepths &bitDepths)
 {
-  /* choose an md5_plane packing function based on the system bitdepth */
-  typedef Void (*MD5PlaneFunc)(MD5&, const Pel*, UInt, UInt, UInt);
-  MD5PlaneFunc md5_plane_func;
+  UChar planeDigest[MAX_NUM_COMPONENT][MD5_DIGEST_STRING_LENGTH];
 
-  MD5 md5[MAX_NUM_COMPONENT];
+  hashPlanes(pic, [&](const ComponentID compID)
+  {
+    /* choose an md5_plane packing function based on the system bitdepth */
+    typedef Void (*MD5PlaneFunc)(MD5&, const Pel*, UInt, UInt, UInt);
+    const MD5PlaneFunc md5_plane_func = bitDepths.recon[toChannelType(compID)] <= 8 ? (MD5PlaneFunc)md5_plane<1> : (MD5PlaneFunc)md5_plane<2>;
 
-  digest.hash.clear();
+    MD5 md5;
+    const CPelBuf area = pic.get(compID);
+    md5_plane_func(md5, area.bufAt(0, 0), area.width, area.height, area.stride );
+    md5.finalize(planeDigest[compID]);
+  });
 
+  digest.hash.clear();
   for (UInt chan = 0; chan< (UInt)pic.bufs.size(); chan++)
   {
-    const ComponentID compID=ComponentID(chan);
-    const CPelBuf area = pic.get(compID);
-    md5_plane_func = bitDepths.recon[toChannelType(compID)] <= 8 ? (MD5PlaneFunc)md5_plane<1> : (MD5PlaneFunc)md5_plane<2>;
-    UChar tmp_digest[MD5_DIGEST_STRING_LENGTH];
-    md5_plane_func(md5[compID], area.bufAt(0, 0), area.width, area.height, area.stride );
-    md5[compID].finalize(tmp_digest);
     for(UInt i=0; i<MD5_DIGEST_STRING_LENGTH; i++)
     {
-      digest.hash.push_back(tmp_digest[i]);
+      digest.hash.push_back(planeDigest[chan][i]);
     }
   }
   return 16;
@@ -229,7 +305,7 @@ std::string hashToString(const PictureHash &digest, Int numChar)
   return result;
 }
 
-int calcAndPrintHashStatus(const CPelUnitBuf& pic, const SEIDecodedPictureHash* pictureHashSEI, const BitDepths &bitDepths, const MsgLevel msgl)
+int calcHashStatus(const CPelUnitBuf& pic, const SEIDecodedPictureHash* pictureHashSEI, const BitDepths &bitDepths, std::string &status)
 {
   /* calculate MD5sum for entire reconstructed picture */
   PictureHash recon_digest;
@@ -280,13 +356,22 @@ int calcAndPrintHashStatus(const CPelUnitBuf& pic, const SEIDecodedPictureHash*
     }
   }
 
-  msg( msgl, "[%s:%s,%s] ", hashType, hashToString(recon_digest, numChar).c_str(), ok);
+  status = std::string("[") + hashType + ":" + hashToString(recon_digest, numChar) + "," + ok + "] ";
 
   if (mismatch)
   {
-    msg( msgl, "[rx%s:%s] ", hashType, hashToString(pictureHashSEI->m_pictureHash, numChar).c_str());
+    status += std::string("[rx") + hashType + ":" + hashToString(pictureHashSEI->m_pictureHash, numChar) + "] ";
   }
   return mismatch;
 }
 
+int calcAndPrintHashStatus(const CPelUnitBuf& pic, const SEIDecodedPictureHash* pictureHashSEI, const BitDepths &bitDepths, const MsgLevel msgl)
+{
+  std::string status;
+  const int   mismatch = calcHashStatus(pic, pictureHashSEI, bitDepths, status);
+
+  msg( msgl, "%s", status.c_str());
+  return mismatch;
+}
+
 //! \}
@@ -38,6 +38,7 @@
 #include "Picture.h"
 #include "SEI.h"
 #include "ChromaFormat.h"
+#include "BufferPool.h"
 
 // ---------------------------------------------------------------------------
 // picture methods
@@ -318,6 +319,7 @@ Picture::Picture()
 {
   tileMap              = nullptr;
   cs                   = nullptr;
+  m_tempBufPool        = nullptr;
   m_bIsBorderExtended  = false;
   usedByCurr           = false;
   longTerm             = false;
@@ -325,6 +327,7 @@ Picture::Picture()
   neededForOutput      = false;
   referenced           = false;
   layer                = std::numeric_limits<UInt>::max();
+  memset( wpAcDcParam, 0, sizeof( wpAcDcParam ) );
 }
 
 
@@ -344,11 +347,24 @@ Void Picture::create(const ChromaFormat &_chromaFormat, const Size &size, const
 
 Void Picture::destroy()
 {
+  if( m_tempBufPool )
+  {
+    destroyTempBuffers();
+  }
   for (UInt t = 0; t < NUM_PIC_TYPES; t++)
   {
     m_bufs[t].destroy();
   }
 
+  for( UInt fracY = 0; fracY < 4; fracY++ )
+  {
+    for( UInt fracX = 0; fracX < 4; fracX++ )
+    {
+      m_subPelBufs[fracY][fracX].destroy();
+    }
+  }
+  m_subPelRowValid.clear();
+
   if( cs )
   {
     cs->destroy();
@@ -376,12 +392,22 @@ Void Picture::destroy()
   }
 }
 
-Void Picture::createTempBuffers( const unsigned _maxCUSize )
+Void Picture::createTempBuffers( const unsigned _maxCUSize, BufferPool* pool )
 {
   const Area a( Position{ 0, 0 }, lumaSize() );
 
-  m_bufs[PIC_PREDICTION].create( chromaFormat, a, _maxCUSize );
-  m_bufs[PIC_RESIDUAL].  create( chromaFormat, a, _maxCUSize );
+  m_tempBufPool = pool;
+
+  if( pool )
+  {
+    pool->createPelStorage( m_bufs[PIC_PREDICTION], chromaFormat, a, _maxCUSize );
+    pool->createPelStorage( m_bufs[PIC_RESIDUAL],   chromaFormat, a, _maxCUSize );
+  }
+  else
+  {
+    m_bufs[PIC_PREDICTION].create( chromaFormat, a, _maxCUSize );
+    m_bufs[PIC_RESIDUAL].  create( chromaFormat, a, _maxCUSize );
+  }
 
   if( cs ) cs->rebindPicBufs();
 }
@@ -390,12 +416,42 @@ Void Picture::destroyTempBuffers()
 {
   for( UInt t = 0; t < NUM_PIC_TYPES; t++ )
   {
-    if( t != PIC_RECONSTRUCTION && t != PIC_ORIGINAL ) m_bufs[t].destroy();
+    if( t != PIC_RECONSTRUCTION && t != PIC_ORIGINAL )
+    {
+      if( m_tempBufPool ) m_tempBufPool->destroyPelStorage( m_bufs[t] );
+      else                m_bufs[t].destroy();
+    }
   }
+  m_tempBufPool = nullptr;
 
   if( cs ) cs->rebindPicBufs();
 }
 
+Void Picture::createSubPelBuffers( const unsigned _maxCUSize )
+{
+  const Area a( Position{ 0, 0 }, lumaSize() );
+
+  for( UInt fracY = 0; fracY < 4; fracY++ )
+  {
+    for( UInt fracX = 0; fracX < 4; fracX++ )
+    {
+      if( fracX || fracY )
+      {
+        // same geometry as the luma reconstruction, so that block offsets can be shared between the planes
+        m_subPelBufs[fracY][fracX].create( CHROMA_400, a, _maxCUSize, margin, MEMORY_ALIGN_DEF_SIZE );
+        CHECK( m_subPelBufs[fracY][fracX].Y().stride != m_bufs[PIC_RECONSTRUCTION].Y().stride, "Sub-pel plane stride differs from the reconstruction" );
+      }
+    }
+  }
+
+  m_subPelRowValid.resize( ( lumaSize().height + 2 * margin + _maxCUSize - 1 ) / _maxCUSize, false );
+}
+
+Void Picture::invalidateSubPelBuffers()
+{
+  std::fill( m_subPelRowValid.begin(), m_subPelRowValid.end(), false );
+}
+
        PelBuf     Picture::getOrigBuf(const CompArea &blk)        { return getBuf(blk,  PIC_ORIGINAL); }
 const CPelBuf     Picture::getOrigBuf(const CompArea &blk)  const { return getBuf(blk,  PIC_ORIGINAL); }
        PelUnitBuf Picture::getOrigBuf(const UnitArea &unit)       { return getBuf(unit, PIC_ORIGINAL); }  
@@ -545,6 +601,7 @@ void Picture::extendPicBorder()
   }
 
   m_bIsBorderExtended = true;
+  invalidateSubPelBuffers();
 }
 
 
@@ -50,6 +50,9 @@
 #include <deque>
 
 
+class BufferPool;
+
+
 class SEI;
 class AQpLayer;
 
@@ -119,9 +122,13 @@ struct Picture : public UnitArea
 
   Void destroy();
 
-  Void createTempBuffers( const unsigned _maxCUSize );
+  Void createTempBuffers( const unsigned _maxCUSize, BufferPool* pool = nullptr );   ///< pooled buffers are returned to the pool by destroyTempBuffers() and destroy()
   Void destroyTempBuffers();
 
+  Void createSubPelBuffers( const unsigned _maxCUSize );
+  Void invalidateSubPelBuffers();
+  Bool hasSubPelBuffers() const                     { return !m_subPelRowValid.empty(); }
+
          PelBuf     getOrigBuf(const CompArea &blk);
   const CPelBuf     getOrigBuf(const CompArea &blk) const;
          PelUnitBuf getOrigBuf(const UnitArea &unit);
@@ -155,7 +162,7 @@ struct Picture : public UnitArea
   void finalInit( const SPS& sps, const PPS& pps );
 
   int  getPOC()                               const { return poc; }
-  Void setBorderExtension( bool bFlag)              { m_bIsBorderExtended = bFlag;}
+  Void setBorderExtension( bool bFlag)              { m_bIsBorderExtended = bFlag; if( !bFlag ) invalidateSubPelBuffers(); }
 
   Void setPrevQP(Int qp)                            { m_prevQP = qp; }
   Int& getPrevQP()                                  { return m_prevQP; }
@@ -176,6 +183,12 @@ public:
   UInt depth;
 
   PelStorage m_bufs[NUM_PIC_TYPES];
+  BufferPool* m_tempBufPool;          ///< pool of the prediction and residual buffers, null if not pooled
+
+  // luma reconstruction interpolated at the quarter-sample phases [fracY][fracX] (encoder only, [0][0] unused),
+  // filled lazily per CTU row by the fractional motion estimation, hence mutable
+  mutable PelStorage        m_subPelBufs[4][4];
+  mutable std::vector<Bool> m_subPelRowValid;
 
   CodingStructure*   cs;
   std::deque<Slice*> slices;
@@ -188,9 +201,14 @@ public:
   TileMap*     tileMap;
   std::vector<AQpLayer*> aqlayer;
 
+  // weighted prediction analysis of the original picture (encoder only)
+  WPACDCParam            wpAcDcParam[MAX_NUM_COMPONENT];
+  std::vector<Int>       orgHistogram[MAX_NUM_COMPONENT];
+
 };
 
 class SEIDecodedPictureHash;
+int calcHashStatus(const CPelUnitBuf& pic, const SEIDecodedPictureHash* pictureHashSEI, const BitDepths &bitDepths, std::string &status);
 int calcAndPrintHashStatus(const CPelUnitBuf& pic, const SEIDecodedPictureHash* pictureHashSEI, const BitDepths &bitDepths, const MsgLevel msgl);
 
 void smoothResidual( PelBuf& resBuf, const CPelBuf& orgBuf, const ClpRng& clpRng );
@@ -0,0 +1,448 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     Profiler.cpp
+    \brief    scoped timers of the major encoder and decoder stages
+*/
+
+#include "Profiler.h"
+#include "Rom.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+#define PROFILER_USE_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define PROFILER_USE_TSC 0
+#endif
+
+//! \ingroup CommonLib
+//! \{
+
+static const char* const g_profStageNames[NUM_PROF_STAGES] =
+{
+  "EncCtu",
+  "MergeSkip",
+  "MergeFruc",
+  "InterMe",
+  "Affine",
+  "Intra",
+  "IPCM",
+  "MotionEstimation",
+  "FracSearch",
+  "IntraSearchLuma",
+  "IntraSearchChroma",
+  "RDOQ",
+  "Deblock",
+  "SAO",
+  "ALF",
+  "Parse",
+  "Reconstruct",
+};
+
+static const Int PROF_NUM_SIZES = 8;   ///< block sizes are accumulated per log2 width and log2 height
+static const Int PROF_ROOT      = 0;
+
+struct ProfNode
+{
+  Int     stage;                       ///< NUM_PROF_STAGES for the root
+  UInt64  self;                        ///< ticks spent in the stage, excluding the nested stages
+  UInt64  calls;
+  Int     child[NUM_PROF_STAGES];
+
+  ProfNode( Int _stage ) : stage( _stage ), self( 0 ), calls( 0 ) { std::fill( child, child + NUM_PROF_STAGES, -1 ); }
+};
+
+struct ProfFrame
+{
+  Int     node;
+  UInt64  start;
+  UInt64  childTicks;                  ///< ticks of the nested scopes
+  Int     sizeIdx;                     ///< -1: no block size, or recursive entry
+};
+
+struct ProfThreadData
+{
+  std::mutex             mutex;        ///< held by the thread while a scope is active, the report reads the data under it
+  std::vector<ProfNode>  nodes;
+  std::vector<ProfFrame> stack;
+  UInt64                 sizeTicks[NUM_PROF_STAGES][PROF_NUM_SIZES * PROF_NUM_SIZES];
+  UInt64                 sizeCalls[NUM_PROF_STAGES][PROF_NUM_SIZES * PROF_NUM_SIZES];
+
+  ProfThreadData()
+  {
+    nodes.push_back( ProfNode( NUM_PROF_STAGES ) );
+    stack.reserve( 64 );
+    std::fill( &sizeTicks[0][0], &sizeTicks[0][0] + NUM_PROF_STAGES * PROF_NUM_SIZES * PROF_NUM_SIZES, 0 );
+    std::fill( &sizeCalls[0][0], &sizeCalls[0][0] + NUM_PROF_STAGES * PROF_NUM_SIZES * PROF_NUM_SIZES, 0 );
+  }
+};
+
+Bool Profiler::s_enabled = false;
+
+static std::mutex                                  s_profMutex;
+static std::vector<ProfThreadData*>                s_profThreads;   // never freed, the report may outlive the threads
+static std::string                                 s_profJsonFileName;
+static UInt64                                      s_profStartTicks = 0;
+static std::chrono::steady_clock::time_point       s_profStartTime;
+
+static inline UInt64 xProfTicks()
+{
+#if PROFILER_USE_TSC
+  return __rdtsc();
+#else
+  return UInt64( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+}
+
+static ProfThreadData& xProfThreadData()
+{
+  static thread_local ProfThreadData* threadData = nullptr;
+
+  if( !threadData )
+  {
+    threadData = new ProfThreadData;
+    std::lock_guard<std::mutex> lock( s_profMutex );
+    s_profThreads.push_back( threadData );
+  }
+  return *threadData;
+}
+
+static Int xProfSizeIdx( UInt size )
+{
+  Int log2Size = 0;
+  while( log2Size < PROF_NUM_SIZES - 1 && ( 2u << log2Size ) <= size )
+  {
+    log2Size++;
+  }
+  return log2Size;
+}
+
+Void Profiler::enable( const std::string& jsonFileName )
+{
+  if( !s_enabled )
+  {
+    s_profJsonFileName = jsonFileName;
+    s_profStartTime    = std::chrono::steady_clock::now();
+    s_profStartTicks   = xProfTicks();
+    s_enabled          = true;
+  }
+}
+
+Void Profiler::enter( ProfStage stage, UInt width, UInt height )
+{
+  ProfThreadData& data = xProfThreadData();
+  const UInt64    now  = xProfTicks();
+
+  // fold recursive entries into the outer entry of the stage
+  Int node = -1;
+  for( Int i = Int( data.stack.size() ) - 1; i >= 0; i-- )
+  {
+    if( data.nodes[data.stack[i].node].stage == stage )
+    {
+      node = data.stack[i].node;
+      break;
+    }
+  }
+
+  const Bool recursive = node >= 0;
+
+  if( data.stack.empty() )
+  {
+    data.mutex.lock();
+  }
+
+  if( !recursive )
+  {
+    const Int parent = data.stack.empty() ? PROF_ROOT : data.stack.back().node;
+    node             = data.nodes[parent].child[stage];
+    if( node < 0 )
+    {
+      node = Int( data.nodes.size() );
+      data.nodes.push_back( ProfNode( stage ) );
+      data.nodes[parent].child[stage] = node;
+    }
+  }
+
+  ProfFrame frame;
+  frame.node       = node;
+  frame.start      = now;
+  frame.childTicks = 0;
+  frame.sizeIdx    = ( width && height && !recursive ) ? xProfSizeIdx( width ) * PROF_NUM_SIZES + xProfSizeIdx( height ) : -1;
+  data.stack.push_back( frame );
+}
+
+Void Profiler::leave()
+{
+  ProfThreadData& data  = xProfThreadData();
+  const ProfFrame frame = data.stack.back();
+  const UInt64    ticks = xProfTicks() - frame.start;
+
+  data.stack.pop_back();
+
+  ProfNode& node = data.nodes[frame.node];
+  node.self     += ticks - std::min( ticks, frame.childTicks );
+  node.calls    ++;
+
+  if( !data.stack.empty() )
+  {
+    data.stack.back().childTicks += ticks;
+  }
+  if( frame.sizeIdx >= 0 )
+  {
+    data.sizeTicks[node.stage][frame.sizeIdx] += ticks;
+    data.sizeCalls[node.stage][frame.sizeIdx] ++;
+  }
+
+  if( data.stack.empty() )
+  {
+    data.mutex.unlock();
+  }
+}
+
+// ====================================================================================================================
+// Report
+// ====================================================================================================================
+
+/// merges the call tree of a thread into the aggregated call tree
+static Void xProfMergeTree( const std::vector<ProfNode>& src, Int srcNode, std::vector<ProfNode>& dst, Int dstNode )
+{
+  dst[dstNode].self  += src[srcNode].self;
+  dst[dstNode].calls += src[srcNode].calls;
+
+  for( Int stage = 0; stage < NUM_PROF_STAGES; stage++ )
+  {
+    const Int srcChild = src[srcNode].child[stage];
+    if( srcChild < 0 )
+    {
+      continue;
+    }
+    Int dstChild = dst[dstNode].child[stage];
+    if( dstChild < 0 )
+    {
+      dstChild = Int( dst.size() );
+      dst.push_back( ProfNode( stage ) );
+      dst[dstNode].child[stage] = dstChild;
+    }
+    xProfMergeTree( src, srcChild, dst, dstChild );
+  }
+}
+
+static UInt64 xProfTotal( const std::vector<ProfNode>& nodes, Int node )
+{
+  UInt64 total = nodes[node].self;
+  for( Int stage = 0; stage < NUM_PROF_STAGES; stage++ )
+  {
+    if( nodes[node].child[stage] >= 0 )
+    {
+      total += xProfTotal( nodes, nodes[node].child[stage] );
+    }
+  }
+  return total;
+}
+
+Double Profiler::getStageSeconds( ProfStage stage )
+{
+  if( !s_enabled )
+  {
+    return 0;
+  }
+
+  CHECK( !xProfThreadData().stack.empty(), "Stage time requested inside a profiled scope" );
+
+  const Double elapsed      = std::chrono::duration<Double>( std::chrono::steady_clock::now() - s_profStartTime ).count();
+  const UInt64 elapsedTicks = xProfTicks() - s_profStartTicks;
+
+  // recursive entries are folded, so the nodes of a stage never nest
+  UInt64 ticks = 0;
+  std::lock_guard<std::mutex> lock( s_profMutex );
+  for( ProfThreadData* data : s_profThreads )
+  {
+    // wait until the scopes of the thread are closed
+    std::lock_guard<std::mutex> threadLock( data->mutex );
+    for( Int node = PROF_ROOT + 1; node < Int( data->nodes.size() ); node++ )
+    {
+      if( data->nodes[node].stage == stage )
+      {
+        ticks += xProfTotal( data->nodes, node );
+      }
+    }
+  }
+
+  return elapsedTicks > 0 ? ticks * elapsed / Double( elapsedTicks ) : 0;
+}
+
+struct ProfReportLine
+{
+  std::string path;
+  Int         depth;
+  Int         stage;
+  UInt64      calls;
+  Double      self;
+  Double      total;
+};
+
+static Void xProfFlatten( const std::vector<ProfNode>& nodes, Int node, const std::string& path, Int depth, Double secondsPerTick, std::vector<ProfReportLine>& lines )
+{
+  for( Int stage = 0; stage < NUM_PROF_STAGES; stage++ )
+  {
+    const Int child = nodes[node].child[stage];
+    if( child < 0 )
+    {
+      continue;
+    }
+    ProfReportLine line;
+    line.path  = path.empty() ? g_profStageNames[stage] : path + "/" + g_profStageNames[stage];
+    line.depth = depth;
+    line.stage = stage;
+    line.calls = nodes[child].calls;
+    line.self  = nodes[child].self * secondsPerTick;
+    line.total = xProfTotal( nodes, child ) * secondsPerTick;
+    lines.push_back( line );
+    xProfFlatten( nodes, child, line.path, depth + 1, secondsPerTick, lines );
+  }
+}
+
+Void Profiler::report()
+{
+  if( !s_enabled )
+  {
+    return;
+  }
+
+  CHECK( !xProfThreadData().stack.empty(), "Profile report requested inside a profiled scope" );
+
+  const Double elapsed        = std::chrono::duration<Double>( std::chrono::steady_clock::now() - s_profStartTime ).count();
+  const UInt64 elapsedTicks   = xProfTicks() - s_profStartTicks;
+  const Double secondsPerTick = elapsedTicks > 0 ? elapsed / Double( elapsedTicks ) : 0;
+
+  // aggregate all threads
+  std::vector<ProfNode> nodes( 1, ProfNode( NUM_PROF_STAGES ) );
+  std::vector<UInt64>   sizeTicks( NUM_PROF_STAGES * PROF_NUM_SIZES * PROF_NUM_SIZES, 0 );
+  std::vector<UInt64>   sizeCalls( NUM_PROF_STAGES * PROF_NUM_SIZES * PROF_NUM_SIZES, 0 );
+  {
+    std::lock_guard<std::mutex> lock( s_profMutex );
+    for( ProfThreadData* data : s_profThreads )
+    {
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+      xProfMergeTree( data->nodes, PROF_ROOT, nodes, PROF_ROOT );
+      for( Int stage = 0; stage < NUM_PROF_STAGES; stage++ )
+      {
+        for( Int i = 0; i < PROF_NUM_SIZES * PROF_NUM_SIZES; i++ )
+        {
+          sizeTicks[stage * PROF_NUM_SIZES * PROF_NUM_SIZES + i] += data->sizeTicks[stage][i];
+          sizeCalls[stage * PROF_NUM_SIZES * PROF_NUM_SIZES + i] += data->sizeCalls[stage][i];
+        }
+      }
+    }
+  }
+
+  std::vector<ProfReportLine> lines;
+  xProfFlatten( nodes, PROF_ROOT, std::string(), 0, secondsPerTick, lines );
+
+  msg( INFO, "\nProfile (%.3f s since profiling was enabled)\n", elapsed );
+  msg( INFO, "%-40s %12s %12s %12s %8s\n", "stage", "calls", "self [s]", "total [s]", "total" );
+  for( const ProfReportLine& line : lines )
+  {
+    const std::string name = std::string( 2 * line.depth, ' ' ) + g_profStageNames[line.stage];
+    msg( INFO, "%-40s %12llu %12.3f %12.3f %7.2f%%\n", name.c_str(), ( unsigned long long ) line.calls, line.self, line.total, elapsed > 0 ? 100.0 * line.total / elapsed : 0.0 );
+  }
+
+  if( std::any_of( sizeCalls.begin(), sizeCalls.end(), []( UInt64 calls ) { return calls > 0; } ) )
+  {
+    msg( INFO, "\nProfile per block size\n" );
+    msg( INFO, "%-20s %8s %12s %12s %8s\n", "stage", "size", "calls", "total [s]", "stage" );
+  }
+  for( Int stage = 0; stage < NUM_PROF_STAGES; stage++ )
+  {
+    UInt64 stageTicks = 0;
+    for( Int i = 0; i < PROF_NUM_SIZES * PROF_NUM_SIZES; i++ )
+    {
+      stageTicks += sizeTicks[stage * PROF_NUM_SIZES * PROF_NUM_SIZES + i];
+    }
+    for( Int i = 0; i < PROF_NUM_SIZES * PROF_NUM_SIZES; i++ )
+    {
+      const Int idx = stage * PROF_NUM_SIZES * PROF_NUM_SIZES + i;
+      if( sizeCalls[idx] )
+      {
+        const std::string size = std::to_string( 1 << ( i / PROF_NUM_SIZES ) ) + "x" + std::to_string( 1 << ( i % PROF_NUM_SIZES ) );
+        msg( INFO, "%-20s %8s %12llu %12.3f %7.2f%%\n", g_profStageNames[stage], size.c_str(), ( unsigned long long ) sizeCalls[idx],
+             sizeTicks[idx] * secondsPerTick, 100.0 * sizeTicks[idx] / stageTicks );
+      }
+    }
+  }
+
+  if( s_profJsonFileName.empty() )
+  {
+    return;
+  }
+
+  std::ofstream os( s_profJsonFileName.c_str() );
+  if( !os.is_open() )
+  {
+    msg( ERROR, "Unable to open file %s for writing the profile\n", s_profJsonFileName.c_str() );
+    return;
+  }
+
+  os << "{\n  \"seconds\": " << elapsed << ",\n  \"stages\": [\n";
+  for( size_t i = 0; i < lines.size(); i++ )
+  {
+    os << "    { \"path\": \"" << lines[i].path << "\", \"calls\": " << lines[i].calls << ", \"self\": " << lines[i].self
+       << ", \"total\": " << lines[i].total << " }" << ( i + 1 < lines.size() ? ",\n" : "\n" );
+  }
+  os << "  ],\n  \"blockSizes\": [\n";
+  Bool first = true;
+  for( Int idx = 0; idx < NUM_PROF_STAGES * PROF_NUM_SIZES * PROF_NUM_SIZES; idx++ )
+  {
+    if( sizeCalls[idx] )
+    {
+      const Int stage = idx / ( PROF_NUM_SIZES * PROF_NUM_SIZES );
+      const Int i     = idx % ( PROF_NUM_SIZES * PROF_NUM_SIZES );
+      os << ( first ? "" : ",\n" ) << "    { \"stage\": \"" << g_profStageNames[stage] << "\", \"width\": " << ( 1 << ( i / PROF_NUM_SIZES ) )
+         << ", \"height\": " << ( 1 << ( i % PROF_NUM_SIZES ) ) << ", \"calls\": " << sizeCalls[idx] << ", \"total\": " << sizeTicks[idx] * secondsPerTick << " }";
+      first = false;
+    }
+  }
+  os << "\n  ]\n}\n";
+}
+
+//! \}
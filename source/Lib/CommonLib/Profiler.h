@@ -0,0 +1,121 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     Profiler.h
+    \brief    scoped timers of the major encoder and decoder stages (header)
+*/
+
+#ifndef __PROFILER__
+#define __PROFILER__
+
+#include "CommonDef.h"
+
+#include <string>
+
+//! \ingroup CommonLib
+//! \{
+
+/// profiled stages, the hierarchy is given by the nesting of the scopes at run time
+enum ProfStage
+{
+  PROF_ENC_CTU = 0,                 ///< CTU mode decision
+  PROF_ENC_MERGE_SKIP,              ///< EncCu test modes, in the order of EncTestModeType
+  PROF_ENC_MERGE_FRUC,
+  PROF_ENC_INTER_ME,
+  PROF_ENC_AFFINE,
+  PROF_ENC_INTRA,
+  PROF_ENC_IPCM,
+  PROF_ENC_MOTION_ESTIMATION,       ///< InterSearch::xMotionEstimation
+  PROF_ENC_FRAC_SEARCH,             ///< fractional sample refinement of the motion estimation
+  PROF_ENC_INTRA_SEARCH_LUMA,       ///< IntraSearch::estIntraPredLumaQT
+  PROF_ENC_INTRA_SEARCH_CHROMA,     ///< IntraSearch::estIntraPredChromaQT
+  PROF_RDOQ,
+  PROF_DEBLOCK,
+  PROF_SAO,                         ///< SAO, including the parameter estimation in the encoder
+  PROF_ALF,                         ///< ALF, including the parameter estimation in the encoder
+  PROF_DEC_PARSE,                   ///< CABAC parsing of a CTU
+  PROF_DEC_RECON,                   ///< DecCu reconstruction of a CTU
+  NUM_PROF_STAGES
+};
+
+/**
+  Low overhead hierarchical profiler.
+
+  The time between entering and leaving a scope is accumulated per thread in a call tree of the stages, recursive
+  entries of a stage are folded into the outer entry. For scopes with a block size the time is also accumulated per
+  block size. Time is taken with the time stamp counter where available. When profiling is not enabled at run time,
+  a scope costs a single test of a global flag, with ENABLE_PROFILING set to 0 the scopes are not compiled at all.
+  A thread holds its own lock while a scope is active, so the report only reads the call tree of a thread between
+  its outermost scopes and must not be requested from inside a scope.
+*/
+class Profiler
+{
+public:
+  static Bool isEnabled()   { return s_enabled; }
+
+  static Void enable      ( const std::string& jsonFileName );  ///< starts profiling, the JSON report is written to the file if not empty
+  static Void report      ();                                   ///< prints the aggregated report of all threads and writes the JSON report, waits for the active scopes of the other threads
+  static Double getStageSeconds( ProfStage stage );             ///< time spent in the stage by all threads since profiling was enabled, waits for the active scopes of the other threads
+
+  static Void enter       ( ProfStage stage, UInt width, UInt height );
+  static Void leave       ();
+
+private:
+  static Bool s_enabled;
+};
+
+/// profiles the enclosing scope
+class ProfileScope
+{
+public:
+  ProfileScope( ProfStage stage, UInt width = 0, UInt height = 0 ) : m_active( Profiler::isEnabled() ) { if( m_active ) Profiler::enter( stage, width, height ); }
+  ~ProfileScope()                                                                                       { if( m_active ) Profiler::leave(); }
+
+private:
+  Bool m_active;
+};
+
+#define PROFILE_CONCAT_( a, b )               a##b
+#define PROFILE_CONCAT( a, b )                PROFILE_CONCAT_( a, b )
+
+#if ENABLE_PROFILING
+#define PROFILE_SCOPE( stage )                ProfileScope PROFILE_CONCAT( profileScope, __LINE__ )( stage )
+#define PROFILE_SCOPE_SIZE( stage, w, h )     ProfileScope PROFILE_CONCAT( profileScope, __LINE__ )( stage, w, h )
+#else
+#define PROFILE_SCOPE( stage )
+#define PROFILE_SCOPE_SIZE( stage, w, h )
+#endif
+
+//! \}
+
+#endif // __PROFILER__
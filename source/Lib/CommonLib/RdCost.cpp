@@ -48,7 +48,8 @@
 //! \{
 
 
-FpDistFunc RdCost::m_afpDistortFunc[DF_TOTAL_FUNCTIONS] = { nullptr, };
+FpDistFunc   RdCost::m_afpDistortFunc  [DF_TOTAL_FUNCTIONS] = { nullptr, };
+FpDistFuncX4 RdCost::m_afpDistortFuncX4[DF_TOTAL_FUNCTIONS] = { nullptr, };
 
 RdCost::RdCost()
 {
@@ -143,6 +144,25 @@ Void RdCost::init()
   m_afpDistortFunc[DF_SAD_FULL_NBIT64 ] = RdCost::xGetSAD_full;
   m_afpDistortFunc[DF_SAD_FULL_NBIT16N] = RdCost::xGetSAD_full;
 
+  // multi-candidate distortion: plain SAD gets a dedicated kernel, everything else
+  // falls back to calling the single-candidate function four times
+  for( Int i = 0; i < DF_TOTAL_FUNCTIONS; i++ )
+  {
+    m_afpDistortFuncX4[i] = RdCost::xGetDistX4;
+  }
+
+  m_afpDistortFuncX4[DF_SAD    ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD2   ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD4   ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD8   ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD16  ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD32  ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD64  ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD16N ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD12  ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD24  ] = RdCost::xGetSADX4;
+  m_afpDistortFuncX4[DF_SAD48  ] = RdCost::xGetSADX4;
+
 #if HHI_SIMD_OPT_DIST
 #ifdef TARGET_SIMD_X86
   initRdCostX86();
@@ -174,38 +194,42 @@ Void RdCost::setDistParam( DistParam &rcDP, const CPelBuf &org, const Pel* piRef
   rcDP.maximumDistortionForEarlyExit = std::numeric_limits<Distortion>::max();
 
   int DFOffset = ( rcDP.useMR ? DF_MRSAD - DF_SAD : 0 );
+  int eDFunc;
   if( !useHadamard )
   {
     if( org.width == 12 )
     {
-      rcDP.distFunc = m_afpDistortFunc[ DF_SAD12 + DFOffset ];
+      eDFunc = DF_SAD12 + DFOffset;
     }
     else if( org.width == 24 )
     {
-      rcDP.distFunc = m_afpDistortFunc[ DF_SAD24 + DFOffset ];
+      eDFunc = DF_SAD24 + DFOffset;
     }
     else if( org.width == 48 )
     {
-      rcDP.distFunc = m_afpDistortFunc[ DF_SAD48 + DFOffset ];
+      eDFunc = DF_SAD48 + DFOffset;
     }
     else if( isPowerOf2( org.width ) )
     {
-      rcDP.distFunc = m_afpDistortFunc[ DF_SAD + DFOffset + g_aucLog2[ org.width ] ];
+      eDFunc = DF_SAD + DFOffset + g_aucLog2[ org.width ];
     }
     else
     {
-      rcDP.distFunc = m_afpDistortFunc[ DF_SAD + DFOffset ];
+      eDFunc = DF_SAD + DFOffset;
     }
   }
   else if( isPowerOf2( org.width ) )
   {
-    rcDP.distFunc = m_afpDistortFunc[ DF_HAD + DFOffset + g_aucLog2[ org.width ] ];
+    eDFunc = DF_HAD + DFOffset + g_aucLog2[ org.width ];
   }
   else
   {
-    rcDP.distFunc = m_afpDistortFunc[ DF_HAD + DFOffset ];
+    eDFunc = DF_HAD + DFOffset;
   }
 
+  rcDP.distFunc   = m_afpDistortFunc  [ eDFunc ];
+  rcDP.distFuncX4 = m_afpDistortFuncX4[ eDFunc ];
+
   // initialize
   rcDP.subShift  = 0;
 
@@ -277,6 +301,7 @@ Void RdCost::setDistParam( DistParam &rcDP, const CPelBuf &org, const CPelBuf &c
     rcDP.distFunc = m_afpDistortFunc[ DF_HAD + DFOffset + g_aucLog2[ org.width ] ];
   }
 
+  rcDP.distFuncX4 = RdCost::xGetDistX4;
   rcDP.maximumDistortionForEarlyExit = std::numeric_limits<Distortion>::max();
 }
 
@@ -317,6 +342,8 @@ Void RdCost::setDistParam( DistParam &rcDP, const Pel* pOrg, const Pel* piRefY,
   {
     rcDP.distFunc = m_afpDistortFunc[ DF_SAD + g_aucLog2[ width ] ];
   }
+
+  rcDP.distFuncX4 = RdCost::xGetDistX4;
 }
 
 Distortion RdCost::getDistPart( const CPelBuf &org, const CPelBuf &cur, Int bitDepth, const ComponentID compID, DFunc eDFunc )
@@ -382,6 +409,63 @@ Distortion RdCost::xGetSAD_full( const DistParam& rcDtParam )
   return uiSum;
 }
 
+Void RdCost::xGetDistX4( const DistParam& rcDtParam, const Pel* const* piCur, Distortion* puiDist )
+{
+  DistParam cDtParam = rcDtParam;
+
+  for( Int i = 0; i < 4; i++ )
+  {
+    cDtParam.cur.buf = piCur[i];
+    puiDist[i]       = cDtParam.distFunc( cDtParam );
+  }
+}
+
+Void RdCost::xGetSADX4( const DistParam& rcDtParam, const Pel* const* piCur, Distortion* puiDist )
+{
+  if( rcDtParam.applyWeight )
+  {
+    xGetDistX4( rcDtParam, piCur, puiDist );
+    return;
+  }
+
+  const Pel* piOrg           = rcDtParam.org.buf;
+  const Pel* piCur0          = piCur[0];
+  const Pel* piCur1          = piCur[1];
+  const Pel* piCur2          = piCur[2];
+  const Pel* piCur3          = piCur[3];
+  const Int  iCols           = rcDtParam.org.width;
+        Int  iRows           = rcDtParam.org.height;
+  const Int  iSubShift       = rcDtParam.subShift;
+  const Int  iSubStep        = ( 1 << iSubShift );
+  const Int  iStrideCur      = rcDtParam.cur.stride * iSubStep;
+  const Int  iStrideOrg      = rcDtParam.org.stride * iSubStep;
+  const UInt distortionShift = DISTORTION_PRECISION_ADJUSTMENT(rcDtParam.bitDepth - 8);
+
+  Distortion uiSum0 = 0, uiSum1 = 0, uiSum2 = 0, uiSum3 = 0;
+
+  for( ; iRows != 0; iRows -= iSubStep )
+  {
+    for( Int n = 0; n < iCols; n++ )
+    {
+      const Int iOrg = piOrg[n];
+      uiSum0 += abs( iOrg - piCur0[n] );
+      uiSum1 += abs( iOrg - piCur1[n] );
+      uiSum2 += abs( iOrg - piCur2[n] );
+      uiSum3 += abs( iOrg - piCur3[n] );
+    }
+    piOrg  += iStrideOrg;
+    piCur0 += iStrideCur;
+    piCur1 += iStrideCur;
+    piCur2 += iStrideCur;
+    piCur3 += iStrideCur;
+  }
+
+  puiDist[0] = ( uiSum0 << iSubShift ) >> distortionShift;
+  puiDist[1] = ( uiSum1 << iSubShift ) >> distortionShift;
+  puiDist[2] = ( uiSum2 << iSubShift ) >> distortionShift;
+  puiDist[3] = ( uiSum3 << iSubShift ) >> distortionShift;
+}
+
 Distortion RdCost::xGetSAD( const DistParam& rcDtParam )
 {
   if ( rcDtParam.applyWeight )
@@ -58,6 +58,7 @@ class EncCfg;
 
 // for function pointer
 typedef Distortion (*FpDistFunc) (const DistParam&);
+typedef Void       (*FpDistFuncX4) (const DistParam&, const Pel* const* piCur, Distortion* puiDist);
 
 // ====================================================================================================================
 // Class definition
@@ -71,6 +72,7 @@ public:
   CPelBuf               cur;
   int                   step;
   FpDistFunc            distFunc;
+  FpDistFuncX4          distFuncX4;      // evaluates four cur positions against org in one call
   int                   bitDepth;
 
   bool                  useMR;
@@ -86,7 +88,7 @@ public:
   // - 0 = no subsampling, 1 = even rows, 2 = every 4th, etc.
   Int                   subShift;
 
-  DistParam() : org(), cur(), step( 1 ), bitDepth( 0 ), useMR( false ), applyWeight( false ), isBiPred( false ), wpCur( nullptr ), compID( MAX_NUM_COMPONENT ), maximumDistortionForEarlyExit( std::numeric_limits<Distortion>::max() ), subShift( 0 ) { }
+  DistParam() : org(), cur(), step( 1 ), distFunc( nullptr ), distFuncX4( nullptr ), bitDepth( 0 ), useMR( false ), applyWeight( false ), isBiPred( false ), wpCur( nullptr ), compID( MAX_NUM_COMPONENT ), maximumDistortionForEarlyExit( std::numeric_limits<Distortion>::max() ), subShift( 0 ) { }
 };
 
 /// RD cost computation class
@@ -96,6 +98,7 @@ private:
   // for distortion
 
   static FpDistFunc       m_afpDistortFunc[DF_TOTAL_FUNCTIONS]; // [eDFunc]
+  static FpDistFuncX4     m_afpDistortFuncX4[DF_TOTAL_FUNCTIONS]; // [eDFunc]
   CostMode                m_costMode;
   double                  m_distortionWeight[MAX_NUM_COMPONENT]; // only chroma values are used.
   double                  m_dLambda;
@@ -132,6 +135,8 @@ public:
   template <X86_VEXT vext>
   Void          _initRdCostX86();
 #endif
+  static FpDistFunc getDistFunc       ( DFunc eDFunc )             { return m_afpDistortFunc[eDFunc]; }
+  static FpDistFuncX4 getDistFuncX4   ( DFunc eDFunc )             { return m_afpDistortFuncX4[eDFunc]; }
 
   Void           setDistParam( DistParam &rcDP, const CPelBuf &org, const Pel* piRefY , Int iRefStride, Int bitDepth, ComponentID compID, Int subShiftMode = 0, Int step = 1, Bool useHadamard = false );
   Void           setDistParam( DistParam &rcDP, const CPelBuf &org, const CPelBuf &cur, Int bitDepth, ComponentID compID, Bool useHadamard = false );
@@ -192,6 +197,9 @@ private:
 
   static Distortion xGetSAD_full      ( const DistParam& pcDtParam );
 
+  static Void       xGetDistX4        ( const DistParam& pcDtParam, const Pel* const* piCur, Distortion* puiDist );
+  static Void       xGetSADX4         ( const DistParam& pcDtParam, const Pel* const* piCur, Distortion* puiDist );
+
   static Distortion xGetMRSAD         ( const DistParam& pcDtParam );
   static Distortion xGetMRSAD4        ( const DistParam& pcDtParam );
   static Distortion xGetMRSAD8        ( const DistParam& pcDtParam );
@@ -224,6 +232,8 @@ private:
   static Distortion xGetSAD_SIMD    ( const DistParam& pcDtParam );
   template< Int iWidth, X86_VEXT vext >
   static Distortion xGetSAD_NxN_SIMD( const DistParam& pcDtParam );
+  template< X86_VEXT vext >
+  static Void       xGetSADX4_SIMD  ( const DistParam& pcDtParam, const Pel* const* piCur, Distortion* puiDist );
 
   template< typename Torg, typename Tcur, X86_VEXT vext >
   static Distortion xGetHADs_SIMD   ( const DistParam& pcDtParam );
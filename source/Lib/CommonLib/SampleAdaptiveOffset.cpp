@@ -40,6 +40,7 @@
 #include "UnitTools.h"
 #include "UnitPartitioner.h"
 #include "CodingStructure.h"
+#include "Profiler.h"
 #include "CommonLib/dtrace_codingstruct.h"
 
 #include <string.h>
@@ -111,15 +112,22 @@ const SAOBlkParam& SAOBlkParam::operator= (const SAOBlkParam& src)
 
 SampleAdaptiveOffset::SampleAdaptiveOffset()
 {
+  m_offsetEO = xOffsetEO;
+  m_offsetBO = xOffsetBO;
+  m_statsEO  = xStatsEO;
+  m_statsBO  = xStatsBO;
+
+#if HHI_SIMD_OPT_SAO
+#ifdef TARGET_SIMD_X86
+  initSampleAdaptiveOffsetX86();
+#endif
+#endif
 }
 
 
 SampleAdaptiveOffset::~SampleAdaptiveOffset()
 {
   destroy();
-
-  m_signLineBuf1.clear();
-  m_signLineBuf2.clear();
 }
 
 Void SampleAdaptiveOffset::create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth, UInt lumaBitShift, UInt chromaBitShift )
@@ -292,42 +300,26 @@ Void SampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, const ClpRng&
                                           , const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride,  Int width, Int height
                                           , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail)
 {
-  Int x,y, startX, startY, endX, endY, edgeType;
+  Int startX, startY, endX, endY;
   Int firstLineStartX, firstLineEndX, lastLineStartX, lastLineEndX;
-  SChar signLeft, signRight, signDown;
 
   const Pel* srcLine = srcBlk;
         Pel* resLine = resBlk;
 
+  // the edge classes are derived from the two neighbours of each sample, the signs are not carried between lines
+  const Int numMidLines = std::max( 0, height - 2 );
+
   switch(typeIdx)
   {
   case SAO_TYPE_EO_0:
     {
-      offset += 2;
       startX = isLeftAvail ? 0 : 1;
       endX   = isRightAvail ? width : (width -1);
-      for (y=0; y< height; y++)
-      {
-        signLeft = (SChar)sgn(srcLine[startX] - srcLine[startX-1]);
-        for (x=startX; x< endX; x++)
-        {
-          signRight = (SChar)sgn(srcLine[x] - srcLine[x+1]);
-          edgeType =  signRight + signLeft;
-          signLeft  = -signRight;
-
-          resLine[x] = ClipPel<int>( srcLine[x] + offset[edgeType], clpRng);
-        }
-        srcLine  += srcStride;
-        resLine += resStride;
-      }
-
+      m_offsetEO( srcLine, srcStride, resLine, resStride, startX, endX, height, -1, 1, offset + 2, clpRng );
     }
     break;
   case SAO_TYPE_EO_90:
     {
-      offset += 2;
-      SChar *signUpLine = &m_signLineBuf1[0];
-
       startY = isAboveAvail ? 0 : 1;
       endY   = isBelowAvail ? height : height-1;
       if (!isAboveAvail)
@@ -336,167 +328,59 @@ Void SampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, const ClpRng&
         resLine += resStride;
       }
 
-      const Pel* srcLineAbove= srcLine- srcStride;
-      for (x=0; x< width; x++)
-      {
-        signUpLine[x] = (SChar)sgn(srcLine[x] - srcLineAbove[x]);
-      }
-
-      const Pel* srcLineBelow;
-      for (y=startY; y<endY; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for (x=0; x< width; x++)
-        {
-          signDown  = (SChar)sgn(srcLine[x] - srcLineBelow[x]);
-          edgeType = signDown + signUpLine[x];
-          signUpLine[x]= -signDown;
-
-          resLine[x] = ClipPel<int>(srcLine[x] + offset[edgeType], clpRng);
-        }
-        srcLine += srcStride;
-        resLine += resStride;
-      }
-
+      m_offsetEO( srcLine, srcStride, resLine, resStride, 0, width, endY - startY, -srcStride, srcStride, offset + 2, clpRng );
     }
     break;
   case SAO_TYPE_EO_135:
     {
-      offset += 2;
-      SChar *signUpLine, *signDownLine, *signTmpLine;
-
-      signUpLine  = &m_signLineBuf1[0];
-      signDownLine= &m_signLineBuf2[0];
-
       startX = isLeftAvail ? 0 : 1 ;
       endX   = isRightAvail ? width : (width-1);
 
-      //prepare 2nd line's upper sign
-      const Pel* srcLineBelow= srcLine+ srcStride;
-      for (x=startX; x< endX+1; x++)
-      {
-        signUpLine[x] = (SChar)sgn(srcLineBelow[x] - srcLine[x- 1]);
-      }
-
       //1st line
-      const Pel* srcLineAbove= srcLine- srcStride;
       firstLineStartX = isAboveLeftAvail ? 0 : 1;
       firstLineEndX   = isAboveAvail? endX: 1;
-      for(x= firstLineStartX; x< firstLineEndX; x++)
-      {
-        edgeType  =  sgn(srcLine[x] - srcLineAbove[x- 1]) - signUpLine[x+1];
-
-        resLine[x] = ClipPel<int>( srcLine[x] + offset[edgeType], clpRng);
-      }
+      m_offsetEO( srcLine, srcStride, resLine, resStride, firstLineStartX, firstLineEndX, 1, -srcStride - 1, srcStride + 1, offset + 2, clpRng );
       srcLine  += srcStride;
       resLine  += resStride;
 
-
       //middle lines
-      for (y= 1; y< height-1; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for (x=startX; x<endX; x++)
-        {
-          signDown =  (SChar)sgn(srcLine[x] - srcLineBelow[x+ 1]);
-          edgeType =  signDown + signUpLine[x];
-          resLine[x] = ClipPel<int>( srcLine[x] + offset[edgeType], clpRng);
-
-          signDownLine[x+1] = -signDown;
-        }
-        signDownLine[startX] = (SChar)sgn(srcLineBelow[startX] - srcLine[startX-1]);
-
-        signTmpLine  = signUpLine;
-        signUpLine   = signDownLine;
-        signDownLine = signTmpLine;
-
-        srcLine += srcStride;
-        resLine += resStride;
-      }
+      m_offsetEO( srcLine, srcStride, resLine, resStride, startX, endX, numMidLines, -srcStride - 1, srcStride + 1, offset + 2, clpRng );
+      srcLine  += numMidLines * srcStride;
+      resLine  += numMidLines * resStride;
 
       //last line
-      srcLineBelow= srcLine+ srcStride;
       lastLineStartX = isBelowAvail ? startX : (width -1);
       lastLineEndX   = isBelowRightAvail ? width : (width -1);
-      for(x= lastLineStartX; x< lastLineEndX; x++)
-      {
-        edgeType =  sgn(srcLine[x] - srcLineBelow[x+ 1]) + signUpLine[x];
-        resLine[x] = ClipPel<int>( srcLine[x] + offset[edgeType], clpRng);
-
-      }
+      m_offsetEO( srcLine, srcStride, resLine, resStride, lastLineStartX, lastLineEndX, 1, -srcStride - 1, srcStride + 1, offset + 2, clpRng );
     }
     break;
   case SAO_TYPE_EO_45:
     {
-      offset += 2;
-      SChar *signUpLine = &m_signLineBuf1[1];
-
       startX = isLeftAvail ? 0 : 1;
       endX   = isRightAvail ? width : (width -1);
 
-      //prepare 2nd line upper sign
-      const Pel* srcLineBelow= srcLine+ srcStride;
-      for (x=startX-1; x< endX; x++)
-      {
-        signUpLine[x] = (SChar)sgn(srcLineBelow[x] - srcLine[x+1]);
-      }
-
-
       //first line
-      const Pel* srcLineAbove= srcLine- srcStride;
       firstLineStartX = isAboveAvail ? startX : (width -1 );
       firstLineEndX   = isAboveRightAvail ? width : (width-1);
-      for(x= firstLineStartX; x< firstLineEndX; x++)
-      {
-        edgeType = sgn(srcLine[x] - srcLineAbove[x+1]) -signUpLine[x-1];
-        resLine[x] = ClipPel<int>(srcLine[x] + offset[edgeType], clpRng);
-      }
+      m_offsetEO( srcLine, srcStride, resLine, resStride, firstLineStartX, firstLineEndX, 1, -srcStride + 1, srcStride - 1, offset + 2, clpRng );
       srcLine += srcStride;
       resLine += resStride;
 
       //middle lines
-      for (y= 1; y< height-1; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for(x= startX; x< endX; x++)
-        {
-          signDown =  (SChar)sgn(srcLine[x] - srcLineBelow[x-1]);
-          edgeType =  signDown + signUpLine[x];
-          resLine[x] = ClipPel<int>(srcLine[x] + offset[edgeType], clpRng);
-          signUpLine[x-1] = -signDown;
-        }
-        signUpLine[endX-1] = (SChar)sgn(srcLineBelow[endX-1] - srcLine[endX]);
-        srcLine  += srcStride;
-        resLine += resStride;
-      }
+      m_offsetEO( srcLine, srcStride, resLine, resStride, startX, endX, numMidLines, -srcStride + 1, srcStride - 1, offset + 2, clpRng );
+      srcLine += numMidLines * srcStride;
+      resLine += numMidLines * resStride;
 
       //last line
-      srcLineBelow= srcLine+ srcStride;
       lastLineStartX = isBelowLeftAvail ? 0 : 1;
       lastLineEndX   = isBelowAvail ? endX : 1;
-      for(x= lastLineStartX; x< lastLineEndX; x++)
-      {
-        edgeType = sgn(srcLine[x] - srcLineBelow[x-1]) + signUpLine[x];
-        resLine[x] = ClipPel<int>(srcLine[x] + offset[edgeType], clpRng);
-
-      }
+      m_offsetEO( srcLine, srcStride, resLine, resStride, lastLineStartX, lastLineEndX, 1, -srcStride + 1, srcStride - 1, offset + 2, clpRng );
     }
     break;
   case SAO_TYPE_BO:
     {
       const Int shiftBits = channelBitDepth - NUM_SAO_BO_CLASSES_LOG2;
-      for (y=0; y< height; y++)
-      {
-        for (x=0; x< width; x++)
-        {
-          resLine[x] = ClipPel<int>(srcLine[x] + offset[srcLine[x] >> shiftBits], clpRng );
-        }
-        srcLine += srcStride;
-        resLine += resStride;
-      }
+      m_offsetBO( srcLine, srcStride, resLine, resStride, width, height, shiftBits, offset, clpRng );
     }
     break;
   default:
@@ -506,6 +390,67 @@ Void SampleAdaptiveOffset::offsetBlock(const Int channelBitDepth, const ClpRng&
   }
 }
 
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void SampleAdaptiveOffset::xOffsetEO( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, const Int* offset, const ClpRng& clpRng )
+{
+  for( Int y = 0; y < numLines; y++ )
+  {
+    for( Int x = startX; x < endX; x++ )
+    {
+      const Int edgeType = sgn( srcLine[x] - srcLine[x + nbOffsetA] ) + sgn( srcLine[x] - srcLine[x + nbOffsetB] );
+      resLine[x] = ClipPel<Int>( srcLine[x] + offset[edgeType], clpRng );
+    }
+    srcLine += srcStride;
+    resLine += resStride;
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void SampleAdaptiveOffset::xOffsetBO( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, const ClpRng& clpRng )
+{
+  for( Int y = 0; y < height; y++ )
+  {
+    for( Int x = 0; x < width; x++ )
+    {
+      resLine[x] = ClipPel<Int>( srcLine[x] + offset[srcLine[x] >> shiftBits], clpRng );
+    }
+    srcLine += srcStride;
+    resLine += resStride;
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void SampleAdaptiveOffset::xStatsEO( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, Int64* diff, Int64* count )
+{
+  for( Int y = 0; y < numLines; y++ )
+  {
+    for( Int x = startX; x < endX; x++ )
+    {
+      const Int edgeType = sgn( srcLine[x] - srcLine[x + nbOffsetA] ) + sgn( srcLine[x] - srcLine[x + nbOffsetB] );
+      diff [edgeType] += ( orgLine[x] - srcLine[x] );
+      count[edgeType] ++;
+    }
+    srcLine += srcStride;
+    orgLine += orgStride;
+  }
+}
+
+//  If you change the functionality here, consider to switch off the SIMD implementation of this function.
+Void SampleAdaptiveOffset::xStatsBO( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int shiftBits, Int64* diff, Int64* count )
+{
+  for( Int y = 0; y < numLines; y++ )
+  {
+    for( Int x = startX; x < endX; x++ )
+    {
+      const Int bandIdx = srcLine[x] >> shiftBits;
+      diff [bandIdx] += ( orgLine[x] - srcLine[x] );
+      count[bandIdx] ++;
+    }
+    srcLine += srcStride;
+    orgLine += orgStride;
+  }
+}
+
 Void SampleAdaptiveOffset::offsetCTU( const UnitArea& area, const CPelUnitBuf& src, PelUnitBuf& res, SAOBlkParam& saoblkParam, CodingStructure& cs)
 {
   const UInt numberOfComponents = getNumberValidComponents( area.chromaFormat );
@@ -527,13 +472,6 @@ Void SampleAdaptiveOffset::offsetCTU( const UnitArea& area, const CPelUnitBuf& s
   //block boundary availability
   deriveLoopFilterBoundaryAvailibility(cs, area.Y(), isLeftAvail,isRightAvail,isAboveAvail,isBelowAvail,isAboveLeftAvail,isAboveRightAvail,isBelowLeftAvail,isBelowRightAvail);
 
-  const size_t lineBufferSize = area.Y().width + 1;
-  if (m_signLineBuf1.size() < lineBufferSize)
-  {
-    m_signLineBuf1.resize(lineBufferSize);
-    m_signLineBuf2.resize(lineBufferSize);
-  }
-
   for(Int compIdx = 0; compIdx < numberOfComponents; compIdx++)
   {
     const ComponentID compID = ComponentID(compIdx);
@@ -562,6 +500,8 @@ Void SampleAdaptiveOffset::offsetCTU( const UnitArea& area, const CPelUnitBuf& s
 
 Void SampleAdaptiveOffset::SAOProcess(CodingStructure& cs, SAOBlkParam* saoBlkParams)
 {
+  PROFILE_SCOPE( PROF_SAO );
+
   CHECK(!saoBlkParams, "No parameters present");
 
   xReconstructBlkSAOParams(cs, saoBlkParams);
@@ -70,6 +70,24 @@ public:
   Void destroy();
   static Int getMaxOffsetQVal(const Int channelBitDepth) { return (1<<(std::min<Int>(channelBitDepth,MAX_SAO_TRUNCATED_BITDEPTH)-5))-1; } //Table 9-32, inclusive
 
+  // offset and statistics kernels (C reference implementations, replaced by SIMD versions where available)
+  // the edge offset kernels classify each sample by its neighbours at the offsets nbOffsetA and nbOffsetB, offset/diff/count are centered at edge class 0
+  static Void xOffsetEO( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, const Int* offset, const ClpRng& clpRng );
+  static Void xOffsetBO( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, const ClpRng& clpRng );
+  static Void xStatsEO ( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, Int64* diff, Int64* count );
+  static Void xStatsBO ( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int shiftBits, Int64* diff, Int64* count );
+
+  Void ( *m_offsetEO ) ( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, const Int* offset, const ClpRng& clpRng );
+  Void ( *m_offsetBO ) ( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, const ClpRng& clpRng );
+  Void ( *m_statsEO )  ( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, Int64* diff, Int64* count );
+  Void ( *m_statsBO )  ( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int shiftBits, Int64* diff, Int64* count );
+
+#ifdef TARGET_SIMD_X86
+  Void initSampleAdaptiveOffsetX86();
+  template <X86_VEXT vext>
+  Void _initSampleAdaptiveOffsetX86();
+#endif
+
 protected:
   Void deriveLoopFilterBoundaryAvailibility(CodingStructure& cs, const Position &pos,
     Bool& isLeftAvail,
@@ -97,9 +115,6 @@ protected:
   UInt m_offsetStepLog2[MAX_NUM_COMPONENT]; //offset step
   PelStorage m_tempBuf;
   UInt m_numberOfComponents;
-
-  std::vector<SChar> m_signLineBuf1;
-  std::vector<SChar> m_signLineBuf2;
 private:
   Bool m_picSAOEnabled[MAX_NUM_COMPONENT];
 };
@@ -42,6 +42,7 @@
 #include "ContextModelling.h"
 #include "CodingStructure.h"
 #include "CrossCompPrediction.h"
+#include "Profiler.h"
 
 #include "dtrace_buffer.h"
 
@@ -2269,6 +2270,7 @@ Void TrQuant::xQuant(TransformUnit &tu, const ComponentID &compID, const CCoeffB
     if (!m_useSelectiveRDOQ || xNeedRDOQ(tu, compID, piCoef, cQP))
     {
 #endif
+      PROFILE_SCOPE_SIZE( PROF_RDOQ, tu.blocks[compID].width, tu.blocks[compID].height );
       xRateDistOptQuant( tu, compID, pSrc, uiAbsSum, cQP, ctx );
 #if T0196_SELECTIVE_RDOQ
     }
@@ -62,6 +62,10 @@
 #define ENABLE_TRACING                                    0 // DISABLE by default (enable only when debugging, requires 15% run-time in decoding) -- see documentation in 'doc/DTrace for NextSoftware.pdf'
 #endif // ! ENABLE_TRACING
 
+#ifndef ENABLE_PROFILING
+#define ENABLE_PROFILING                                  1 // scoped stage timers, only active with --StageProfile=1 (a flag test per scope otherwise)
+#endif // ! ENABLE_PROFILING
+
 
 #define KEEP_PRED_AND_RESI_SIGNALS                        0
 
@@ -85,6 +89,10 @@
 #define RExt__DECODER_DEBUG_BIT_STATISTICS                0 ///< 0 (default) = decoder reports as normal, 1 = decoder produces bit usage statistics (will impact decoder run time by up to ~10%)
 #endif
 
+#ifndef ENABLE_BIT_STATISTICS
+#define ENABLE_BIT_STATISTICS                             1 ///< run-time selectable bits per syntax element in the normal decoder (BitStatisticsFile), when not selected only the bypass, terminating and PCM bins test for it
+#endif
+
 // ====================================================================================================================
 // Tool Switches - transitory (these macros are likely to be removed in future revisions)
 // ====================================================================================================================
@@ -110,6 +118,11 @@
 #define HHI_SIMD_OPT_MCIF                               ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the interpolation filter, no impact on RD performance
 #define HHI_SIMD_OPT_BUFFER                             ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the buffer operations, no impact on RD performance
 #define HHI_SIMD_OPT_DIST                               ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the distortion calculations(SAD,SSE,HADAMARD), no impact on RD performance
+#define HHI_SIMD_OPT_INTRA_PRED                         ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the intra prediction (angular, planar, DC, reference smoothing, CCLM/MMLM), no impact on RD performance
+#define HHI_SIMD_OPT_DEBLOCK                            ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the deblocking filter, no impact on RD performance
+#define HHI_SIMD_OPT_SAO                                ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the SAO application and the encoder SAO statistics, no impact on RD performance
+#define HHI_SIMD_OPT_ALF                                ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the encoder ALF statistics, no impact on RD performance
+#define HHI_SIMD_OPT_BIF                                ( 1 && HHI_SIMD_OPT )                            ///< SIMD optimization for the bilateral filter, no impact on RD performance
 // End of SIMD optimizations
 
 #define AMP_ENC_SPEEDUP                                   1 ///< encoder only speed-up by AMP mode skipping
@@ -64,14 +64,15 @@ static void xInitFrucMvpEl( CodingStructure& cs, Int x, Int y, Int nCurPOC, Int
 
   CHECK( pos.x >= cs.picture->Y().width || pos.y >= cs.picture->Y().height, "size exceed" );
 
-  const MotionInfo &frucMi = pColPic->cs->getMotionInfo( pos );
+  const MotionField& colField = pColPic->cs->getMotionField();
+  const UInt         colIdx   = colField.idx( pos.x, pos.y );
 
-  if( frucMi.interDir & ( 1 << eRefPicList ) )
+  if( colField.interDir( colIdx ) & ( 1 << eRefPicList ) )
   {
-    CHECK( frucMi.isInter == false && frucMi.interDir < 1, "invalid motion info" );
+    CHECK( !colField.isInter( colIdx ), "invalid motion info" );
 
-    Int nColRefPOC = pColPic->cs->slice->getRefPOC( eRefPicList, frucMi.refIdx[eRefPicList] );
-    Mv mvColPic = frucMi.mv[eRefPicList];
+    Int nColRefPOC = pColPic->cs->slice->getRefPOC( eRefPicList, colField.refIdx( colIdx, eRefPicList ) );
+    Mv mvColPic = colField.mv( colIdx, eRefPicList );
     if( cs.sps->getSpsNext().getUseHighPrecMv() )
     {
       mvColPic.setHighPrec();
@@ -983,7 +984,11 @@ void PU::getInterMergeCandidates( const PredictionUnit &pu, MergeCtx& mrgCtx, co
   const Position posRT = pu.Y().topRight();
   const Position posLB = pu.Y().bottomLeft();
 
-  MotionInfo miAbove, miLeft, miAboveLeft, miAboveRight, miBelowLeft;
+  // the neighbours are read from the block motion of the coding structure they belong to, above, above right and
+  // above left share one row
+  const MotionField *mfAbove = nullptr, *mfLeft = nullptr, *mfAboveLeft = nullptr, *mfAboveRight = nullptr, *mfBelowLeft = nullptr;
+  UInt               idxAbove = 0,      idxLeft = 0,      idxAboveLeft = 0,      idxAboveRight = 0,      idxBelowLeft = 0;
+  MotionField::RowCache rowCache;
 
   //left
   const PredictionUnit* puLeft = cs.getPURestricted( posLB.offset( -1, 0 ), pu );
@@ -992,20 +997,23 @@ void PU::getInterMergeCandidates( const PredictionUnit &pu, MergeCtx& mrgCtx, co
 
   if( isAvailableA1 )
   {
-    miLeft = puLeft->getMotionInfo( posLB.offset(-1, 0) );
+    const Position posLeft = posLB.offset(-1, 0);
+
+    mfLeft  = &puLeft->cs->getBlockMotion();
+    idxLeft = rowCache.idx( *mfLeft, posLeft.x, posLeft.y );
 
     isCandInter[cnt] = true;
 
     // get Inter Dir
-    mrgCtx.interDirNeighbours[cnt] = miLeft.interDir;
-    mrgCtx.LICFlags          [cnt] = miLeft.usesLIC;
+    mrgCtx.interDirNeighbours[cnt] = mfLeft->interDir( idxLeft );
+    mrgCtx.LICFlags          [cnt] = mfLeft->usesLIC ( idxLeft );
 
     // get Mv from Left
-    mrgCtx.mvFieldNeighbours[cnt << 1].setMvField(miLeft.mv[0], miLeft.refIdx[0]);
+    mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( mfLeft->mv( idxLeft, REF_PIC_LIST_0 ), mfLeft->refIdx( idxLeft, REF_PIC_LIST_0 ) );
 
     if (slice.isInterB())
     {
-      mrgCtx.mvFieldNeighbours[(cnt << 1) + 1].setMvField(miLeft.mv[1], miLeft.refIdx[1]);
+      mrgCtx.mvFieldNeighbours[(cnt << 1) + 1].setMvField( mfLeft->mv( idxLeft, REF_PIC_LIST_1 ), mfLeft->refIdx( idxLeft, REF_PIC_LIST_1 ) );
     }
 
     if( mrgCandIdx == cnt && canFastExit )
@@ -1030,22 +1038,25 @@ void PU::getInterMergeCandidates( const PredictionUnit &pu, MergeCtx& mrgCtx, co
 
   if( isAvailableB1 )
   {
-    miAbove = puAbove->getMotionInfo( posRT.offset( 0, -1 ) );
+    const Position posAbove = posRT.offset( 0, -1 );
+
+    mfAbove  = &puAbove->cs->getBlockMotion();
+    idxAbove = rowCache.idx( *mfAbove, posAbove.x, posAbove.y );
 
-    if( !isAvailableA1 || ( miAbove != miLeft ) )
+    if( !isAvailableA1 || !mfAbove->sameMotion( idxAbove, *mfLeft, idxLeft ) )
     {
       isCandInter[cnt] = true;
 
       // get Inter Dir
-      mrgCtx.interDirNeighbours[cnt] = miAbove.interDir;
-      mrgCtx.LICFlags          [cnt] = miAbove.usesLIC;
+      mrgCtx.interDirNeighbours[cnt] = mfAbove->interDir( idxAbove );
+      mrgCtx.LICFlags          [cnt] = mfAbove->usesLIC ( idxAbove );
 
       // get Mv from Left
-      mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( miAbove.mv[0], miAbove.refIdx[0] );
+      mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( mfAbove->mv( idxAbove, REF_PIC_LIST_0 ), mfAbove->refIdx( idxAbove, REF_PIC_LIST_0 ) );
 
       if( slice.isInterB() )
       {
-        mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( miAbove.mv[1], miAbove.refIdx[1] );
+        mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( mfAbove->mv( idxAbove, REF_PIC_LIST_1 ), mfAbove->refIdx( idxAbove, REF_PIC_LIST_1 ) );
       }
 
       if( mrgCandIdx == cnt && canFastExit )
@@ -1070,22 +1081,25 @@ void PU::getInterMergeCandidates( const PredictionUnit &pu, MergeCtx& mrgCtx, co
 
   if( isAvailableB0 )
   {
-    miAboveRight = puAboveRight->getMotionInfo( posRT.offset( 1, -1 ) );
+    const Position posAboveRight = posRT.offset( 1, -1 );
 
-    if( !isAvailableB1 || ( miAbove != miAboveRight ) )
+    mfAboveRight  = &puAboveRight->cs->getBlockMotion();
+    idxAboveRight = rowCache.idx( *mfAboveRight, posAboveRight.x, posAboveRight.y );
+
+    if( !isAvailableB1 || !mfAbove->sameMotion( idxAbove, *mfAboveRight, idxAboveRight ) )
     {
       isCandInter[cnt] = true;
 
       // get Inter Dir
-      mrgCtx.interDirNeighbours[cnt] = miAboveRight.interDir;
-      mrgCtx.LICFlags          [cnt] = miAboveRight.usesLIC;
+      mrgCtx.interDirNeighbours[cnt] = mfAboveRight->interDir( idxAboveRight );
+      mrgCtx.LICFlags          [cnt] = mfAboveRight->usesLIC ( idxAboveRight );
 
       // get Mv from Left
-      mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( miAboveRight.mv[0], miAboveRight.refIdx[0] );
+      mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( mfAboveRight->mv( idxAboveRight, REF_PIC_LIST_0 ), mfAboveRight->refIdx( idxAboveRight, REF_PIC_LIST_0 ) );
 
       if( slice.isInterB() )
       {
-        mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( miAboveRight.mv[1], miAboveRight.refIdx[1] );
+        mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( mfAboveRight->mv( idxAboveRight, REF_PIC_LIST_1 ), mfAboveRight->refIdx( idxAboveRight, REF_PIC_LIST_1 ) );
       }
 
       if( mrgCandIdx == cnt && canFastExit )
@@ -1109,22 +1123,25 @@ void PU::getInterMergeCandidates( const PredictionUnit &pu, MergeCtx& mrgCtx, co
 
   if( isAvailableA0 )
   {
-    miBelowLeft = puLeftBottom->getMotionInfo( posLB.offset( -1, 1 ) );
+    const Position posBelowLeft = posLB.offset( -1, 1 );
+
+    mfBelowLeft  = &puLeftBottom->cs->getBlockMotion();
+    idxBelowLeft = rowCache.idx( *mfBelowLeft, posBelowLeft.x, posBelowLeft.y );
 
-    if( !isAvailableA1 || ( miBelowLeft != miLeft ) )
+    if( !isAvailableA1 || !mfBelowLeft->sameMotion( idxBelowLeft, *mfLeft, idxLeft ) )
     {
       isCandInter[cnt] = true;
 
       // get Inter Dir
-      mrgCtx.interDirNeighbours[cnt] = miBelowLeft.interDir;
-      mrgCtx.LICFlags          [cnt] = miBelowLeft.usesLIC;
+      mrgCtx.interDirNeighbours[cnt] = mfBelowLeft->interDir( idxBelowLeft );
+      mrgCtx.LICFlags          [cnt] = mfBelowLeft->usesLIC ( idxBelowLeft );
 
       // get Mv from Bottom-Left
-      mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( miBelowLeft.mv[0], miBelowLeft.refIdx[0] );
+      mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( mfBelowLeft->mv( idxBelowLeft, REF_PIC_LIST_0 ), mfBelowLeft->refIdx( idxBelowLeft, REF_PIC_LIST_0 ) );
 
       if( slice.isInterB() )
       {
-        mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( miBelowLeft.mv[1], miBelowLeft.refIdx[1] );
+        mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( mfBelowLeft->mv( idxBelowLeft, REF_PIC_LIST_1 ), mfBelowLeft->refIdx( idxBelowLeft, REF_PIC_LIST_1 ) );
       }
 
       if( mrgCandIdx == cnt && canFastExit )
@@ -1213,22 +1230,25 @@ void PU::getInterMergeCandidates( const PredictionUnit &pu, MergeCtx& mrgCtx, co
 
     if( isAvailableB2 )
     {
-      miAboveLeft = puAboveLeft->getMotionInfo( posLT.offset( -1, -1 ) );
+      const Position posAboveLeft = posLT.offset( -1, -1 );
 
-      if( ( !isAvailableA1 || ( miLeft != miAboveLeft ) ) && ( !isAvailableB1 || ( miAbove != miAboveLeft ) ) )
+      mfAboveLeft  = &puAboveLeft->cs->getBlockMotion();
+      idxAboveLeft = rowCache.idx( *mfAboveLeft, posAboveLeft.x, posAboveLeft.y );
+
+      if( ( !isAvailableA1 || !mfLeft->sameMotion( idxLeft, *mfAboveLeft, idxAboveLeft ) ) && ( !isAvailableB1 || !mfAbove->sameMotion( idxAbove, *mfAboveLeft, idxAboveLeft ) ) )
       {
         isCandInter[cnt] = true;
 
         // get Inter Dir
-        mrgCtx.interDirNeighbours[cnt] = miAboveLeft.interDir;
-        mrgCtx.LICFlags          [cnt] = miAboveLeft.usesLIC;
+        mrgCtx.interDirNeighbours[cnt] = mfAboveLeft->interDir( idxAboveLeft );
+        mrgCtx.LICFlags          [cnt] = mfAboveLeft->usesLIC ( idxAboveLeft );
 
         // get Mv from Above-Left
-        mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( miAboveLeft.mv[0], miAboveLeft.refIdx[0] );
+        mrgCtx.mvFieldNeighbours[cnt << 1].setMvField( mfAboveLeft->mv( idxAboveLeft, REF_PIC_LIST_0 ), mfAboveLeft->refIdx( idxAboveLeft, REF_PIC_LIST_0 ) );
 
         if( slice.isInterB() )
         {
-          mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( miAboveLeft.mv[1], miAboveLeft.refIdx[1] );
+          mrgCtx.mvFieldNeighbours[( cnt << 1 ) + 1].setMvField( mfAboveLeft->mv( idxAboveLeft, REF_PIC_LIST_1 ), mfAboveLeft->refIdx( idxAboveLeft, REF_PIC_LIST_1 ) );
         }
 
         if( mrgCandIdx == cnt && canFastExit )
@@ -1486,19 +1506,20 @@ bool PU::getColocatedMVP(const PredictionUnit &pu, const RefPicList &eRefPicList
 
   RefPicList eColRefPicList = slice.getCheckLDC() ? eRefPicList : RefPicList(slice.getColFromL0Flag());
 
-  const MotionInfo& mi = pColPic->cs->getMotionInfo( pos );
+  const MotionField& colField = pColPic->cs->getMotionField();
+  const UInt         colIdx   = colField.idx( pos.x, pos.y );
 
-  if( !mi.isInter )
+  if( !colField.isInter( colIdx ) )
   {
     return false;
   }
 
-  int iColRefIdx = mi.refIdx[eColRefPicList];
+  int iColRefIdx = colField.refIdx( colIdx, eColRefPicList );
 
   if (iColRefIdx < 0)
   {
     eColRefPicList = RefPicList(1 - eColRefPicList);
-    iColRefIdx = mi.refIdx[eColRefPicList];
+    iColRefIdx = colField.refIdx( colIdx, eColRefPicList );
 
     if (iColRefIdx < 0)
     {
@@ -1510,7 +1531,7 @@ bool PU::getColocatedMVP(const PredictionUnit &pu, const RefPicList &eRefPicList
 
   for( const auto s : pColPic->slices )
   {
-    if( s->getIndependentSliceIdx() == mi.sliceIdx )
+    if( s->getIndependentSliceIdx() == colField.sliceIdx( colIdx ) )
     {
       pColSlice = s;
       break;
@@ -1531,11 +1552,11 @@ bool PU::getColocatedMVP(const PredictionUnit &pu, const RefPicList &eRefPicList
 
   if( LICFlag )
   {
-    *LICFlag = mi.usesLIC;
+    *LICFlag = colField.usesLIC( colIdx );
   }
 
   // Scale the vector.
-  Mv cColMv = mi.mv[eColRefPicList];
+  Mv cColMv = colField.mv( colIdx, eColRefPicList );
 
   if (bIsCurrRefLongTerm /*|| bIsColRefLongTerm*/)
   {
@@ -2031,7 +2052,8 @@ bool PU::addMVPCandUnscaled( const PredictionUnit &pu, const RefPicList &eRefPic
     return false;
   }
 
-  const MotionInfo& neibMi        = neibPU->getMotionInfo( neibPos );
+  const MotionField& neibMotion   = neibPU->cs->getBlockMotion();
+  const UInt         neibIdx      = neibMotion.idx( neibPos.x, neibPos.y );
 
   const Int        currRefPOC     = cs.slice->getRefPic( eRefPicList, iRefIdx )->getPOC();
   const RefPicList eRefPicList2nd = ( eRefPicList == REF_PIC_LIST_0 ) ? REF_PIC_LIST_1 : REF_PIC_LIST_0;
@@ -2039,7 +2061,7 @@ bool PU::addMVPCandUnscaled( const PredictionUnit &pu, const RefPicList &eRefPic
   for( Int predictorSource = 0; predictorSource < 2; predictorSource++ ) // examine the indicated reference picture list, then if not available, examine the other list.
   {
     const RefPicList eRefPicListIndex = ( predictorSource == 0 ) ? eRefPicList : eRefPicList2nd;
-    const Int        neibRefIdx       = neibMi.refIdx[eRefPicListIndex];
+    const Int        neibRefIdx       = neibMotion.refIdx( neibIdx, eRefPicListIndex );
 
     if( neibRefIdx >= 0 && currRefPOC == cs.slice->getRefPOC( eRefPicListIndex, neibRefIdx ) )
     {
@@ -2048,23 +2070,23 @@ bool PU::addMVPCandUnscaled( const PredictionUnit &pu, const RefPicList &eRefPic
         Int i = 0;
         for( i = 0; i < info.numCand; i++ )
         {
-          if( info.mvCand[i] == neibMi.mv[eRefPicListIndex] )
+          if( info.mvCand[i] == neibMotion.mv( neibIdx, eRefPicListIndex ) )
           {
             break;
           }
         }
         if( i == info.numCand )
         {
-          info.mvCand[info.numCand++] = neibMi.mv[eRefPicListIndex];
-          Mv cMvHigh = neibMi.mv[eRefPicListIndex];
+          info.mvCand[info.numCand++] = neibMotion.mv( neibIdx, eRefPicListIndex );
+          Mv cMvHigh = neibMotion.mv( neibIdx, eRefPicListIndex );
           cMvHigh.setHighPrec();
-//          CHECK( !neibMi.mv[eRefPicListIndex].highPrec, "Unexpected low precision mv.");
+//          CHECK( !neibMotion.mv( neibIdx, eRefPicListIndex ).highPrec, "Unexpected low precision mv.");
           return true;
         }
       }
       else
       {
-        info.mvCand[info.numCand++] = neibMi.mv[eRefPicListIndex];
+        info.mvCand[info.numCand++] = neibMotion.mv( neibIdx, eRefPicListIndex );
         return true;
       }
     }
@@ -2116,7 +2138,8 @@ bool PU::addMVPCandWithScaling( const PredictionUnit &pu, const RefPicList &eRef
     return false;
   }
 
-  const MotionInfo& neibMi        = neibPU->getMotionInfo( neibPos );
+  const MotionField& neibMotion   = neibPU->cs->getBlockMotion();
+  const UInt         neibIdx      = neibMotion.idx( neibPos.x, neibPos.y );
 
   const RefPicList eRefPicList2nd = ( eRefPicList == REF_PIC_LIST_0 ) ? REF_PIC_LIST_1 : REF_PIC_LIST_0;
 
@@ -2128,14 +2151,14 @@ bool PU::addMVPCandWithScaling( const PredictionUnit &pu, const RefPicList &eRef
   for( int predictorSource = 0; predictorSource < 2; predictorSource++ ) // examine the indicated reference picture list, then if not available, examine the other list.
   {
     const RefPicList eRefPicListIndex = (predictorSource == 0) ? eRefPicList : eRefPicList2nd;
-    const int        neibRefIdx       = neibMi.refIdx[eRefPicListIndex];
+    const int        neibRefIdx       = neibMotion.refIdx( neibIdx, eRefPicListIndex );
     if( neibRefIdx >= 0 )
     {
       const bool bIsNeibRefLongTerm = slice.getRefPic(eRefPicListIndex, neibRefIdx)->longTerm;
 
       if (bIsCurrRefLongTerm == bIsNeibRefLongTerm)
       {
-        Mv cMv = neibMi.mv[eRefPicListIndex];
+        Mv cMv = neibMotion.mv( neibIdx, eRefPicListIndex );
 
         if( !( bIsCurrRefLongTerm /* || bIsNeibRefLongTerm*/) )
         {
@@ -2191,14 +2214,13 @@ bool PU::isBipredRestriction(const PredictionUnit &pu)
 }
 
 static bool deriveScaledMotionTemporal( const Slice&      slice,
-                                        const Position&   colPos,
+                                        const MotionInfo& mi,
                                         const Picture*    pColPic,
                                         const RefPicList  eCurrRefPicList,
                                               Mv&         cColMv,
                                               bool&       LICFlag,
                                         const RefPicList  eFetchRefPicList )
 {
-  const MotionInfo &mi    = pColPic->cs->getMotionInfo( colPos );
   const Slice *pColSlice  = nullptr;
 
   for( const auto &pSlice : pColPic->slices )
@@ -2379,7 +2401,7 @@ bool PU::getInterMergeSubPuMvpCand( const PredictionUnit &pu, MergeCtx& mrgCtx,
       centerPos.y = Clip3( 0, ( int ) pColPic->lheight() - 1, centerPos.y );
 
       // derivation of center motion parameters from the collocated CU
-      const MotionInfo &mi = pColPic->cs->getMotionInfo( centerPos );
+      const MotionInfo mi = pColPic->cs->getMotionField().get( centerPos.x, centerPos.y );
 
       if( mi.isInter )
       {
@@ -2387,7 +2409,7 @@ bool PU::getInterMergeSubPuMvpCand( const PredictionUnit &pu, MergeCtx& mrgCtx,
         {
           RefPicList  eCurrRefPicList = RefPicList( uiCurrRefListId );
 
-          if( deriveScaledMotionTemporal( slice, centerPos, pColPic, eCurrRefPicList, cColMv, tempLICFlag, eFetchRefPicList ) )
+          if( deriveScaledMotionTemporal( slice, mi, pColPic, eCurrRefPicList, cColMv, tempLICFlag, eFetchRefPicList ) )
           {
             // set as default, for further motion vector field spanning
             mrgCtx.mvFieldNeighbours[( count << 1 ) + uiCurrRefListId].setMvField( cColMv, 0 );
@@ -2424,16 +2446,15 @@ bool PU::getInterMergeSubPuMvpCand( const PredictionUnit &pu, MergeCtx& mrgCtx,
 
   const bool isBiPred = isBipredRestriction( pu );
 
+  const MotionField& colField = pColPic->cs->getMotionField();
+
   for( int y = puPos.y; y < puPos.y + puSize.height; y += iPUHeight )
   {
+    const MotionField::Row colRow = colField.row( Clip3( 0, iPicHeight, y + yOff ) );
+
     for( int x = puPos.x; x < puPos.x + puSize.width; x += iPUWidth )
     {
-      Position colPos{ x + xOff, y + yOff };
-
-      colPos.x = Clip3( 0, iPicWidth, colPos.x );
-      colPos.y = Clip3( 0, iPicHeight, colPos.y );
-
-      const MotionInfo &colMi = pColPic->cs->getMotionInfo( colPos );
+      const MotionInfo colMi = colRow.get( Clip3( 0, iPicWidth, x + xOff ) );
 
       MotionInfo mi;
 
@@ -2445,7 +2466,7 @@ bool PU::getInterMergeSubPuMvpCand( const PredictionUnit &pu, MergeCtx& mrgCtx,
         for( UInt uiCurrRefListId = 0; uiCurrRefListId < ( bBSlice ? 2 : 1 ); uiCurrRefListId++ )
         {
           RefPicList eCurrRefPicList = RefPicList( uiCurrRefListId );
-          if( deriveScaledMotionTemporal( slice, colPos, pColPic, eCurrRefPicList, cColMv, tempLICFlag, eFetchRefPicList ) )
+          if( deriveScaledMotionTemporal( slice, colMi, pColPic, eCurrRefPicList, cColMv, tempLICFlag, eFetchRefPicList ) )
           {
             mi.refIdx[uiCurrRefListId] = 0;
             mi.mv    [uiCurrRefListId] = cColMv;
@@ -3125,6 +3146,8 @@ Void PU::setAllAffineMv( PredictionUnit& pu, Mv affLT, Mv affRT, Mv affLB, RefPi
   mb.at( mb.width - 1,             0 ).mv[eRefList] = affRT;
   mb.at(            0, mb.height - 1 ).mv[eRefList] = affLB;
   mb.at( mb.width - 1, mb.height - 1 ).mv[eRefList] = mv;
+
+  pu.cs->updateBlockMotion( pu.Y() );
 }
 
 Void PU::setAllAffineMvd( MotionBuf mb, const Mv& affLT, const Mv& affRT, RefPicList eRefList, Bool rectCUs )
@@ -3256,6 +3279,9 @@ void PU::spanLICFlags( PredictionUnit &pu, const bool LICFlag )
       mi.usesLIC = LICFlag;
     }
   }
+
+  // every write of the PU motion ends here or in setAllAffineMv
+  pu.cs->updateBlockMotion( pu.Y() );
 }
 
 Void PU::applyImv( PredictionUnit& pu, MergeCtx &mrgCtx, InterPrediction *interPred )
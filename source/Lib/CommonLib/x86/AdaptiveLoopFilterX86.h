@@ -0,0 +1,109 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     AdaptiveLoopFilterX86.h
+    \brief    SIMD adaptive loop filter (encoder covariance statistics).
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+
+#include "CommonLib/CommonDef.h"
+#include "CommonDefX86.h"
+#include "../AdaptiveLoopFilter.h"
+
+
+#if HHI_SIMD_OPT_ALF
+#ifdef TARGET_SIMD_X86
+
+template< X86_VEXT vext >
+Void alfAccumulateCovariance_SSE( const Int* ELocal, Int yLocal, Int sqrFiltLength, Int64* E, Int64* y )
+{
+  for( Int k = 0; k < sqrFiltLength; k++ )
+  {
+    Int64*        pE  = E + k * AdaptiveLoopFilter::m_MAX_SQR_FILT_LENGTH;
+    const __m128i vek = _mm_set1_epi32( ELocal[k] );
+    Int l = k;
+
+    if( vext >= AVX2 )
+    {
+#if USE_AVX2
+      for( ; l + 4 <= sqrFiltLength; l += 4 )
+      {
+        const __m256i prod = _mm256_cvtepi32_epi64( _mm_mullo_epi32( vek, _mm_loadu_si128( ( const __m128i* ) &ELocal[l] ) ) );
+        _mm256_storeu_si256( ( __m256i* ) &pE[l], _mm256_add_epi64( _mm256_loadu_si256( ( const __m256i* ) &pE[l] ), prod ) );
+      }
+#endif
+    }
+
+    for( ; l + 4 <= sqrFiltLength; l += 4 )
+    {
+      const __m128i prod = _mm_mullo_epi32( vek, _mm_loadu_si128( ( const __m128i* ) &ELocal[l] ) );
+      _mm_storeu_si128( ( __m128i* ) &pE[l    ], _mm_add_epi64( _mm_loadu_si128( ( const __m128i* ) &pE[l    ] ), _mm_cvtepi32_epi64( prod ) ) );
+      _mm_storeu_si128( ( __m128i* ) &pE[l + 2], _mm_add_epi64( _mm_loadu_si128( ( const __m128i* ) &pE[l + 2] ), _mm_cvtepi32_epi64( _mm_srli_si128( prod, 8 ) ) ) );
+    }
+
+    for( ; l < sqrFiltLength; l++ )
+    {
+      pE[l] += ELocal[k] * ELocal[l];
+    }
+  }
+
+  // cross-correlation
+  const __m128i vy = _mm_set1_epi32( yLocal );
+  Int k = 0;
+  for( ; k + 4 <= sqrFiltLength; k += 4 )
+  {
+    const __m128i prod = _mm_mullo_epi32( vy, _mm_loadu_si128( ( const __m128i* ) &ELocal[k] ) );
+    _mm_storeu_si128( ( __m128i* ) &y[k    ], _mm_add_epi64( _mm_loadu_si128( ( const __m128i* ) &y[k    ] ), _mm_cvtepi32_epi64( prod ) ) );
+    _mm_storeu_si128( ( __m128i* ) &y[k + 2], _mm_add_epi64( _mm_loadu_si128( ( const __m128i* ) &y[k + 2] ), _mm_cvtepi32_epi64( _mm_srli_si128( prod, 8 ) ) ) );
+  }
+  for( ; k < sqrFiltLength; k++ )
+  {
+    y[k] += ELocal[k] * yLocal;
+  }
+}
+
+template<X86_VEXT vext>
+Void AdaptiveLoopFilter::_initAdaptiveLoopFilterX86()
+{
+  m_accumulateCovariance = alfAccumulateCovariance_SSE<vext>;
+}
+
+template Void AdaptiveLoopFilter::_initAdaptiveLoopFilterX86<SIMDX86>();
+
+#endif // TARGET_SIMD_X86
+#endif
+//! \}
@@ -0,0 +1,389 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     BilateralFilterX86.h
+    \brief    SIMD bilateral filter
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+
+#include "CommonLib/CommonDef.h"
+#include "CommonDefX86.h"
+#include "../BilateralFilter.h"
+
+
+#if HHI_SIMD_OPT_BIF
+#ifdef TARGET_SIMD_X86
+
+#define BIF_MAX_TABLE_CHUNKS 16
+#define BIF_LINE_PAD         16
+
+// looks up the weights for the byte indices, the table is split into chunks of 16 entries, each looked up with a byte shuffle
+static inline __m128i bifLookup_SSE( const __m128i& idx, const __m128i* vtab, Int numChunks )
+{
+  const __m128i vlo = _mm_and_si128( idx, _mm_set1_epi8( 0x0f ) );
+  const __m128i vhi = _mm_and_si128( _mm_srli_epi16( idx, 4 ), _mm_set1_epi8( 0x0f ) );
+  __m128i vres      = _mm_shuffle_epi8( vtab[0], vlo );
+  vres              = _mm_and_si128( vres, _mm_cmpeq_epi8( vhi, _mm_setzero_si128() ) );
+
+  for( Int k = 1; k < numChunks; k++ )
+  {
+    const __m128i vsel = _mm_cmpeq_epi8( vhi, _mm_set1_epi8( ( SChar ) k ) );
+    vres = _mm_or_si128( vres, _mm_and_si128( vsel, _mm_shuffle_epi8( vtab[k], vlo ) ) );
+  }
+  return vres;
+}
+
+// ( N * divToMulOneOverN[W] ) >> ( BITS_PER_DIV_LUT_ENTRY + divToMulShift[W] ) per 32 bit lane, the product wraps like the C implementation
+static inline __m128i bifDivide_SSE( const __m128i& vnum, const __m128i& vden, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift )
+{
+  const Int w0 = _mm_extract_epi32( vden, 0 );
+  const Int w1 = _mm_extract_epi32( vden, 1 );
+  const Int w2 = _mm_extract_epi32( vden, 2 );
+  const Int w3 = _mm_extract_epi32( vden, 3 );
+
+  const __m128i vprod = _mm_mullo_epi32( vnum, _mm_setr_epi32( divToMulOneOverN[w0], divToMulOneOverN[w1], divToMulOneOverN[w2], divToMulOneOverN[w3] ) );
+
+  // per lane right shift: the high dword of the multiplication with 2^( 32 - shift )
+  const __m128i vfac  = _mm_setr_epi32( 1 << ( 32 - BITS_PER_DIV_LUT_ENTRY - divToMulShift[w0] ), 1 << ( 32 - BITS_PER_DIV_LUT_ENTRY - divToMulShift[w1] ),
+                                        1 << ( 32 - BITS_PER_DIV_LUT_ENTRY - divToMulShift[w2] ), 1 << ( 32 - BITS_PER_DIV_LUT_ENTRY - divToMulShift[w3] ) );
+  const __m128i vev   = _mm_srli_epi64( _mm_mul_epu32( vprod, vfac ), 32 );
+  const __m128i vod   = _mm_mul_epu32( _mm_srli_epi64( vprod, 32 ), _mm_srli_epi64( vfac, 32 ) );
+  return _mm_blend_epi16( vev, vod, 0xCC );
+}
+
+// filters 8 samples given their neighbours, the weights of neighbours outside of the block are masked out
+static inline __m128i bifFilter_SSE( const __m128i& vc, const __m128i& vl, const __m128i& vr, const __m128i& vt, const __m128i& vb,
+                                     const __m128i& vmaskL, const __m128i& vmaskR, const __m128i& vmaskT, const __m128i& vmaskB,
+                                     const __m128i* vtab, Int numChunks, const __m128i& vmaxPos, const __m128i& vcw, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift )
+{
+  const __m128i vzero = _mm_setzero_si128();
+  const __m128i vdR   = _mm_sub_epi16( vr, vc );
+  const __m128i vdL   = _mm_sub_epi16( vl, vc );
+  const __m128i vdB   = _mm_sub_epi16( vb, vc );
+  const __m128i vdT   = _mm_sub_epi16( vt, vc );
+
+  const __m128i vwRL  = bifLookup_SSE( _mm_packus_epi16( _mm_min_epi16( _mm_abs_epi16( vdR ), vmaxPos ), _mm_min_epi16( _mm_abs_epi16( vdL ), vmaxPos ) ), vtab, numChunks );
+  const __m128i vwBT  = bifLookup_SSE( _mm_packus_epi16( _mm_min_epi16( _mm_abs_epi16( vdB ), vmaxPos ), _mm_min_epi16( _mm_abs_epi16( vdT ), vmaxPos ) ), vtab, numChunks );
+
+  const __m128i vwR   = _mm_and_si128( _mm_unpacklo_epi8( vwRL, vzero ), vmaskR );
+  const __m128i vwL   = _mm_and_si128( _mm_unpackhi_epi8( vwRL, vzero ), vmaskL );
+  const __m128i vwB   = _mm_and_si128( _mm_unpacklo_epi8( vwBT, vzero ), vmaskB );
+  const __m128i vwT   = _mm_and_si128( _mm_unpackhi_epi8( vwBT, vzero ), vmaskT );
+
+  const __m128i vsumW = _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( vwR, vwL ), _mm_add_epi16( vwB, vwT ) ), vcw );
+
+  __m128i vres[2];
+  for( Int h = 0; h < 2; h++ )
+  {
+    const __m128i vdelta = h == 0
+                         ? _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vwR, vwL ), _mm_unpacklo_epi16( vdR, vdL ) ),
+                                          _mm_madd_epi16( _mm_unpacklo_epi16( vwB, vwT ), _mm_unpacklo_epi16( vdB, vdT ) ) )
+                         : _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vwR, vwL ), _mm_unpackhi_epi16( vdR, vdL ) ),
+                                          _mm_madd_epi16( _mm_unpackhi_epi16( vwB, vwT ), _mm_unpackhi_epi16( vdB, vdT ) ) );
+    const __m128i vden   = h == 0 ? _mm_unpacklo_epi16( vsumW, vzero ) : _mm_unpackhi_epi16( vsumW, vzero );
+    const __m128i vneg   = _mm_srai_epi32( vdelta, 31 );
+    const __m128i vnum   = _mm_add_epi32( _mm_abs_epi32( vdelta ), _mm_srai_epi32( _mm_add_epi32( vden, vneg ), 1 ) );
+    const __m128i vq     = bifDivide_SSE( vnum, vden, divToMulOneOverN, divToMulShift );
+
+    vres[h] = _mm_sub_epi32( _mm_xor_si128( vq, vneg ), vneg );
+  }
+
+  return _mm_add_epi16( vc, _mm_packs_epi32( vres[0], vres[1] ) );
+}
+
+#if USE_AVX2
+// filters 16 samples given their neighbours, the weights of neighbours outside of the block are masked out
+static inline __m256i bifFilter_AVX2( const __m256i& vc, const __m256i& vl, const __m256i& vr, const __m256i& vt, const __m256i& vb,
+                                      const __m256i& vmaskL, const __m256i& vmaskR, const __m256i& vmaskT, const __m256i& vmaskB,
+                                      const __m256i* vtab, Int numChunks, const __m256i& vmaxPos, const __m256i& vcw, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift )
+{
+  const __m256i vzero  = _mm256_setzero_si256();
+  const __m256i vdR    = _mm256_sub_epi16( vr, vc );
+  const __m256i vdL    = _mm256_sub_epi16( vl, vc );
+  const __m256i vdB    = _mm256_sub_epi16( vb, vc );
+  const __m256i vdT    = _mm256_sub_epi16( vt, vc );
+
+  const __m256i vidxRL = _mm256_packus_epi16( _mm256_min_epi16( _mm256_abs_epi16( vdR ), vmaxPos ), _mm256_min_epi16( _mm256_abs_epi16( vdL ), vmaxPos ) );
+  const __m256i vidxBT = _mm256_packus_epi16( _mm256_min_epi16( _mm256_abs_epi16( vdB ), vmaxPos ), _mm256_min_epi16( _mm256_abs_epi16( vdT ), vmaxPos ) );
+  const __m256i vloRL  = _mm256_and_si256( vidxRL, _mm256_set1_epi8( 0x0f ) );
+  const __m256i vhiRL  = _mm256_and_si256( _mm256_srli_epi16( vidxRL, 4 ), _mm256_set1_epi8( 0x0f ) );
+  const __m256i vloBT  = _mm256_and_si256( vidxBT, _mm256_set1_epi8( 0x0f ) );
+  const __m256i vhiBT  = _mm256_and_si256( _mm256_srli_epi16( vidxBT, 4 ), _mm256_set1_epi8( 0x0f ) );
+
+  __m256i vwRL = _mm256_and_si256( _mm256_shuffle_epi8( vtab[0], vloRL ), _mm256_cmpeq_epi8( vhiRL, vzero ) );
+  __m256i vwBT = _mm256_and_si256( _mm256_shuffle_epi8( vtab[0], vloBT ), _mm256_cmpeq_epi8( vhiBT, vzero ) );
+  for( Int k = 1; k < numChunks; k++ )
+  {
+    const __m256i vk = _mm256_set1_epi8( ( SChar ) k );
+    vwRL = _mm256_or_si256( vwRL, _mm256_and_si256( _mm256_cmpeq_epi8( vhiRL, vk ), _mm256_shuffle_epi8( vtab[k], vloRL ) ) );
+    vwBT = _mm256_or_si256( vwBT, _mm256_and_si256( _mm256_cmpeq_epi8( vhiBT, vk ), _mm256_shuffle_epi8( vtab[k], vloBT ) ) );
+  }
+
+  // in lane unpacking restores the sample order of the in lane packing
+  const __m256i vwR    = _mm256_and_si256( _mm256_unpacklo_epi8( vwRL, vzero ), vmaskR );
+  const __m256i vwL    = _mm256_and_si256( _mm256_unpackhi_epi8( vwRL, vzero ), vmaskL );
+  const __m256i vwB    = _mm256_and_si256( _mm256_unpacklo_epi8( vwBT, vzero ), vmaskB );
+  const __m256i vwT    = _mm256_and_si256( _mm256_unpackhi_epi8( vwBT, vzero ), vmaskT );
+
+  const __m256i vsumW  = _mm256_add_epi16( _mm256_add_epi16( _mm256_add_epi16( vwR, vwL ), _mm256_add_epi16( vwB, vwT ) ), vcw );
+
+  __m256i vres[2];
+  for( Int h = 0; h < 2; h++ )
+  {
+    const __m256i vdelta = h == 0
+                         ? _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpacklo_epi16( vwR, vwL ), _mm256_unpacklo_epi16( vdR, vdL ) ),
+                                             _mm256_madd_epi16( _mm256_unpacklo_epi16( vwB, vwT ), _mm256_unpacklo_epi16( vdB, vdT ) ) )
+                         : _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpackhi_epi16( vwR, vwL ), _mm256_unpackhi_epi16( vdR, vdL ) ),
+                                             _mm256_madd_epi16( _mm256_unpackhi_epi16( vwB, vwT ), _mm256_unpackhi_epi16( vdB, vdT ) ) );
+    const __m256i vden   = h == 0 ? _mm256_unpacklo_epi16( vsumW, vzero ) : _mm256_unpackhi_epi16( vsumW, vzero );
+    const __m256i vneg   = _mm256_srai_epi32( vdelta, 31 );
+    const __m256i vnum   = _mm256_add_epi32( _mm256_abs_epi32( vdelta ), _mm256_srai_epi32( _mm256_add_epi32( vden, vneg ), 1 ) );
+
+    // the table weights are at most 31 and the center weight at most 196, hence the sum of weights is at most 320
+    // and the 4 byte reads of the shift table stay within the table
+    const __m256i vmul   = _mm256_i32gather_epi32( ( const int* ) divToMulOneOverN, vden, 4 );
+    const __m256i vshift = _mm256_and_si256( _mm256_i32gather_epi32( ( const int* ) divToMulShift, vden, 1 ), _mm256_set1_epi32( 0xff ) );
+    const __m256i vq     = _mm256_srlv_epi32( _mm256_mullo_epi32( vnum, vmul ), _mm256_add_epi32( vshift, _mm256_set1_epi32( BITS_PER_DIV_LUT_ENTRY ) ) );
+
+    vres[h] = _mm256_sub_epi32( _mm256_xor_si256( vq, vneg ), vneg );
+  }
+
+  return _mm256_add_epi16( vc, _mm256_packs_epi32( vres[0], vres[1] ) );
+}
+#endif
+
+// copies a block line into a line buffer, the samples next to the line are zeroed (their weights are masked out)
+static inline Void bifCopyLine( Short* dst, const Short* src, Int width )
+{
+  memcpy( dst, src, width * sizeof( Short ) );
+  dst[-1] = 0;
+  _mm_storeu_si128( ( __m128i* ) ( dst + width     ), _mm_setzero_si128() );
+  _mm_storeu_si128( ( __m128i* ) ( dst + width + 8 ), _mm_setzero_si128() );
+}
+
+template<X86_VEXT vext>
+static void bifSmoothBlock_SSE( short block[], int width, int height, int centerWeight, const UShort* lookupTable, int maxPos, const unsigned* divToMulOneOverN, const uint8_t* divToMulShift )
+{
+  // the weights fit into bytes
+  const Int numChunks = ( maxPos >> 4 ) + 1;
+  __m128i   vtab[BIF_MAX_TABLE_CHUNKS];
+
+  CHECK( numChunks > BIF_MAX_TABLE_CHUNKS, "Bilateral filter table too large" );
+
+  for( Int k = 0; k < numChunks; k++ )
+  {
+    vtab[k] = _mm_packus_epi16( _mm_loadu_si128( ( const __m128i* ) ( lookupTable + 16 * k ) ), _mm_loadu_si128( ( const __m128i* ) ( lookupTable + 16 * k + 8 ) ) );
+  }
+
+  const __m128i vmaxPos = _mm_set1_epi16( maxPos );
+  const __m128i vcw     = _mm_set1_epi16( centerWeight );
+
+  // the block is filtered in place and has a stride equal to its width. Narrow blocks are processed several lines per
+  // vector, the unfiltered lines above are kept in registers. The horizontal neighbours are obtained by shifting within
+  // the lines, which feeds zeros at the block edges (their weights are masked out).
+#if USE_AVX2
+  if( vext >= AVX2 && width == 8 )
+  {
+    const __m256i vmaxPos256 = _mm256_set1_epi16( maxPos );
+    const __m256i vcw256     = _mm256_set1_epi16( centerWeight );
+    const __m256i vmaskL     = _mm256_setr_epi16( 0, -1, -1, -1, -1, -1, -1, -1, 0, -1, -1, -1, -1, -1, -1, -1 );
+    const __m256i vmaskR     = _mm256_setr_epi16( -1, -1, -1, -1, -1, -1, -1, 0, -1, -1, -1, -1, -1, -1, -1, 0 );
+    const __m256i vlineIdx   = _mm256_setr_epi16( 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1 );
+    const __m256i vlastLine  = _mm256_set1_epi16( height - 1 );
+
+    __m256i vtab256[BIF_MAX_TABLE_CHUNKS];
+    for( Int k = 0; k < numChunks; k++ )
+    {
+      vtab256[k] = _mm256_broadcastsi128_si256( vtab[k] );
+    }
+
+    __m256i vprev = _mm256_setzero_si256();
+    __m256i vc    = _mm256_loadu_si256( ( const __m256i* ) block );
+
+    for( Int y = 0; y < height; y += 2 )
+    {
+      const __m256i vnext  = y + 2 < height ? _mm256_loadu_si256( ( const __m256i* ) ( block + ( y + 2 ) * 8 ) ) : _mm256_setzero_si256();
+      const __m256i vline  = _mm256_add_epi16( _mm256_set1_epi16( y ), vlineIdx );
+      const __m256i vmaskT = _mm256_cmpgt_epi16( vline, _mm256_setzero_si256() );
+      const __m256i vmaskB = _mm256_cmpgt_epi16( vlastLine, vline );
+
+      const __m256i vt     = _mm256_permute2x128_si256( vprev, vc, 0x21 );
+      const __m256i vb     = _mm256_permute2x128_si256( vc, vnext, 0x21 );
+
+      const __m256i vres   = bifFilter_AVX2( vc, _mm256_slli_si256( vc, 2 ), _mm256_srli_si256( vc, 2 ), vt, vb, vmaskL, vmaskR, vmaskT, vmaskB,
+                                             vtab256, numChunks, vmaxPos256, vcw256, divToMulOneOverN, divToMulShift );
+      _mm256_storeu_si256( ( __m256i* ) ( block + y * 8 ), vres );
+
+      vprev = vc;
+      vc    = vnext;
+    }
+    return;
+  }
+#endif
+
+  if( width <= 8 )
+  {
+    // two lines of 4 samples or one line of 8 samples per vector
+    const Int     numLines  = 8 / width;
+    const __m128i vmaskL    = width == 4 ? _mm_setr_epi16( 0, -1, -1, -1, 0, -1, -1, -1 ) : _mm_setr_epi16( 0, -1, -1, -1, -1, -1, -1, -1 );
+    const __m128i vmaskR    = width == 4 ? _mm_setr_epi16( -1, -1, -1, 0, -1, -1, -1, 0 ) : _mm_setr_epi16( -1, -1, -1, -1, -1, -1, -1, 0 );
+    const __m128i vlineIdx  = width == 4 ? _mm_setr_epi16( 0, 0, 0, 0, 1, 1, 1, 1 ) : _mm_setzero_si128();
+    const __m128i vlastLine = _mm_set1_epi16( height - 1 );
+
+    __m128i vprev = _mm_setzero_si128();
+    __m128i vc    = _mm_loadu_si128( ( const __m128i* ) block );
+
+    for( Int y = 0; y < height; y += numLines )
+    {
+      const __m128i vnext  = y + numLines < height ? _mm_loadu_si128( ( const __m128i* ) ( block + ( y + numLines ) * width ) ) : _mm_setzero_si128();
+      const __m128i vline  = _mm_add_epi16( _mm_set1_epi16( y ), vlineIdx );
+      const __m128i vmaskT = _mm_cmpgt_epi16( vline, _mm_setzero_si128() );
+      const __m128i vmaskB = _mm_cmpgt_epi16( vlastLine, vline );
+
+      __m128i vl, vr, vt, vb;
+      if( width == 4 )
+      {
+        vl = _mm_slli_epi64( vc, 16 );
+        vr = _mm_srli_epi64( vc, 16 );
+        vt = _mm_alignr_epi8( vc, vprev, 8 );
+        vb = _mm_alignr_epi8( vnext, vc, 8 );
+      }
+      else
+      {
+        vl = _mm_slli_si128( vc, 2 );
+        vr = _mm_srli_si128( vc, 2 );
+        vt = vprev;
+        vb = vnext;
+      }
+
+      const __m128i vres = bifFilter_SSE( vc, vl, vr, vt, vb, vmaskL, vmaskR, vmaskT, vmaskB, vtab, numChunks, vmaxPos, vcw, divToMulOneOverN, divToMulShift );
+      _mm_storeu_si128( ( __m128i* ) ( block + y * width ), vres );
+
+      vprev = vc;
+      vc    = vnext;
+    }
+    return;
+  }
+
+  // wide blocks: the unfiltered lines above, at and below the current line are kept in line buffers
+  Short  lineBuf[3][MAX_CU_SIZE + 2 * BIF_LINE_PAD];
+  Short* pTop = lineBuf[0] + BIF_LINE_PAD;
+  Short* pCur = lineBuf[1] + BIF_LINE_PAD;
+  Short* pBot = lineBuf[2] + BIF_LINE_PAD;
+
+  bifCopyLine( pCur, block, width );
+  bifCopyLine( pBot, block + width, width );
+  pTop = pCur;
+
+  for( Int y = 0; y < height; y++ )
+  {
+    Short* pDst = block + y * width;
+
+#if USE_AVX2
+    if( vext >= AVX2 )
+    {
+      const __m256i vmaxPos256 = _mm256_set1_epi16( maxPos );
+      const __m256i vcw256     = _mm256_set1_epi16( centerWeight );
+      const __m256i viota      = _mm256_setr_epi16( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+      const __m256i vmaskT     = _mm256_set1_epi16( y > 0 ? -1 : 0 );
+      const __m256i vmaskB     = _mm256_set1_epi16( y < height - 1 ? -1 : 0 );
+
+      __m256i vtab256[BIF_MAX_TABLE_CHUNKS];
+      for( Int k = 0; k < numChunks; k++ )
+      {
+        vtab256[k] = _mm256_broadcastsi128_si256( vtab[k] );
+      }
+
+      for( Int x = 0; x < width; x += 16 )
+      {
+        const __m256i vmaskL = _mm256_cmpgt_epi16( viota, _mm256_set1_epi16( -x ) );
+        const __m256i vmaskR = _mm256_cmpgt_epi16( _mm256_set1_epi16( width - 1 - x ), viota );
+
+        const __m256i vres   = bifFilter_AVX2( _mm256_loadu_si256( ( const __m256i* ) ( pCur + x ) ),
+                                               _mm256_loadu_si256( ( const __m256i* ) ( pCur + x - 1 ) ),
+                                               _mm256_loadu_si256( ( const __m256i* ) ( pCur + x + 1 ) ),
+                                               _mm256_loadu_si256( ( const __m256i* ) ( pTop + x ) ),
+                                               _mm256_loadu_si256( ( const __m256i* ) ( pBot + x ) ),
+                                               vmaskL, vmaskR, vmaskT, vmaskB, vtab256, numChunks, vmaxPos256, vcw256, divToMulOneOverN, divToMulShift );
+        _mm256_storeu_si256( ( __m256i* ) ( pDst + x ), vres );
+      }
+    }
+    else
+#endif
+    {
+      const __m128i viota  = _mm_setr_epi16( 0, 1, 2, 3, 4, 5, 6, 7 );
+      const __m128i vmaskT = _mm_set1_epi16( y > 0 ? -1 : 0 );
+      const __m128i vmaskB = _mm_set1_epi16( y < height - 1 ? -1 : 0 );
+
+      for( Int x = 0; x < width; x += 8 )
+      {
+        const __m128i vmaskL = _mm_cmpgt_epi16( viota, _mm_set1_epi16( -x ) );
+        const __m128i vmaskR = _mm_cmpgt_epi16( _mm_set1_epi16( width - 1 - x ), viota );
+
+        const __m128i vres   = bifFilter_SSE( _mm_loadu_si128( ( const __m128i* ) ( pCur + x ) ),
+                                              _mm_loadu_si128( ( const __m128i* ) ( pCur + x - 1 ) ),
+                                              _mm_loadu_si128( ( const __m128i* ) ( pCur + x + 1 ) ),
+                                              _mm_loadu_si128( ( const __m128i* ) ( pTop + x ) ),
+                                              _mm_loadu_si128( ( const __m128i* ) ( pBot + x ) ),
+                                              vmaskL, vmaskR, vmaskT, vmaskB, vtab, numChunks, vmaxPos, vcw, divToMulOneOverN, divToMulShift );
+        _mm_storeu_si128( ( __m128i* ) ( pDst + x ), vres );
+      }
+    }
+
+    // rotate the line buffers, the line below the last line is never used (its weights are masked out)
+    Short* pFree = pTop == pCur ? lineBuf[0] + BIF_LINE_PAD : pTop;
+    pTop = pCur;
+    pCur = pBot;
+    if( y + 2 < height )
+    {
+      bifCopyLine( pFree, block + ( y + 2 ) * width, width );
+      pBot = pFree;
+    }
+  }
+}
+
+template<X86_VEXT vext>
+void BilateralFilter::_initBilateralFilterX86()
+{
+  m_smoothBlock = bifSmoothBlock_SSE<vext>;
+}
+
+template void BilateralFilter::_initBilateralFilterX86<SIMDX86>();
+
+#endif // TARGET_SIMD_X86
+#endif
+//! \}
@@ -317,6 +317,289 @@ Void linTf_SSE( const Pel* src, Int srcStride, Pel *dst, Int dstStride, Int widt
   }
 }
 
+template<X86_VEXT vext>
+Void packLowBytes_SSE( const Pel* src, UChar* dst, Int num )
+{
+  Int i = 0;
+#if USE_AVX2
+  if( vext >= AVX2 )
+  {
+    const __m256i vmask = _mm256_set1_epi16( 0xff );
+    for( ; i + 32 <= num; i += 32 )
+    {
+      __m256i vsrc0 = _mm256_and_si256( _mm256_loadu_si256( ( const __m256i* ) &src[i      ] ), vmask );
+      __m256i vsrc1 = _mm256_and_si256( _mm256_loadu_si256( ( const __m256i* ) &src[i + 16] ), vmask );
+      // packus works within the 128 bit lanes, restore the sample order
+      __m256i vdst  = _mm256_permute4x64_epi64( _mm256_packus_epi16( vsrc0, vsrc1 ), 0xd8 );
+      _mm256_storeu_si256( ( __m256i* ) &dst[i], vdst );
+    }
+  }
+#endif
+  const __m128i vmask = _mm_set1_epi16( 0xff );
+  for( ; i + 16 <= num; i += 16 )
+  {
+    __m128i vsrc0 = _mm_and_si128( _mm_loadu_si128( ( const __m128i* ) &src[i    ] ), vmask );
+    __m128i vsrc1 = _mm_and_si128( _mm_loadu_si128( ( const __m128i* ) &src[i + 8] ), vmask );
+    _mm_storeu_si128( ( __m128i* ) &dst[i], _mm_packus_epi16( vsrc0, vsrc1 ) );
+  }
+  for( ; i < num; i++ )
+  {
+    dst[i] = UChar( src[i] );
+  }
+}
+
+template<X86_VEXT vext>
+UInt64 sse_SSE( const Pel* src0, Int src0Stride, const Pel* src1, Int src1Stride, Int width, Int height )
+{
+  // the squared differences are summed pairwise in 32 bit (at most 2 * 32767^2) and accumulated in 64 bit
+  UInt64  sum   = 0;
+  __m128i vsum  = _mm_setzero_si128();
+  __m128i vzero = _mm_setzero_si128();
+#if USE_AVX2
+  __m256i vsum256  = _mm256_setzero_si256();
+  __m256i vzero256 = _mm256_setzero_si256();
+#endif
+
+  for( Int y = 0; y < height; y++ )
+  {
+    Int x = 0;
+#if USE_AVX2
+    if( vext >= AVX2 )
+    {
+      for( ; x + 16 <= width; x += 16 )
+      {
+        __m256i vdiff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* ) &src0[x] ), _mm256_loadu_si256( ( const __m256i* ) &src1[x] ) );
+        __m256i vsqr  = _mm256_madd_epi16( vdiff, vdiff );
+        vsum256 = _mm256_add_epi64( vsum256, _mm256_unpacklo_epi32( vsqr, vzero256 ) );
+        vsum256 = _mm256_add_epi64( vsum256, _mm256_unpackhi_epi32( vsqr, vzero256 ) );
+      }
+    }
+#endif
+    for( ; x + 8 <= width; x += 8 )
+    {
+      __m128i vdiff = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* ) &src0[x] ), _mm_loadu_si128( ( const __m128i* ) &src1[x] ) );
+      __m128i vsqr  = _mm_madd_epi16( vdiff, vdiff );
+      vsum = _mm_add_epi64( vsum, _mm_unpacklo_epi32( vsqr, vzero ) );
+      vsum = _mm_add_epi64( vsum, _mm_unpackhi_epi32( vsqr, vzero ) );
+    }
+    for( ; x < width; x++ )
+    {
+      const Int diff = src0[x] - src1[x];
+      sum += UInt64( diff * diff );
+    }
+    src0 += src0Stride;
+    src1 += src1Stride;
+  }
+
+#if USE_AVX2
+  vsum = _mm_add_epi64( vsum, _mm_add_epi64( _mm256_castsi256_si128( vsum256 ), _mm256_extracti128_si256( vsum256, 1 ) ) );
+#endif
+  UInt64 partSums[2];
+  _mm_storeu_si128( ( __m128i* ) partSums, vsum );
+
+  return sum + partSums[0] + partSums[1];
+}
+
+template<X86_VEXT vext>
+Void sumAndSqr_SSE( const Pel* src, Int srcStride, Int width, Int height, UInt64& sum, UInt64& sumSqr )
+{
+  // the samples are summed pairwise in 32 bit for each row, the squares pairwise by madd, both are accumulated in 64 bit
+  const __m128i vone   = _mm_set1_epi16( 1 );
+  const __m128i vzero  = _mm_setzero_si128();
+  __m128i       vsum   = _mm_setzero_si128();
+  __m128i       vsqr   = _mm_setzero_si128();
+  Int64         sumRem = 0;
+  UInt64        sqrRem = 0;
+
+  for( Int y = 0; y < height; y++ )
+  {
+    __m128i vrow = _mm_setzero_si128();
+    Int x = 0;
+#if USE_AVX2
+    if( vext >= AVX2 )
+    {
+      const __m256i vone256  = _mm256_set1_epi16( 1 );
+      const __m256i vzero256 = _mm256_setzero_si256();
+      __m256i       vrow256  = _mm256_setzero_si256();
+      __m256i       vsqr256  = _mm256_setzero_si256();
+      for( ; x + 16 <= width; x += 16 )
+      {
+        __m256i vsrc = _mm256_loadu_si256( ( const __m256i* ) &src[x] );
+        __m256i vsq  = _mm256_madd_epi16( vsrc, vsrc );
+        vrow256 = _mm256_add_epi32( vrow256, _mm256_madd_epi16( vsrc, vone256 ) );
+        vsqr256 = _mm256_add_epi64( vsqr256, _mm256_unpacklo_epi32( vsq, vzero256 ) );
+        vsqr256 = _mm256_add_epi64( vsqr256, _mm256_unpackhi_epi32( vsq, vzero256 ) );
+      }
+      vrow = _mm_add_epi32( _mm256_castsi256_si128( vrow256 ), _mm256_extracti128_si256( vrow256, 1 ) );
+      vsqr = _mm_add_epi64( vsqr, _mm_add_epi64( _mm256_castsi256_si128( vsqr256 ), _mm256_extracti128_si256( vsqr256, 1 ) ) );
+    }
+#endif
+    for( ; x + 8 <= width; x += 8 )
+    {
+      __m128i vsrc = _mm_loadu_si128( ( const __m128i* ) &src[x] );
+      __m128i vsq  = _mm_madd_epi16( vsrc, vsrc );
+      vrow = _mm_add_epi32( vrow, _mm_madd_epi16( vsrc, vone ) );
+      vsqr = _mm_add_epi64( vsqr, _mm_unpacklo_epi32( vsq, vzero ) );
+      vsqr = _mm_add_epi64( vsqr, _mm_unpackhi_epi32( vsq, vzero ) );
+    }
+    vsum = _mm_add_epi64( vsum, _mm_cvtepi32_epi64( vrow ) );
+    vsum = _mm_add_epi64( vsum, _mm_cvtepi32_epi64( _mm_unpackhi_epi64( vrow, vrow ) ) );
+    for( ; x < width; x++ )
+    {
+      sumRem += src[x];
+      sqrRem += src[x] * src[x];
+    }
+    src += srcStride;
+  }
+
+  UInt64 partSums[2], partSqrs[2];
+  _mm_storeu_si128( ( __m128i* ) partSums, vsum );
+  _mm_storeu_si128( ( __m128i* ) partSqrs, vsqr );
+
+  sum    = UInt64( sumRem ) + partSums[0] + partSums[1];
+  sumSqr = sqrRem + partSqrs[0] + partSqrs[1];
+}
+
+template<X86_VEXT vext>
+Void histogram_SSE( const Pel* src, Int srcStride, Int width, Int height, Int* hist, Int numBins )
+{
+  // the clipping to the bins is vectorized, the bins are counted into two interleaved histograms to break the
+  // dependency between consecutive increments of the same bin
+  const __m128i vmax = _mm_set1_epi16( Short( std::min( numBins - 1, 32767 ) ) );
+  const __m128i vmin = _mm_setzero_si128();
+  // without RExt__HIGH_BIT_DEPTH_SUPPORT the internal bit depth is at most 12
+  const Int maxBins = 1 << 12;
+  CHECKD( numBins > maxBins, "Too many histogram bins" );
+  Int histOdd[maxBins];
+  std::fill( histOdd, histOdd + numBins, 0 );
+  Short idx[8];
+
+  for( Int y = 0; y < height; y++ )
+  {
+    Int x = 0;
+    for( ; x + 8 <= width; x += 8 )
+    {
+      _mm_storeu_si128( ( __m128i* ) idx, _mm_min_epi16( _mm_max_epi16( _mm_loadu_si128( ( const __m128i* ) &src[x] ), vmin ), vmax ) );
+      hist   [idx[0]]++;
+      histOdd[idx[1]]++;
+      hist   [idx[2]]++;
+      histOdd[idx[3]]++;
+      hist   [idx[4]]++;
+      histOdd[idx[5]]++;
+      hist   [idx[6]]++;
+      histOdd[idx[7]]++;
+    }
+    for( ; x < width; x++ )
+    {
+      hist[Clip3( 0, numBins - 1, Int( src[x] ) )]++;
+    }
+    src += srcStride;
+  }
+
+  for( Int i = 0; i < numBins; i++ )
+  {
+    hist[i] += histOdd[i];
+  }
+}
+
+template<X86_VEXT vext>
+Int64 sadWeighted_SSE( const Pel* org, Int orgStride, const Pel* ref, Int refStride, Int width, Int height, Int orgShift, Int weight, Int offset )
+{
+  // the weighted differences are computed in 32 bit and their absolute values accumulated in 64 bit
+  const __m128i vshift  = _mm_cvtsi32_si128( orgShift );
+  const __m128i vweight = _mm_set1_epi32( weight );
+  const __m128i voffset = _mm_set1_epi32( offset );
+  const __m128i vzero   = _mm_setzero_si128();
+  __m128i       vsad    = _mm_setzero_si128();
+  Int64         sad     = 0;
+#if USE_AVX2
+  const __m256i vweight256 = _mm256_set1_epi32( weight );
+  const __m256i voffset256 = _mm256_set1_epi32( offset );
+  const __m256i vzero256   = _mm256_setzero_si256();
+  __m256i       vsad256    = _mm256_setzero_si256();
+#endif
+
+  for( Int y = 0; y < height; y++ )
+  {
+    Int x = 0;
+#if USE_AVX2
+    if( vext >= AVX2 )
+    {
+      for( ; x + 8 <= width; x += 8 )
+      {
+        __m256i vorg  = _mm256_sll_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* ) &org[x] ) ), vshift );
+        __m256i vref  = _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* ) &ref[x] ) );
+        __m256i vdiff = _mm256_abs_epi32( _mm256_sub_epi32( vorg, _mm256_add_epi32( _mm256_mullo_epi32( vref, vweight256 ), voffset256 ) ) );
+        vsad256 = _mm256_add_epi64( vsad256, _mm256_unpacklo_epi32( vdiff, vzero256 ) );
+        vsad256 = _mm256_add_epi64( vsad256, _mm256_unpackhi_epi32( vdiff, vzero256 ) );
+      }
+    }
+#endif
+    for( ; x + 4 <= width; x += 4 )
+    {
+      __m128i vorg  = _mm_sll_epi32( _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &org[x] ) ), vshift );
+      __m128i vref  = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &ref[x] ) );
+      __m128i vdiff = _mm_abs_epi32( _mm_sub_epi32( vorg, _mm_add_epi32( _mm_mullo_epi32( vref, vweight ), voffset ) ) );
+      vsad = _mm_add_epi64( vsad, _mm_unpacklo_epi32( vdiff, vzero ) );
+      vsad = _mm_add_epi64( vsad, _mm_unpackhi_epi32( vdiff, vzero ) );
+    }
+    for( ; x < width; x++ )
+    {
+      sad += abs( ( Int( org[x] ) << orgShift ) - ( ref[x] * weight + offset ) );
+    }
+    org += orgStride;
+    ref += refStride;
+  }
+
+#if USE_AVX2
+  vsad = _mm_add_epi64( vsad, _mm_add_epi64( _mm256_castsi256_si128( vsad256 ), _mm256_extracti128_si256( vsad256, 1 ) ) );
+#endif
+  Int64 partSums[2];
+  _mm_storeu_si128( ( __m128i* ) partSums, vsad );
+
+  return sad + partSums[0] + partSums[1];
+}
+
+template<X86_VEXT vext>
+Int64 sadWeightedClip_SSE( const Pel* org, Int orgStride, const Pel* ref, Int refStride, Int width, Int height, Int shift, Int weight, Int offset, Int maxVal )
+{
+  const Int     round   = shift == 0 ? 0 : 1 << ( shift - 1 );
+  const __m128i vshift  = _mm_cvtsi32_si128( shift );
+  const __m128i vweight = _mm_set1_epi32( weight );
+  const __m128i vround  = _mm_set1_epi32( round );
+  const __m128i voffset = _mm_set1_epi32( offset );
+  const __m128i vmax    = _mm_set1_epi32( maxVal );
+  const __m128i vzero   = _mm_setzero_si128();
+  __m128i       vsad    = _mm_setzero_si128();
+  Int64         sad     = 0;
+
+  for( Int y = 0; y < height; y++ )
+  {
+    Int x = 0;
+    for( ; x + 4 <= width; x += 4 )
+    {
+      __m128i vorg    = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &org[x] ) );
+      __m128i vref    = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &ref[x] ) );
+      __m128i vscaled = _mm_add_epi32( _mm_sra_epi32( _mm_add_epi32( _mm_mullo_epi32( vref, vweight ), vround ), vshift ), voffset );
+      vscaled = _mm_min_epi32( _mm_max_epi32( vscaled, vzero ), vmax );
+      __m128i vdiff   = _mm_abs_epi32( _mm_sub_epi32( vorg, vscaled ) );
+      vsad = _mm_add_epi64( vsad, _mm_unpacklo_epi32( vdiff, vzero ) );
+      vsad = _mm_add_epi64( vsad, _mm_unpackhi_epi32( vdiff, vzero ) );
+    }
+    for( ; x < width; x++ )
+    {
+      sad += abs( org[x] - Clip3( 0, maxVal, ( ( ref[x] * weight + round ) >> shift ) + offset ) );
+    }
+    org += orgStride;
+    ref += refStride;
+  }
+
+  Int64 partSums[2];
+  _mm_storeu_si128( ( __m128i* ) partSums, vsad );
+
+  return sad + partSums[0] + partSums[1];
+}
+
 template<X86_VEXT vext, int W>
 Void linTf_SSE_entry( const Pel* src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Int scale, Int shift, Int offset, const ClpRng& clpRng, bool clip )
 {
@@ -373,6 +656,15 @@ Void PelBufferOps::_initPelBufOpsX86()
 
   linTf8 = linTf_SSE_entry<vext, 8>;
   linTf4 = linTf_SSE_entry<vext, 4>;
+
+  packLowBytes = packLowBytes_SSE<vext>;
+
+  sse = sse_SSE<vext>;
+
+  sumAndSqr       = sumAndSqr_SSE<vext>;
+  histogram       = histogram_SSE<vext>;
+  sadWeighted     = sadWeighted_SSE<vext>;
+  sadWeightedClip = sadWeightedClip_SSE<vext>;
 }
 
 template Void PelBufferOps::_initPelBufOpsX86<SIMDX86>();
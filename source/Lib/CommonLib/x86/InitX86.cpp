@@ -18,6 +18,11 @@
 
 #include "CommonLib/CommonDef.h"
 #include "CommonLib/InterpolationFilter.h"
+#include "CommonLib/IntraPrediction.h"
+#include "CommonLib/LoopFilter.h"
+#include "CommonLib/AdaptiveLoopFilter.h"
+#include "CommonLib/SampleAdaptiveOffset.h"
+#include "CommonLib/BilateralFilter.h"
 #include "CommonLib/TrQuant.h"
 #include "CommonLib/RdCost.h"
 #include "CommonLib/Buffer.h"
@@ -46,6 +51,106 @@ Void InterpolationFilter::initInterpolationFilterX86( /*Int iBitDepthY, Int iBit
 }
 #endif
 
+#if HHI_SIMD_OPT_INTRA_PRED
+Void IntraPrediction::initIntraPredictionX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch (vext){
+  case AVX512:
+  case AVX2:
+    _initIntraPredictionX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initIntraPredictionX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if HHI_SIMD_OPT_DEBLOCK
+Void LoopFilter::initLoopFilterX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch (vext){
+  case AVX512:
+  case AVX2:
+    _initLoopFilterX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initLoopFilterX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if HHI_SIMD_OPT_SAO
+Void SampleAdaptiveOffset::initSampleAdaptiveOffsetX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch (vext){
+  case AVX512:
+  case AVX2:
+    _initSampleAdaptiveOffsetX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initSampleAdaptiveOffsetX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if HHI_SIMD_OPT_ALF
+Void AdaptiveLoopFilter::initAdaptiveLoopFilterX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch (vext){
+  case AVX512:
+  case AVX2:
+    _initAdaptiveLoopFilterX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initAdaptiveLoopFilterX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if HHI_SIMD_OPT_BIF
+void BilateralFilter::initBilateralFilterX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch (vext){
+  case AVX512:
+  case AVX2:
+    _initBilateralFilterX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initBilateralFilterX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
 #if HHI_SIMD_OPT_BUFFER
 Void PelBufferOps::initPelBufOpsX86()
 {
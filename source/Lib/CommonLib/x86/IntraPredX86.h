@@ -0,0 +1,581 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     IntraPredX86.h
+    \brief    SIMD intra prediction (angular, planar, DC, reference sample smoothing and cross-component linear model).
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+
+#include "CommonLib/CommonDef.h"
+#include "CommonDefX86.h"
+#include "../Rom.h"
+#include "../IntraPrediction.h"
+
+
+#if HHI_SIMD_OPT_INTRA_PRED
+#ifdef TARGET_SIMD_X86
+
+template< X86_VEXT vext >
+Void intraPredAngLinear_SSE( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle )
+{
+  if( width < 4 )
+  {
+    IntraPrediction::xPredAngLinear( pDst, dstStride, refMain, width, height, intraPredAngle );
+    return;
+  }
+
+  for( Int y = 0, deltaPos = intraPredAngle; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const Int  deltaInt   = deltaPos >> 5;
+    const Int  deltaFract = deltaPos & ( 32 - 1 );
+    const Pel* pRM        = refMain + deltaInt + 1;
+
+    if( !deltaFract )
+    {
+      // Just copy the integer samples
+      memcpy( pDst, pRM, width * sizeof( Pel ) );
+      continue;
+    }
+
+    // ( ( 32 - deltaFract ) * pRM[x] + deltaFract * pRM[x + 1] + 16 ) >> 5 on interleaved sample pairs
+    const Short w0 = Short( 32 - deltaFract );
+    const Short w1 = Short( deltaFract );
+
+    if( vext >= AVX2 && width >= 16 )
+    {
+#if USE_AVX2
+      const __m256i vcoef = _mm256_setr_epi16( w0, w1, w0, w1, w0, w1, w0, w1, w0, w1, w0, w1, w0, w1, w0, w1 );
+      const __m256i vrnd  = _mm256_set1_epi32( 16 );
+
+      for( Int x = 0; x < width; x += 16 )
+      {
+        __m256i va  = _mm256_loadu_si256( ( const __m256i* ) &pRM[x] );
+        __m256i vb  = _mm256_loadu_si256( ( const __m256i* ) &pRM[x + 1] );
+        __m256i vlo = _mm256_madd_epi16( _mm256_unpacklo_epi16( va, vb ), vcoef );
+        __m256i vhi = _mm256_madd_epi16( _mm256_unpackhi_epi16( va, vb ), vcoef );
+        vlo = _mm256_srai_epi32( _mm256_add_epi32( vlo, vrnd ), 5 );
+        vhi = _mm256_srai_epi32( _mm256_add_epi32( vhi, vrnd ), 5 );
+        _mm256_storeu_si256( ( __m256i* ) &pDst[x], _mm256_packs_epi32( vlo, vhi ) );
+      }
+#endif
+    }
+    else
+    {
+      const __m128i vcoef = _mm_setr_epi16( w0, w1, w0, w1, w0, w1, w0, w1 );
+      const __m128i vrnd  = _mm_set1_epi32( 16 );
+
+      if( width == 4 )
+      {
+        __m128i va  = _mm_loadl_epi64( ( const __m128i* ) &pRM[0] );
+        __m128i vb  = _mm_loadl_epi64( ( const __m128i* ) &pRM[1] );
+        __m128i vlo = _mm_madd_epi16( _mm_unpacklo_epi16( va, vb ), vcoef );
+        vlo = _mm_srai_epi32( _mm_add_epi32( vlo, vrnd ), 5 );
+        _mm_storel_epi64( ( __m128i* ) pDst, _mm_packs_epi32( vlo, vlo ) );
+        continue;
+      }
+
+      for( Int x = 0; x < width; x += 8 )
+      {
+        __m128i va  = _mm_loadu_si128( ( const __m128i* ) &pRM[x] );
+        __m128i vb  = _mm_loadu_si128( ( const __m128i* ) &pRM[x + 1] );
+        __m128i vlo = _mm_madd_epi16( _mm_unpacklo_epi16( va, vb ), vcoef );
+        __m128i vhi = _mm_madd_epi16( _mm_unpackhi_epi16( va, vb ), vcoef );
+        vlo = _mm_srai_epi32( _mm_add_epi32( vlo, vrnd ), 5 );
+        vhi = _mm_srai_epi32( _mm_add_epi32( vhi, vrnd ), 5 );
+        _mm_storeu_si128( ( __m128i* ) &pDst[x], _mm_packs_epi32( vlo, vhi ) );
+      }
+    }
+  }
+}
+
+static inline __m128i intraPred4Tap_SSE( const __m128i& p0, const __m128i& p1, const __m128i& p2, const __m128i& p3, const __m128i& vf01, const __m128i& vf23, Bool bHigh )
+{
+  const __m128i vrnd = _mm_set1_epi32( 128 );
+  __m128i v01 = bHigh ? _mm_unpackhi_epi16( p0, p1 ) : _mm_unpacklo_epi16( p0, p1 );
+  __m128i v23 = bHigh ? _mm_unpackhi_epi16( p2, p3 ) : _mm_unpacklo_epi16( p2, p3 );
+  __m128i vsum = _mm_add_epi32( _mm_madd_epi16( v01, vf01 ), _mm_madd_epi16( v23, vf23 ) );
+  return _mm_srai_epi32( _mm_add_epi32( vsum, vrnd ), 8 );
+}
+
+template< X86_VEXT vext >
+Void intraPredAng4Tap_SSE( Pel* pDst, Int dstStride, const Pel* refMain, Int width, Int height, Int intraPredAngle, const ClpRng& clpRng )
+{
+  if( width < 4 )
+  {
+    IntraPrediction::xPredAng4Tap( pDst, dstStride, refMain, width, height, intraPredAngle, clpRng );
+    return;
+  }
+
+  const Bool    useCubicFilter = ( width <= 8 );
+  const __m128i vmin           = _mm_set1_epi16( clpRng.min );
+  const __m128i vmax           = _mm_set1_epi16( clpRng.max );
+
+  for( Int y = 0, deltaPos = intraPredAngle; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const Int  deltaInt   = deltaPos >> 5;
+    const Int  deltaFract = deltaPos & ( 32 - 1 );
+    const Pel* pRM        = refMain + deltaInt + 1;
+
+    if( !deltaFract )
+    {
+      // Just copy the integer samples
+      memcpy( pDst, pRM, width * sizeof( Pel ) );
+      continue;
+    }
+
+    const Int*    f    = useCubicFilter ? intraCubicFilter[deltaFract] : intraGaussFilter[deltaFract];
+    const __m128i vf01 = _mm_setr_epi16( f[0], f[1], f[0], f[1], f[0], f[1], f[0], f[1] );
+    const __m128i vf23 = _mm_setr_epi16( f[2], f[3], f[2], f[3], f[2], f[3], f[2], f[3] );
+
+    // the outer taps are replicated from the inner ones at the first and the last sample of the row,
+    // so neither pRM[-1] nor pRM[width + 1] is ever read
+    if( width == 4 )
+    {
+      __m128i p1 = _mm_loadl_epi64( ( const __m128i* ) &pRM[0] );
+      __m128i p2 = _mm_loadl_epi64( ( const __m128i* ) &pRM[1] );
+      __m128i p0 = _mm_insert_epi16( _mm_slli_si128( p1, 2 ), pRM[0], 0 );
+      __m128i p3 = _mm_insert_epi16( _mm_srli_si128( p2, 2 ), pRM[4], 3 );
+      __m128i vlo = intraPred4Tap_SSE( p0, p1, p2, p3, vf01, vf23, false );
+      __m128i vres = _mm_packs_epi32( vlo, vlo );
+      vres = _mm_min_epi16( vmax, _mm_max_epi16( vmin, vres ) ); // cubic filter (width <= 8) requires clipping
+      _mm_storel_epi64( ( __m128i* ) pDst, vres );
+      continue;
+    }
+
+    for( Int x = 0; x < width; x += 8 )
+    {
+      __m128i p1 = _mm_loadu_si128( ( const __m128i* ) &pRM[x] );
+      __m128i p2 = _mm_loadu_si128( ( const __m128i* ) &pRM[x + 1] );
+      __m128i p0 = x == 0             ? _mm_insert_epi16( _mm_slli_si128( p1, 2 ), pRM[0], 0 )     : _mm_loadu_si128( ( const __m128i* ) &pRM[x - 1] );
+      __m128i p3 = x + 8 == width     ? _mm_insert_epi16( _mm_srli_si128( p2, 2 ), pRM[width], 7 ) : _mm_loadu_si128( ( const __m128i* ) &pRM[x + 2] );
+      __m128i vlo  = intraPred4Tap_SSE( p0, p1, p2, p3, vf01, vf23, false );
+      __m128i vhi  = intraPred4Tap_SSE( p0, p1, p2, p3, vf01, vf23, true );
+      __m128i vres = _mm_packs_epi32( vlo, vhi );
+      if( useCubicFilter ) // only cubic filter has negative coefficients and requires clipping
+      {
+        vres = _mm_min_epi16( vmax, _mm_max_epi16( vmin, vres ) );
+      }
+      _mm_storeu_si128( ( __m128i* ) &pDst[x], vres );
+    }
+  }
+}
+
+template< X86_VEXT vext >
+Void intraPredPlanar_SSE( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
+  const Int log2W = g_aucLog2[width];
+  const Int log2H = g_aucLog2[height];
+
+  // the division by width * height * 2 of the C implementation becomes a shift for power of two sizes (all terms are non-negative)
+  if( width < 4 || ( 1 << log2W ) != width || ( 1 << log2H ) != height )
+  {
+    IntraPrediction::xPredPlanarCore( pSrc, srcStride, pDst, dstStride, width, height );
+    return;
+  }
+
+  Int topRow[MAX_CU_SIZE], bottomRow[MAX_CU_SIZE];
+
+  const Int bottomLeft = pSrc[( height + 1 ) * srcStride];
+  const Int topRight   = pSrc[width + 1];
+  const Int shift      = log2W + log2H + 1;
+
+  for( Int k = 0; k < width; k++ )
+  {
+    const Int top = pSrc[k + 1];
+    bottomRow[k]  = bottomLeft - top;
+    topRow[k]     = top << log2H;
+  }
+
+  for( Int y = 0; y < height; y++, pDst += dstStride )
+  {
+    const Int left  = pSrc[( y + 1 ) * srcStride];
+    const Int right = topRight - left;
+
+    if( vext >= AVX2 && width >= 8 )
+    {
+#if USE_AVX2
+      const __m256i voffset = _mm256_set1_epi32( width * height );
+      const __m256i vstep   = _mm256_set1_epi32( right << 3 );
+      __m256i vhor = _mm256_add_epi32( _mm256_set1_epi32( left << log2W ), _mm256_mullo_epi32( _mm256_set1_epi32( right ), _mm256_setr_epi32( 1, 2, 3, 4, 5, 6, 7, 8 ) ) );
+
+      for( Int x = 0; x < width; x += 8 )
+      {
+        __m256i vver = _mm256_add_epi32( _mm256_loadu_si256( ( const __m256i* ) &topRow[x] ), _mm256_loadu_si256( ( const __m256i* ) &bottomRow[x] ) );
+        _mm256_storeu_si256( ( __m256i* ) &topRow[x], vver );
+
+        __m256i vsum = _mm256_add_epi32( _mm256_slli_epi32( vhor, log2H ), _mm256_slli_epi32( vver, log2W ) );
+        vsum = _mm256_srai_epi32( _mm256_add_epi32( vsum, voffset ), shift );
+        vsum = _mm256_permute4x64_epi64( _mm256_packs_epi32( vsum, vsum ), 0x08 );
+        _mm_storeu_si128( ( __m128i* ) &pDst[x], _mm256_castsi256_si128( vsum ) );
+
+        vhor = _mm256_add_epi32( vhor, vstep );
+      }
+#endif
+    }
+    else
+    {
+      const __m128i voffset = _mm_set1_epi32( width * height );
+      const __m128i vstep   = _mm_set1_epi32( right << 2 );
+      __m128i vhor = _mm_add_epi32( _mm_set1_epi32( left << log2W ), _mm_mullo_epi32( _mm_set1_epi32( right ), _mm_setr_epi32( 1, 2, 3, 4 ) ) );
+
+      for( Int x = 0; x < width; x += 4 )
+      {
+        __m128i vver = _mm_add_epi32( _mm_loadu_si128( ( const __m128i* ) &topRow[x] ), _mm_loadu_si128( ( const __m128i* ) &bottomRow[x] ) );
+        _mm_storeu_si128( ( __m128i* ) &topRow[x], vver );
+
+        __m128i vsum = _mm_add_epi32( _mm_slli_epi32( vhor, log2H ), _mm_slli_epi32( vver, log2W ) );
+        vsum = _mm_srai_epi32( _mm_add_epi32( vsum, voffset ), shift );
+        _mm_storel_epi64( ( __m128i* ) &pDst[x], _mm_packs_epi32( vsum, vsum ) );
+
+        vhor = _mm_add_epi32( vhor, vstep );
+      }
+    }
+  }
+}
+
+template< X86_VEXT vext >
+Void intraPredDc_SSE( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
+  if( width < 4 )
+  {
+    IntraPrediction::xPredDcCore( pSrc, srcStride, pDst, dstStride, width, height );
+    return;
+  }
+
+  // the above reference row is contiguous, the left one is stored as a column
+  const Pel*    pTop = pSrc + 1;
+  const __m128i vone = _mm_set1_epi16( 1 );
+  __m128i       vacc = _mm_setzero_si128();
+
+  if( width == 4 )
+  {
+    vacc = _mm_madd_epi16( _mm_loadl_epi64( ( const __m128i* ) pTop ), vone );
+  }
+  else
+  {
+    for( Int x = 0; x < width; x += 8 )
+    {
+      vacc = _mm_add_epi32( vacc, _mm_madd_epi16( _mm_loadu_si128( ( const __m128i* ) &pTop[x] ), vone ) );
+    }
+  }
+  vacc = _mm_hadd_epi32( vacc, vacc );
+  vacc = _mm_hadd_epi32( vacc, vacc );
+
+  Int sum = _mm_cvtsi128_si32( vacc );
+  for( Int y = 0; y < height; y++ )
+  {
+    sum += pSrc[( y + 1 ) * srcStride];
+  }
+
+  const Pel dcVal = ( sum + ( ( width + height ) >> 1 ) ) / ( width + height );
+
+  if( vext >= AVX2 && width >= 16 )
+  {
+#if USE_AVX2
+    const __m256i vdc = _mm256_set1_epi16( dcVal );
+    for( Int y = 0; y < height; y++, pDst += dstStride )
+    {
+      for( Int x = 0; x < width; x += 16 )
+      {
+        _mm256_storeu_si256( ( __m256i* ) &pDst[x], vdc );
+      }
+    }
+#endif
+  }
+  else
+  {
+    const __m128i vdc = _mm_set1_epi16( dcVal );
+    for( Int y = 0; y < height; y++, pDst += dstStride )
+    {
+      if( width == 4 )
+      {
+        _mm_storel_epi64( ( __m128i* ) pDst, vdc );
+        continue;
+      }
+      for( Int x = 0; x < width; x += 8 )
+      {
+        _mm_storeu_si128( ( __m128i* ) &pDst[x], vdc );
+      }
+    }
+  }
+}
+
+template< X86_VEXT vext >
+Void intraFilterRefRow_SSE( const Pel* pSrc, Pel* pDst, Int num )
+{
+  const __m128i vrnd = _mm_set1_epi16( 2 );
+  Int i = 0;
+
+  // [1 2 1] / 4, the sum fits into 16 bit unsigned for all bit depths supported without high bit depth
+  for( ; i + 8 <= num; i += 8 )
+  {
+    __m128i vl = _mm_loadu_si128( ( const __m128i* ) &pSrc[i - 1] );
+    __m128i vc = _mm_loadu_si128( ( const __m128i* ) &pSrc[i] );
+    __m128i vr = _mm_loadu_si128( ( const __m128i* ) &pSrc[i + 1] );
+    __m128i vsum = _mm_add_epi16( _mm_add_epi16( vl, vr ), _mm_add_epi16( vc, vc ) );
+    _mm_storeu_si128( ( __m128i* ) &pDst[i], _mm_srli_epi16( _mm_add_epi16( vsum, vrnd ), 2 ) );
+  }
+
+  for( ; i < num; i++ )
+  {
+    pDst[i] = ( pSrc[i + 1] + 2 * pSrc[i] + pSrc[i - 1] + 2 ) >> 2;
+  }
+}
+
+template< X86_VEXT vext >
+Void intraTransposeBlk_SSE( const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int width, Int height )
+{
+  if( ( width & 7 ) == 0 && ( height & 7 ) == 0 )
+  {
+    for( Int y = 0; y < height; y += 8 )
+    {
+      for( Int x = 0; x < width; x += 8 )
+      {
+        __m128i T[8];
+        for( Int k = 0; k < 8; k++ )
+        {
+          T[k] = _mm_loadu_si128( ( const __m128i* ) &pSrc[( y + k ) * srcStride + x] );
+        }
+
+        TRANSPOSE8x8( T );
+
+        for( Int k = 0; k < 8; k++ )
+        {
+          _mm_storeu_si128( ( __m128i* ) &pDst[( x + k ) * dstStride + y], T[k] );
+        }
+      }
+    }
+  }
+  else if( ( width & 3 ) == 0 && ( height & 3 ) == 0 )
+  {
+    for( Int y = 0; y < height; y += 4 )
+    {
+      for( Int x = 0; x < width; x += 4 )
+      {
+        __m128i r0 = _mm_loadl_epi64( ( const __m128i* ) &pSrc[( y + 0 ) * srcStride + x] );
+        __m128i r1 = _mm_loadl_epi64( ( const __m128i* ) &pSrc[( y + 1 ) * srcStride + x] );
+        __m128i r2 = _mm_loadl_epi64( ( const __m128i* ) &pSrc[( y + 2 ) * srcStride + x] );
+        __m128i r3 = _mm_loadl_epi64( ( const __m128i* ) &pSrc[( y + 3 ) * srcStride + x] );
+        __m128i r01 = _mm_unpacklo_epi16( r0, r1 );
+        __m128i r23 = _mm_unpacklo_epi16( r2, r3 );
+        __m128i c01 = _mm_unpacklo_epi32( r01, r23 );
+        __m128i c23 = _mm_unpackhi_epi32( r01, r23 );
+
+        _mm_storel_epi64( ( __m128i* ) &pDst[( x + 0 ) * dstStride + y], c01 );
+        _mm_storel_epi64( ( __m128i* ) &pDst[( x + 1 ) * dstStride + y], _mm_unpackhi_epi64( c01, c01 ) );
+        _mm_storel_epi64( ( __m128i* ) &pDst[( x + 2 ) * dstStride + y], c23 );
+        _mm_storel_epi64( ( __m128i* ) &pDst[( x + 3 ) * dstStride + y], _mm_unpackhi_epi64( c23, c23 ) );
+      }
+    }
+  }
+  else
+  {
+    IntraPrediction::xTransposeBlk( pSrc, srcStride, pDst, dstStride, width, height );
+  }
+}
+
+template< X86_VEXT vext >
+Void intraLumaDownsample_SSE( const Pel* pRec, Int recStride, Pel* pDst, Int dstStride, Int width, Int height, Bool bLeftAvail )
+{
+  if( width & 3 )
+  {
+    IntraPrediction::xLumaDownsample( pRec, recStride, pDst, dstStride, width, height, bLeftAvail );
+    return;
+  }
+
+  // ( 2 * r[2i] + r[2i+1] + r[2i-1] + 4 ) >> 3 with r being the sum of the two luma rows
+  const __m128i vcoef0 = _mm_setr_epi16( 2, 1, 2, 1, 2, 1, 2, 1 );
+  const __m128i vcoef1 = _mm_setr_epi16( 1, 0, 1, 0, 1, 0, 1, 0 );
+  const __m128i vrnd   = _mm_set1_epi32( 4 );
+
+  for( Int j = 0; j < height; j++, pDst += dstStride, pRec += recStride << 1 )
+  {
+    const Pel* pRec1 = pRec + recStride;
+
+    for( Int i = 0; i < width; i += 4 )
+    {
+      __m128i vr0 = _mm_add_epi16( _mm_loadu_si128( ( const __m128i* ) &pRec[2 * i] ), _mm_loadu_si128( ( const __m128i* ) &pRec1[2 * i] ) );
+      __m128i vr1;
+      if( i == 0 && !bLeftAvail )
+      {
+        // the samples left of the block are not read, the first output is replaced below
+        vr1 = _mm_slli_si128( vr0, 2 );
+      }
+      else
+      {
+        vr1 = _mm_add_epi16( _mm_loadu_si128( ( const __m128i* ) &pRec[2 * i - 1] ), _mm_loadu_si128( ( const __m128i* ) &pRec1[2 * i - 1] ) );
+      }
+
+      __m128i vsum = _mm_add_epi32( _mm_madd_epi16( vr0, vcoef0 ), _mm_madd_epi16( vr1, vcoef1 ) );
+      vsum = _mm_srai_epi32( _mm_add_epi32( vsum, vrnd ), 3 );
+      _mm_storel_epi64( ( __m128i* ) &pDst[i], _mm_packs_epi32( vsum, vsum ) );
+    }
+
+    if( !bLeftAvail )
+    {
+      pDst[0] = ( pRec[0] + pRec1[0] + 1 ) >> 1;
+    }
+  }
+}
+
+template< X86_VEXT vext >
+Void intraLMSumsRow_SSE( const Pel* pSrc, const Pel* pCur, Int num, Int& x, Int& y, Int& xx, Int& xy )
+{
+  if( num & 3 )
+  {
+    IntraPrediction::xLMSumsRow( pSrc, pCur, num, x, y, xx, xy );
+    return;
+  }
+
+  const __m128i vone = _mm_set1_epi16( 1 );
+  __m128i vx  = _mm_setzero_si128();
+  __m128i vy  = _mm_setzero_si128();
+  __m128i vxx = _mm_setzero_si128();
+  __m128i vxy = _mm_setzero_si128();
+
+  for( Int j = 0; j < num; j += 4 )
+  {
+    __m128i vsrc = _mm_loadl_epi64( ( const __m128i* ) &pSrc[j] );
+    __m128i vcur = _mm_loadl_epi64( ( const __m128i* ) &pCur[j] );
+    vx  = _mm_add_epi32( vx,  _mm_madd_epi16( vsrc, vone ) );
+    vy  = _mm_add_epi32( vy,  _mm_madd_epi16( vcur, vone ) );
+    vxx = _mm_add_epi32( vxx, _mm_madd_epi16( vsrc, vsrc ) );
+    vxy = _mm_add_epi32( vxy, _mm_madd_epi16( vsrc, vcur ) );
+  }
+
+  // horizontal sums of the four accumulators
+  __m128i vsum = _mm_hadd_epi32( _mm_hadd_epi32( vx, vy ), _mm_hadd_epi32( vxx, vxy ) );
+  x  += _mm_extract_epi32( vsum, 0 );
+  y  += _mm_extract_epi32( vsum, 1 );
+  xx += _mm_extract_epi32( vsum, 2 );
+  xy += _mm_extract_epi32( vsum, 3 );
+}
+
+template< X86_VEXT vext >
+Void intraLMClassSums_SSE( const Int* pLuma, const Int* pChroma, const Int* pTag, Int count, Int numGroups, Int x[], Int y[], Int xx[], Int xy[] )
+{
+  const Int numVec = count & ~3;
+
+  for( Int group = 0; group < numGroups; group++ )
+  {
+    const __m128i vgroup = _mm_set1_epi32( group );
+    __m128i vx  = _mm_setzero_si128();
+    __m128i vy  = _mm_setzero_si128();
+    __m128i vxx = _mm_setzero_si128();
+    __m128i vxy = _mm_setzero_si128();
+
+    for( Int i = 0; i < numVec; i += 4 )
+    {
+      __m128i vmask = _mm_cmpeq_epi32( _mm_loadu_si128( ( const __m128i* ) &pTag[i] ), vgroup );
+      __m128i vl    = _mm_and_si128( _mm_loadu_si128( ( const __m128i* ) &pLuma  [i] ), vmask );
+      __m128i vc    = _mm_and_si128( _mm_loadu_si128( ( const __m128i* ) &pChroma[i] ), vmask );
+      vx  = _mm_add_epi32( vx,  vl );
+      vy  = _mm_add_epi32( vy,  vc );
+      vxx = _mm_add_epi32( vxx, _mm_mullo_epi32( vl, vl ) );
+      vxy = _mm_add_epi32( vxy, _mm_mullo_epi32( vl, vc ) );
+    }
+
+    __m128i vsum = _mm_hadd_epi32( _mm_hadd_epi32( vx, vy ), _mm_hadd_epi32( vxx, vxy ) );
+    x [group] = _mm_extract_epi32( vsum, 0 );
+    y [group] = _mm_extract_epi32( vsum, 1 );
+    xx[group] = _mm_extract_epi32( vsum, 2 );
+    xy[group] = _mm_extract_epi32( vsum, 3 );
+  }
+
+  for( Int i = numVec; i < count; i++ )
+  {
+    Int group = pTag[i];
+    x[group]  += pLuma[i];
+    y[group]  += pChroma[i];
+    xx[group] += pLuma[i] * pLuma[i];
+    xy[group] += pLuma[i] * pChroma[i];
+  }
+}
+
+template< X86_VEXT vext >
+Void intraLMApply2_SSE( const Pel* pLuma, Int lumaStride, Pel* pPred, Int predStride, Int width, Int height, const IntraPrediction::MMLM_parameter parameters[2], const ClpRng& clpRng )
+{
+  if( width & 3 )
+  {
+    IntraPrediction::xLMApply2( pLuma, lumaStride, pPred, predStride, width, height, parameters, clpRng );
+    return;
+  }
+
+  // both models are evaluated for all samples, the luma value selects the result
+  const __m128i vsup    = _mm_set1_epi32( parameters[0].Sup );
+  const __m128i va0     = _mm_set1_epi32( parameters[0].a );
+  const __m128i vb0     = _mm_set1_epi32( parameters[0].b );
+  const __m128i vshift0 = _mm_cvtsi32_si128( parameters[0].shift );
+  const __m128i va1     = _mm_set1_epi32( parameters[1].a );
+  const __m128i vb1     = _mm_set1_epi32( parameters[1].b );
+  const __m128i vshift1 = _mm_cvtsi32_si128( parameters[1].shift );
+  const __m128i vmin    = _mm_set1_epi32( clpRng.min );
+  const __m128i vmax    = _mm_set1_epi32( clpRng.max );
+
+  for( Int i = 0; i < height; i++, pPred += predStride, pLuma += lumaStride )
+  {
+    for( Int j = 0; j < width; j += 4 )
+    {
+      __m128i vl   = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &pLuma[j] ) );
+      __m128i v0   = _mm_add_epi32( _mm_sra_epi32( _mm_mullo_epi32( va0, vl ), vshift0 ), vb0 );
+      __m128i v1   = _mm_add_epi32( _mm_sra_epi32( _mm_mullo_epi32( va1, vl ), vshift1 ), vb1 );
+      __m128i vres = _mm_blendv_epi8( v0, v1, _mm_cmpgt_epi32( vl, vsup ) );
+      vres = _mm_min_epi32( vmax, _mm_max_epi32( vmin, vres ) );
+      _mm_storel_epi64( ( __m128i* ) &pPred[j], _mm_packs_epi32( vres, vres ) );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+Void IntraPrediction::_initIntraPredictionX86()
+{
+  m_predAngLinear  = intraPredAngLinear_SSE<vext>;
+  m_predAng4Tap    = intraPredAng4Tap_SSE<vext>;
+  m_predPlanar     = intraPredPlanar_SSE<vext>;
+  m_predDc         = intraPredDc_SSE<vext>;
+  m_filterRefRow   = intraFilterRefRow_SSE<vext>;
+  m_transposeBlk   = intraTransposeBlk_SSE<vext>;
+  m_lumaDownsample = intraLumaDownsample_SSE<vext>;
+  m_lmSumsRow      = intraLMSumsRow_SSE<vext>;
+  m_lmClassSums    = intraLMClassSums_SSE<vext>;
+  m_lmApply2       = intraLMApply2_SSE<vext>;
+}
+
+template Void IntraPrediction::_initIntraPredictionX86<SIMDX86>();
+
+#endif // TARGET_SIMD_X86
+#endif
+//! \}
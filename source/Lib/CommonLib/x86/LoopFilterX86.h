@@ -0,0 +1,386 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     LoopFilterX86.h
+    \brief    SIMD deblocking filter (edge segment decisions and filtering).
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+
+#include "CommonLib/CommonDef.h"
+#include "CommonDefX86.h"
+#include "../LoopFilter.h"
+
+
+#if HHI_SIMD_OPT_DEBLOCK
+#ifdef TARGET_SIMD_X86
+
+// Clip3( lo, hi, val ) on 32 bit lanes
+static inline __m128i dbClip3( const __m128i& vlo, const __m128i& vhi, const __m128i& val )
+{
+  return _mm_min_epi32( vhi, _mm_max_epi32( vlo, val ) );
+}
+
+// loads the samples p3..q3 of four lines of a luma edge segment, one line per 32 bit lane
+static inline Void dbLoadLumaSeg( const Pel* piSrc, const Int iOffset, const Int iSrcStep, __m128i m[8] )
+{
+  if( iSrcStep == 1 )
+  {
+    // horizontal edge, the lines are adjacent in memory
+    for( Int k = 0; k < 8; k++ )
+    {
+      m[k] = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( piSrc + ( k - 4 ) * iOffset ) ) );
+    }
+  }
+  else
+  {
+    // vertical edge, transpose the 4x8 block
+    const __m128i r0 = _mm_loadu_si128( ( const __m128i* ) ( piSrc - 4                ) );
+    const __m128i r1 = _mm_loadu_si128( ( const __m128i* ) ( piSrc - 4 +     iSrcStep ) );
+    const __m128i r2 = _mm_loadu_si128( ( const __m128i* ) ( piSrc - 4 + 2 * iSrcStep ) );
+    const __m128i r3 = _mm_loadu_si128( ( const __m128i* ) ( piSrc - 4 + 3 * iSrcStep ) );
+
+    const __m128i a0 = _mm_unpacklo_epi16( r0, r1 );
+    const __m128i a1 = _mm_unpackhi_epi16( r0, r1 );
+    const __m128i a2 = _mm_unpacklo_epi16( r2, r3 );
+    const __m128i a3 = _mm_unpackhi_epi16( r2, r3 );
+
+    const __m128i b0 = _mm_unpacklo_epi32( a0, a2 );
+    const __m128i b1 = _mm_unpackhi_epi32( a0, a2 );
+    const __m128i b2 = _mm_unpacklo_epi32( a1, a3 );
+    const __m128i b3 = _mm_unpackhi_epi32( a1, a3 );
+
+    m[0] = _mm_cvtepi16_epi32( b0 );
+    m[1] = _mm_cvtepi16_epi32( _mm_srli_si128( b0, 8 ) );
+    m[2] = _mm_cvtepi16_epi32( b1 );
+    m[3] = _mm_cvtepi16_epi32( _mm_srli_si128( b1, 8 ) );
+    m[4] = _mm_cvtepi16_epi32( b2 );
+    m[5] = _mm_cvtepi16_epi32( _mm_srli_si128( b2, 8 ) );
+    m[6] = _mm_cvtepi16_epi32( b3 );
+    m[7] = _mm_cvtepi16_epi32( _mm_srli_si128( b3, 8 ) );
+  }
+}
+
+// stores the samples p3..q3 of four lines of a luma edge segment (p3 and q3 are not modified by the filter)
+static inline Void dbStoreLumaSeg( Pel* piSrc, const Int iOffset, const Int iSrcStep, const __m128i n[8] )
+{
+  if( iSrcStep == 1 )
+  {
+    for( Int k = 1; k < 7; k++ )
+    {
+      _mm_storel_epi64( ( __m128i* ) ( piSrc + ( k - 4 ) * iOffset ), _mm_packs_epi32( n[k], n[k] ) );
+    }
+  }
+  else
+  {
+    const __m128i t0 = _mm_packs_epi32( n[0], n[1] );
+    const __m128i t1 = _mm_packs_epi32( n[2], n[3] );
+    const __m128i t2 = _mm_packs_epi32( n[4], n[5] );
+    const __m128i t3 = _mm_packs_epi32( n[6], n[7] );
+
+    const __m128i u0 = _mm_unpacklo_epi16( t0, t1 );
+    const __m128i u1 = _mm_unpackhi_epi16( t0, t1 );
+    const __m128i u2 = _mm_unpacklo_epi16( t2, t3 );
+    const __m128i u3 = _mm_unpackhi_epi16( t2, t3 );
+
+    const __m128i v0 = _mm_unpacklo_epi16( u0, u1 );
+    const __m128i v1 = _mm_unpackhi_epi16( u0, u1 );
+    const __m128i v2 = _mm_unpacklo_epi16( u2, u3 );
+    const __m128i v3 = _mm_unpackhi_epi16( u2, u3 );
+
+    _mm_storeu_si128( ( __m128i* ) ( piSrc - 4                ), _mm_unpacklo_epi64( v0, v2 ) );
+    _mm_storeu_si128( ( __m128i* ) ( piSrc - 4 +     iSrcStep ), _mm_unpackhi_epi64( v0, v2 ) );
+    _mm_storeu_si128( ( __m128i* ) ( piSrc - 4 + 2 * iSrcStep ), _mm_unpacklo_epi64( v1, v3 ) );
+    _mm_storeu_si128( ( __m128i* ) ( piSrc - 4 + 3 * iSrcStep ), _mm_unpackhi_epi64( v1, v3 ) );
+  }
+}
+
+template< X86_VEXT vext >
+Void filterLumaSeg_SSE( Pel* piSrc, const Int iOffset, const Int iSrcStep, const Int tc, const Int beta, const Int sideThreshold, const Int thrCut, const Bool bPartPNoFilter, const Bool bPartQNoFilter, const ClpRng& clpRng )
+{
+  __m128i m[8];
+  dbLoadLumaSeg( piSrc, iOffset, iSrcStep, m );
+
+  // second derivatives of all four lines, the decisions use lines 0 and 3
+  const __m128i vdp = _mm_abs_epi32( _mm_add_epi32( _mm_sub_epi32( m[1], _mm_slli_epi32( m[2], 1 ) ), m[3] ) );
+  const __m128i vdq = _mm_abs_epi32( _mm_add_epi32( _mm_sub_epi32( m[4], _mm_slli_epi32( m[5], 1 ) ), m[6] ) );
+
+  const Int dp0 = _mm_cvtsi128_si32( vdp );
+  const Int dq0 = _mm_cvtsi128_si32( vdq );
+  const Int dp3 = _mm_extract_epi32( vdp, 3 );
+  const Int dq3 = _mm_extract_epi32( vdq, 3 );
+
+  const Int dp  = dp0 + dp3;
+  const Int dq  = dq0 + dq3;
+
+  if( dp + dq >= beta )
+  {
+    return;
+  }
+
+  const Bool bFilterP = ( dp < sideThreshold );
+  const Bool bFilterQ = ( dq < sideThreshold );
+
+  // strong filter decision for all lines, evaluated for lines 0 and 3
+  const __m128i vdStrong = _mm_add_epi32( _mm_abs_epi32( _mm_sub_epi32( m[0], m[3] ) ), _mm_abs_epi32( _mm_sub_epi32( m[7], m[4] ) ) );
+  const __m128i vd2      = _mm_slli_epi32( _mm_add_epi32( vdp, vdq ), 1 );
+  __m128i vsw = _mm_cmplt_epi32( vdStrong, _mm_set1_epi32( beta >> 3 ) );
+  vsw = _mm_and_si128( vsw, _mm_cmplt_epi32( vd2, _mm_set1_epi32( beta >> 2 ) ) );
+  vsw = _mm_and_si128( vsw, _mm_cmplt_epi32( _mm_abs_epi32( _mm_sub_epi32( m[3], m[4] ) ), _mm_set1_epi32( ( tc * 5 + 1 ) >> 1 ) ) );
+  const Bool sw = ( _mm_movemask_ps( _mm_castsi128_ps( vsw ) ) & 0x9 ) == 0x9;
+
+  const __m128i vmin = _mm_set1_epi32( clpRng.min );
+  const __m128i vmax = _mm_set1_epi32( clpRng.max );
+
+  __m128i n[8];
+  for( Int k = 0; k < 8; k++ )
+  {
+    n[k] = m[k];
+  }
+
+  if( sw )
+  {
+    const __m128i vtc2 = _mm_set1_epi32( 2 * tc );
+    const __m128i v2   = _mm_set1_epi32( 2 );
+    const __m128i v4   = _mm_set1_epi32( 4 );
+
+    const __m128i s34  = _mm_add_epi32( m[3], m[4] );
+    const __m128i s234 = _mm_add_epi32( s34, m[2] );
+    const __m128i s345 = _mm_add_epi32( s34, m[5] );
+
+    // ( m1 + 2 * m2 + 2 * m3 + 2 * m4 + m5 + 4 ) >> 3
+    __m128i val = _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( _mm_add_epi32( m[1], m[5] ), _mm_slli_epi32( s234, 1 ) ), v4 ), 3 );
+    n[3] = dbClip3( _mm_sub_epi32( m[3], vtc2 ), _mm_add_epi32( m[3], vtc2 ), val );
+    // ( m2 + 2 * m3 + 2 * m4 + 2 * m5 + m6 + 4 ) >> 3
+    val  = _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( _mm_add_epi32( m[2], m[6] ), _mm_slli_epi32( s345, 1 ) ), v4 ), 3 );
+    n[4] = dbClip3( _mm_sub_epi32( m[4], vtc2 ), _mm_add_epi32( m[4], vtc2 ), val );
+    // ( m1 + m2 + m3 + m4 + 2 ) >> 2
+    val  = _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( s234, m[1] ), v2 ), 2 );
+    n[2] = dbClip3( _mm_sub_epi32( m[2], vtc2 ), _mm_add_epi32( m[2], vtc2 ), val );
+    // ( m3 + m4 + m5 + m6 + 2 ) >> 2
+    val  = _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( s345, m[6] ), v2 ), 2 );
+    n[5] = dbClip3( _mm_sub_epi32( m[5], vtc2 ), _mm_add_epi32( m[5], vtc2 ), val );
+    // ( 2 * m0 + 3 * m1 + m2 + m3 + m4 + 4 ) >> 3
+    val  = _mm_add_epi32( _mm_slli_epi32( _mm_add_epi32( m[0], m[1] ), 1 ), _mm_add_epi32( m[1], s234 ) );
+    val  = _mm_srai_epi32( _mm_add_epi32( val, v4 ), 3 );
+    n[1] = dbClip3( _mm_sub_epi32( m[1], vtc2 ), _mm_add_epi32( m[1], vtc2 ), val );
+    // ( m3 + m4 + m5 + 3 * m6 + 2 * m7 + 4 ) >> 3
+    val  = _mm_add_epi32( _mm_slli_epi32( _mm_add_epi32( m[7], m[6] ), 1 ), _mm_add_epi32( m[6], s345 ) );
+    val  = _mm_srai_epi32( _mm_add_epi32( val, v4 ), 3 );
+    n[6] = dbClip3( _mm_sub_epi32( m[6], vtc2 ), _mm_add_epi32( m[6], vtc2 ), val );
+  }
+  else
+  {
+    // weak filter, applied to the lines with abs( delta ) < thrCut
+    const __m128i vtc   = _mm_set1_epi32(  tc );
+    const __m128i vtcN  = _mm_set1_epi32( -tc );
+    const __m128i v1    = _mm_set1_epi32( 1 );
+
+    const __m128i d43   = _mm_sub_epi32( m[4], m[3] );
+    const __m128i d52   = _mm_sub_epi32( m[5], m[2] );
+    __m128i delta = _mm_sub_epi32( _mm_add_epi32( _mm_slli_epi32( d43, 3 ), d43 ), _mm_add_epi32( _mm_slli_epi32( d52, 1 ), d52 ) );
+    delta = _mm_srai_epi32( _mm_add_epi32( delta, _mm_set1_epi32( 8 ) ), 4 );
+
+    const __m128i vmask = _mm_cmplt_epi32( _mm_abs_epi32( delta ), _mm_set1_epi32( thrCut ) );
+
+    if( _mm_movemask_epi8( vmask ) )
+    {
+      delta = dbClip3( vtcN, vtc, delta );
+      n[3] = _mm_blendv_epi8( m[3], dbClip3( vmin, vmax, _mm_add_epi32( m[3], delta ) ), vmask );
+      n[4] = _mm_blendv_epi8( m[4], dbClip3( vmin, vmax, _mm_sub_epi32( m[4], delta ) ), vmask );
+
+      const __m128i vtc2  = _mm_set1_epi32(  tc >> 1 );
+      const __m128i vtc2N = _mm_set1_epi32( -( tc >> 1 ) );
+      if( bFilterP )
+      {
+        __m128i delta1 = _mm_srai_epi32( _mm_add_epi32( m[1], _mm_add_epi32( m[3], v1 ) ), 1 );
+        delta1 = _mm_srai_epi32( _mm_add_epi32( _mm_sub_epi32( delta1, m[2] ), delta ), 1 );
+        delta1 = dbClip3( vtc2N, vtc2, delta1 );
+        n[2] = _mm_blendv_epi8( m[2], dbClip3( vmin, vmax, _mm_add_epi32( m[2], delta1 ) ), vmask );
+      }
+      if( bFilterQ )
+      {
+        __m128i delta2 = _mm_srai_epi32( _mm_add_epi32( m[6], _mm_add_epi32( m[4], v1 ) ), 1 );
+        delta2 = _mm_srai_epi32( _mm_sub_epi32( _mm_sub_epi32( delta2, m[5] ), delta ), 1 );
+        delta2 = dbClip3( vtc2N, vtc2, delta2 );
+        n[5] = _mm_blendv_epi8( m[5], dbClip3( vmin, vmax, _mm_add_epi32( m[5], delta2 ) ), vmask );
+      }
+    }
+    else
+    {
+      return;
+    }
+  }
+
+  if( bPartPNoFilter )
+  {
+    n[1] = m[1];
+    n[2] = m[2];
+    n[3] = m[3];
+  }
+  if( bPartQNoFilter )
+  {
+    n[4] = m[4];
+    n[5] = m[5];
+    n[6] = m[6];
+  }
+
+  dbStoreLumaSeg( piSrc, iOffset, iSrcStep, n );
+}
+
+// filters 2 or 4 lines of a chroma edge segment, one line per 32 bit lane
+template< Int numLines >
+static inline Void dbFilterChromaLines( Pel* piSrc, const Int iOffset, const Int iSrcStep, const __m128i& vtc, const Bool bPartPNoFilter, const Bool bPartQNoFilter, const ClpRng& clpRng )
+{
+  __m128i m2, m3, m4, m5;
+
+  if( iSrcStep == 1 )
+  {
+    // horizontal edge, the lines are adjacent in memory
+    if( numLines == 4 )
+    {
+      m2 = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( piSrc - 2 * iOffset ) ) );
+      m3 = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( piSrc -     iOffset ) ) );
+      m4 = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( piSrc                ) ) );
+      m5 = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( piSrc +     iOffset ) ) );
+    }
+    else
+    {
+      m2 = _mm_cvtepi16_epi32( _mm_cvtsi32_si128( *( const Int* ) ( piSrc - 2 * iOffset ) ) );
+      m3 = _mm_cvtepi16_epi32( _mm_cvtsi32_si128( *( const Int* ) ( piSrc -     iOffset ) ) );
+      m4 = _mm_cvtepi16_epi32( _mm_cvtsi32_si128( *( const Int* ) ( piSrc                ) ) );
+      m5 = _mm_cvtepi16_epi32( _mm_cvtsi32_si128( *( const Int* ) ( piSrc +     iOffset ) ) );
+    }
+  }
+  else
+  {
+    // vertical edge, transpose the 4x4 (or 2x4) block
+    const __m128i r0 = _mm_loadl_epi64( ( const __m128i* ) ( piSrc - 2                ) );
+    const __m128i r1 = _mm_loadl_epi64( ( const __m128i* ) ( piSrc - 2 +     iSrcStep ) );
+    const __m128i r2 = numLines == 4 ? _mm_loadl_epi64( ( const __m128i* ) ( piSrc - 2 + 2 * iSrcStep ) ) : r0;
+    const __m128i r3 = numLines == 4 ? _mm_loadl_epi64( ( const __m128i* ) ( piSrc - 2 + 3 * iSrcStep ) ) : r1;
+
+    const __m128i a0 = _mm_unpacklo_epi16( r0, r1 );
+    const __m128i a1 = _mm_unpacklo_epi16( r2, r3 );
+    const __m128i b0 = _mm_unpacklo_epi32( a0, a1 );
+    const __m128i b1 = _mm_unpackhi_epi32( a0, a1 );
+
+    m2 = _mm_cvtepi16_epi32( b0 );
+    m3 = _mm_cvtepi16_epi32( _mm_srli_si128( b0, 8 ) );
+    m4 = _mm_cvtepi16_epi32( b1 );
+    m5 = _mm_cvtepi16_epi32( _mm_srli_si128( b1, 8 ) );
+  }
+
+  const __m128i vmin = _mm_set1_epi32( clpRng.min );
+  const __m128i vmax = _mm_set1_epi32( clpRng.max );
+
+  // Clip3( -tc, tc, ( ( ( m4 - m3 ) << 2 ) + m2 - m5 + 4 ) >> 3 )
+  __m128i delta = _mm_add_epi32( _mm_slli_epi32( _mm_sub_epi32( m4, m3 ), 2 ), _mm_sub_epi32( m2, m5 ) );
+  delta = _mm_srai_epi32( _mm_add_epi32( delta, _mm_set1_epi32( 4 ) ), 3 );
+  delta = dbClip3( _mm_sub_epi32( _mm_setzero_si128(), vtc ), vtc, delta );
+
+  const __m128i n3 = bPartPNoFilter ? m3 : dbClip3( vmin, vmax, _mm_add_epi32( m3, delta ) );
+  const __m128i n4 = bPartQNoFilter ? m4 : dbClip3( vmin, vmax, _mm_sub_epi32( m4, delta ) );
+
+  if( iSrcStep == 1 )
+  {
+    const __m128i p3 = _mm_packs_epi32( n3, n3 );
+    const __m128i p4 = _mm_packs_epi32( n4, n4 );
+    if( numLines == 4 )
+    {
+      _mm_storel_epi64( ( __m128i* ) ( piSrc - iOffset ), p3 );
+      _mm_storel_epi64( ( __m128i* ) ( piSrc           ), p4 );
+    }
+    else
+    {
+      *( Int* ) ( piSrc - iOffset ) = _mm_cvtsi128_si32( p3 );
+      *( Int* ) ( piSrc           ) = _mm_cvtsi128_si32( p4 );
+    }
+  }
+  else
+  {
+    // interleave to one pair of samples ( p0, q0 ) per line
+    const __m128i p34 = _mm_packs_epi32( n3, n4 );
+    const __m128i v   = _mm_unpacklo_epi16( p34, _mm_srli_si128( p34, 8 ) );
+
+    *( Int* ) ( piSrc - 1                ) = _mm_cvtsi128_si32( v );
+    *( Int* ) ( piSrc - 1 +     iSrcStep ) = _mm_extract_epi32( v, 1 );
+    if( numLines == 4 )
+    {
+      *( Int* ) ( piSrc - 1 + 2 * iSrcStep ) = _mm_extract_epi32( v, 2 );
+      *( Int* ) ( piSrc - 1 + 3 * iSrcStep ) = _mm_extract_epi32( v, 3 );
+    }
+  }
+}
+
+template< X86_VEXT vext >
+Void filterChromaSeg_SSE( Pel* piSrc, const Int iOffset, const Int iSrcStep, const Int numLines, const Int tc, const Bool bPartPNoFilter, const Bool bPartQNoFilter, const ClpRng& clpRng )
+{
+  if( bPartPNoFilter && bPartQNoFilter )
+  {
+    return;
+  }
+
+  const __m128i vtc = _mm_set1_epi32( tc );
+
+  Int i = 0;
+  for( ; i + 4 <= numLines; i += 4 )
+  {
+    dbFilterChromaLines<4>( piSrc + i * iSrcStep, iOffset, iSrcStep, vtc, bPartPNoFilter, bPartQNoFilter, clpRng );
+  }
+  if( i + 2 <= numLines )
+  {
+    dbFilterChromaLines<2>( piSrc + i * iSrcStep, iOffset, iSrcStep, vtc, bPartPNoFilter, bPartQNoFilter, clpRng );
+    i += 2;
+  }
+  if( i < numLines )
+  {
+    LoopFilter::xFilterChromaSeg( piSrc + i * iSrcStep, iOffset, iSrcStep, numLines - i, tc, bPartPNoFilter, bPartQNoFilter, clpRng );
+  }
+}
+
+template<X86_VEXT vext>
+Void LoopFilter::_initLoopFilterX86()
+{
+  m_filterLumaSeg   = filterLumaSeg_SSE<vext>;
+  m_filterChromaSeg = filterChromaSeg_SSE<vext>;
+}
+
+template Void LoopFilter::_initLoopFilterX86<SIMDX86>();
+
+#endif // TARGET_SIMD_X86
+#endif
+//! \}
@@ -417,6 +417,128 @@ Distortion RdCost::xGetSAD_NxN_SIMD( const DistParam &rcDtParam )
   return uiSum >> DISTORTION_PRECISION_ADJUSTMENT( rcDtParam.bitDepth - 8 );
 }
 
+template< X86_VEXT vext >
+Void RdCost::xGetSADX4_SIMD( const DistParam &rcDtParam, const Pel* const* piCur, Distortion* puiDist )
+{
+  const Int iCols = rcDtParam.org.width;
+
+  if( rcDtParam.bitDepth > 10 || rcDtParam.applyWeight || ( iCols & 3 ) != 0 )
+  {
+    RdCost::xGetSADX4( rcDtParam, piCur, puiDist );
+    return;
+  }
+
+  // the original row is loaded once and compared against all four candidates
+  const short* pSrc1   = (const short*)rcDtParam.org.buf;
+  const short* pSrc20  = (const short*)piCur[0];
+  const short* pSrc21  = (const short*)piCur[1];
+  const short* pSrc22  = (const short*)piCur[2];
+  const short* pSrc23  = (const short*)piCur[3];
+  Int  iRows           = rcDtParam.org.height;
+  Int  iSubShift       = rcDtParam.subShift;
+  Int  iSubStep        = ( 1 << iSubShift );
+  const Int iStrideSrc1 = rcDtParam.org.stride * iSubStep;
+  const Int iStrideSrc2 = rcDtParam.cur.stride * iSubStep;
+
+  __m128i vsum;
+
+  if( vext >= AVX2 && ( iCols & 15 ) == 0 )
+  {
+#ifdef USE_AVX2
+    __m256i vzero   = _mm256_setzero_si256();
+    __m256i vsum320 = vzero;
+    __m256i vsum321 = vzero;
+    __m256i vsum322 = vzero;
+    __m256i vsum323 = vzero;
+    for( int iY = 0; iY < iRows; iY += iSubStep )
+    {
+      __m256i vsum160 = vzero;
+      __m256i vsum161 = vzero;
+      __m256i vsum162 = vzero;
+      __m256i vsum163 = vzero;
+      for( int iX = 0; iX < iCols; iX += 16 )
+      {
+        __m256i vsrc1 = _mm256_lddqu_si256( ( __m256i* )( &pSrc1[iX] ) );
+        vsum160 = _mm256_add_epi16( vsum160, _mm256_abs_epi16( _mm256_sub_epi16( vsrc1, _mm256_lddqu_si256( ( __m256i* )( &pSrc20[iX] ) ) ) ) );
+        vsum161 = _mm256_add_epi16( vsum161, _mm256_abs_epi16( _mm256_sub_epi16( vsrc1, _mm256_lddqu_si256( ( __m256i* )( &pSrc21[iX] ) ) ) ) );
+        vsum162 = _mm256_add_epi16( vsum162, _mm256_abs_epi16( _mm256_sub_epi16( vsrc1, _mm256_lddqu_si256( ( __m256i* )( &pSrc22[iX] ) ) ) ) );
+        vsum163 = _mm256_add_epi16( vsum163, _mm256_abs_epi16( _mm256_sub_epi16( vsrc1, _mm256_lddqu_si256( ( __m256i* )( &pSrc23[iX] ) ) ) ) );
+      }
+      vsum320 = _mm256_add_epi32( vsum320, _mm256_add_epi32( _mm256_unpacklo_epi16( vsum160, vzero ), _mm256_unpackhi_epi16( vsum160, vzero ) ) );
+      vsum321 = _mm256_add_epi32( vsum321, _mm256_add_epi32( _mm256_unpacklo_epi16( vsum161, vzero ), _mm256_unpackhi_epi16( vsum161, vzero ) ) );
+      vsum322 = _mm256_add_epi32( vsum322, _mm256_add_epi32( _mm256_unpacklo_epi16( vsum162, vzero ), _mm256_unpackhi_epi16( vsum162, vzero ) ) );
+      vsum323 = _mm256_add_epi32( vsum323, _mm256_add_epi32( _mm256_unpacklo_epi16( vsum163, vzero ), _mm256_unpackhi_epi16( vsum163, vzero ) ) );
+      pSrc1  += iStrideSrc1;
+      pSrc20 += iStrideSrc2;
+      pSrc21 += iStrideSrc2;
+      pSrc22 += iStrideSrc2;
+      pSrc23 += iStrideSrc2;
+    }
+    // reduce to { sum0, sum1, sum2, sum3 } per 128-bit lane, then fold the lanes
+    __m256i vsum01 = _mm256_hadd_epi32( vsum320, vsum321 );
+    __m256i vsum23 = _mm256_hadd_epi32( vsum322, vsum323 );
+    __m256i vsum4  = _mm256_hadd_epi32( vsum01, vsum23 );
+    vsum = _mm_add_epi32( _mm256_castsi256_si128( vsum4 ), _mm256_extracti128_si256( vsum4, 1 ) );
+#endif
+  }
+  else
+  {
+    __m128i vzero   = _mm_setzero_si128();
+    __m128i vsum320 = vzero;
+    __m128i vsum321 = vzero;
+    __m128i vsum322 = vzero;
+    __m128i vsum323 = vzero;
+    for( int iY = 0; iY < iRows; iY += iSubStep )
+    {
+      __m128i vsum160 = vzero;
+      __m128i vsum161 = vzero;
+      __m128i vsum162 = vzero;
+      __m128i vsum163 = vzero;
+      if( ( iCols & 7 ) == 0 )
+      {
+        for( int iX = 0; iX < iCols; iX += 8 )
+        {
+          __m128i vsrc1 = _mm_loadu_si128( ( const __m128i* )( &pSrc1[iX] ) );
+          vsum160 = _mm_add_epi16( vsum160, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_lddqu_si128( ( const __m128i* )( &pSrc20[iX] ) ) ) ) );
+          vsum161 = _mm_add_epi16( vsum161, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_lddqu_si128( ( const __m128i* )( &pSrc21[iX] ) ) ) ) );
+          vsum162 = _mm_add_epi16( vsum162, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_lddqu_si128( ( const __m128i* )( &pSrc22[iX] ) ) ) ) );
+          vsum163 = _mm_add_epi16( vsum163, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_lddqu_si128( ( const __m128i* )( &pSrc23[iX] ) ) ) ) );
+        }
+      }
+      else
+      {
+        for( int iX = 0; iX < iCols; iX += 4 )
+        {
+          __m128i vsrc1 = _mm_loadl_epi64( ( const __m128i* )&pSrc1[iX] );
+          vsum160 = _mm_add_epi16( vsum160, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_loadl_epi64( ( const __m128i* )&pSrc20[iX] ) ) ) );
+          vsum161 = _mm_add_epi16( vsum161, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_loadl_epi64( ( const __m128i* )&pSrc21[iX] ) ) ) );
+          vsum162 = _mm_add_epi16( vsum162, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_loadl_epi64( ( const __m128i* )&pSrc22[iX] ) ) ) );
+          vsum163 = _mm_add_epi16( vsum163, _mm_abs_epi16( _mm_sub_epi16( vsrc1, _mm_loadl_epi64( ( const __m128i* )&pSrc23[iX] ) ) ) );
+        }
+      }
+      vsum320 = _mm_add_epi32( vsum320, _mm_add_epi32( _mm_unpacklo_epi16( vsum160, vzero ), _mm_unpackhi_epi16( vsum160, vzero ) ) );
+      vsum321 = _mm_add_epi32( vsum321, _mm_add_epi32( _mm_unpacklo_epi16( vsum161, vzero ), _mm_unpackhi_epi16( vsum161, vzero ) ) );
+      vsum322 = _mm_add_epi32( vsum322, _mm_add_epi32( _mm_unpacklo_epi16( vsum162, vzero ), _mm_unpackhi_epi16( vsum162, vzero ) ) );
+      vsum323 = _mm_add_epi32( vsum323, _mm_add_epi32( _mm_unpacklo_epi16( vsum163, vzero ), _mm_unpackhi_epi16( vsum163, vzero ) ) );
+      pSrc1  += iStrideSrc1;
+      pSrc20 += iStrideSrc2;
+      pSrc21 += iStrideSrc2;
+      pSrc22 += iStrideSrc2;
+      pSrc23 += iStrideSrc2;
+    }
+    // reduce to { sum0, sum1, sum2, sum3 }
+    vsum = _mm_hadd_epi32( _mm_hadd_epi32( vsum320, vsum321 ), _mm_hadd_epi32( vsum322, vsum323 ) );
+  }
+
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT( rcDtParam.bitDepth - 8 );
+  vsum = _mm_srli_epi32( _mm_slli_epi32( vsum, iSubShift ), uiShift );
+
+  puiDist[0] = (UInt)_mm_extract_epi32( vsum, 0 );
+  puiDist[1] = (UInt)_mm_extract_epi32( vsum, 1 );
+  puiDist[2] = (UInt)_mm_extract_epi32( vsum, 2 );
+  puiDist[3] = (UInt)_mm_extract_epi32( vsum, 3 );
+}
+
 
 template< typename Torg, typename Tcur >
 static UInt xCalcHAD4x4_SSE( const Torg *piOrg, const Tcur *piCur, const Int iStrideOrg, const Int iStrideCur )
@@ -2417,6 +2539,18 @@ Void RdCost::_initRdCostX86()
   m_afpDistortFunc[DF_SAD24  ] = RdCost::xGetSAD_SIMD<vext>;
   m_afpDistortFunc[DF_SAD48  ] = RdCost::xGetSAD_SIMD<vext>;
 
+  m_afpDistortFuncX4[DF_SAD    ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD2   ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD4   ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD8   ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD16  ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD32  ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD64  ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD16N ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD12  ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD24  ] = RdCost::xGetSADX4_SIMD<vext>;
+  m_afpDistortFuncX4[DF_SAD48  ] = RdCost::xGetSADX4_SIMD<vext>;
+
   m_afpDistortFunc[DF_HAD]     = RdCost::xGetHADs_SIMD<Pel, Pel, vext>;
   m_afpDistortFunc[DF_HAD2]    = RdCost::xGetHADs_SIMD<Pel, Pel, vext>;
   m_afpDistortFunc[DF_HAD4]    = RdCost::xGetHADs_SIMD<Pel, Pel, vext>;
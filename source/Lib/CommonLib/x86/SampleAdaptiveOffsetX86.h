@@ -0,0 +1,366 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     SampleAdaptiveOffsetX86.h
+    \brief    SIMD sample adaptive offset (edge/band offset application and encoder statistics).
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+
+#include "CommonLib/CommonDef.h"
+#include "CommonDefX86.h"
+#include "../SampleAdaptiveOffset.h"
+
+
+#if HHI_SIMD_OPT_SAO
+#ifdef TARGET_SIMD_X86
+
+// the offsets are looked up with byte shuffles, which requires them to fit into 8 bit
+static inline Bool saoOffsetsFitInt8( const Int* offset, Int num )
+{
+  for( Int i = 0; i < num; i++ )
+  {
+    if( offset[i] < -128 || offset[i] > 127 )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// sgn( a - b ) per 16 bit lane
+static inline __m128i saoSign( const __m128i& a, const __m128i& b )
+{
+  return _mm_sub_epi16( _mm_cmpgt_epi16( b, a ), _mm_cmpgt_epi16( a, b ) );
+}
+
+// looks up the table entries for the indices (0..15) of the 16 bit lanes and sign extends them
+static inline __m128i saoLookup( const __m128i& vtab, const __m128i& idx )
+{
+  const __m128i r = _mm_shuffle_epi8( vtab, _mm_or_si128( idx, _mm_set1_epi16( ( Short ) 0x8000 ) ) );
+  return _mm_srai_epi16( _mm_slli_epi16( r, 8 ), 8 );
+}
+
+#if USE_AVX2
+static inline __m256i saoSign256( const __m256i& a, const __m256i& b )
+{
+  return _mm256_sub_epi16( _mm256_cmpgt_epi16( b, a ), _mm256_cmpgt_epi16( a, b ) );
+}
+
+static inline __m256i saoLookup256( const __m256i& vtab, const __m256i& idx )
+{
+  const __m256i r = _mm256_shuffle_epi8( vtab, _mm256_or_si256( idx, _mm256_set1_epi16( ( Short ) 0x8000 ) ) );
+  return _mm256_srai_epi16( _mm256_slli_epi16( r, 8 ), 8 );
+}
+#endif
+
+template< X86_VEXT vext >
+Void saoOffsetEO_SSE( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, const Int* offset, const ClpRng& clpRng )
+{
+  if( !saoOffsetsFitInt8( offset - 2, 5 ) )
+  {
+    SampleAdaptiveOffset::xOffsetEO( srcLine, srcStride, resLine, resStride, startX, endX, numLines, nbOffsetA, nbOffsetB, offset, clpRng );
+    return;
+  }
+
+  SChar tab[16] = { 0 };
+  for( Int k = 0; k < 5; k++ )
+  {
+    tab[k] = ( SChar ) offset[k - 2];
+  }
+
+  const __m128i vtab = _mm_loadu_si128( ( const __m128i* ) tab );
+  const __m128i vmin = _mm_set1_epi16( clpRng.min );
+  const __m128i vmax = _mm_set1_epi16( clpRng.max );
+  const __m128i vtwo = _mm_set1_epi16( 2 );
+
+  for( Int y = 0; y < numLines; y++ )
+  {
+    Int x = startX;
+
+    if( vext >= AVX2 )
+    {
+#if USE_AVX2
+      const __m256i vtab256 = _mm256_broadcastsi128_si256( vtab );
+      const __m256i vmin256 = _mm256_set1_epi16( clpRng.min );
+      const __m256i vmax256 = _mm256_set1_epi16( clpRng.max );
+      const __m256i vtwo256 = _mm256_set1_epi16( 2 );
+
+      for( ; x + 16 <= endX; x += 16 )
+      {
+        const __m256i c   = _mm256_loadu_si256( ( const __m256i* ) &srcLine[x] );
+        const __m256i na  = _mm256_loadu_si256( ( const __m256i* ) &srcLine[x + nbOffsetA] );
+        const __m256i nb  = _mm256_loadu_si256( ( const __m256i* ) &srcLine[x + nbOffsetB] );
+        const __m256i idx = _mm256_add_epi16( _mm256_add_epi16( saoSign256( c, na ), saoSign256( c, nb ) ), vtwo256 );
+        const __m256i res = _mm256_add_epi16( c, saoLookup256( vtab256, idx ) );
+        _mm256_storeu_si256( ( __m256i* ) &resLine[x], _mm256_min_epi16( vmax256, _mm256_max_epi16( vmin256, res ) ) );
+      }
+#endif
+    }
+
+    for( ; x + 8 <= endX; x += 8 )
+    {
+      const __m128i c   = _mm_loadu_si128( ( const __m128i* ) &srcLine[x] );
+      const __m128i na  = _mm_loadu_si128( ( const __m128i* ) &srcLine[x + nbOffsetA] );
+      const __m128i nb  = _mm_loadu_si128( ( const __m128i* ) &srcLine[x + nbOffsetB] );
+      const __m128i idx = _mm_add_epi16( _mm_add_epi16( saoSign( c, na ), saoSign( c, nb ) ), vtwo );
+      const __m128i res = _mm_add_epi16( c, saoLookup( vtab, idx ) );
+      _mm_storeu_si128( ( __m128i* ) &resLine[x], _mm_min_epi16( vmax, _mm_max_epi16( vmin, res ) ) );
+    }
+
+    for( ; x < endX; x++ )
+    {
+      const Int edgeType = sgn( srcLine[x] - srcLine[x + nbOffsetA] ) + sgn( srcLine[x] - srcLine[x + nbOffsetB] );
+      resLine[x] = ClipPel<Int>( srcLine[x] + offset[edgeType], clpRng );
+    }
+
+    srcLine += srcStride;
+    resLine += resStride;
+  }
+}
+
+template< X86_VEXT vext >
+Void saoOffsetBO_SSE( const Pel* srcLine, Int srcStride, Pel* resLine, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, const ClpRng& clpRng )
+{
+  if( ( width & 7 ) || !saoOffsetsFitInt8( offset, NUM_SAO_BO_CLASSES ) )
+  {
+    SampleAdaptiveOffset::xOffsetBO( srcLine, srcStride, resLine, resStride, width, height, shiftBits, offset, clpRng );
+    return;
+  }
+
+  SChar tab[NUM_SAO_BO_CLASSES];
+  for( Int k = 0; k < NUM_SAO_BO_CLASSES; k++ )
+  {
+    tab[k] = ( SChar ) offset[k];
+  }
+
+  // bands 0..15 and 16..31
+  const __m128i vtabLo = _mm_loadu_si128( ( const __m128i* ) &tab[ 0] );
+  const __m128i vtabHi = _mm_loadu_si128( ( const __m128i* ) &tab[16] );
+  const __m128i vmin   = _mm_set1_epi16( clpRng.min );
+  const __m128i vmax   = _mm_set1_epi16( clpRng.max );
+  const __m128i v15    = _mm_set1_epi16( 15 );
+
+  if( vext >= AVX2 && ( width & 15 ) == 0 )
+  {
+#if USE_AVX2
+    const __m256i vtabLo256 = _mm256_broadcastsi128_si256( vtabLo );
+    const __m256i vtabHi256 = _mm256_broadcastsi128_si256( vtabHi );
+    const __m256i vmin256   = _mm256_set1_epi16( clpRng.min );
+    const __m256i vmax256   = _mm256_set1_epi16( clpRng.max );
+    const __m256i v15256    = _mm256_set1_epi16( 15 );
+
+    for( Int y = 0; y < height; y++ )
+    {
+      for( Int x = 0; x < width; x += 16 )
+      {
+        const __m256i c    = _mm256_loadu_si256( ( const __m256i* ) &srcLine[x] );
+        const __m256i band = _mm256_srli_epi16( c, shiftBits );
+        const __m256i off  = _mm256_blendv_epi8( saoLookup256( vtabLo256, band ), saoLookup256( vtabHi256, band ), _mm256_cmpgt_epi16( band, v15256 ) );
+        const __m256i res  = _mm256_add_epi16( c, off );
+        _mm256_storeu_si256( ( __m256i* ) &resLine[x], _mm256_min_epi16( vmax256, _mm256_max_epi16( vmin256, res ) ) );
+      }
+      srcLine += srcStride;
+      resLine += resStride;
+    }
+#endif
+  }
+  else
+  {
+    for( Int y = 0; y < height; y++ )
+    {
+      for( Int x = 0; x < width; x += 8 )
+      {
+        const __m128i c    = _mm_loadu_si128( ( const __m128i* ) &srcLine[x] );
+        const __m128i band = _mm_srli_epi16( c, shiftBits );
+        const __m128i off  = _mm_blendv_epi8( saoLookup( vtabLo, band ), saoLookup( vtabHi, band ), _mm_cmpgt_epi16( band, v15 ) );
+        const __m128i res  = _mm_add_epi16( c, off );
+        _mm_storeu_si128( ( __m128i* ) &resLine[x], _mm_min_epi16( vmax, _mm_max_epi16( vmin, res ) ) );
+      }
+      srcLine += srcStride;
+      resLine += resStride;
+    }
+  }
+}
+
+template< X86_VEXT vext >
+Void saoStatsEO_SSE( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int nbOffsetA, Int nbOffsetB, Int64* diff, Int64* count )
+{
+  // partial sums of the edge classes -2..2, per 32 bit lane
+  __m128i vdiff[5], vcount[5];
+  for( Int k = 0; k < 5; k++ )
+  {
+    vdiff [k] = _mm_setzero_si128();
+    vcount[k] = _mm_setzero_si128();
+  }
+  const __m128i vone = _mm_set1_epi16( 1 );
+
+#if USE_AVX2
+  __m256i vdiff256[5], vcount256[5];
+  for( Int k = 0; k < 5; k++ )
+  {
+    vdiff256 [k] = _mm256_setzero_si256();
+    vcount256[k] = _mm256_setzero_si256();
+  }
+  const __m256i vone256 = _mm256_set1_epi16( 1 );
+#endif
+
+  for( Int y = 0; y < numLines; y++ )
+  {
+    Int x = startX;
+
+    if( vext >= AVX2 )
+    {
+#if USE_AVX2
+      for( ; x + 16 <= endX; x += 16 )
+      {
+        const __m256i c    = _mm256_loadu_si256( ( const __m256i* ) &srcLine[x] );
+        const __m256i na   = _mm256_loadu_si256( ( const __m256i* ) &srcLine[x + nbOffsetA] );
+        const __m256i nb   = _mm256_loadu_si256( ( const __m256i* ) &srcLine[x + nbOffsetB] );
+        const __m256i edge = _mm256_add_epi16( saoSign256( c, na ), saoSign256( c, nb ) );
+        const __m256i d    = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* ) &orgLine[x] ), c );
+
+        for( Int k = 0; k < 5; k++ )
+        {
+          const __m256i m = _mm256_cmpeq_epi16( edge, _mm256_set1_epi16( k - 2 ) );
+          vdiff256 [k] = _mm256_add_epi32( vdiff256 [k], _mm256_madd_epi16( _mm256_and_si256( m, d ), vone256 ) );
+          vcount256[k] = _mm256_sub_epi32( vcount256[k], _mm256_madd_epi16( m, vone256 ) );
+        }
+      }
+#endif
+    }
+
+    for( ; x + 8 <= endX; x += 8 )
+    {
+      const __m128i c    = _mm_loadu_si128( ( const __m128i* ) &srcLine[x] );
+      const __m128i na   = _mm_loadu_si128( ( const __m128i* ) &srcLine[x + nbOffsetA] );
+      const __m128i nb   = _mm_loadu_si128( ( const __m128i* ) &srcLine[x + nbOffsetB] );
+      const __m128i edge = _mm_add_epi16( saoSign( c, na ), saoSign( c, nb ) );
+      const __m128i d    = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* ) &orgLine[x] ), c );
+
+      for( Int k = 0; k < 5; k++ )
+      {
+        const __m128i m = _mm_cmpeq_epi16( edge, _mm_set1_epi16( k - 2 ) );
+        vdiff [k] = _mm_add_epi32( vdiff [k], _mm_madd_epi16( _mm_and_si128( m, d ), vone ) );
+        vcount[k] = _mm_sub_epi32( vcount[k], _mm_madd_epi16( m, vone ) );
+      }
+    }
+
+    for( ; x < endX; x++ )
+    {
+      const Int edgeType = sgn( srcLine[x] - srcLine[x + nbOffsetA] ) + sgn( srcLine[x] - srcLine[x + nbOffsetB] );
+      diff [edgeType] += ( orgLine[x] - srcLine[x] );
+      count[edgeType] ++;
+    }
+
+    srcLine += srcStride;
+    orgLine += orgStride;
+  }
+
+  for( Int k = 0; k < 5; k++ )
+  {
+#if USE_AVX2
+    vdiff [k] = _mm_add_epi32( vdiff [k], _mm_add_epi32( _mm256_castsi256_si128( vdiff256 [k] ), _mm256_extracti128_si256( vdiff256 [k], 1 ) ) );
+    vcount[k] = _mm_add_epi32( vcount[k], _mm_add_epi32( _mm256_castsi256_si128( vcount256[k] ), _mm256_extracti128_si256( vcount256[k], 1 ) ) );
+#endif
+    __m128i sum = _mm_hadd_epi32( vdiff[k], vcount[k] );
+    sum = _mm_hadd_epi32( sum, sum );
+    diff [k - 2] += _mm_cvtsi128_si32( sum );
+    count[k - 2] += _mm_extract_epi32( sum, 1 );
+  }
+}
+
+template< X86_VEXT vext >
+Void saoStatsBO_SSE( const Pel* srcLine, Int srcStride, const Pel* orgLine, Int orgStride, Int startX, Int endX, Int numLines, Int shiftBits, Int64* diff, Int64* count )
+{
+  // the bands and differences are derived with SIMD, the histogram is accumulated in four partial
+  // histograms (one per lane modulo 4) to break the dependency between neighbouring samples of the same band
+  Int partDiff [4][NUM_SAO_BO_CLASSES];
+  Int partCount[4][NUM_SAO_BO_CLASSES];
+  memset( partDiff,  0, sizeof( partDiff  ) );
+  memset( partCount, 0, sizeof( partCount ) );
+
+  Short band[8], dif[8];
+
+  for( Int y = 0; y < numLines; y++ )
+  {
+    Int x = startX;
+    for( ; x + 8 <= endX; x += 8 )
+    {
+      const __m128i c = _mm_loadu_si128( ( const __m128i* ) &srcLine[x] );
+      const __m128i o = _mm_loadu_si128( ( const __m128i* ) &orgLine[x] );
+      _mm_storeu_si128( ( __m128i* ) band, _mm_srli_epi16( c, shiftBits ) );
+      _mm_storeu_si128( ( __m128i* ) dif,  _mm_sub_epi16( o, c ) );
+
+      for( Int i = 0; i < 8; i++ )
+      {
+        partDiff [i & 3][band[i]] += dif[i];
+        partCount[i & 3][band[i]] ++;
+      }
+    }
+
+    for( ; x < endX; x++ )
+    {
+      const Int bandIdx = srcLine[x] >> shiftBits;
+      diff [bandIdx] += ( orgLine[x] - srcLine[x] );
+      count[bandIdx] ++;
+    }
+
+    srcLine += srcStride;
+    orgLine += orgStride;
+  }
+
+  for( Int k = 0; k < NUM_SAO_BO_CLASSES; k++ )
+  {
+    diff [k] += partDiff [0][k] + partDiff [1][k] + partDiff [2][k] + partDiff [3][k];
+    count[k] += partCount[0][k] + partCount[1][k] + partCount[2][k] + partCount[3][k];
+  }
+}
+
+template<X86_VEXT vext>
+Void SampleAdaptiveOffset::_initSampleAdaptiveOffsetX86()
+{
+  m_offsetEO = saoOffsetEO_SSE<vext>;
+  m_offsetBO = saoOffsetBO_SSE<vext>;
+  m_statsEO  = saoStatsEO_SSE<vext>;
+  m_statsBO  = saoStatsBO_SSE<vext>;
+}
+
+template Void SampleAdaptiveOffset::_initSampleAdaptiveOffsetX86<SIMDX86>();
+
+#endif // TARGET_SIMD_X86
+#endif
+//! \}
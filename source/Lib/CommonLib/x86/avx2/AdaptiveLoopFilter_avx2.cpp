@@ -0,0 +1 @@
+#include "../AdaptiveLoopFilterX86.h"
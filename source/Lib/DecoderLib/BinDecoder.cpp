@@ -2,15 +2,23 @@
 
 #include "BinDecoder.h"
 #include "CommonLib/Rom.h"
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
 #include "CommonLib/CodingStatistics.h"
 #endif
+#if ENABLE_BIT_STATISTICS
+#include "BitStatistics.h"
+#endif
 
 #include "CommonLib/dtrace_next.h"
 
 #define CNT_OFFSET 0
 
 
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
+static const CodingStatisticsClassType s_unsetStatisticsType( STATS__CABAC_BITS__INVALID );
+#endif
+
+
 
 template <class BinProbModel>
 BinDecoderBase::BinDecoderBase( const BinProbModel* dummy )
@@ -19,6 +27,12 @@ BinDecoderBase::BinDecoderBase( const BinProbModel* dummy )
   , m_Range     ( 0 )
   , m_Value     ( 0 )
   , m_bitsNeeded( 0 )
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
+  , ptype       ( &s_unsetStatisticsType )
+#endif
+#if ENABLE_BIT_STATISTICS
+  , m_bitStatistics( nullptr )
+#endif
 {}
 
 
@@ -39,6 +53,12 @@ void BinDecoderBase::start()
   CHECK( m_Bitstream->getNumBitsUntilByteAligned(), "Bitstream is not byte aligned." );
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::UpdateCABACStat(STATS__CABAC_INITIALISATION, 512, 510, 0);
+#endif
+#if ENABLE_BIT_STATISTICS
+  if( m_bitStatistics )
+  {
+    m_bitStatistics->addCABAC( STATS__CABAC_INITIALISATION, 512, 510 );
+  }
 #endif
   m_Range       = 510;
   m_Value       = ( m_Bitstream->readByte() << 8 ) + m_Bitstream->readByte();
@@ -79,6 +99,12 @@ unsigned BinDecoderBase::decodeBinEP()
   }
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::IncrementStatisticEP( *ptype, 1, int(bin) );
+#endif
+#if ENABLE_BIT_STATISTICS
+  if( m_bitStatistics )
+  {
+    m_bitStatistics->addEP( ptype->type, 1 );
+  }
 #endif
   DTRACE( g_trace_ctx, D_CABAC, "%d" "  " "%d" "  EP=%d \n",  DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, bin );
   return bin;
@@ -134,6 +160,12 @@ unsigned BinDecoderBase::decodeBinsEP( unsigned numBins )
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::IncrementStatisticEP( *ptype, numBins, int(bins) );
 #endif
+#if ENABLE_BIT_STATISTICS
+  if( m_bitStatistics )
+  {
+    m_bitStatistics->addEP( ptype->type, numBins );
+  }
+#endif
 #if ENABLE_TRACING
   for( Int i = 0; i < numBinsOrig; i++ )
   {
@@ -196,6 +228,13 @@ unsigned BinDecoderBase::decodeBinTrm()
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     CodingStatistics::UpdateCABACStat     ( STATS__CABAC_TRM_BITS,       m_Range+2, 2, 1 );
     CodingStatistics::IncrementStatisticEP( STATS__BYTE_ALIGNMENT_BITS, -m_bitsNeeded, 0 );
+#endif
+#if ENABLE_BIT_STATISTICS
+    if( m_bitStatistics )
+    {
+      m_bitStatistics->addCABAC( STATS__CABAC_TRM_BITS,       m_Range+2, 2 );
+      m_bitStatistics->addEP   ( STATS__BYTE_ALIGNMENT_BITS, -m_bitsNeeded );
+    }
 #endif
     return 1;
   }
@@ -203,6 +242,12 @@ unsigned BinDecoderBase::decodeBinTrm()
   {
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     CodingStatistics::UpdateCABACStat ( STATS__CABAC_TRM_BITS, m_Range+2, m_Range, 0 );
+#endif
+#if ENABLE_BIT_STATISTICS
+    if( m_bitStatistics )
+    {
+      m_bitStatistics->addCABAC( STATS__CABAC_TRM_BITS, m_Range+2, m_Range );
+    }
 #endif
     if( m_Range < 256 )
     {
@@ -225,6 +270,12 @@ unsigned BinDecoderBase::decodeBinsPCM( unsigned numBins )
   m_Bitstream->read( numBins, bins );
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::IncrementStatisticEP( STATS__CABAC_PCM_CODE_BITS, numBins, int(bins) );
+#endif
+#if ENABLE_BIT_STATISTICS
+  if( m_bitStatistics )
+  {
+    m_bitStatistics->addEP( STATS__CABAC_PCM_CODE_BITS, numBins );
+  }
 #endif
   return bins;
 }
@@ -234,6 +285,12 @@ void BinDecoderBase::align()
 {
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::UpdateCABACStat( STATS__CABAC_EP_BIT_ALIGNMENT, m_Range, 256, 0 );
+#endif
+#if ENABLE_BIT_STATISTICS
+  if( m_bitStatistics )
+  {
+    m_bitStatistics->addCABAC( STATS__CABAC_EP_BIT_ALIGNMENT, m_Range, 256 );
+  }
 #endif
   m_Range = 256;
 }
@@ -272,6 +329,12 @@ unsigned BinDecoderBase::decodeAlignedBinsEP( unsigned numBins )
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::IncrementStatisticEP( *ptype, numBins, int(bins) );
 #endif
+#if ENABLE_BIT_STATISTICS
+  if( m_bitStatistics )
+  {
+    m_bitStatistics->addEP( ptype->type, numBins );
+  }
+#endif
 #if ENABLE_TRACING
   for( Int i = 0; i < numBinsOrig; i++ )
   {
@@ -284,15 +347,15 @@ unsigned BinDecoderBase::decodeAlignedBinsEP( unsigned numBins )
 
 
 
-template <class BinProbModel>
-TBinDecoder<BinProbModel>::TBinDecoder()
+template <class BinProbModel, bool CountBits>
+TBinDecoder<BinProbModel, CountBits>::TBinDecoder()
   : BinDecoderBase( static_cast<const BinProbModel*>    ( nullptr ) )
   , m_Ctx         ( static_cast<CtxStore<BinProbModel>&>( *this   ) )
 {}
 
 
-template <class BinProbModel>
-unsigned TBinDecoder<BinProbModel>::decodeBin( unsigned ctxId )
+template <class BinProbModel, bool CountBits>
+unsigned TBinDecoder<BinProbModel, CountBits>::decodeBin( unsigned ctxId )
 {
   BinProbModel& rcProbModel = m_Ctx[ctxId];
   unsigned      bin         = rcProbModel.mps();
@@ -306,6 +369,12 @@ unsigned TBinDecoder<BinProbModel>::decodeBin( unsigned ctxId )
   {
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, m_Range, int( bin ) );
+#endif
+#if ENABLE_BIT_STATISTICS
+    if( CountBits )
+    {
+      m_bitStatistics->addCABAC( ptype->type, m_Range+LPS, m_Range );
+    }
 #endif
     // MPS path
     if( m_Range < 256 )
@@ -326,6 +395,12 @@ unsigned TBinDecoder<BinProbModel>::decodeBin( unsigned ctxId )
     bin = 1 - bin;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, LPS, int( bin ) );
+#endif
+#if ENABLE_BIT_STATISTICS
+    if( CountBits )
+    {
+      m_bitStatistics->addCABAC( ptype->type, m_Range+LPS, LPS );
+    }
 #endif
     // LPS path
     int numBits   = rcProbModel.getRenormBitsLPS( LPS );
@@ -351,4 +426,10 @@ template class TBinDecoder<BinProbModel_Std>;
 template class TBinDecoder<BinProbModel_JMP>;
 template class TBinDecoder<BinProbModel_JAW>;
 template class TBinDecoder<BinProbModel_JMPAW>;
+#if ENABLE_BIT_STATISTICS
+template class TBinDecoder<BinProbModel_Std,   true>;
+template class TBinDecoder<BinProbModel_JMP,   true>;
+template class TBinDecoder<BinProbModel_JAW,   true>;
+template class TBinDecoder<BinProbModel_JMPAW, true>;
+#endif
 
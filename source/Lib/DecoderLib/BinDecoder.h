@@ -7,9 +7,12 @@
 #include "CommonLib/BitStream.h"
 
 
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
 class CodingStatisticsClassType;
 #endif
+#if ENABLE_BIT_STATISTICS
+class BitStatistics;
+#endif
 
 
 
@@ -26,9 +29,12 @@ public:
   void      start   ();
   void      finish  ();
   void      reset   ( int qp, int initId );
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
   void      set     ( const CodingStatisticsClassType& type) { ptype = &type; }
 #endif
+#if ENABLE_BIT_STATISTICS
+  void      setBitStatistics( BitStatistics* bitStatistics ) { m_bitStatistics = bitStatistics; }
+#endif
 
 public:
   virtual unsigned  decodeBin           ( unsigned ctxId    ) = 0;
@@ -48,14 +54,18 @@ protected:
   uint32_t          m_Range;
   uint32_t          m_Value;
   int32_t           m_bitsNeeded;
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
   const CodingStatisticsClassType* ptype;
 #endif
+#if ENABLE_BIT_STATISTICS
+  BitStatistics*    m_bitStatistics;    ///< only set for the counting variants of TBinDecoder
+#endif
 };
 
 
 
-template <class BinProbModel>
+/// the bins of the context coded syntax elements are counted in the CountBits variants only
+template <class BinProbModel, bool CountBits = false>
 class TBinDecoder : public BinDecoderBase
 {
 public:
@@ -73,4 +83,11 @@ typedef TBinDecoder<BinProbModel_JMP>   BinDecoder_JMP;
 typedef TBinDecoder<BinProbModel_JAW>   BinDecoder_JAW;
 typedef TBinDecoder<BinProbModel_JMPAW> BinDecoder_JMPAW;
 
+#if ENABLE_BIT_STATISTICS
+typedef TBinDecoder<BinProbModel_Std,   true> BinDecoderBits_Std;
+typedef TBinDecoder<BinProbModel_JMP,   true> BinDecoderBits_JMP;
+typedef TBinDecoder<BinProbModel_JAW,   true> BinDecoderBits_JAW;
+typedef TBinDecoder<BinProbModel_JMPAW, true> BinDecoderBits_JMPAW;
+#endif
+
 
@@ -0,0 +1,191 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     BitStatistics.cpp
+    \brief    run-time syntax element bit statistics of the decoder
+*/
+
+#include "BitStatistics.h"
+
+#include <iomanip>
+
+//! \ingroup DecoderLib
+//! \{
+
+#if ENABLE_BIT_STATISTICS
+
+// the syntax elements of the slice data, the types before are counted by the analyser build only
+static const Int FIRST_SLICE_DATA_STAT = STATS__CABAC_INITIALISATION;
+
+Void BitStatistics::Counts::clear()
+{
+  std::fill_n( cabac, ( size_t ) STATS__NUM_STATS, 0 );
+  std::fill_n( ep,    ( size_t ) STATS__NUM_STATS, 0 );
+}
+
+BitStatistics::Counts& BitStatistics::Counts::operator+=( const Counts& src )
+{
+  for( Int i = 0; i < STATS__NUM_STATS; i++ )
+  {
+    cabac[i] += src.cabac[i];
+    ep   [i] += src.ep   [i];
+  }
+  return *this;
+}
+
+BitStatistics::BitStatistics()
+  : m_json       ( false )
+  , m_perCtu     ( false )
+  , m_firstRecord( true )
+{
+}
+
+BitStatistics::~BitStatistics()
+{
+  close();
+}
+
+Bool BitStatistics::open( const std::string& fileName, Bool perCtu )
+{
+  const std::string jsonExt = ".json";
+
+  m_json        = fileName.size() >= jsonExt.size() && fileName.compare( fileName.size() - jsonExt.size(), jsonExt.size(), jsonExt ) == 0;
+  m_perCtu      = perCtu;
+  m_firstRecord = true;
+  m_ctu    .clear();
+  m_picture.clear();
+
+  m_file.open( fileName.c_str(), std::ios::out );
+  if( !m_file.is_open() )
+  {
+    return false;
+  }
+  m_file << std::fixed << std::setprecision( 2 );
+  xWriteHeader();
+  return m_file.good();
+}
+
+Void BitStatistics::close()
+{
+  if( m_file.is_open() )
+  {
+    if( m_json )
+    {
+      m_file << ( m_firstRecord ? "" : "\n" ) << "  ]\n}\n";
+    }
+    m_file.close();
+  }
+}
+
+Void BitStatistics::finishCtu( Int poc, UInt ctuRsAddr )
+{
+  if( m_perCtu )
+  {
+    xWriteRecord( poc, Int( ctuRsAddr ), m_ctu );
+  }
+  m_picture += m_ctu;
+  m_ctu.clear();
+}
+
+Void BitStatistics::finishPicture( Int poc )
+{
+  if( !m_perCtu )
+  {
+    xWriteRecord( poc, -1, m_picture );
+  }
+  m_picture.clear();
+}
+
+Void BitStatistics::xWriteHeader()
+{
+  if( m_json )
+  {
+    m_file << "{\n  \"granularity\": \"" << ( m_perCtu ? "ctu" : "picture" ) << "\",\n  \"records\": [\n";
+    return;
+  }
+
+  m_file << "poc" << ( m_perCtu ? ",ctu" : "" ) << ",total";
+  for( Int i = FIRST_SLICE_DATA_STAT; i < STATS__NUM_STATS; i++ )
+  {
+    m_file << "," << getName( CodingStatisticsType( i ) );
+  }
+  m_file << "\n";
+}
+
+Void BitStatistics::xWriteRecord( Int poc, Int ctuRsAddr, const Counts& counts )
+{
+  Double total = 0;
+  for( Int i = FIRST_SLICE_DATA_STAT; i < STATS__NUM_STATS; i++ )
+  {
+    total += counts.bits( i );
+  }
+
+  if( !m_json )
+  {
+    m_file << poc;
+    if( ctuRsAddr >= 0 )
+    {
+      m_file << "," << ctuRsAddr;
+    }
+    m_file << "," << total;
+    for( Int i = FIRST_SLICE_DATA_STAT; i < STATS__NUM_STATS; i++ )
+    {
+      m_file << "," << counts.bits( i );
+    }
+    m_file << "\n";
+    return;
+  }
+
+  m_file << ( m_firstRecord ? "" : ",\n" ) << "    { \"poc\": " << poc;
+  if( ctuRsAddr >= 0 )
+  {
+    m_file << ", \"ctu\": " << ctuRsAddr;
+  }
+  m_file << ", \"total\": " << total << ", \"bits\": {";
+
+  Bool firstBits = true;
+  for( Int i = FIRST_SLICE_DATA_STAT; i < STATS__NUM_STATS; i++ )
+  {
+    if( counts.cabac[i] || counts.ep[i] )
+    {
+      m_file << ( firstBits ? " " : ", " ) << "\"" << getName( CodingStatisticsType( i ) ) << "\": " << counts.bits( i );
+      firstBits = false;
+    }
+  }
+  m_file << " } }";
+  m_firstRecord = false;
+}
+
+#endif
+
+//! \}
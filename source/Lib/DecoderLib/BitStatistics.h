@@ -0,0 +1,111 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     BitStatistics.h
+    \brief    run-time syntax element bit statistics of the decoder (header)
+*/
+
+#ifndef __BITSTATISTICS__
+#define __BITSTATISTICS__
+
+#include "CommonLib/CommonDef.h"
+#include "CommonLib/CodingStatistics.h"
+
+#include <fstream>
+#include <string>
+
+//! \ingroup DecoderLib
+//! \{
+
+#if ENABLE_BIT_STATISTICS
+
+/**
+  Bits spent per syntax element of the slice data, written per picture or per CTU as CSV or JSON.
+
+  Unlike the statistics of the analyser build (RExt__DECODER_DEBUG_BIT_STATISTICS), this is a run-time option of the
+  normal decoder: the bins are only counted by the bin decoder variants created for it, see CABACDecoder. The counts
+  are kept per decoder instance, so each decoding thread accumulates into its own object without synchronisation.
+*/
+class BitStatistics
+{
+public:
+  BitStatistics();
+  ~BitStatistics();
+
+  Bool  open          ( const std::string& fileName, Bool perCtu );   ///< JSON if the file name ends with ".json", CSV otherwise
+  Void  close         ();
+
+  Void  addCABAC      ( CodingStatisticsType type, UInt rangeBefore, UInt rangeAfter )
+  {
+    m_ctu.cabac[xValidType( type )] += m_log.values[rangeBefore] - m_log.values[rangeAfter];
+  }
+  Void  addEP         ( CodingStatisticsType type, UInt numBits )
+  {
+    m_ctu.ep[xValidType( type )] += numBits;
+  }
+
+  Void  finishCtu     ( Int poc, UInt ctuRsAddr );
+  Void  finishPicture ( Int poc );
+
+private:
+  struct Counts
+  {
+    Int64 cabac[STATS__NUM_STATS];   ///< in units of 1 / CODINGSTATISTICS_ENTROPYSCALE bits
+    Int64 ep   [STATS__NUM_STATS];
+
+    Counts()                                { clear(); }
+    Void    clear       ();
+    Counts& operator+=  ( const Counts& src );
+    Double  bits        ( Int type ) const  { return Double( cabac[type] ) / CODINGSTATISTICS_ENTROPYSCALE + ep[type]; }
+  };
+
+  // the type may be stale if the syntax element did not set its own, see CodingStatisticsClassType
+  static Int xValidType ( CodingStatisticsType type ) { return UInt( type ) < STATS__NUM_STATS ? type : STATS__CABAC_BITS__INVALID; }
+
+  Void  xWriteHeader  ();
+  Void  xWriteRecord  ( Int poc, Int ctuRsAddr, const Counts& counts );
+
+  CodingStatistics::StatLogValue m_log;
+  Counts                         m_ctu;
+  Counts                         m_picture;
+  std::ofstream                  m_file;
+  Bool                           m_json;
+  Bool                           m_perCtu;
+  Bool                           m_firstRecord;
+};
+
+#endif
+
+//! \}
+
+#endif // __BITSTATISTICS__
@@ -44,8 +44,9 @@
 #include "CommonLib/AdaptiveLoopFilter.h"
 #include "CommonLib/dtrace_next.h"
 #include "CommonLib/Picture.h"
+#include "CommonLib/Profiler.h"
 
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
 #include "CommonLib/CodingStatistics.h"
 #endif
 
@@ -56,12 +57,23 @@
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET_SIZE(x,s)    const CodingStatisticsClassType CSCT(x, s.width, s.height);    m_BinDecoder.set( CSCT )
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET_SIZE2(x,s,z) const CodingStatisticsClassType CSCT(x, s.width, s.height, z); m_BinDecoder.set( CSCT )
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_SET(x)                  m_BinDecoder.set( x );
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2(n,x,w,h,z) CodingStatisticsClassType n(x, w, h, z)
+#elif ENABLE_BIT_STATISTICS
+// the run-time statistics only distinguish the syntax elements, the block size and component are not needed, and the
+// type is only set when the bits are counted
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET(x)           const CodingStatisticsClassType CSCT(x);                       if( m_countBits ) m_BinDecoder.set( CSCT )
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET2(x,y)        const CodingStatisticsClassType CSCT(x);                       if( m_countBits ) m_BinDecoder.set( CSCT )
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET_SIZE(x,s)    const CodingStatisticsClassType CSCT(x);                       if( m_countBits ) m_BinDecoder.set( CSCT )
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET_SIZE2(x,s,z) const CodingStatisticsClassType CSCT(x);                       if( m_countBits ) m_BinDecoder.set( CSCT )
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_SET(x)                  if( m_countBits ) m_BinDecoder.set( x );
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2(n,x,w,h,z) CodingStatisticsClassType n(x)
 #else
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET(x)
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET2(x,y)
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET_SIZE(x,s)
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SET_SIZE2(x,s,z)
 #define RExt__DECODER_DEBUG_BIT_STATISTICS_SET(x)
+#define RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2(n,x,w,h,z)
 #endif
 
 
@@ -145,6 +157,8 @@ void CABACReader::remaining_bytes( bool noTrailingBytesExpected )
 
 bool CABACReader::coding_tree_unit( CodingStructure& cs, const UnitArea& area, int& qp, unsigned ctuRsAddr )
 {
+  PROFILE_SCOPE( PROF_DEC_PARSE );
+
   CUCtx cuCtx( qp );
   Partitioner *partitioner = PartitionerFactory::get( *cs.slice );
 
@@ -2190,7 +2204,7 @@ bool CABACReader::cbf_comp( const CompArea& area, unsigned depth )
 
 void CABACReader::mvd_coding( Mv &rMvd )
 {
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
   CodingStatisticsClassType ctype_mvd    ( STATS__CABAC_BITS__MVD );
   CodingStatisticsClassType ctype_mvd_ep ( STATS__CABAC_BITS__MVD_EP );
 #endif
@@ -2759,12 +2773,10 @@ int CABACReader::last_sig_coeff( CoeffCodingContext& cctx )
 void CABACReader::residual_coding_subblock( CoeffCodingContext& cctx, TCoeff* coeff )
 {
   // NOTE: All coefficients of the subblock must be set to zero before calling this function
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-  CodingStatisticsClassType ctype_group ( STATS__CABAC_BITS__SIG_COEFF_GROUP_FLAG,  cctx.width(), cctx.height(), cctx.compID() );
-  CodingStatisticsClassType ctype_map   ( STATS__CABAC_BITS__SIG_COEFF_MAP_FLAG,    cctx.width(), cctx.height(), cctx.compID() );
-  CodingStatisticsClassType ctype_gt1   ( STATS__CABAC_BITS__GT1_FLAG,              cctx.width(), cctx.height(), cctx.compID() );
-  CodingStatisticsClassType ctype_gt2   ( STATS__CABAC_BITS__GT2_FLAG,              cctx.width(), cctx.height(), cctx.compID() );
-#endif
+  RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_group, STATS__CABAC_BITS__SIG_COEFF_GROUP_FLAG,  cctx.width(), cctx.height(), cctx.compID() );
+  RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_map,   STATS__CABAC_BITS__SIG_COEFF_MAP_FLAG,    cctx.width(), cctx.height(), cctx.compID() );
+  RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_gt1,   STATS__CABAC_BITS__GT1_FLAG,              cctx.width(), cctx.height(), cctx.compID() );
+  RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_gt2,   STATS__CABAC_BITS__GT2_FLAG,              cctx.width(), cctx.height(), cctx.compID() );
   RExt__DECODER_DEBUG_BIT_STATISTICS_SET( ctype_group );
 
   //===== init =====
@@ -2884,10 +2896,10 @@ void CABACReader::residual_coding_subblock( CoeffCodingContext& cctx, TCoeff* co
       m_BinDecoder.align();
     }
 
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
     const bool alignGroup = escapeData && cctx.alignFlag();
-    CodingStatisticsClassType ctype_signs( ( alignGroup ? STATS__CABAC_BITS__ALIGNED_SIGN_BIT    : STATS__CABAC_BITS__SIGN_BIT    ), cctx.width(), cctx.height(), cctx.compID() );
-    CodingStatisticsClassType ctype_escs ( ( alignGroup ? STATS__CABAC_BITS__ALIGNED_ESCAPE_BITS : STATS__CABAC_BITS__ESCAPE_BITS ), cctx.width(), cctx.height(), cctx.compID() );
+    RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_signs, ( alignGroup ? STATS__CABAC_BITS__ALIGNED_SIGN_BIT    : STATS__CABAC_BITS__SIGN_BIT    ), cctx.width(), cctx.height(), cctx.compID() );
+    RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_escs,  ( alignGroup ? STATS__CABAC_BITS__ALIGNED_ESCAPE_BITS : STATS__CABAC_BITS__ESCAPE_BITS ), cctx.width(), cctx.height(), cctx.compID() );
 #endif
 
     RExt__DECODER_DEBUG_BIT_STATISTICS_SET( ctype_signs );
@@ -3053,10 +3065,10 @@ void CABACReader::residual_coding_subblock( CoeffCodingContext& cctx, TCoeff* co
       m_BinDecoder.align();
     }
 
-  #if RExt__DECODER_DEBUG_BIT_STATISTICS
+  #if RExt__DECODER_DEBUG_BIT_STATISTICS || ENABLE_BIT_STATISTICS
     const bool alignGroup = escapeData && cctx.alignFlag();
-    CodingStatisticsClassType ctype_signs( ( alignGroup ? STATS__CABAC_BITS__ALIGNED_SIGN_BIT    : STATS__CABAC_BITS__SIGN_BIT    ), cctx.width(), cctx.height(), cctx.compID() );
-    CodingStatisticsClassType ctype_escs ( ( alignGroup ? STATS__CABAC_BITS__ALIGNED_ESCAPE_BITS : STATS__CABAC_BITS__ESCAPE_BITS ), cctx.width(), cctx.height(), cctx.compID() );
+    RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_signs, ( alignGroup ? STATS__CABAC_BITS__ALIGNED_SIGN_BIT    : STATS__CABAC_BITS__SIGN_BIT    ), cctx.width(), cctx.height(), cctx.compID() );
+    RExt__DECODER_DEBUG_BIT_STATISTICS_CREATE_SIZE2( ctype_escs,  ( alignGroup ? STATS__CABAC_BITS__ALIGNED_ESCAPE_BITS : STATS__CABAC_BITS__ESCAPE_BITS ), cctx.width(), cctx.height(), cctx.compID() );
   #endif
 
     RExt__DECODER_DEBUG_BIT_STATISTICS_SET( ctype_signs );
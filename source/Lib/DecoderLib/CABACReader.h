@@ -49,7 +49,11 @@ class CABACDecoder;
 class CABACReader
 {
 public:
+#if ENABLE_BIT_STATISTICS
+  CABACReader( BinDecoderBase& binDecoder, bool countBits = false ) : m_BinDecoder( binDecoder ), m_Bitstream( 0 ), m_countBits( countBits ) {}
+#else
   CABACReader( BinDecoderBase& binDecoder ) : m_BinDecoder( binDecoder ), m_Bitstream( 0 ) {}
+#endif
   virtual ~CABACReader() {}
 
 public:
@@ -163,6 +167,9 @@ private:
 private:
   BinDecoderBase& m_BinDecoder;
   InputBitstream* m_Bitstream;
+#if ENABLE_BIT_STATISTICS
+  const bool      m_countBits;      ///< the syntax elements only set their statistics type for the counting bin decoders
+#endif
   MotionInfo      m_SubPuMiBuf   [( MAX_CU_SIZE * MAX_CU_SIZE ) >> ( MIN_CU_LOG2 << 1 )];
   MotionInfo      m_SubPuExtMiBuf[( MAX_CU_SIZE * MAX_CU_SIZE ) >> ( MIN_CU_LOG2 << 1 )];
 };
@@ -177,9 +184,32 @@ public:
     , m_CABACReaderJAW  ( m_BinDecoderJAW )
     , m_CABACReaderJMPAW( m_BinDecoderJMPAW )
     , m_CABACReader     { &m_CABACReaderStd, &m_CABACReaderJMP, &m_CABACReaderJAW, &m_CABACReaderJMPAW }
+#if ENABLE_BIT_STATISTICS
+    , m_CABACReaderBitsStd  ( m_BinDecoderBitsStd, true )
+    , m_CABACReaderBitsJMP  ( m_BinDecoderBitsJMP, true )
+    , m_CABACReaderBitsJAW  ( m_BinDecoderBitsJAW, true )
+    , m_CABACReaderBitsJMPAW( m_BinDecoderBitsJMPAW, true )
+    , m_CABACReaderBits     { &m_CABACReaderBitsStd, &m_CABACReaderBitsJMP, &m_CABACReaderBitsJAW, &m_CABACReaderBitsJMPAW }
+    , m_bitStatistics       ( nullptr )
+#endif
   {}
 
+#if ENABLE_BIT_STATISTICS
+  CABACReader*                getCABACReader    ( int           id    )       { return m_bitStatistics ? m_CABACReaderBits[id] : m_CABACReader[id]; }
+
+  /// selects the bin decoders counting the bits per syntax element into bitStatistics (nullptr: the normal bin decoders)
+  void                        setBitStatistics  ( BitStatistics* bitStatistics )
+  {
+    m_bitStatistics = bitStatistics;
+    m_BinDecoderBitsStd  .setBitStatistics( bitStatistics );
+    m_BinDecoderBitsJMP  .setBitStatistics( bitStatistics );
+    m_BinDecoderBitsJAW  .setBitStatistics( bitStatistics );
+    m_BinDecoderBitsJMPAW.setBitStatistics( bitStatistics );
+  }
+  BitStatistics*              getBitStatistics  ()                            { return m_bitStatistics; }
+#else
   CABACReader*                getCABACReader    ( int           id    )       { return m_CABACReader[id]; }
+#endif
 
   void                        checkInit         ( const SPS*    sps   )       { m_CtxWSizeStore.checkInit(sps); }
   const std::vector<uint8_t>* getWinSizes       ( const Slice*  slice ) const { return m_CtxWSizeStore.getWinSizes(slice); }
@@ -218,6 +248,18 @@ private:
   CABACReader             m_CABACReaderJAW;
   CABACReader             m_CABACReaderJMPAW;
   CABACReader*            m_CABACReader[BPM_NUM-1];
+#if ENABLE_BIT_STATISTICS
+  BinDecoderBits_Std      m_BinDecoderBitsStd;
+  BinDecoderBits_JMP      m_BinDecoderBitsJMP;
+  BinDecoderBits_JAW      m_BinDecoderBitsJAW;
+  BinDecoderBits_JMPAW    m_BinDecoderBitsJMPAW;
+  CABACReader             m_CABACReaderBitsStd;
+  CABACReader             m_CABACReaderBitsJMP;
+  CABACReader             m_CABACReaderBitsJAW;
+  CABACReader             m_CABACReaderBitsJMPAW;
+  CABACReader*            m_CABACReaderBits[BPM_NUM-1];
+  BitStatistics*          m_bitStatistics;
+#endif
   CtxStateStore           m_CtxStateStore;
   CtxWSizeStore           m_CtxWSizeStore;
 };
@@ -43,6 +43,7 @@
 #include "CommonLib/Picture.h"
 #include "CommonLib/UnitTools.h"
 #include "CommonLib/BilateralFilter.h"
+#include "CommonLib/Profiler.h"
 
 #include "CommonLib/dtrace_buffer.h"
 
@@ -79,6 +80,8 @@ Void DecCu::init( TrQuant* pcTrQuant, IntraPrediction* pcIntra, InterPrediction*
  */
 Void DecCu::decompressCtu( CodingStructure& cs, const UnitArea& ctuArea )
 {
+  PROFILE_SCOPE( PROF_DEC_RECON );
+
   for( auto &currCU : cs.traverseCUs( CS::getArea( cs, ctuArea ) ) )
   {
     switch( currCU.predMode )
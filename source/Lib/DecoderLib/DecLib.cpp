@@ -294,6 +294,12 @@ DecLib::DecLib()
   , m_pocRandomAccess(MAX_INT)
   , m_lastRasPoc(MAX_INT)
   , m_cListPic()
+  , m_cBufferPool()
+  , m_pcBufferPool( &m_cBufferPool )
+  , m_lowMemoryDecoding( false )
+#if ENABLE_BIT_STATISTICS
+  , m_bitStatistics( nullptr )
+#endif
   , m_parameterSetManager()
   , m_apcSlicePilot(NULL)
   , m_SEIs()
@@ -321,6 +327,8 @@ DecLib::DecLib()
   , m_pDecodedSEIOutputStream(NULL)
   , m_decodedPictureHashSEIEnabled(false)
   , m_numberOfChecksumErrorsDetected(0)
+  , m_asyncPictureHash(false)
+  , m_pendingHashMsgLevel(INFO)
   , m_warningMessageSkipPicture(false)
   , m_prefixSEINALUs()
 {
@@ -346,11 +354,42 @@ Void DecLib::create()
 
 Void DecLib::destroy()
 {
+  xFinishPictureHash();
+  m_pendingHashBuf.destroy();
+
   delete m_apcSlicePilot;
   m_apcSlicePilot = NULL;
 
   m_cSliceDecoder.destroy();
+
+  m_cBufferPool.clear();
+
+#if ENABLE_BIT_STATISTICS
+  m_CABACDecoder.setBitStatistics( nullptr );
+  delete m_bitStatistics;
+  m_bitStatistics = nullptr;
+#endif
+}
+
+#if ENABLE_BIT_STATISTICS
+/** count the bits per syntax element of the slice data and write them per picture or per CTU to the file
+ */
+Bool DecLib::openBitStatistics( const std::string& fileName, Bool perCtu )
+{
+  if( !m_bitStatistics )
+  {
+    m_bitStatistics = new BitStatistics;
+  }
+  if( !m_bitStatistics->open( fileName, perCtu ) )
+  {
+    delete m_bitStatistics;
+    m_bitStatistics = nullptr;
+  }
+  m_CABACDecoder.setBitStatistics( m_bitStatistics );
+
+  return m_bitStatistics != nullptr;
 }
+#endif
 
 Void DecLib::init()
 {
@@ -453,6 +492,13 @@ Void DecLib::executeLoopFilters()
 
   CodingStructure& cs = *m_pcPic->cs;
 
+#if ENABLE_BIT_STATISTICS
+  if( m_bitStatistics )
+  {
+    m_bitStatistics->finishPicture( cs.slice->getPOC() );
+  }
+#endif
+
   //-- For time output for each slice
 //  pcSlice->startProcessingTimer();
   // deblocking filter
@@ -500,10 +546,27 @@ Void DecLib::finishPictureLight(Int& poc, PicList*& rpcListPic )
   rpcListPic          = &m_cListPic;
 }
 
+/**
+ - print the message line of the last finished picture once its hash check is done
+ */
+Void DecLib::xFinishPictureHash()
+{
+  if( !m_pendingHashCheck.valid() )
+  {
+    return;
+  }
+
+  m_numberOfChecksumErrorsDetected += m_pendingHashCheck.get();
+  msg( m_pendingHashMsgLevel, "%s%s\n", m_pendingHashMsg.c_str(), m_pendingHashStatus.c_str() );
+}
+
 Void DecLib::finishPicture(Int& poc, PicList*& rpcListPic, MsgLevel msgl )
 {
   Slice*  pcSlice = m_pcPic->cs->slice;
 
+  // the line of the previous picture is printed first
+  xFinishPictureHash();
+
   TChar c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
   if (!m_pcPic->referenced)
   {
@@ -511,22 +574,28 @@ Void DecLib::finishPicture(Int& poc, PicList*& rpcListPic, MsgLevel msgl )
   }
 
   //-- For time output for each slice
-  msg( msgl, "POC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
+  std::string line;
+  TChar       str[64];
+
+  snprintf( str, sizeof( str ), "POC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
          pcSlice->getTLayer(),
          c,
          pcSlice->getSliceQp() );
+  line += str;
 
-
-  msg( msgl, "[DT %6.3f] ", pcSlice->getProcessingTime() );
+  snprintf( str, sizeof( str ), "[DT %6.3f] ", pcSlice->getProcessingTime() );
+  line += str;
 
   for (Int iRefList = 0; iRefList < 2; iRefList++)
   {
-    msg( msgl, "[L%d ", iRefList);
+    snprintf( str, sizeof( str ), "[L%d ", iRefList);
+    line += str;
     for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(RefPicList(iRefList)); iRefIndex++)
     {
-      msg( msgl, "%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
+      snprintf( str, sizeof( str ), "%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
+      line += str;
     }
-    msg( msgl, "] ");
+    line += "] ";
   }
   if (m_decodedPictureHashSEIEnabled)
   {
@@ -536,10 +605,41 @@ Void DecLib::finishPicture(Int& poc, PicList*& rpcListPic, MsgLevel msgl )
     {
       msg( WARNING, "Warning: Got multiple decoded picture hash SEI messages. Using first.");
     }
-    m_numberOfChecksumErrorsDetected += calcAndPrintHashStatus(((const Picture*) m_pcPic)->getRecoBuf(), hash, pcSlice->getSPS()->getBitDepths(), msgl);
+
+    if( m_asyncPictureHash )
+    {
+      // the check works on a copy, the picture is modified (border extension) and output while the next picture is decoded
+      const CPelUnitBuf reco = ((const Picture*) m_pcPic)->getRecoBuf();
+      if( m_pendingHashBuf.bufs.empty() || m_pendingHashBuf.chromaFormat != reco.chromaFormat || m_pendingHashBuf.Y().width != reco.Y().width || m_pendingHashBuf.Y().height != reco.Y().height )
+      {
+        m_pendingHashBuf.destroy();
+        m_pendingHashBuf.create( reco.chromaFormat, Area( 0, 0, reco.Y().width, reco.Y().height ) );
+      }
+      m_pendingHashBuf.copyFrom( reco );
+
+      const CPelUnitBuf hashBuf   = m_pendingHashBuf;
+      const BitDepths   bitDepths = pcSlice->getSPS()->getBitDepths();
+      const std::shared_ptr<const SEIDecodedPictureHash> hashSEI( hash ? new SEIDecodedPictureHash( *hash ) : nullptr );
+
+      m_pendingHashMsg      = line;
+      m_pendingHashMsgLevel = msgl;
+      m_pendingHashCheck    = std::async( std::launch::async, [this, hashBuf, bitDepths, hashSEI]()
+      {
+        return calcHashStatus( hashBuf, hashSEI.get(), bitDepths, m_pendingHashStatus );
+      } );
+    }
+    else
+    {
+      std::string status;
+      m_numberOfChecksumErrorsDetected += calcHashStatus(((const Picture*) m_pcPic)->getRecoBuf(), hash, pcSlice->getSPS()->getBitDepths(), status);
+      line += status;
+    }
   }
 
-  msg( msgl, "\n");
+  if( !m_pendingHashCheck.valid() )
+  {
+    msg( msgl, "%s\n", line.c_str() );
+  }
 
   m_pcPic->neededForOutput = (pcSlice->getPicOutputFlag() ? true : false);
   m_pcPic->reconstructed = true;
@@ -550,9 +650,22 @@ Void DecLib::finishPicture(Int& poc, PicList*& rpcListPic, MsgLevel msgl )
   rpcListPic          = &m_cListPic;
   m_bFirstSliceInPicture  = true; // TODO: immer true? hier ist irgendwas faul
 
-  m_pcPic->destroyTempBuffers();
-  m_pcPic->cs->destroyCoeffs();
+  if( m_pcPic->cs->hasCtuScratch() )
+  {
+    m_pcPic->cs->destroyCtuScratch();
+  }
+  else
+  {
+    m_pcPic->destroyTempBuffers();
+    m_pcPic->cs->destroyCoeffs();
+  }
+  // once per GOP, free the pooled buffers that were not needed since the last one, e.g. after a picture size change
+  if( pcSlice->getTLayer() == 0 )
+  {
+    m_pcBufferPool->trim();
+  }
   m_pcPic->cs->releaseIntermediateData();
+  m_pcPic->cs->compactMotion();
 }
 
 Void DecLib::checkNoOutputPriorPics (PicList* pcListPic)
@@ -671,8 +784,18 @@ Void DecLib::xActivateParameterSets()
 
     m_pcPic->finalInit( *sps, *pps );
 
-    m_pcPic->createTempBuffers( m_pcPic->cs->pps->pcv->maxCUWidth );
-    m_pcPic->cs->createCoeffs();
+    if( m_lowMemoryDecoding )
+    {
+      // the PCM/lossless sample restoration after the loop filters needs the PCM buffers of the whole picture
+      const Bool keepPicCoeffs = ( sps->getUsePCM() && sps->getPCMFilterDisableFlag() ) || pps->getTransquantBypassEnabledFlag();
+
+      m_pcPic->cs->createCtuScratch( !keepPicCoeffs, m_pcBufferPool );
+    }
+    else
+    {
+      m_pcPic->createTempBuffers( m_pcPic->cs->pps->pcv->maxCUWidth, m_pcBufferPool );
+      m_pcPic->cs->createCoeffs( m_pcBufferPool );
+    }
 
     m_pcPic->allocateNewSlice();
     // make the slice-pilot a real slice, and set up the slice-pilot for the next slice
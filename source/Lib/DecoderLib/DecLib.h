@@ -40,10 +40,12 @@
 
 #include "DecSlice.h"
 #include "CABACReader.h"
+#include "BitStatistics.h"
 #include "VLCReader.h"
 #include "SEIread.h"
 
 #include "CommonLib/CommonDef.h"
+#include "CommonLib/BufferPool.h"
 #include "CommonLib/Picture.h"
 #include "CommonLib/TrQuant.h"
 #include "CommonLib/InterPrediction.h"
@@ -53,6 +55,10 @@
 #include "CommonLib/SEI.h"
 #include "CommonLib/Unit.h"
 
+#include <future>
+#include <memory>
+#include <thread>
+
 class InputNALUnit;
 
 //! \ingroup DecoderLib
@@ -76,6 +82,12 @@ private:
   Int                     m_lastRasPoc;
 
   PicList                 m_cListPic;         //  Dynamic buffer
+  BufferPool              m_cBufferPool;      //  per-picture temporary buffers, unless a shared pool is set
+  BufferPool*             m_pcBufferPool;
+  Bool                    m_lowMemoryDecoding;  //  CTU sized prediction/residual/coefficient buffers
+#if ENABLE_BIT_STATISTICS
+  BitStatistics*          m_bitStatistics;      //  bits per syntax element, nullptr: not counted
+#endif
   ParameterSetManager     m_parameterSetManager;  // storage for parameter sets
   Slice*                  m_apcSlicePilot;
 
@@ -112,6 +124,12 @@ private:
 
   Int                     m_decodedPictureHashSEIEnabled;  ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
   UInt                    m_numberOfChecksumErrorsDetected;
+  Bool                    m_asyncPictureHash;              ///< check the picture hash while the next picture is decoded
+  std::future<Int>        m_pendingHashCheck;              ///< hash check of the last finished picture, returns the number of mismatches
+  PelStorage              m_pendingHashBuf;                ///< copy of the reconstruction of the last finished picture
+  std::string             m_pendingHashMsg;                ///< message line of the picture, printed with the hash status when the check is done
+  std::string             m_pendingHashStatus;
+  MsgLevel                m_pendingHashMsgLevel;
 
   Bool                    m_warningMessageSkipPicture;
 
@@ -125,6 +143,16 @@ public:
   Void  destroy ();
 
   Void setDecodedPictureHashSEIEnabled(Int enabled) { m_decodedPictureHashSEIEnabled=enabled; }
+  /// check the decoded picture hash on a worker thread, overlapped with the decoding of the next picture (multi-core systems only)
+  Void setAsyncPictureHash(Bool b)                   { m_asyncPictureHash = b && std::thread::hardware_concurrency() > 1; }
+
+  /// use a buffer pool shared with other decoder instances (nullptr: own pool), to be set before decoding
+  Void        setBufferPool( BufferPool* pool )     { m_pcBufferPool = pool ? pool : &m_cBufferPool; }
+  BufferPool* getBufferPool()                       { return m_pcBufferPool; }
+  Void        setLowMemoryDecoding( Bool b )        { m_lowMemoryDecoding = b; }
+#if ENABLE_BIT_STATISTICS
+  Bool        openBitStatistics( const std::string& fileName, Bool perCtu );
+#endif
 
   Void  init();
   Bool  decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay);
@@ -141,12 +169,13 @@ public:
   Bool  getFirstSliceInSequence () const   { return m_bFirstSliceInSequence; }
   Void  setFirstSliceInSequence (bool val) { m_bFirstSliceInSequence = val; }
   Void  setDecodedSEIMessageOutputStream(std::ostream *pOpStream) { m_pDecodedSEIOutputStream = pOpStream; }
-  UInt  getNumberOfChecksumErrorsDetected() const { return m_numberOfChecksumErrorsDetected; }
+  UInt  getNumberOfChecksumErrorsDetected()       { xFinishPictureHash(); return m_numberOfChecksumErrorsDetected; }
 
 protected:
   Void  xUpdateRasInit(Slice* slice);
 
   Picture * xGetNewPicBuffer(const SPS &sps, const PPS &pps, const UInt temporalLayer);
+  Void      xFinishPictureHash();
   Void  xCreateLostPicture (Int iLostPOC);
 
   Void      xActivateParameterSets();
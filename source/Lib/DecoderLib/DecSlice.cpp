@@ -36,6 +36,7 @@
 */
 
 #include "DecSlice.h"
+#include "BitStatistics.h"
 #include "CommonLib/UnitTools.h"
 #include "CommonLib/dtrace_next.h"
 
@@ -197,8 +198,20 @@ Void DecSlice::decompressSlice( Slice* slice, InputBitstream* bitstream )
     {
       cabacReader.alf( cs );
     }
+    if( cs.hasCtuScratch() )
+    {
+      cs.initCtuScratch( ctuArea );
+    }
+
     isLastCtuOfSliceSegment = cabacReader.coding_tree_unit( cs, ctuArea, pic->getPrevQP(), ctuRsAddr );
 
+#if ENABLE_BIT_STATISTICS
+    if( m_CABACDecoder->getBitStatistics() )
+    {
+      m_CABACDecoder->getBitStatistics()->finishCtu( slice->getPOC(), ctuRsAddr );
+    }
+#endif
+
     m_pcCuDecoder->decompressCtu( cs, ctuArea );
 
     // store probabilities of second CTU in line into buffer
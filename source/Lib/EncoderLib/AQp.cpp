@@ -67,22 +67,33 @@ AQpLayer::~AQpLayer()
  */
 
 Void AQpPreanalyzer::preanalyze( Picture* pcEPic )
+{
+  preanalyzeArea( pcEPic, 0, pcEPic->getOrigBuf().Y().height );
+  finishPreanalysis( pcEPic );
+}
+
+/** Compute the activities of the QP adaptation units in a range of luma rows
+ * \param pcEPic Picture object to be analyzed
+ * \param startY first luma row, a multiple of the CTU height
+ * \param endY   luma row after the last one, a multiple of the CTU height or the picture height
+ * \return Void
+ */
+Void AQpPreanalyzer::preanalyzeArea( Picture* pcEPic, const UInt startY, const UInt endY )
 {
   const CPelBuf lumaPlane = pcEPic->getOrigBuf().Y();
-  const Int iWidth  = lumaPlane.width;
-  const Int iHeight = lumaPlane.height;
-  const Int iStride = lumaPlane.stride;
+  const UInt iWidth  = lumaPlane.width;
+  const UInt iHeight = std::min<UInt>( endY, lumaPlane.height );
+  const Int  iStride = lumaPlane.stride;
 
   for ( UInt d = 0; d < pcEPic->aqlayer.size(); d++ )
   {
-    const Pel* pLineY = lumaPlane.bufAt( 0, 0);
     AQpLayer* pcAQLayer = pcEPic->aqlayer[d];
     const UInt uiAQPartWidth = pcAQLayer->getAQPartWidth();
     const UInt uiAQPartHeight = pcAQLayer->getAQPartHeight();
-    Double* pcAQU = &pcAQLayer->getQPAdaptationUnit()[0];
+    const Pel* pLineY = lumaPlane.bufAt( 0, startY );
+    Double* pcAQU = &pcAQLayer->getQPAdaptationUnit()[( startY / uiAQPartHeight ) * pcAQLayer->getAQPartStride()];
 
-    Double dSumAct = 0.0;
-    for ( UInt y = 0; y < iHeight; y += uiAQPartHeight )
+    for ( UInt y = startY; y < iHeight; y += uiAQPartHeight )
     {
       const UInt uiCurrAQPartHeight = std::min(uiAQPartHeight, iHeight-y);
       for ( UInt x = 0; x < iWidth; x += uiAQPartWidth, pcAQU++ )
@@ -91,6 +102,20 @@ Void AQpPreanalyzer::preanalyze( Picture* pcEPic )
         const Pel* pBlkY = &pLineY[x];
         UInt64 uiSum[4] = {0, 0, 0, 0};
         UInt64 uiSumSq[4] = {0, 0, 0, 0};
+
+        CHECK((uiCurrAQPartWidth&1)!=0,  "Odd part width unsupported");
+        CHECK((uiCurrAQPartHeight&1)!=0, "Odd part height unsupported");
+        const UInt pixelWidthOfQuadrants  = uiCurrAQPartWidth >>1;
+        const UInt pixelHeightOfQuadrants = uiCurrAQPartHeight>>1;
+        const UInt numPixInAQPart         = pixelWidthOfQuadrants * pixelHeightOfQuadrants;
+
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+        for ( Int i=0; i<4; i++ )
+        {
+          const Pel* pQuadY = pBlkY + ( i >> 1 ) * pixelHeightOfQuadrants * iStride + ( i & 1 ) * pixelWidthOfQuadrants;
+          g_pelBufOP.sumAndSqr( pQuadY, iStride, pixelWidthOfQuadrants, pixelHeightOfQuadrants, uiSum[i], uiSumSq[i] );
+        }
+#else
         UInt by = 0;
         for ( ; by < uiCurrAQPartHeight>>1; by++ )
         {
@@ -122,12 +147,7 @@ Void AQpPreanalyzer::preanalyze( Picture* pcEPic )
           }
           pBlkY += iStride;
         }
-
-        CHECK((uiCurrAQPartWidth&1)!=0,  "Odd part width unsupported");
-        CHECK((uiCurrAQPartHeight&1)!=0, "Odd part height unsupported");
-        const UInt pixelWidthOfQuadrants  = uiCurrAQPartWidth >>1;
-        const UInt pixelHeightOfQuadrants = uiCurrAQPartHeight>>1;
-        const UInt numPixInAQPart         = pixelWidthOfQuadrants * pixelHeightOfQuadrants;
+#endif
 
         Double dMinVar = DBL_MAX;
         if (numPixInAQPart!=0)
@@ -145,10 +165,27 @@ Void AQpPreanalyzer::preanalyze( Picture* pcEPic )
         }
         const Double dActivity = 1.0 + dMinVar;
         *pcAQU = dActivity;
-        dSumAct += dActivity;
       }
       pLineY += iStride * uiCurrAQPartHeight;
     }
+  }
+}
+
+/** Compute the average activities after the activities of all QP adaptation units are known
+ * \param pcEPic Picture object to be analyzed
+ * \return Void
+ */
+Void AQpPreanalyzer::finishPreanalysis( Picture* pcEPic )
+{
+  for ( UInt d = 0; d < pcEPic->aqlayer.size(); d++ )
+  {
+    AQpLayer* pcAQLayer = pcEPic->aqlayer[d];
+
+    Double dSumAct = 0.0;
+    for ( const Double dActivity : pcAQLayer->getQPAdaptationUnit() )
+    {
+      dSumAct += dActivity;
+    }
 
     const Double dAvgAct = dSumAct / (pcAQLayer->getNumAQPartInWidth() * pcAQLayer->getNumAQPartInHeight());
     pcAQLayer->setAvgActivity( dAvgAct );
@@ -89,6 +89,10 @@ protected:
   virtual ~AQpPreanalyzer() {}
 public:
   static Void preanalyze( Picture* picture );
+
+  // the analysis split into independent ranges of CTU rows and the final averaging
+  static Void preanalyzeArea   ( Picture* picture, const UInt startY, const UInt endY );
+  static Void finishPreanalysis( Picture* picture );
 };
 
 //! \}
@@ -65,24 +65,30 @@ private:
   UInt      m_uiNumPic;
   Double    m_dFrmRate; //--CFG_KDY
   Double    m_MSEyuvframe[MAX_NUM_COMPONENT]; // sum of MSEs
+  Double    m_SSIMSum[MAX_NUM_COMPONENT];
+  Double    m_MSSSIMSum[MAX_NUM_COMPONENT];
 
 public:
   virtual ~Analyze()  {}
   Analyze() { clear(); }
 
-  Void  addResult( Double psnr[MAX_NUM_COMPONENT], Double bits, const Double MSEyuvframe[MAX_NUM_COMPONENT])
+  Void  addResult( Double psnr[MAX_NUM_COMPONENT], Double bits, const Double MSEyuvframe[MAX_NUM_COMPONENT], const Double* ssim = NULL, const Double* msssim = NULL )
   {
     m_dAddBits  += bits;
     for(UInt i=0; i<MAX_NUM_COMPONENT; i++)
     {
       m_dPSNRSum[i] += psnr[i];
       m_MSEyuvframe[i] += MSEyuvframe[i];
+      m_SSIMSum[i]     += ssim   ? ssim[i]   : 0.0;
+      m_MSSSIMSum[i]   += msssim ? msssim[i] : 0.0;
     }
 
     m_uiNumPic++;
   }
 
   Double  getPsnr(ComponentID compID) const { return  m_dPSNRSum[compID];  }
+  Double  getSSIM(ComponentID compID) const { return  m_SSIMSum[compID];   }
+  Double  getMSSSIM(ComponentID compID) const { return m_MSSSIMSum[compID]; }
   Double  getBits()                   const { return  m_dAddBits;   }
   Void    setBits(Double numBits)     { m_dAddBits=numBits; }
   UInt    getNumPic()                 const { return  m_uiNumPic;   }
@@ -95,6 +101,8 @@ public:
     {
       m_dPSNRSum[i] = 0;
       m_MSEyuvframe[i] = 0;
+      m_SSIMSum[i] = 0;
+      m_MSSSIMSum[i] = 0;
     }
     m_uiNumPic = 0;
   }
@@ -359,7 +367,34 @@ public:
   }
 
 
-  Void    printSummary(const ChromaFormat chFmt, const Bool printSequenceMSE, const BitDepths &bitDepths, const std::string &sFilename)
+  Void    printSSIM( TChar cDelim, const ChromaFormat chFmt )
+  {
+    MsgLevel e_msg_level = cDelim == 'a' ? INFO: DETAILS;
+
+    if (chFmt == CHROMA_400)
+    {
+      msg( e_msg_level, "\tTotal Frames |   "  "Y-SSIM    "  "Y-MS-SSIM\n" );
+      msg( e_msg_level, "\t %8d    %c "          "%8.6lf  "    "%8.6lf\n",
+             getNumPic(), cDelim,
+             getSSIM  (COMPONENT_Y) / (Double)getNumPic(),
+             getMSSSIM(COMPONENT_Y) / (Double)getNumPic() );
+    }
+    else
+    {
+      msg( e_msg_level, "\tTotal Frames |   "  "Y-SSIM    "  "U-SSIM    "  "V-SSIM    "  "Y-MS-SSIM "  "U-MS-SSIM "  "V-MS-SSIM\n" );
+      msg( e_msg_level, "\t %8d    %c "          "%8.6lf  "    "%8.6lf  "    "%8.6lf  "    "%8.6lf  "    "%8.6lf  "    "%8.6lf\n",
+             getNumPic(), cDelim,
+             getSSIM  (COMPONENT_Y ) / (Double)getNumPic(),
+             getSSIM  (COMPONENT_Cb) / (Double)getNumPic(),
+             getSSIM  (COMPONENT_Cr) / (Double)getNumPic(),
+             getMSSSIM(COMPONENT_Y ) / (Double)getNumPic(),
+             getMSSSIM(COMPONENT_Cb) / (Double)getNumPic(),
+             getMSSSIM(COMPONENT_Cr) / (Double)getNumPic() );
+    }
+  }
+
+
+  Void    printSummary(const ChromaFormat chFmt, const Bool printSequenceMSE, const Bool printSSIM, const BitDepths &bitDepths, const std::string &sFilename)
   {
     FILE* pFile = fopen (sFilename.c_str(), "at");
 
@@ -368,9 +403,17 @@ public:
     switch (chFmt)
     {
       case CHROMA_400:
-        fprintf(pFile, "%f\t %f\n",
+        fprintf(pFile, "%f\t %f",
             getBits() * dScale,
             getPsnr(COMPONENT_Y) / (Double)getNumPic() );
+
+        if (printSSIM)
+        {
+          fprintf(pFile, "\t %f\t %f",
+              getSSIM  (COMPONENT_Y) / (Double)getNumPic(),
+              getMSSSIM(COMPONENT_Y) / (Double)getNumPic() );
+        }
+        fprintf(pFile, "\n");
         break;
       case CHROMA_420:
       case CHROMA_422:
@@ -390,16 +433,24 @@ public:
 
           if (printSequenceMSE)
           {
-            fprintf(pFile, "\t %f\t %f\t %f\t %f\n",
+            fprintf(pFile, "\t %f\t %f\t %f\t %f",
                 m_MSEyuvframe[COMPONENT_Y ] / (Double)getNumPic(),
                 m_MSEyuvframe[COMPONENT_Cb] / (Double)getNumPic(),
                 m_MSEyuvframe[COMPONENT_Cr] / (Double)getNumPic(),
                 MSEyuv );
           }
-          else
+
+          if (printSSIM)
           {
-            fprintf(pFile, "\n");
+            fprintf(pFile, "\t %f\t %f\t %f\t %f\t %f\t %f",
+                getSSIM  (COMPONENT_Y ) / (Double)getNumPic(),
+                getSSIM  (COMPONENT_Cb) / (Double)getNumPic(),
+                getSSIM  (COMPONENT_Cr) / (Double)getNumPic(),
+                getMSSSIM(COMPONENT_Y ) / (Double)getNumPic(),
+                getMSSSIM(COMPONENT_Cb) / (Double)getNumPic(),
+                getMSSSIM(COMPONENT_Cr) / (Double)getNumPic() );
           }
+          fprintf(pFile, "\n");
 
           break;
         }
@@ -39,6 +39,7 @@
 
 #include "dtrace_codingstruct.h"
 #include "UnitTools.h"
+#include "Profiler.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -146,6 +147,13 @@ EncAdaptiveLoopFilter::EncAdaptiveLoopFilter()
   m_EGlobalSym    = nullptr;
   m_yGlobalSym    = nullptr;
   m_pixAcc        = nullptr;
+  m_EGlobalSymInt = nullptr;
+  m_yGlobalSymInt = nullptr;
+  m_pixAccInt     = nullptr;
+  m_EFullSymInt   = nullptr;
+  m_yFullSymInt   = nullptr;
+  m_pixAccFullInt = nullptr;
+  m_fullStatsValid = false;
   m_E_temp        = nullptr;
   m_y_temp        = nullptr;
   m_E_merged      = nullptr;
@@ -204,6 +212,13 @@ Void EncAdaptiveLoopFilter::create( const Int iPicWidth, Int iPicHeight, const C
   initMatrix4D_double( &m_EGlobalSym, m_NO_TEST_FILT,  m_NO_VAR_BINS, m_MAX_SQR_FILT_LENGTH, m_MAX_SQR_FILT_LENGTH);
   initMatrix3D_double( &m_yGlobalSym, m_NO_TEST_FILT, m_NO_VAR_BINS, m_MAX_SQR_FILT_LENGTH);
   m_pixAcc = (double *) calloc(m_NO_VAR_BINS, sizeof(double));
+  m_EGlobalSymInt = (Int64 *) calloc(m_NO_VAR_BINS * m_MAX_SQR_FILT_LENGTH * m_MAX_SQR_FILT_LENGTH, sizeof(Int64));
+  m_yGlobalSymInt = (Int64 *) calloc(m_NO_VAR_BINS * m_MAX_SQR_FILT_LENGTH, sizeof(Int64));
+  m_pixAccInt     = (Int64 *) calloc(m_NO_VAR_BINS, sizeof(Int64));
+  m_EFullSymInt   = (Int64 *) calloc(m_NO_VAR_BINS * m_MAX_SQR_FILT_LENGTH * m_MAX_SQR_FILT_LENGTH, sizeof(Int64));
+  m_yFullSymInt   = (Int64 *) calloc(m_NO_VAR_BINS * m_MAX_SQR_FILT_LENGTH, sizeof(Int64));
+  m_pixAccFullInt = (Int64 *) calloc(m_NO_VAR_BINS, sizeof(Int64));
+  m_fullStatsValid = false;
 
   initMatrix_double( &m_E_temp, m_MAX_SQR_FILT_LENGTH, m_MAX_SQR_FILT_LENGTH);//
   m_y_temp = (double *) calloc(m_MAX_SQR_FILT_LENGTH, sizeof(double));//
@@ -270,6 +285,15 @@ Void EncAdaptiveLoopFilter::destroy()
   destroyMatrix_int(m_filterCoeffSymQuant);
 
   free(m_pixAcc);
+  free(m_EGlobalSymInt);
+  free(m_yGlobalSymInt);
+  free(m_pixAccInt);
+  free(m_EFullSymInt);
+  free(m_yFullSymInt);
+  free(m_pixAccFullInt);
+  m_EGlobalSymInt = m_yGlobalSymInt = m_pixAccInt = nullptr;
+  m_EFullSymInt   = m_yFullSymInt   = m_pixAccFullInt = nullptr;
+  m_fullStatsValid = false;
 
   destroyMatrix3D_double(m_E_merged, m_NO_VAR_BINS);
   destroyMatrix_double(m_y_merged);
@@ -298,6 +322,8 @@ Void EncAdaptiveLoopFilter::destroy()
  */
 Void EncAdaptiveLoopFilter::ALFProcess(CodingStructure& cs, ALFParam* pcAlfParam, Double dLambdaLuma, Double dLambdaChroma )
 {
+  PROFILE_SCOPE( PROF_ALF );
+
 #if COM16_C806_ALF_TEMPPRED_NUM
   const Int tidx = cs.slice->getTLayer();
   CHECK( tidx >= E0104_ALF_MAX_TEMPLAYERID, " index out of range");
@@ -439,6 +465,7 @@ Void EncAdaptiveLoopFilter::ALFProcess(CodingStructure& cs, ALFParam* pcAlfParam
 Void EncAdaptiveLoopFilter::xEncALFLuma( const PelUnitBuf& orgUnitBuf, const PelUnitBuf& recExtBuf, PelUnitBuf& recUnitBuf, UInt64& ruiMinRate, UInt64& ruiMinDist, Double& rdMinCost, const Slice* pSlice)
 {
   m_updateMatrix = true;
+  m_fullStatsValid = false;
 #if JVET_C0038_NO_PREV_FILTERS
   bFindBestFixedFilter = false;
 #endif
@@ -516,28 +543,23 @@ Void EncAdaptiveLoopFilter::xstoreInBlockMatrixForChroma(const PelUnitBuf& orgUn
 {
   Pel* ImgOrg;
   Pel* ImgDec;
-  Int i, j, k, l, varInd = 0, ii, jj;
+  Int i, j, k, varInd = 0, ii, jj;
   Int x, y, yLocal;
   Int fl = tap / 2;
   Int flV = AdaptiveLoopFilter::ALFFlHToFlV(fl);
   Int sqrFiltLength = AdaptiveLoopFilter::ALFTapHToNumCoeff(tap);
   Int fl2 = 9 / 2; //extended size at each side of the frame
   Int ELocal[m_MAX_SQR_FILT_LENGTH];
-  Int filtType = 0; //for chroma
+  AlfFilterType filtType = ALF_FILTER_SYM_5; //for chroma
   Int iImgHeight = recExtBuf.get(COMPONENT_Cb).height;
   Int iImgWidth = recExtBuf.get(COMPONENT_Cb).width;
-  Double **E, *yy;
 
   const Int *p_pattern = m_patternTab[filtType];
 
-  memset(m_pixAcc, 0, sizeof(Double)*m_NO_VAR_BINS);
-  {
-    memset(m_yGlobalSym[filtType][varInd], 0, sizeof(Double)*m_MAX_SQR_FILT_LENGTH);
-    for (k = 0; k<sqrFiltLength; k++)
-    {
-      memset(m_EGlobalSym[filtType][varInd][k], 0, sizeof(Double)*m_MAX_SQR_FILT_LENGTH);
-    }
-  }
+  memset(m_EGlobalSymInt, 0, sizeof(Int64)*m_MAX_SQR_FILT_LENGTH*m_MAX_SQR_FILT_LENGTH);
+  memset(m_yGlobalSymInt, 0, sizeof(Int64)*m_MAX_SQR_FILT_LENGTH);
+  memset(m_pixAccInt,     0, sizeof(Int64));
+
   for (Int iColorIdx = 0; iColorIdx < 2; iColorIdx++)
   {
     if ((iColorIdx == 0 && chroma_idc < 2) || (iColorIdx == 1 && (chroma_idc & 0x01) == 0))
@@ -553,7 +575,6 @@ Void EncAdaptiveLoopFilter::xstoreInBlockMatrixForChroma(const PelUnitBuf& orgUn
     {
       for (j = 0, x = fl2; j < iImgWidth; j++, x++)
       {
-        varInd = 0;
         k = 0;
         memset(ELocal, 0, sqrFiltLength*sizeof(Int));
         for (ii = -flV; ii < 0; ii++)
@@ -571,29 +592,14 @@ Void EncAdaptiveLoopFilter::xstoreInBlockMatrixForChroma(const PelUnitBuf& orgUn
         }
         ELocal[p_pattern[k++]] += ImgDec[iOffset];
         yLocal = ImgOrg[iOffsetO];
-        m_pixAcc[varInd] += (yLocal*yLocal);
-        E = m_EGlobalSym[filtType][varInd];
-        yy = m_yGlobalSym[filtType][varInd];
-        for (k = 0; k<sqrFiltLength; k++)
-        {
-          for (l = k; l<sqrFiltLength; l++)
-          {
-            E[k][l] += (Double)(ELocal[k] * ELocal[l]);
-          }
-          yy[k] += (Double)(ELocal[k] * yLocal);
-        }
+        m_pixAccInt[varInd] += (yLocal*yLocal);
+        m_accumulateCovariance(ELocal, yLocal, sqrFiltLength, m_EGlobalSymInt, m_yGlobalSymInt);
       }
     }
   }
-  // Matrix EGlobalSeq is symmetric, only part of it is calculated
-  Double **pE = m_EGlobalSym[filtType][varInd];
-  for (k = 1; k < sqrFiltLength; k++)
-  {
-    for (l = 0; l < k; l++)
-    {
-      pE[k][l] = pE[l][k];
-    }
-  }
+
+  memset(m_pixAcc, 0, sizeof(Double)*m_NO_VAR_BINS);
+  xStoreStats(m_EGlobalSymInt, m_yGlobalSymInt, m_pixAccInt, 1, filtType, filtType);
 }
 
 #if JVET_C0038_NO_PREV_FILTERS
@@ -1146,140 +1152,222 @@ Double EncAdaptiveLoopFilter::xCalcDistForce0(
 
 Void EncAdaptiveLoopFilter::xStoreInBlockMatrix(const PelUnitBuf& orgUnitBuf, const PelUnitBuf& recExtBuf, AlfFilterType filtType)
 {
-  const CPelBuf orgLuma = orgUnitBuf.get(COMPONENT_Y);
-  const Pel*    orgBuf = orgLuma.buf;
-  const Int     orgStride = orgLuma.stride;
-
+  const CPelBuf orgLuma    = orgUnitBuf.get(COMPONENT_Y);
   const CPelBuf recExtLuma = recExtBuf.get(COMPONENT_Y);
-  const Pel*    recBufExt = recExtLuma.buf;
-  const Int     recStrideExt = recExtLuma.stride;
 
   if ( !m_isGALF || m_updateMatrix)
   {
-    Int var_step_size_w = m_ALF_VAR_SIZE_W;
-    Int var_step_size_h = m_ALF_VAR_SIZE_H;
-
-    Int tap = m_mapTypeToNumOfTaps[ filtType ];
-
-    Int i,j,k,l,varInd;
-    Int x, y;
-    Int fl =tap/2;
-    Int flV = AdaptiveLoopFilter::ALFFlHToFlV(fl);
-    Int sqrFiltLength = AdaptiveLoopFilter::ALFTapHToNumCoeff(tap);
-    Int fl2=9/2; //extended size at each side of the frame
-    Int ELocal[m_MAX_SQR_FILT_LENGTH];
-    Int yLocal;
-
-    Double **E,*yy;
+    const Int numStats = m_NO_VAR_BINS * m_MAX_SQR_FILT_LENGTH;
     Int count_valid=0;
+    Int i,j;
+    Int fl2=9/2; //extended size at each side of the frame
 
+    for (i = fl2; i < m_img_height+fl2; i++)
+    {
+      for (j = fl2; j < m_img_width+fl2; j++)
+      {
+        if ( m_maskBuf.at(j-fl2, i-fl2) == 1) //[i-fl2][j-fl2]
+        {
+          count_valid++;
+        }
+      }
+    }
 
-    const Int *p_pattern = m_patternTab[filtType];
+    const Int numSamples = m_img_width * m_img_height;
 
     memset( m_pixAcc, 0,sizeof(Double) * m_NO_VAR_BINS);
 
-    for (varInd=0; varInd<m_NO_VAR_BINS; varInd++)
+    if( m_isGALF && ( count_valid == 0 || 2 * count_valid > numSamples ) )
     {
-      memset(m_yGlobalSym[filtType][varInd],0,sizeof(double)*m_MAX_SQR_FILT_LENGTH);
-      for (k=0; k<sqrFiltLength; k++)
+      // the statistics of all samples are accumulated once per picture for the largest filter shape,
+      // the statistics of a masked picture are derived by subtracting the disabled samples
+      if( !m_fullStatsValid )
       {
-        memset(m_EGlobalSym[filtType][varInd][k],0,sizeof(double)*m_MAX_SQR_FILT_LENGTH);
+        memset( m_EFullSymInt,   0, sizeof(Int64) * numStats * m_MAX_SQR_FILT_LENGTH );
+        memset( m_yFullSymInt,   0, sizeof(Int64) * numStats );
+        memset( m_pixAccFullInt, 0, sizeof(Int64) * m_NO_VAR_BINS );
+        xAccumulateLumaStats( orgLuma, recExtLuma, ALF_FILTER_SYM_9, -1, m_EFullSymInt, m_yFullSymInt, m_pixAccFullInt );
+        m_fullStatsValid = true;
       }
-    }
 
-    for (i = fl2; i < m_img_height+fl2; i++)
-    {
-      for (j = fl2; j < m_img_width+fl2; j++)
+      if( count_valid > 0 && count_valid < numSamples )
       {
-        if ( m_maskBuf.at(j-fl2, i-fl2) == 1) //[i-fl2][j-fl2]
+        memset( m_EGlobalSymInt, 0, sizeof(Int64) * numStats * m_MAX_SQR_FILT_LENGTH );
+        memset( m_yGlobalSymInt, 0, sizeof(Int64) * numStats );
+        memset( m_pixAccInt,     0, sizeof(Int64) * m_NO_VAR_BINS );
+        xAccumulateLumaStats( orgLuma, recExtLuma, ALF_FILTER_SYM_9, 0, m_EGlobalSymInt, m_yGlobalSymInt, m_pixAccInt );
+
+        for( i = 0; i < numStats * m_MAX_SQR_FILT_LENGTH; i++ )
         {
-          count_valid++;
+          m_EGlobalSymInt[i] = m_EFullSymInt[i] - m_EGlobalSymInt[i];
+        }
+        for( i = 0; i < numStats; i++ )
+        {
+          m_yGlobalSymInt[i] = m_yFullSymInt[i] - m_yGlobalSymInt[i];
         }
+        for( i = 0; i < m_NO_VAR_BINS; i++ )
+        {
+          m_pixAccInt[i] = m_pixAccFullInt[i] - m_pixAccInt[i];
+        }
+        xStoreStats( m_EGlobalSymInt, m_yGlobalSymInt, m_pixAccInt, m_NO_VAR_BINS, ALF_FILTER_SYM_9, filtType );
+      }
+      else
+      {
+        xStoreStats( m_EFullSymInt, m_yFullSymInt, m_pixAccFullInt, m_NO_VAR_BINS, ALF_FILTER_SYM_9, filtType );
       }
     }
+    else
+    {
+      memset( m_EGlobalSymInt, 0, sizeof(Int64) * numStats * m_MAX_SQR_FILT_LENGTH );
+      memset( m_yGlobalSymInt, 0, sizeof(Int64) * numStats );
+      memset( m_pixAccInt,     0, sizeof(Int64) * m_NO_VAR_BINS );
+      xAccumulateLumaStats( orgLuma, recExtLuma, filtType, count_valid > 0 ? 1 : -1, m_EGlobalSymInt, m_yGlobalSymInt, m_pixAccInt );
+      xStoreStats( m_EGlobalSymInt, m_yGlobalSymInt, m_pixAccInt, m_NO_VAR_BINS, filtType, filtType );
+    }
+  }
+  else
+  {
+    CHECK(filtType == 2, "filterType has to be 0 or 1!");
+    for (Int varInd = 0; varInd < m_NO_VAR_BINS; varInd++)
+    {
+      xDeriveGlobalEyFromLgrTapFilter(m_EGlobalSym[2][varInd], m_yGlobalSym[2][varInd], m_EGlobalSym[filtType][varInd], m_yGlobalSym[filtType][varInd], m_patternMapTab[2], m_patternMapTab[filtType]);
+    }
+  }
+}
+
+// accumulates the integer statistics of the luma samples selected by maskSel (-1: all samples, 0: disabled samples, 1: enabled samples)
+Void EncAdaptiveLoopFilter::xAccumulateLumaStats(const CPelBuf& orgLuma, const CPelBuf& recExtLuma, AlfFilterType filtType, Int maskSel, Int64* E, Int64* y, Int64* pixAcc)
+{
+  const Pel* orgBuf       = orgLuma.buf;
+  const Int  orgStride    = orgLuma.stride;
+  const Pel* recBufExt    = recExtLuma.buf;
+  const Int  recStrideExt = recExtLuma.stride;
 
-    for (i=0,y=fl2; i<m_img_height; i++,y++)
+  Int var_step_size_w = m_ALF_VAR_SIZE_W;
+  Int var_step_size_h = m_ALF_VAR_SIZE_H;
+
+  Int tap = m_mapTypeToNumOfTaps[ filtType ];
+
+  Int i,j,k,varInd;
+  Int fl =tap/2;
+  Int flV = AdaptiveLoopFilter::ALFFlHToFlV(fl);
+  Int sqrFiltLength = AdaptiveLoopFilter::ALFTapHToNumCoeff(tap);
+  Int ELocal[m_MAX_SQR_FILT_LENGTH];
+  Int yLocal;
+
+  const Int *p_pattern = m_patternTab[filtType];
+  const Int  matSize   = m_MAX_SQR_FILT_LENGTH * m_MAX_SQR_FILT_LENGTH;
+
+  for (i=0; i<m_img_height; i++)
+  {
+    for (j=0; j<m_img_width; j++)
     {
-      for (j=0,x=fl2; j<m_img_width; j++,x++)
+      if( maskSel >= 0 && ( m_maskBuf.at(j,i) != 0 ) != ( maskSel != 0 ) )
+      {
+        continue;
+      }
+
+      k = 0;
+      memset(ELocal, 0, sqrFiltLength*sizeof(int));
+      if( m_isGALF )
+      {
+        varInd = m_varImg[i][j];
+        Int transpose = 0;
+        Int varIndMod = selectTransposeVarInd(varInd, &transpose);
+        yLocal = orgBuf[(i)*orgStride + (j)] - recBufExt[(i)*recStrideExt + (j)];
+        calcMatrixE(ELocal, recBufExt, p_pattern, i, j, flV, fl, transpose, recStrideExt);
+        m_accumulateCovariance(ELocal, yLocal, sqrFiltLength, E + varIndMod * matSize, y + varIndMod * m_MAX_SQR_FILT_LENGTH);
+        pixAcc[varIndMod] += (yLocal*yLocal);
+      }
+      else
       {
-        Int condition = (m_maskBuf.at(j,i) == 0 && count_valid > 0);
-        if(!condition)
+        varInd = m_varImg[i / var_step_size_h][j / var_step_size_w];
+        for (int ii = -flV; ii < 0; ii++)
         {
-          k = 0;
-          memset(ELocal, 0, sqrFiltLength*sizeof(int));
-          if( m_isGALF )
+          for (int jj=-fl-ii; jj<=fl+ii; jj++)
           {
-            varInd = m_varImg[i][j];
-            Int transpose = 0;
-            Int varIndMod = selectTransposeVarInd(varInd, &transpose);
-            yLocal = orgBuf[(i)*orgStride + (j)] - recBufExt[(i)*recStrideExt + (j)];
-            calcMatrixE(ELocal, recBufExt, p_pattern, i, j, flV, fl, transpose, recStrideExt);
-            E = m_EGlobalSym[filtType][varIndMod];
-            yy = m_yGlobalSym[filtType][varIndMod];
-
-            for (k = 0; k < sqrFiltLength; k++)
-            {
-              for (l = k; l < sqrFiltLength; l++)
-              {
-                E[k][l] += (double)(ELocal[k] * ELocal[l]);
-              }
-              yy[k] += (double)(ELocal[k] * yLocal);
-            }
-            m_pixAcc[varIndMod] += (yLocal*yLocal);
-          }
-          else
-          {
-            varInd = m_varImg[i / var_step_size_h][j / var_step_size_w];
-            for (int ii = -flV; ii < 0; ii++)
-            {
-              for (int jj=-fl-ii; jj<=fl+ii; jj++)
-              {
-                ELocal[p_pattern[k++]]+=(recBufExt[(i+ii)*recStrideExt + (j+jj)]+recBufExt[(i-ii)*recStrideExt + (j-jj)] );
-              }
-            }
-            for (int jj=-fl; jj<0; jj++)
-            {
-              ELocal[p_pattern[k++]]+=(recBufExt[(i)*recStrideExt + (j+jj)]+recBufExt[(i)*recStrideExt + (j-jj)]);
-            }
-            ELocal[p_pattern[k++]] += recBufExt[(i)*recStrideExt + (j)];
-            ELocal[sqrFiltLength-1]=1;
-            yLocal=orgBuf[(i)*orgStride + (j)];
-
-            m_pixAcc[varInd]+=(yLocal*yLocal);
-            E = m_EGlobalSym[filtType][varInd];
-            yy= m_yGlobalSym[filtType][varInd];
-
-            for (k=0; k<sqrFiltLength; k++)
-            {
-              for (l=k; l<sqrFiltLength; l++)
-                E[k][l]+=(double)(ELocal[k]*ELocal[l]);
-              yy[k]+=(double)(ELocal[k]*yLocal);
-            }
+            ELocal[p_pattern[k++]]+=(recBufExt[(i+ii)*recStrideExt + (j+jj)]+recBufExt[(i-ii)*recStrideExt + (j-jj)] );
           }
         }
+        for (int jj=-fl; jj<0; jj++)
+        {
+          ELocal[p_pattern[k++]]+=(recBufExt[(i)*recStrideExt + (j+jj)]+recBufExt[(i)*recStrideExt + (j-jj)]);
+        }
+        ELocal[p_pattern[k++]] += recBufExt[(i)*recStrideExt + (j)];
+        ELocal[sqrFiltLength-1]=1;
+        yLocal=orgBuf[(i)*orgStride + (j)];
+
+        pixAcc[varInd]+=(yLocal*yLocal);
+        m_accumulateCovariance(ELocal, yLocal, sqrFiltLength, E + varInd * matSize, y + varInd * m_MAX_SQR_FILT_LENGTH);
       }
     }
+  }
+}
 
-    // Matrix EGlobalSeq is symmetric, only part of it is calculated
-    for (varInd=0; varInd<m_NO_VAR_BINS; varInd++)
+// converts the integer statistics accumulated for the filter shape srcFiltType to the statistics of the (equal or smaller) shape filtType
+Void EncAdaptiveLoopFilter::xStoreStats(const Int64* E, const Int64* y, const Int64* pixAcc, Int numVarBins, AlfFilterType srcFiltType, AlfFilterType filtType)
+{
+  const Int sqrFiltLength = AdaptiveLoopFilter::ALFTapHToNumCoeff( m_mapTypeToNumOfTaps[ filtType ] );
+  Int coeffMap[m_MAX_SQR_FILT_LENGTH];
+
+  if( srcFiltType == filtType )
+  {
+    for( Int k = 0; k < sqrFiltLength; k++ )
+    {
+      coeffMap[k] = k;
+    }
+  }
+  else
+  {
+    const Int* pattern0 = m_patternMapTab[srcFiltType];
+    const Int* pattern1 = m_patternMapTab[filtType];
+    for( Int i = 0, k = 0; i < m_MAX_SQR_FILT_LENGTH; i++ )
     {
-      double **pE = m_EGlobalSym[filtType][varInd];
-      for (k=1; k<sqrFiltLength; k++)
+      if( pattern0[i] > 0 )
       {
-        for (l=0; l<k; l++)
+        if( pattern1[i] > 0 )
         {
-          pE[k][l]=pE[l][k];
+          coeffMap[pattern1[i] - 1] = k;
         }
+        k++;
       }
     }
   }
-  else
+
+  for( Int varInd = 0; varInd < numVarBins; varInd++ )
   {
-    CHECK(filtType == 2, "filterType has to be 0 or 1!");
-    for (Int varInd = 0; varInd < m_NO_VAR_BINS; varInd++)
+    const Int64* pEInt = E + varInd * m_MAX_SQR_FILT_LENGTH * m_MAX_SQR_FILT_LENGTH;
+    const Int64* pyInt = y + varInd * m_MAX_SQR_FILT_LENGTH;
+    Double**     pE    = m_EGlobalSym[filtType][varInd];
+    Double*      py    = m_yGlobalSym[filtType][varInd];
+
+    memset( py, 0, sizeof( Double ) * m_MAX_SQR_FILT_LENGTH );
+    for( Int k = 0; k < sqrFiltLength; k++ )
     {
-      xDeriveGlobalEyFromLgrTapFilter(m_EGlobalSym[2][varInd], m_yGlobalSym[2][varInd], m_EGlobalSym[filtType][varInd], m_yGlobalSym[filtType][varInd], m_patternMapTab[2], m_patternMapTab[filtType]);
+      memset( pE[k], 0, sizeof( Double ) * m_MAX_SQR_FILT_LENGTH );
+    }
+
+    for( Int k = 0; k < sqrFiltLength; k++ )
+    {
+      for( Int l = k; l < sqrFiltLength; l++ )
+      {
+        const Int a = std::min( coeffMap[k], coeffMap[l] );
+        const Int b = std::max( coeffMap[k], coeffMap[l] );
+        pE[k][l] = ( Double ) pEInt[a * m_MAX_SQR_FILT_LENGTH + b];
+      }
+      py[k] = ( Double ) pyInt[coeffMap[k]];
     }
+
+    // Matrix EGlobalSeq is symmetric, only part of it is calculated
+    for( Int k = 1; k < sqrFiltLength; k++ )
+    {
+      for( Int l = 0; l < k; l++ )
+      {
+        pE[k][l] = pE[l][k];
+      }
+    }
+
+    m_pixAcc[varInd] = ( Double ) pixAcc[varInd];
   }
 }
 
@@ -111,6 +111,8 @@ private:
 #endif
     );
   Void   xStoreInBlockMatrix(const PelUnitBuf& orgUnitBuf, const PelUnitBuf& recExtBuf, AlfFilterType filtType);
+  Void   xAccumulateLumaStats(const CPelBuf& orgLuma, const CPelBuf& recExtLuma, AlfFilterType filtType, Int maskSel, Int64* E, Int64* y, Int64* pixAcc);
+  Void   xStoreStats(const Int64* E, const Int64* y, const Int64* pixAcc, Int numVarBins, AlfFilterType srcFiltType, AlfFilterType filtType);
 
   Void calcMatrixE(int *ELocal, const Pel *recBufExt, const int *p_pattern, int i, int j, int flV, int fl, int transpose, int recStrideExt);
   Int  xFilterPixel(const Pel *ImgDec, Int* varIndBeforeMapping, Int **filterCoeffSym, Int *pattern, Int i, Int j, Int fl, Int Stride, AlfFilterType filtNo);
@@ -259,6 +261,16 @@ private:
   Double***  m_yGlobalSym;
   Double*    m_pixAcc;
 
+  // integer statistics [m_NO_VAR_BINS][m_MAX_SQR_FILT_LENGTH][m_MAX_SQR_FILT_LENGTH], the full statistics of all samples
+  // are accumulated once per picture for the largest filter shape and reused for the masked statistics (GALF)
+  Int64*     m_EGlobalSymInt;
+  Int64*     m_yGlobalSymInt;
+  Int64*     m_pixAccInt;
+  Int64*     m_EFullSymInt;
+  Int64*     m_yFullSymInt;
+  Int64*     m_pixAccFullInt;
+  Bool       m_fullStatsValid;
+
   Double**   m_E_temp;
   Double*    m_y_temp;
 
@@ -131,6 +131,7 @@ protected:
   Bool      m_printMSEBasedSequencePSNR;
   Bool      m_printFrameMSE;
   Bool      m_printSequenceMSE;
+  Bool      m_printSSIM;
   Bool      m_cabacZeroWordPaddingEnabled;
 
 
@@ -152,6 +153,8 @@ protected:
   UInt      m_uiIntraPeriod;                    // TODO: make this an Int - it can be -1!
   UInt      m_uiDecodingRefreshType;            ///< the type of decoding refresh employed for the random access.
   Int       m_iGOPSize;
+  Int       m_lookaheadFrames;                  ///< number of input pictures analysed ahead of the encoder
+  Int       m_sceneCutThreshold;                ///< scene cut sensitivity of the lookahead in percent
   GOPEntry  m_GOPList[MAX_GOP];
   Int       m_extraRPSs;
   Int       m_maxDecPicBuffering[MAX_TLAYER];
@@ -242,6 +245,7 @@ protected:
   Int       m_loopFilterTcOffsetDiv2;
 #if W0038_DB_OPT
   Int       m_deblockingFilterMetric;
+  Int       m_deblockingFilterMetricThreads;
 #else
   Bool      m_DeblockingFilterMetric;
 #endif
@@ -261,6 +265,10 @@ protected:
   Bool      m_bFastMEAssumingSmootherMVEnabled;
   Int       m_minSearchWindow;
   Bool      m_bRestrictMESampling;
+  Bool      m_bSubPelMECache;
+  Bool      m_bUseHierarchicalME;
+  Int       m_iHierarchicalMESearchRange;
+  Int       m_iMergePredCache;
 
   //====== Quality control ========
   Int       m_iMaxDeltaQP;                      //  Max. absolute delta QP (1:default)
@@ -283,6 +291,7 @@ protected:
   Bool      m_highPrecisionOffsetsEnabledFlag;
   Bool      m_bUseAdaptiveQP;
   Int       m_iQPAdaptationRange;
+  Int       m_preanalysisThreads;
 #if HHI_HLM_USE_QPA
   Bool      m_bUsePerceptQPA;
   Bool      m_bUseANSNR;
@@ -438,6 +447,7 @@ protected:
   Bool      m_RCUseLCUSeparateModel;
   Int       m_RCInitialQP;
   Bool      m_RCForceIntraQP;
+  Int       m_RCLookahead;
 #if U0132_TARGET_BITS_SATURATION
   Bool      m_RCCpbSaturationEnabled;
   UInt      m_RCCpbSize;
@@ -538,6 +548,9 @@ public:
   Bool      getPrintSequenceMSE             ()         const { return m_printSequenceMSE;           }
   Void      setPrintSequenceMSE             (Bool value)     { m_printSequenceMSE = value;          }
 
+  Bool      getPrintSSIM                    ()         const { return m_printSSIM;                  }
+  Void      setPrintSSIM                    (Bool value)     { m_printSSIM = value;                 }
+
   Bool      getCabacZeroWordPaddingEnabled()           const { return m_cabacZeroWordPaddingEnabled;  }
   Void      setCabacZeroWordPaddingEnabled(Bool value)       { m_cabacZeroWordPaddingEnabled = value; }
 
@@ -545,6 +558,8 @@ public:
   Void      setIntraPeriod                  ( Int   i )      { m_uiIntraPeriod = (UInt)i; }
   Void      setDecodingRefreshType          ( Int   i )      { m_uiDecodingRefreshType = (UInt)i; }
   Void      setGOPSize                      ( Int   i )      { m_iGOPSize = i; }
+  Void      setLookaheadFrames              ( Int   i )      { m_lookaheadFrames = i; }
+  Void      setSceneCutThreshold            ( Int   i )      { m_sceneCutThreshold = i; }
   Void      setGopList                      ( const GOPEntry GOPList[MAX_GOP] ) {  for ( Int i = 0; i < MAX_GOP; i++ ) m_GOPList[i] = GOPList[i]; }
   Void      setExtraRPSs                    ( Int   i )      { m_extraRPSs = i; }
   const GOPEntry &getGOPEntry               ( Int   i ) const { return m_GOPList[i]; }
@@ -712,6 +727,7 @@ public:
   Void      setLoopFilterTcOffset           ( Int   i )      { m_loopFilterTcOffsetDiv2    = i; }
 #if W0038_DB_OPT
   Void      setDeblockingFilterMetric       ( Int   i )      { m_deblockingFilterMetric = i; }
+  Void      setDeblockingFilterMetricThreads( Int   i )      { m_deblockingFilterMetricThreads = i; }
 #else
   Void      setDeblockingFilterMetric       ( Bool  b )      { m_DeblockingFilterMetric = b; }
 #endif
@@ -724,6 +740,10 @@ public:
   Void      setFastMEAssumingSmootherMVEnabled ( Bool b )    { m_bFastMEAssumingSmootherMVEnabled = b; }
   Void      setMinSearchWindow              ( Int   i )      { m_minSearchWindow = i; }
   Void      setRestrictMESampling           ( Bool  b )      { m_bRestrictMESampling = b; }
+  Void      setSubPelMECache                ( Bool  b )      { m_bSubPelMECache = b; }
+  Void      setUseHierarchicalME            ( Bool  b )      { m_bUseHierarchicalME = b; }
+  Void      setHierarchicalMESearchRange    ( Int   i )      { m_iHierarchicalMESearchRange = i; }
+  Void      setMergePredCache               ( Int   i )      { m_iMergePredCache = i; }
 
   //====== Quality control ========
   Void      setMaxDeltaQP                   ( Int   i )      { m_iMaxDeltaQP = i; }
@@ -760,6 +780,7 @@ public:
 
   Void      setUseAdaptiveQP                ( Bool  b )      { m_bUseAdaptiveQP = b; }
   Void      setQPAdaptationRange            ( Int   i )      { m_iQPAdaptationRange = i; }
+  Void      setPreanalysisThreads           ( Int   i )      { m_preanalysisThreads = i; }
 #if HHI_HLM_USE_QPA
   Void      setUsePerceptQPA                ( const Bool b ) { m_bUsePerceptQPA = b; }
   Void      setUseANSNR                     ( const Bool b ) { m_bUseANSNR = b; }
@@ -785,6 +806,8 @@ public:
   UInt      getIntraPeriod                  () const     { return  m_uiIntraPeriod; }
   UInt      getDecodingRefreshType          () const     { return  m_uiDecodingRefreshType; }
   Int       getGOPSize                      () const     { return  m_iGOPSize; }
+  Int       getLookaheadFrames              () const     { return  m_lookaheadFrames; }
+  Int       getSceneCutThreshold            () const     { return  m_sceneCutThreshold; }
   Int       getMaxDecPicBuffering           (UInt tlayer) { return m_maxDecPicBuffering[tlayer]; }
   Int       getNumReorderPics               (UInt tlayer) { return m_numReorderPics[tlayer]; }
 #if X0038_LAMBDA_FROM_QP_CAPABILITY
@@ -815,6 +838,7 @@ public:
   Int       getLoopFilterTcOffset           ()      { return m_loopFilterTcOffsetDiv2; }
 #if W0038_DB_OPT
   Int       getDeblockingFilterMetric       ()      { return m_deblockingFilterMetric; }
+  Int       getDeblockingFilterMetricThreads()      { return m_deblockingFilterMetricThreads; }
 #else
   Bool      getDeblockingFilterMetric       ()      { return m_DeblockingFilterMetric; }
 #endif
@@ -827,12 +851,17 @@ public:
   Bool      getFastMEAssumingSmootherMVEnabled () const { return m_bFastMEAssumingSmootherMVEnabled; }
   Int       getMinSearchWindow                 () const { return m_minSearchWindow; }
   Bool      getRestrictMESampling              () const { return m_bRestrictMESampling; }
+  Bool      getSubPelMECache                   () const { return m_bSubPelMECache; }
+  Bool      getUseHierarchicalME               () const { return m_bUseHierarchicalME; }
+  Int       getHierarchicalMESearchRange       () const { return m_iHierarchicalMESearchRange; }
+  Int       getMergePredCache                  () const { return m_iMergePredCache; }
 
   //==== Quality control ========
   Int       getMaxDeltaQP                   () const { return m_iMaxDeltaQP; }
   Int       getMaxCuDQPDepth                () const { return m_iMaxCuDQPDepth; }
   Bool      getUseAdaptiveQP                () const { return m_bUseAdaptiveQP; }
   Int       getQPAdaptationRange            () const { return m_iQPAdaptationRange; }
+  Int       getPreanalysisThreads           () const { return m_preanalysisThreads; }
 #if HHI_HLM_USE_QPA
   Bool      getUsePerceptQPA                () const { return m_bUsePerceptQPA; }
   Bool      getUseANSNR                     () const { return m_bUseANSNR; }
@@ -1136,6 +1165,8 @@ public:
   Void         setInitialQP           ( Int QP )                     { m_RCInitialQP = QP;             }
   Bool         getForceIntraQP        ()                             { return m_RCForceIntraQP;        }
   Void         setForceIntraQP        ( Bool b )                     { m_RCForceIntraQP = b;           }
+  Int          getRCLookahead         () const                       { return m_RCLookahead;           }
+  Void         setRCLookahead         ( Int i )                      { m_RCLookahead = i;              }
 #if U0132_TARGET_BITS_SATURATION
   Bool         getCpbSaturationEnabled()                             { return m_RCCpbSaturationEnabled;}
   Void         setCpbSaturationEnabled( Bool b )                     { m_RCCpbSaturationEnabled = b;   }
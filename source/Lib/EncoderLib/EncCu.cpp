@@ -46,6 +46,7 @@
 #include "CommonLib/UnitTools.h"
 
 #include "CommonLib/dtrace_buffer.h"
+#include "CommonLib/Profiler.h"
 
 #include <stdio.h>
 #include <cmath>
@@ -57,6 +58,217 @@ using namespace std;
 //! \ingroup EncoderLib
 //! \{
 
+// ====================================================================================================================
+// Merge prediction cache
+// ====================================================================================================================
+
+Bool MergePredCache::Key::operator==( const Key& other ) const
+{
+  for( UInt l = 0; l < NUM_REF_PIC_LIST_01; l++ )
+  {
+    if( refIdx[l] != other.refIdx[l] || mv[l].hor != other.mv[l].hor || mv[l].ver != other.mv[l].ver || mv[l].highPrec != other.mv[l].highPrec )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t MergePredCache::KeyHash::operator()( const Key& key ) const
+{
+  size_t hash = 0;
+  for( UInt l = 0; l < NUM_REF_PIC_LIST_01; l++ )
+  {
+    hash = hash * 31 + size_t( key.refIdx[l] + 1 );
+    hash = hash * 1021 + size_t( UInt( key.mv[l].hor ) );
+    hash = hash * 1021 + size_t( UInt( key.mv[l].ver ) ) * 2 + ( key.mv[l].highPrec ? 1 : 0 );
+  }
+  return hash;
+}
+
+MergePredCache::MergePredCache()
+  : m_chromaFormat  ( CHROMA_420 )
+  , m_used          ( 0 )
+  , m_numLookups    ( 0 )
+  , m_numHitsSame   ( 0 )
+  , m_numHitsInside ( 0 )
+  , m_numStored     ( 0 )
+{
+}
+
+Void MergePredCache::create( const ChromaFormat chromaFormat, const size_t maxBytes )
+{
+  m_chromaFormat = chromaFormat;
+  m_samples.resize( maxBytes / sizeof( Pel ) );
+  m_used         = 0;
+}
+
+Void MergePredCache::destroy()
+{
+  m_samples.clear();
+  m_samples.shrink_to_fit();
+  m_entries.clear();
+  m_used = 0;
+}
+
+Void MergePredCache::reset()
+{
+  // the keys are motion vectors, which hardly repeat across CTUs, the entries only refer to the sample arena which is rewound
+  m_entries.clear();
+  m_used = 0;
+}
+
+Bool MergePredCache::xIsCacheable( const PredictionUnit& pu )
+{
+  return !pu.cu->LICFlag && !pu.cu->affine && !pu.frucMrgMode && pu.mergeType == MRG_TYPE_DEFAULT_N;
+}
+
+Bool MergePredCache::xIsSampleWise( const PredictionUnit& pu )
+{
+  const SPSNext& spsNext = pu.cs->sps->getSpsNext();
+
+  // BIO and DMVR derive their refinement from the whole block
+  if( pu.interDir == 3 && ( spsNext.getUseBIO() || spsNext.getUseDMVR() ) )
+  {
+    return false;
+  }
+
+  // the clipping of the vector depends on the block position
+  for( UInt l = 0; l < NUM_REF_PIC_LIST_01; l++ )
+  {
+    if( pu.refIdx[l] >= 0 )
+    {
+      Mv mv = pu.mv[l];
+      clipMv( mv, pu.cu->lumaPos(), *pu.cs->sps );
+
+      if( mv.hor != pu.mv[l].hor || mv.ver != pu.mv[l].ver )
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+Bool MergePredCache::get( PredictionUnit& pu, PelUnitBuf& predBuf, Key& key )
+{
+  if( !isEnabled() || !xIsCacheable( pu ) )
+  {
+    return false;
+  }
+
+  for( UInt l = 0; l < NUM_REF_PIC_LIST_01; l++ )
+  {
+    key.refIdx[l] = pu.refIdx[l];
+    key.mv    [l] = pu.refIdx[l] >= 0 ? pu.mv[l] : Mv();
+  }
+
+  m_numLookups++;
+
+  const auto bucket = m_entries.find( key );
+
+  if( bucket == m_entries.end() )
+  {
+    return false;
+  }
+
+  const Area& area       = pu.Y();
+  const Bool  sampleWise = xIsSampleWise( pu );
+
+  for( const Entry& entry : bucket->second )
+  {
+    const Bool same = entry.area == area;
+
+    if( !same && !( sampleWise && entry.sampleWise && entry.area.contains( area ) ) )
+    {
+      continue;
+    }
+
+    size_t offset = entry.offset;
+
+    for( UInt c = 0; c < getNumberValidComponents( m_chromaFormat ); c++ )
+    {
+      const ComponentID compID = ComponentID( c );
+      const UInt        scaleX = getComponentScaleX( compID, m_chromaFormat );
+      const UInt        scaleY = getComponentScaleY( compID, m_chromaFormat );
+      const Int         stride = entry.area.width >> scaleX;
+      const Pel*        src    = &m_samples[offset] + ( ( area.y - entry.area.y ) >> scaleY ) * stride + ( ( area.x - entry.area.x ) >> scaleX );
+
+      predBuf.bufs[c].copyFrom( CPelBuf( src, stride, area.width >> scaleX, area.height >> scaleY ) );
+
+      offset += stride * ( entry.area.height >> scaleY );
+    }
+
+    pu.mv[0] = entry.mv[0];
+    pu.mv[1] = entry.mv[1];
+
+    ( same ? m_numHitsSame : m_numHitsInside )++;
+
+    return true;
+  }
+
+  return false;
+}
+
+Void MergePredCache::add( const Key& key, const PredictionUnit& pu, const CPelUnitBuf& predBuf )
+{
+  if( !isEnabled() || !xIsCacheable( pu ) )
+  {
+    return;
+  }
+
+  const Area& area       = pu.Y();
+  const UInt  numComp    = getNumberValidComponents( m_chromaFormat );
+  size_t      numSamples = 0;
+
+  for( UInt c = 0; c < numComp; c++ )
+  {
+    numSamples += ( area.width >> getComponentScaleX( ComponentID( c ), m_chromaFormat ) ) * ( area.height >> getComponentScaleY( ComponentID( c ), m_chromaFormat ) );
+  }
+
+  if( m_used + numSamples > m_samples.size() )
+  {
+    // the arena is full until the next CTU
+    return;
+  }
+
+  Entry entry;
+  entry.area       = area;
+  entry.sampleWise = xIsSampleWise( pu );
+  entry.mv[0]      = pu.mv[0];
+  entry.mv[1]      = pu.mv[1];
+  entry.offset     = m_used;
+
+  for( UInt c = 0; c < numComp; c++ )
+  {
+    const ComponentID compID = ComponentID( c );
+    const UInt        width  = area.width  >> getComponentScaleX( compID, m_chromaFormat );
+    const UInt        height = area.height >> getComponentScaleY( compID, m_chromaFormat );
+
+    PelBuf( &m_samples[m_used], width, width, height ).copyFrom( predBuf.bufs[c] );
+
+    m_used += width * height;
+  }
+
+  m_entries[key].push_back( entry );
+  m_numStored++;
+}
+
+Void MergePredCache::printStats() const
+{
+  if( !isEnabled() || m_numLookups == 0 )
+  {
+    return;
+  }
+
+  const UInt64 numHits = m_numHitsSame + m_numHitsInside;
+
+  msg( VERBOSE, "\nMerge prediction cache: %llu lookups, %llu hits (%.2f%%), %llu of same block, %llu inside a larger block, %llu predictions stored\n",
+       ( unsigned long long ) m_numLookups, ( unsigned long long ) numHits, 100.0 * numHits / m_numLookups,
+       ( unsigned long long ) m_numHitsSame, ( unsigned long long ) m_numHitsInside, ( unsigned long long ) m_numStored );
+}
+
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -177,6 +389,11 @@ void EncCu::create( EncCfg* encCfg )
     m_acMergeBuffer[ui].create( chromaFormat, Area(  0, 0, uiMaxWidth, uiMaxHeight ) );
   }
 
+  if( encCfg->getMergePredCache() > 0 )
+  {
+    m_mergePredCache.create( chromaFormat, size_t( encCfg->getMergePredCache() ) << 10 );
+  }
+
   m_CtxBuffer.resize( maxDepth );
   m_CurrCtx = 0;
 }
@@ -260,6 +477,9 @@ void EncCu::destroy()
   {
     m_acMergeBuffer[ui].destroy();
   }
+
+  m_mergePredCache.printStats();
+  m_mergePredCache.destroy();
 }
 
 
@@ -295,7 +515,10 @@ void EncCu::init( EncLib* pcEncLib, const SPS& sps )
 
 void EncCu::compressCtu( CodingStructure& cs, const UnitArea& area, unsigned ctuRsAddr )
 {
+  PROFILE_SCOPE( PROF_ENC_CTU );
+
   m_modeCtrl->initCTUEncoding( *cs.slice );
+  m_mergePredCache.reset();
 
   // init the partitioning manager
   Partitioner *partitioner = PartitionerFactory::get( *cs.slice );
@@ -553,6 +776,8 @@ void EncCu::xCompressCU( CodingStructure *&tempCS, CodingStructure *&bestCS, Par
 
     if( currTestMode.type == ETM_INTER_ME )
     {
+      PROFILE_SCOPE_SIZE( PROF_ENC_INTER_ME, tempCS->area.lwidth(), tempCS->area.lheight() );
+
       bool tryObmc = true;
 
       if( ( currTestMode.opts & ETO_IMV ) != 0 )
@@ -571,22 +796,27 @@ void EncCu::xCompressCU( CodingStructure *&tempCS, CodingStructure *&bestCS, Par
     }
     else if( currTestMode.type == ETM_AFFINE )
     {
+      PROFILE_SCOPE_SIZE( PROF_ENC_AFFINE, tempCS->area.lwidth(), tempCS->area.lheight() );
       xCheckRDCostAffineMerge2Nx2N( tempCS, bestCS, partitioner, currTestMode );
     }
     else if( currTestMode.type == ETM_MERGE_SKIP )
     {
+      PROFILE_SCOPE_SIZE( PROF_ENC_MERGE_SKIP, tempCS->area.lwidth(), tempCS->area.lheight() );
       xCheckRDCostMerge2Nx2N( tempCS, bestCS, partitioner, currTestMode );
     }
     else if( currTestMode.type == ETM_MERGE_FRUC )
     {
+      PROFILE_SCOPE_SIZE( PROF_ENC_MERGE_FRUC, tempCS->area.lwidth(), tempCS->area.lheight() );
       xCheckRDCostMerge2Nx2NFRUC( tempCS, bestCS, partitioner, currTestMode );
     }
     else if( currTestMode.type == ETM_INTRA )
     {
+      PROFILE_SCOPE_SIZE( PROF_ENC_INTRA, tempCS->area.lwidth(), tempCS->area.lheight() );
       xCheckRDCostIntra( tempCS, bestCS, partitioner, currTestMode );
     }
     else if( currTestMode.type == ETM_IPCM )
     {
+      PROFILE_SCOPE_SIZE( PROF_ENC_IPCM, tempCS->area.lwidth(), tempCS->area.lheight() );
       xCheckIntraPCM( tempCS, bestCS, partitioner, currTestMode );
     }
     else if( isModeSplit( currTestMode ) )
@@ -1223,9 +1453,7 @@ void EncCu::xCheckRDCostMerge2Nx2N( CodingStructure *&tempCS, CodingStructure *&
 
         distParam.cur = acMergeBuffer[uiMergeCand].Y();
 
-        pu.mvRefine = true;
-        m_pcInterSearch->motionCompensation( pu,  acMergeBuffer[uiMergeCand] );
-        pu.mvRefine = false;
+        xMergeMotionCompensation( pu, acMergeBuffer[uiMergeCand] );
 
         m_pcInterSearch->subBlockOBMC      ( pu, &acMergeBuffer[uiMergeCand], false );
 /*
@@ -1323,9 +1551,8 @@ void EncCu::xCheckRDCostMerge2Nx2N( CodingStructure *&tempCS, CodingStructure *&
             }
             else
             {
-              pu.mvRefine = true;
-              m_pcInterSearch->motionCompensation( pu );
-              pu.mvRefine = false;
+              PelUnitBuf predBuf = tempCS->getPredBuf( pu );
+              xMergeMotionCompensation( pu, predBuf );
 
               m_pcInterSearch->subBlockOBMC      ( pu );
 
@@ -1423,6 +1650,22 @@ void EncCu::xCheckRDCostMerge2Nx2N( CodingStructure *&tempCS, CodingStructure *&
   }
 }
 
+void EncCu::xMergeMotionCompensation( PredictionUnit &pu, PelUnitBuf &predBuf )
+{
+  MergePredCache::Key key;
+
+  if( m_mergePredCache.get( pu, predBuf, key ) )
+  {
+    return;
+  }
+
+  pu.mvRefine = true;
+  m_pcInterSearch->motionCompensation( pu, predBuf );
+  pu.mvRefine = false;
+
+  m_mergePredCache.add( key, pu, predBuf );
+}
+
 void EncCu::xCheckRDCostAffineMerge2Nx2N( CodingStructure *&tempCS, CodingStructure *&bestCS, Partitioner &partitioner, const EncTestMode& encTestMode )
 {
   if( m_modeCtrl->getFastDeltaQp() )
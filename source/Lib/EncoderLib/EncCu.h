@@ -51,6 +51,9 @@
 #include "InterSearch.h"
 #include "RateCtrl.h"
 #include "EncModeCtrl.h"
+
+#include <unordered_map>
+
 //! \ingroup EncoderLib
 //! \{
 
@@ -62,6 +65,63 @@ class EncSlice;
 // Class definition
 // ====================================================================================================================
 
+/// Motion compensated predictions of merge candidates within a CTU. A prediction is reused when the same motion is
+/// tested again for the same block or, if it is computed sample by sample, for a block inside a cached one.
+/// OBMC is applied on top of the cached prediction, since it depends on the neighbouring CUs.
+class MergePredCache
+{
+public:
+  struct Key
+  {
+    Int   refIdx[NUM_REF_PIC_LIST_01];
+    Mv    mv    [NUM_REF_PIC_LIST_01];
+
+    Bool operator==( const Key& other ) const;
+  };
+
+private:
+  struct KeyHash
+  {
+    size_t operator()( const Key& key ) const;
+  };
+
+  struct Entry
+  {
+    Area    area;                         ///< luma area of the prediction
+    Bool    sampleWise;                   ///< prediction does not depend on the block extent
+    Mv      mv[NUM_REF_PIC_LIST_01];      ///< motion after decoder side refinement
+    size_t  offset;                       ///< position of the samples in m_samples
+  };
+
+  ChromaFormat                                           m_chromaFormat;
+  std::vector<Pel>                                       m_samples;
+  size_t                                                 m_used;
+  std::unordered_map<Key, std::vector<Entry>, KeyHash>   m_entries;
+
+  UInt64 m_numLookups;
+  UInt64 m_numHitsSame;
+  UInt64 m_numHitsInside;
+  UInt64 m_numStored;
+
+  static Bool xIsCacheable  ( const PredictionUnit& pu );
+  static Bool xIsSampleWise ( const PredictionUnit& pu );
+
+public:
+  MergePredCache();
+
+  Void create     ( const ChromaFormat chromaFormat, const size_t maxBytes );
+  Void destroy    ();
+  Void reset      ();
+  Bool isEnabled  () const { return !m_samples.empty(); }
+
+  /// copy a cached prediction of the PU to predBuf and restore its refined motion, returns the key for add() on a miss
+  Bool get        ( PredictionUnit& pu, PelUnitBuf& predBuf, Key& key );
+  Void add        ( const Key& key, const PredictionUnit& pu, const CPelUnitBuf& predBuf );
+
+  Void printStats () const;
+};
+
+
 /// CU encoder class
 class EncCu
 {
@@ -102,6 +162,7 @@ private:
   EncModeCtrl          *m_modeCtrl;
 
   PelStorage            m_acMergeBuffer[MRG_MAX_NUM_CANDS];
+  MergePredCache        m_mergePredCache;
 
   MotionInfo            m_SubPuMiBuf   [( MAX_CU_SIZE * MAX_CU_SIZE ) >> ( MIN_CU_LOG2 << 1 )];
   MotionInfo            m_SubPuExtMiBuf[( MAX_CU_SIZE * MAX_CU_SIZE ) >> ( MIN_CU_LOG2 << 1 )];
@@ -155,6 +216,8 @@ protected:
   void xCheckRDCostMerge2Nx2N ( CodingStructure *&tempCS, CodingStructure *&bestCS, Partitioner &pm, const EncTestMode& encTestMode );
 
   void xCheckRDCostMerge2Nx2NFRUC( CodingStructure *&tempCS, CodingStructure *&bestCS, Partitioner &partitioner, const EncTestMode& encTestMode );
+
+  void xMergeMotionCompensation  ( PredictionUnit &pu, PelUnitBuf &predBuf );
 };
 
 //! \}
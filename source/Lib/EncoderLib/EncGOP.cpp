@@ -42,6 +42,7 @@
 #include "EncLib.h"
 #include "EncGOP.h"
 #include "Analyze.h"
+#include "QualityMetrics.h"
 #include "libmd5/MD5.h"
 #include "CommonLib/SEI.h"
 #include "CommonLib/NAL.h"
@@ -50,6 +51,8 @@
 #include <time.h>
 #include <math.h>
 #include <deque>
+#include <thread>
+#include <atomic>
 
 #include "CommonLib/UnitTools.h"
 #include "CommonLib/dtrace_codingstruct.h"
@@ -58,6 +61,8 @@
 
 #define ENCODE_SUB_SET 0
 
+static const UInt MIN_METRICS_WORKER_SAMPLES = 352 * 288;   ///< pictures with fewer luma samples get their structural metrics computed in place
+
 using namespace std;
 
 //! \ingroup EncoderLib
@@ -288,11 +293,14 @@ EncGOP::EncGOP()
   m_bufferingPeriodSEIPresentInAU = false;
   m_associatedIRAPType  = NAL_UNIT_CODED_SLICE_IDR_N_LP;
   m_associatedIRAPPOC   = 0;
-#if W0038_DB_OPT
-  m_pcDeblockingTempPicYuv = NULL;
-#endif
 
   m_bInitAMaxBT         = true;
+#if W0038_DB_OPT
+  m_deblockingJobId     = 0;
+  m_deblockingNumBusy   = 0;
+  m_deblockingStop      = false;
+#endif
+  m_metricsStop         = false;
 }
 
 EncGOP::~EncGOP()
@@ -315,13 +323,37 @@ Void  EncGOP::create()
 Void  EncGOP::destroy()
 {
 #if W0038_DB_OPT
-  if (m_pcDeblockingTempPicYuv)
   {
-    m_pcDeblockingTempPicYuv->destroy();
-    delete m_pcDeblockingTempPicYuv;
-    m_pcDeblockingTempPicYuv = NULL;
+    std::unique_lock<std::mutex> lock( m_deblockingMutex );
+    m_deblockingStop = true;
+  }
+  m_deblockingJobCond.notify_all();
+  for( auto& worker : m_deblockingWorkers )
+  {
+    worker.join();
   }
+  m_deblockingWorkers.clear();
+  m_deblockingStop  = false;
+  m_deblockingJobId = 0;
+
+  for( auto& scratch : m_deblockingScratch )
+  {
+    scratch->destroy();
+    delete scratch;
+  }
+  m_deblockingScratch.clear();
 #endif
+
+  if( m_metricsWorker.joinable() )
+  {
+    {
+      std::unique_lock<std::mutex> lock( m_metricsMutex );
+      m_metricsStop = true;
+    }
+    m_metricsCond.notify_all();
+    m_metricsWorker.join();
+    m_metricsStop = false;
+  }
 }
 
 Void EncGOP::init ( EncLib* pcEncLib )
@@ -1434,6 +1466,10 @@ Void EncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, PicList& rcListPic,
   AccessUnit::iterator  itLocationToPushSliceHeaderNALU; // used to store location where NALU containing slice header is to be inserted
 
   xInitGOP( iPOCLast, iNumPicRcvd, isField );
+  if( !isField && m_pcEncLib->getLookahead()->isActive() )
+  {
+    xDetectSceneCut( iPOCLast, iNumPicRcvd );
+  }
 
   m_iNumPicCoded = 0;
   SEIMessages leadingSeiMessages;
@@ -1507,6 +1543,7 @@ Void EncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, PicList& rcListPic,
     accessUnitsInGOP.push_back(AccessUnit());
     AccessUnit& accessUnit = accessUnitsInGOP.back();
     xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pocCurr, isField );
+    m_pcEncLib->getPreanalysis()->waitPicture( pcPic );
 
     pcPic->createTempBuffers( pcPic->cs->pps->pcv->maxCUWidth );
     pcPic->cs->createCoeffs();
@@ -1882,6 +1919,16 @@ Void EncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, PicList& rcListPic,
         frameLevel = 0;
       }
       m_pcRateCtrl->initRCPic( frameLevel );
+
+      if ( m_pcCfg->getRCLookahead() > 0 && m_pcCfg->getLCULevelRC() && m_pcEncLib->getLookahead()->isActive() )
+      {
+        // CTUs referenced by many of the following pictures get a lower QP
+        std::vector<Double> blockQPOffsets;
+        std::vector<std::pair<Int, std::vector<Int> > > codedAfter;
+        xGetPropagationPictures( iPOCLast, iNumPicRcvd, iGOPid, pocCurr, codedAfter );
+        m_pcEncLib->getLookahead()->getPropagationQpOffsets( pocCurr, codedAfter, g_RCPropagationStrength, blockQPOffsets );
+        m_pcRateCtrl->getRCPic()->setLCUQPOffsets( blockQPOffsets, EncLookahead::BLK_SIZE );
+      }
       estimatedBits = m_pcRateCtrl->getRCPic()->getTargetBits();
 
 #if U0132_TARGET_BITS_SATURATION
@@ -2368,6 +2415,7 @@ Void EncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, PicList& rcListPic,
     pcPic->destroyTempBuffers();
     pcPic->cs->destroyCoeffs();
     pcPic->cs->releaseIntermediateData();
+    pcPic->cs->compactMotion();
   } // iGOPid-loop
 
   delete pcBitstreamRedirect;
@@ -2393,6 +2441,7 @@ Void EncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool pri
   m_gcAnalyzeP.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
   m_gcAnalyzeB.setFrmRate( m_pcCfg->getFrameRate()*rateMultiplier / (Double)m_pcCfg->getTemporalSubsampleRatio());
   const ChromaFormat chFmt = m_pcCfg->getChromaFormatIdc();
+  const Bool printSSIM = m_pcCfg->getPrintSSIM();
 
   //-- all
   msg( INFO, "\n" );
@@ -2402,25 +2451,41 @@ Void EncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool pri
 #else
   m_gcAnalyzeAll.printOut('a', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
 #endif
+  if (printSSIM)
+  {
+    m_gcAnalyzeAll.printSSIM('a', chFmt);
+  }
   msg( DETAILS,"\n\nI Slices--------------------------------------------------------\n" );
   m_gcAnalyzeI.printOut('i', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+  if (printSSIM)
+  {
+    m_gcAnalyzeI.printSSIM('i', chFmt);
+  }
 
   msg( DETAILS,"\n\nP Slices--------------------------------------------------------\n" );
   m_gcAnalyzeP.printOut('p', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+  if (printSSIM)
+  {
+    m_gcAnalyzeP.printSSIM('p', chFmt);
+  }
 
   msg( DETAILS,"\n\nB Slices--------------------------------------------------------\n" );
   m_gcAnalyzeB.printOut('b', chFmt, printMSEBasedSNR, printSequenceMSE, bitDepths);
+  if (printSSIM)
+  {
+    m_gcAnalyzeB.printSSIM('b', chFmt);
+  }
 
   if (!m_pcCfg->getSummaryOutFilename().empty())
   {
-    m_gcAnalyzeAll.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryOutFilename());
+    m_gcAnalyzeAll.printSummary(chFmt, printSequenceMSE, printSSIM, bitDepths, m_pcCfg->getSummaryOutFilename());
   }
 
   if (!m_pcCfg->getSummaryPicFilenameBase().empty())
   {
-    m_gcAnalyzeI.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"I.txt");
-    m_gcAnalyzeP.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"P.txt");
-    m_gcAnalyzeB.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"B.txt");
+    m_gcAnalyzeI.printSummary(chFmt, printSequenceMSE, printSSIM, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"I.txt");
+    m_gcAnalyzeP.printSummary(chFmt, printSequenceMSE, printSSIM, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"P.txt");
+    m_gcAnalyzeB.printSummary(chFmt, printSequenceMSE, printSSIM, bitDepths, m_pcCfg->getSummaryPicFilenameBase()+"B.txt");
   }
 
   if(isField)
@@ -2438,36 +2503,13 @@ Void EncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool pri
 #endif
     if (!m_pcCfg->getSummaryOutFilename().empty())
     {
-      m_gcAnalyzeAll_in.printSummary(chFmt, printSequenceMSE, bitDepths, m_pcCfg->getSummaryOutFilename());
+      m_gcAnalyzeAll_in.printSummary(chFmt, printSequenceMSE, false, bitDepths, m_pcCfg->getSummaryOutFilename());
     }
   }
 
   msg( DETAILS,"\nRVM: %.3lf\n", xCalculateRVM() );
 }
 
-#if W0038_DB_OPT
-UInt64 EncGOP::preLoopFilterPicAndCalcDist( Picture* pcPic )
-{
-  CodingStructure& cs = *pcPic->cs;
-  m_pcLoopFilter->loopFilterPic( cs );
-
-  const CPelUnitBuf picOrg = pcPic->getRecoBuf();
-  const CPelUnitBuf picRec = cs.getRecoBuf();
-
-  UInt64 uiDist = 0;
-  for( UInt comp = 0; comp < (UInt)picRec.bufs.size(); comp++)
-  {
-    const ComponentID compID = ComponentID(comp);
-    const UInt rshift  = 2 * DISTORTION_PRECISION_ADJUSTMENT(cs.sps->getBitDepth(toChannelType(compID)) - 8);
-#if HHI_HLM_USE_QPA
-    CHECK( rshift >= 8, "shifts greater than 7 are not supported." );
-#endif
-    uiDist += xFindDistortionPlane( picOrg.get(compID), picRec.get(compID), rshift );
-  }
-  return uiDist;
-}
-#endif
-
 // ====================================================================================================================
 // Protected member functions
 // ====================================================================================================================
@@ -2490,6 +2532,102 @@ Void EncGOP::xInitGOP( Int iPOCLast, Int iNumPicRcvd, Bool isField )
   return;
 }
 
+/** Code the key picture of the GOP as intra picture when the lookahead found a scene cut in the GOP
+ * \param iPOCLast    POC of the last received picture
+ * \param iNumPicRcvd number of pictures of the GOP
+ *
+ * The intra picture can only be placed at the key picture of the GOP structure, i.e. the scene cut is moved to the
+ * end of the GOP.
+ */
+Void EncGOP::xDetectSceneCut( Int iPOCLast, Int iNumPicRcvd )
+{
+  EncLookahead* pcLookahead = m_pcEncLib->getLookahead();
+  const Int     iFirstPOC   = iPOCLast - iNumPicRcvd + 1;
+  const Int     iKeyPOC     = iPOCLast - iNumPicRcvd + m_iGopSize;
+
+  pcLookahead->release( iFirstPOC );
+  m_sceneCutPOCs.erase( m_sceneCutPOCs.begin(), m_sceneCutPOCs.lower_bound( iFirstPOC ) );
+
+  if( iPOCLast == 0 || iKeyPOC > iPOCLast || iKeyPOC % m_pcCfg->getIntraPeriod() == 0 )
+  {
+    return;
+  }
+
+  for( Int poc = iFirstPOC; poc <= iKeyPOC; poc++ )
+  {
+    if( pcLookahead->isSceneCut( poc ) )
+    {
+      msg( DETAILS, "Scene cut at POC %d, coding POC %d as intra picture\n", poc, iKeyPOC );
+      m_sceneCutPOCs.insert( iKeyPOC );
+      return;
+    }
+  }
+}
+
+
+/** Pictures coded after the current one up to LookaheadFrames (at least a GOP) ahead of it, in coding order, with the
+ *  nearest past and future reference of their GOP entry, for the propagation of the lookahead costs
+ * \param iPOCLast    last POC of the GOP
+ * \param iNumPicRcvd number of pictures of the GOP
+ * \param iGOPid      GOP entry of the current picture
+ * \param pocCurr     POC of the current picture
+ * \param codedAfter  returns the POCs and their references, intra pictures have none
+ */
+Void EncGOP::xGetPropagationPictures( Int iPOCLast, Int iNumPicRcvd, Int iGOPid, Int pocCurr, std::vector<std::pair<Int, std::vector<Int> > >& codedAfter )
+{
+  const Int lastPOC = std::min( pocCurr + std::max( m_pcCfg->getLookaheadFrames(), m_iGopSize ), m_pcEncLib->getLookahead()->getNumPicsAdded() - 1 );
+
+  codedAfter.clear();
+
+  // the first picture is coded alone, the next GOP starts after it
+  Int iBase  = iPOCLast == 0 ? 0 : iPOCLast - iNumPicRcvd;
+  Int iEntry = iPOCLast == 0 ? 0 : iGOPid + 1;
+
+  for( ; iBase < lastPOC; iBase += m_iGopSize, iEntry = 0 )
+  {
+    for( ; iEntry < m_iGopSize; iEntry++ )
+    {
+      const GOPEntry& rEntry = m_pcCfg->getGOPEntry( iEntry );
+      const Int       poc    = iBase + rEntry.m_POC;
+
+      if( poc > lastPOC )
+      {
+        continue;
+      }
+
+      std::vector<Int> refs;
+      const Bool bIntra = ( m_pcCfg->getIntraPeriod() > 0 && poc % m_pcCfg->getIntraPeriod() == 0 ) || m_sceneCutPOCs.count( poc ) > 0;
+
+      if( !bIntra )
+      {
+        Int iPast   = -1;
+        Int iFuture = MAX_INT;
+        for( Int i = 0; i < rEntry.m_numRefPics; i++ )
+        {
+          const Int refPoc = poc + rEntry.m_referencePics[i];
+          if( rEntry.m_referencePics[i] < 0 && refPoc >= 0 )
+          {
+            iPast = std::max( iPast, refPoc );
+          }
+          else if( rEntry.m_referencePics[i] > 0 )
+          {
+            iFuture = std::min( iFuture, refPoc );
+          }
+        }
+        if( iPast >= 0 )
+        {
+          refs.push_back( iPast );
+        }
+        if( iFuture < MAX_INT )
+        {
+          refs.push_back( iFuture );
+        }
+      }
+
+      codedAfter.push_back( std::make_pair( poc, refs ) );
+    }
+  }
+}
 
 Void EncGOP::xGetBuffer( PicList&      rcListPic,
                          std::list<PelUnitBuf*>&    rcListPicYuvRecOut,
@@ -2617,18 +2755,7 @@ UInt64 EncGOP::xFindDistortionPlane(const CPelBuf& pic0, const CPelBuf& pic1, co
 
       if (B < 4) // image is too small to use ANSNR, resort to traditional PSNR
       {
-        uiTotalDiff = 0;
-        for (y = 0; y < H; y++)
-        {
-          for (x = 0; x < W; x++)
-          {
-            register Int64 iDiff = (Int64)pSrc0[x] - (Int64)pSrc1[x];
-            uiTotalDiff += UInt64(iDiff * iDiff);
-          }
-          pSrc0 += pic0.stride;
-          pSrc1 += pic1.stride;
-        }
-        return uiTotalDiff;
+        return calcPlaneSSE(pic0, pic1);
       }
 
       double wmse = 0.0, sumAct = 0.0, numAct = 0.0; // activity normalized SNR
@@ -2660,17 +2787,7 @@ UInt64 EncGOP::xFindDistortionPlane(const CPelBuf& pic0, const CPelBuf& pic1, co
   }
   else
   {
-    uiTotalDiff = 0;
-    for (Int y = 0; y < pic0.height; y++)
-    {
-      for (Int x = 0; x < pic0.width; x++)
-      {
-        Intermediate_Int iTemp = pSrc0[x] - pSrc1[x];
-        uiTotalDiff += UInt64(iTemp * iTemp);
-      }
-      pSrc0 += pic0.stride;
-      pSrc1 += pic1.stride;
-    }
+    uiTotalDiff = calcPlaneSSE(pic0, pic1);
   }
 
   return uiTotalDiff;
@@ -2775,8 +2892,18 @@ Void EncGOP::xCalculateAddPSNR( Picture* pcPic, PelUnitBuf cPicD, const AccessUn
   const ChromaFormat formatD = pic.chromaFormat;
   const ChromaFormat format = sps.getChromaFormatIdc();
 
+  // the structural metrics of all planes are computed by one worker while the PSNR is computed, small pictures are measured in place
+  const Bool printSSIM = m_pcCfg->getPrintSSIM();
+  const Bool useWorker = printSSIM && std::thread::hardware_concurrency() > 1 && pic.Y().area() >= MIN_METRICS_WORKER_SAMPLES;
+  const Int  numComp   = ::getNumberValidComponents(formatD);
+  Double  dSSIM  [MAX_NUM_COMPONENT] = {0, 0, 0};
+  Double  dMSSSIM[MAX_NUM_COMPONENT] = {0, 0, 0};
+  CPelBuf recPB  [MAX_NUM_COMPONENT];
+  CPelBuf orgPB  [MAX_NUM_COMPONENT];
+  UInt    bitDepth[MAX_NUM_COMPONENT];
+
   bool bPicIsField = pcPic->fieldPic;
-  for(Int comp=0; comp<::getNumberValidComponents(formatD); comp++)
+  for(Int comp=0; comp<numComp; comp++)
   {
     const ComponentID compID = ComponentID(comp);
     const CPelBuf&    p = picC.get(compID);
@@ -2789,15 +2916,46 @@ Void EncGOP::xCalculateAddPSNR( Picture* pcPic, PelUnitBuf cPicD, const AccessUn
     const UInt   height = p.height - (m_pcEncLib->getPad(1) >> (!!bPicIsField+::getComponentScaleY(compID,format)));
 
     // create new buffers with correct dimensions
-    const CPelBuf recPB(p.bufAt(0, 0), p.stride, width, height);
-    const CPelBuf orgPB(o.bufAt(0, 0), o.stride, width, height);
-    const UInt    bitDepth = sps.getBitDepth(toChannelType(compID));
+    recPB[comp]    = CPelBuf(p.bufAt(0, 0), p.stride, width, height);
+    orgPB[comp]    = CPelBuf(o.bufAt(0, 0), o.stride, width, height);
+    bitDepth[comp] = sps.getBitDepth(toChannelType(compID));
+  }
+
+  auto calcStructuralMetrics = [&]()
+  {
+    for (Int comp = 0; comp < numComp; comp++)
+    {
+      dSSIM  [comp] = calcPlaneSSIM  (orgPB[comp], recPB[comp], bitDepth[comp]);
+      dMSSSIM[comp] = calcPlaneMSSSIM(orgPB[comp], recPB[comp], bitDepth[comp]);
+    }
+  };
+
+  if (useWorker)
+  {
+    std::unique_lock<std::mutex> lock(m_metricsMutex);
+    if (!m_metricsWorker.joinable())
+    {
+      m_metricsWorker = std::thread(&EncGOP::xMetricsWorker, this);
+    }
+    m_metricsJob = calcStructuralMetrics;
+    m_metricsCond.notify_all();
+  }
+  else if (printSSIM)
+  {
+    calcStructuralMetrics();
+  }
+
+  for(Int comp=0; comp<numComp; comp++)
+  {
+    const ComponentID compID = ComponentID(comp);
+    const UInt   width  = recPB[comp].width;
+    const UInt   height = recPB[comp].height;
 #if HHI_HLM_USE_QPA
-    const UInt64 uiSSDtemp = xFindDistortionPlane(recPB, orgPB, useANSNR ? bitDepth : 0, ::getComponentScaleX(compID, format));
-    const UInt maxval = /*useANSNR ? (1 << bitDepth) - 1 :*/ 255 << (bitDepth - 8); // fix with ANSNR: 1023 (4095) instead of 1020 (4080) for bit-depth 10 (12)
+    const UInt64 uiSSDtemp = xFindDistortionPlane(recPB[comp], orgPB[comp], useANSNR ? bitDepth[comp] : 0, ::getComponentScaleX(compID, format));
+    const UInt maxval = /*useANSNR ? (1 << bitDepth) - 1 :*/ 255 << (bitDepth[comp] - 8); // fix with ANSNR: 1023 (4095) instead of 1020 (4080) for bit-depth 10 (12)
 #else
-    const UInt64 uiSSDtemp = xFindDistortionPlane(recPB, orgPB, 0);
-    const UInt maxval = 255 << (bitDepth - 8);
+    const UInt64 uiSSDtemp = xFindDistortionPlane(recPB[comp], orgPB[comp], 0);
+    const UInt maxval = 255 << (bitDepth[comp] - 8);
 #endif
     const UInt size   = width * height;
     const Double fRefValue = (Double)maxval * maxval * size;
@@ -2805,6 +2963,12 @@ Void EncGOP::xCalculateAddPSNR( Picture* pcPic, PelUnitBuf cPicD, const AccessUn
     MSEyuvframe[comp] = (Double)uiSSDtemp / size;
   }
 
+  if (useWorker)
+  {
+    std::unique_lock<std::mutex> lock(m_metricsMutex);
+    m_metricsCond.wait(lock, [&]() { return !m_metricsJob; });
+  }
+
 
   /* calculate the size of the access unit, excluding:
    *  - any AnnexB contributions (start_code_prefix, zero_byte, etc.,)
@@ -2828,21 +2992,21 @@ Void EncGOP::xCalculateAddPSNR( Picture* pcPic, PelUnitBuf cPicD, const AccessUn
   m_vRVM_RP.push_back( uibits );
 
   //===== add PSNR =====
-  m_gcAnalyzeAll.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+  m_gcAnalyzeAll.addResult (dPSNR, (Double)uibits, MSEyuvframe, dSSIM, dMSSSIM);
   const Slice*  pcSlice = pcPic->slices[0];
   if (pcSlice->isIntra())
   {
-    m_gcAnalyzeI.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    m_gcAnalyzeI.addResult (dPSNR, (Double)uibits, MSEyuvframe, dSSIM, dMSSSIM);
     *PSNR_Y = dPSNR[COMPONENT_Y];
   }
   if (pcSlice->isInterP())
   {
-    m_gcAnalyzeP.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    m_gcAnalyzeP.addResult (dPSNR, (Double)uibits, MSEyuvframe, dSSIM, dMSSSIM);
     *PSNR_Y = dPSNR[COMPONENT_Y];
   }
   if (pcSlice->isInterB())
   {
-    m_gcAnalyzeB.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    m_gcAnalyzeB.addResult (dPSNR, (Double)uibits, MSEyuvframe, dSSIM, dMSSSIM);
     *PSNR_Y = dPSNR[COMPONENT_Y];
   }
 
@@ -2866,6 +3030,11 @@ Void EncGOP::xCalculateAddPSNR( Picture* pcPic, PelUnitBuf cPicD, const AccessUn
     {
       msg( NOTICE, " [Y MSE %6.4lf  U MSE %6.4lf  V MSE %6.4lf]", MSEyuvframe[COMPONENT_Y], MSEyuvframe[COMPONENT_Cb], MSEyuvframe[COMPONENT_Cr] );
     }
+    if( printSSIM )
+    {
+      msg( NOTICE, " [Y SSIM %6.4lf  U SSIM %6.4lf  V SSIM %6.4lf]", dSSIM[COMPONENT_Y], dSSIM[COMPONENT_Cb], dSSIM[COMPONENT_Cr] );
+      msg( NOTICE, " [Y MS-SSIM %6.4lf  U MS-SSIM %6.4lf  V MS-SSIM %6.4lf]", dMSSSIM[COMPONENT_Y], dMSSSIM[COMPONENT_Cb], dMSSSIM[COMPONENT_Cr] );
+    }
     msg( NOTICE, " [ET %5.0f ]", dEncTime );
 
     // msg( SOME, " [WP %d]", pcSlice->getUseWeightedPrediction());
@@ -2887,6 +3056,29 @@ Void EncGOP::xCalculateAddPSNR( Picture* pcPic, PelUnitBuf cPicD, const AccessUn
   }
 }
 
+/** worker of xCalculateAddPSNR, computes the structural metrics of a picture while the caller computes its PSNR
+ */
+Void EncGOP::xMetricsWorker()
+{
+  std::unique_lock<std::mutex> lock( m_metricsMutex );
+
+  while( true )
+  {
+    m_metricsCond.wait( lock, [&]() { return m_metricsStop || m_metricsJob; } );
+    if( m_metricsStop )
+    {
+      return;
+    }
+
+    lock.unlock();
+    m_metricsJob();
+    lock.lock();
+
+    m_metricsJob = nullptr;
+    m_metricsCond.notify_all();
+  }
+}
+
 Void EncGOP::xCalculateInterlacedAddPSNR( Picture* pcPicOrgFirstField, Picture* pcPicOrgSecondField,
                                           PelUnitBuf cPicRecFirstField, PelUnitBuf cPicRecSecondField,
                                           const InputColourSpaceConversion conversion, const Bool printFrameMSE, Double* PSNR_Y )
@@ -2992,7 +3184,7 @@ NalUnitType EncGOP::getNalUnitType(Int pocCurr, Int lastIDR, Bool isField)
     return NAL_UNIT_CODED_SLICE_TRAIL_R;
   }
 
-  if(m_pcCfg->getDecodingRefreshType() != 3 && (pocCurr - isField) % m_pcCfg->getIntraPeriod() == 0)
+  if(m_pcCfg->getDecodingRefreshType() != 3 && ((pocCurr - isField) % m_pcCfg->getIntraPeriod() == 0 || isSceneCutIntra(pocCurr)))
   {
     if (m_pcCfg->getDecodingRefreshType() == 1)
     {
@@ -3336,6 +3528,108 @@ Void EncGOP::applyDeblockingFilterMetric( Picture* pcPic, UInt uiNumSlices )
 }
 
 #if W0038_DB_OPT
+/**
+ - distortion of the deblocked picture for several pairs of beta and tc offsets
+ .
+ Only the rows of samples around the edge segments are restored from the reconstruction, filtered and measured, the
+ distortion of the other samples does not depend on the offsets. The returned distortions thus differ from the full
+ picture distortion by a constant. The offset pairs are evaluated concurrently, each thread in its own buffer.
+ */
+Void EncGOP::xEvalDeblockingFilterParams( Picture* pcPic, const std::vector<Area> ( &rows )[MAX_NUM_COMPONENT], const std::vector<std::pair<Int, Int> >& offsets, UInt64* dists )
+{
+  const CodingStructure& cs       = *pcPic->cs;
+  const CPelUnitBuf      picRec   = pcPic->getRecoBuf();
+  const CPelUnitBuf      picOrg   = pcPic->getOrigBuf();
+  const UInt             numComp  = (UInt) picRec.bufs.size();
+  std::atomic<size_t>    nextIdx  ( 0 );
+
+  auto evalOffsets = [&]( PelStorage* scratch )
+  {
+    for( size_t idx = nextIdx++; idx < offsets.size(); idx = nextIdx++ )
+    {
+      for( UInt comp = 0; comp < numComp; comp++ )
+      {
+        const ComponentID compID = ComponentID( comp );
+        for( const auto& row : rows[comp] )
+        {
+          memcpy( scratch->get( compID ).bufAt( row ), picRec.get( compID ).bufAt( row ), row.width * sizeof( Pel ) );
+        }
+      }
+
+      m_pcLoopFilter->filterEdgeSegments( cs, m_deblockingEdgeSegments, *scratch, offsets[idx].first, offsets[idx].second );
+
+      UInt64 dist = 0;
+      for( UInt comp = 0; comp < numComp; comp++ )
+      {
+        const ComponentID compID = ComponentID( comp );
+        const UInt        rshift = 2 * DISTORTION_PRECISION_ADJUSTMENT( cs.sps->getBitDepth( toChannelType( compID ) ) - 8 );
+#if HHI_HLM_USE_QPA
+        CHECK( rshift >= 8, "shifts greater than 7 are not supported." );
+#endif
+        for( const auto& row : rows[comp] )
+        {
+          const Pel* pOrg = picOrg.get( compID ).bufAt( row );
+          const Pel* pRec = scratch->get( compID ).bufAt( row );
+          for( Int x = 0; x < row.width; x++ )
+          {
+            const Intermediate_Int iTemp = pRec[x] - pOrg[x];
+            dist += UInt64( ( iTemp * iTemp ) >> rshift );
+          }
+        }
+      }
+      dists[idx] = dist;
+    }
+  };
+
+  if( m_deblockingWorkers.empty() || offsets.size() < 2 )
+  {
+    evalOffsets( m_deblockingScratch[0] );
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock( m_deblockingMutex );
+    m_deblockingJob     = evalOffsets;
+    m_deblockingNumBusy = (Int) m_deblockingWorkers.size();
+    m_deblockingJobId++;
+  }
+  m_deblockingJobCond.notify_all();
+
+  evalOffsets( m_deblockingScratch[0] );
+
+  std::unique_lock<std::mutex> lock( m_deblockingMutex );
+  m_deblockingDoneCond.wait( lock, [&]() { return m_deblockingNumBusy == 0; } );
+  m_deblockingJob = nullptr;
+}
+
+/** worker of the deblocking parameter selection, runs each job of xEvalDeblockingFilterParams with its own buffer
+ */
+Void EncGOP::xDeblockingWorker( PelStorage* scratch )
+{
+  // the workers are started before the first job
+  std::unique_lock<std::mutex> lock( m_deblockingMutex );
+  UInt lastJobId = 0;
+
+  while( true )
+  {
+    m_deblockingJobCond.wait( lock, [&]() { return m_deblockingStop || m_deblockingJobId != lastJobId; } );
+    if( m_deblockingStop )
+    {
+      return;
+    }
+    lastJobId = m_deblockingJobId;
+
+    lock.unlock();
+    m_deblockingJob( scratch );
+    lock.lock();
+
+    if( --m_deblockingNumBusy == 0 )
+    {
+      m_deblockingDoneCond.notify_one();
+    }
+  }
+}
+
 Void EncGOP::applyDeblockingFilterParameterSelection( Picture* pcPic, const UInt numSlices, const Int gopID )
 {
   enum DBFltParam
@@ -3351,22 +3645,77 @@ Void EncGOP::applyDeblockingFilterParameterSelection( Picture* pcPic, const UInt
   const Int MAX_TC_OFFSET = 3;
   const Int MIN_TC_OFFSET = -3;
 
-  PelUnitBuf reco = pcPic->getRecoBuf();
-
   const Int currQualityLayer = (pcPic->slices[0]->getSliceType() != I_SLICE) ? m_pcCfg->getGOPEntry(gopID).m_temporalId+1 : 0;
   CHECK(!(currQualityLayer <MAX_ENCODER_DEBLOCKING_QUALITY_LAYERS), "Unspecified error");
 
   CodingStructure& cs = *pcPic->cs;
 
-  if(!m_pcDeblockingTempPicYuv)
+  if( m_deblockingScratch.empty() )
   {
-    m_pcDeblockingTempPicYuv = new PelStorage;
-    m_pcDeblockingTempPicYuv->create( cs.area );
+    // every thread filters into a picture sized buffer, the number of threads is bounded to limit the memory
+    const Int numThreads = m_pcCfg->getDeblockingFilterMetricThreads() > 0 ? m_pcCfg->getDeblockingFilterMetricThreads() : std::max<Int>( 1, std::thread::hardware_concurrency() );
+
+    m_deblockingScratch.resize( std::min( numThreads, MAX_ENCODER_DEBLOCKING_THREADS ) );
+    for( auto& scratch : m_deblockingScratch )
+    {
+      scratch = new PelStorage;
+      scratch->create( cs.area );
+    }
+    for( size_t t = 1; t < m_deblockingScratch.size(); t++ )
+    {
+      m_deblockingWorkers.push_back( std::thread( &EncGOP::xDeblockingWorker, this, m_deblockingScratch[t] ) );
+    }
     memset(m_DBParam, 0, sizeof(m_DBParam));
   }
 
-  //preserve current reconstruction
-  m_pcDeblockingTempPicYuv->copyFrom ( reco );
+  // the edges, boundary strengths and QPs do not depend on the offsets, collect them once with the filter enabled
+  for (Int i=0; i<numSlices; i++)
+  {
+    Slice* pcSlice = pcPic->slices[i];
+    pcSlice->setDeblockingFilterOverrideFlag  ( true);
+    pcSlice->setDeblockingFilterDisable       ( false);
+  }
+  m_pcLoopFilter->getEdgeSegments( cs, m_deblockingEdgeSegments );
+
+  // rows of samples read or modified by the filtering of the segments
+  std::vector<Area> rows[MAX_NUM_COMPONENT];
+  for( UInt comp = 0; comp < (UInt)cs.area.blocks.size(); comp++ )
+  {
+    const CompArea&    compArea = cs.area.blocks[comp];
+    std::vector<UChar> mask     ( compArea.area(), 0 );
+
+    for( const auto& seg : m_deblockingEdgeSegments )
+    {
+      if( seg.compID != comp )
+      {
+        continue;
+      }
+      const Area   segArea = seg.area();
+      const PosType x0     = std::max<PosType>( segArea.x, 0 ), x1 = std::min<PosType>( segArea.x + segArea.width,  compArea.width  );
+      const PosType y0     = std::max<PosType>( segArea.y, 0 ), y1 = std::min<PosType>( segArea.y + segArea.height, compArea.height );
+      for( PosType y = y0; y < y1; y++ )
+      {
+        memset( &mask[y * compArea.width + x0], 1, std::max<PosType>( x1 - x0, 0 ) );
+      }
+    }
+
+    for( UInt y = 0; y < compArea.height; y++ )
+    {
+      const UChar* pMask = &mask[y * compArea.width];
+      for( UInt x = 0; x < compArea.width; x++ )
+      {
+        if( pMask[x] )
+        {
+          const UInt xStart = x;
+          while( x < compArea.width && pMask[x] )
+          {
+            x++;
+          }
+          rows[comp].push_back( Area( xStart, y, x - xStart, 1 ) );
+        }
+      }
+    }
+  }
 
   const Bool bNoFiltering      = m_DBParam[currQualityLayer][DBFLT_PARAM_AVAILABLE] && m_DBParam[currQualityLayer][DBFLT_DISABLE_FLAG]==false /*&& pcPic->getTLayer()==0*/;
   const Int  maxBetaOffsetDiv2 = bNoFiltering? Clip3(MIN_BETA_OFFSET, MAX_BETA_OFFSET, m_DBParam[currQualityLayer][DBFLT_BETA_OFFSETD2]+1) : MAX_BETA_OFFSET;
@@ -3374,6 +3723,32 @@ Void EncGOP::applyDeblockingFilterParameterSelection( Picture* pcPic, const UInt
   const Int  maxTcOffsetDiv2   = bNoFiltering? Clip3(MIN_TC_OFFSET, MAX_TC_OFFSET, m_DBParam[currQualityLayer][DBFLT_TC_OFFSETD2]+2)       : MAX_TC_OFFSET;
   const Int  minTcOffsetDiv2   = bNoFiltering? Clip3(MIN_TC_OFFSET, MAX_TC_OFFSET, m_DBParam[currQualityLayer][DBFLT_TC_OFFSETD2]-2)       : MIN_TC_OFFSET;
 
+  // the search below only terminates early after a beta offset below -1, all offsets down to the first such beta
+  // offset are evaluated at once, the remaining beta offsets one at a time when reached
+  UInt64 dists[MAX_BETA_OFFSET - MIN_BETA_OFFSET + 1][MAX_TC_OFFSET - MIN_TC_OFFSET + 1];
+  Int    minBetaEvaluated = maxBetaOffsetDiv2 + 1;
+
+  auto evalBetaOffsets = [&]( const Int minBeta )
+  {
+    std::vector<std::pair<Int, Int> > offsets;
+    for( Int betaOffsetDiv2 = minBetaEvaluated - 1; betaOffsetDiv2 >= minBeta; betaOffsetDiv2-- )
+    {
+      for( Int tcOffsetDiv2 = maxTcOffsetDiv2; tcOffsetDiv2 >= minTcOffsetDiv2; tcOffsetDiv2-- )
+      {
+        offsets.push_back( std::make_pair( betaOffsetDiv2, tcOffsetDiv2 ) );
+      }
+    }
+    std::vector<UInt64> offsetDists( offsets.size() );
+    xEvalDeblockingFilterParams( pcPic, rows, offsets, offsetDists.data() );
+    for( size_t i = 0; i < offsets.size(); i++ )
+    {
+      dists[offsets[i].first - MIN_BETA_OFFSET][offsets[i].second - MIN_TC_OFFSET] = offsetDists[i];
+    }
+    minBetaEvaluated = minBeta;
+  };
+
+  evalBetaOffsets( std::max( minBetaOffsetDiv2, std::min( maxBetaOffsetDiv2, -2 ) ) );
+
   UInt64 distBetaPrevious      = std::numeric_limits<UInt64>::max();
   UInt64 distMin               = std::numeric_limits<UInt64>::max();
   Bool   bDBFilterDisabledBest = true;
@@ -3382,22 +3757,15 @@ Void EncGOP::applyDeblockingFilterParameterSelection( Picture* pcPic, const UInt
 
   for(Int betaOffsetDiv2=maxBetaOffsetDiv2; betaOffsetDiv2>=minBetaOffsetDiv2; betaOffsetDiv2--)
   {
+    if( betaOffsetDiv2 < minBetaEvaluated )
+    {
+      evalBetaOffsets( betaOffsetDiv2 );
+    }
+
     UInt64 distTcMin = std::numeric_limits<UInt64>::max();
     for(Int tcOffsetDiv2=maxTcOffsetDiv2; tcOffsetDiv2 >= minTcOffsetDiv2; tcOffsetDiv2--)
     {
-      for (Int i=0; i<numSlices; i++)
-      {
-        Slice* pcSlice = pcPic->slices[i];
-        pcSlice->setDeblockingFilterOverrideFlag  ( true);
-        pcSlice->setDeblockingFilterDisable       ( false);
-        pcSlice->setDeblockingFilterBetaOffsetDiv2( betaOffsetDiv2 );
-        pcSlice->setDeblockingFilterTcOffsetDiv2  ( tcOffsetDiv2 );
-      }
-
-      // restore reconstruction
-      reco.copyFrom( *m_pcDeblockingTempPicYuv );
-
-      const UInt64 dist = preLoopFilterPicAndCalcDist( pcPic );
+      const UInt64 dist = dists[betaOffsetDiv2 - MIN_BETA_OFFSET][tcOffsetDiv2 - MIN_TC_OFFSET];
 
       if(dist < distMin)
       {
@@ -3428,9 +3796,6 @@ Void EncGOP::applyDeblockingFilterParameterSelection( Picture* pcPic, const UInt
   m_DBParam[currQualityLayer][DBFLT_BETA_OFFSETD2]   = betaOffsetDiv2Best;
   m_DBParam[currQualityLayer][DBFLT_TC_OFFSETD2]     = tcOffsetDiv2Best;
 
-  // restore reconstruction
-  reco.copyFrom( *m_pcDeblockingTempPicYuv );
-
   const PPS* pcPPS = pcPic->slices[0]->getPPS();
   if(bDBFilterDisabledBest)
   {
@@ -56,6 +56,11 @@
 #include "Analyze.h"
 #include "RateCtrl.h"
 #include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 //! \ingroup EncoderLib
 //! \{
@@ -123,6 +128,7 @@ private:
   Int                     m_pocCRA;
   NalUnitType             m_associatedIRAPType;
   Int                     m_associatedIRAPPOC;
+  std::set<Int>           m_sceneCutPOCs;               ///< key pictures coded as intra at scene cuts found by the lookahead
 
   std::vector<Int>        m_vRVM_RP;
   UInt                    m_lastBPSEI;
@@ -130,9 +136,23 @@ private:
   Bool                    m_bufferingPeriodSEIPresentInAU;
   SEIEncoder              m_seiEncoder;
 #if W0038_DB_OPT
-  PelStorage*             m_pcDeblockingTempPicYuv;
+  std::vector<PelStorage*>        m_deblockingScratch;        ///< per thread buffers of the deblocking parameter selection
+  std::vector<std::thread>        m_deblockingWorkers;        ///< workers of the deblocking parameter selection, kept for the whole sequence
+  std::mutex                      m_deblockingMutex;
+  std::condition_variable         m_deblockingJobCond;        ///< signals a new job or the stop of the workers
+  std::condition_variable         m_deblockingDoneCond;       ///< signals that all workers finished the job
+  std::function<Void( PelStorage* )> m_deblockingJob;
+  UInt                            m_deblockingJobId;
+  Int                             m_deblockingNumBusy;
+  Bool                            m_deblockingStop;
+  std::vector<DeblockEdgeSegment> m_deblockingEdgeSegments;
   Int                     m_DBParam[MAX_ENCODER_DEBLOCKING_QUALITY_LAYERS][4];   //[layer_id][0: available; 1: bDBDisabled; 2: Beta Offset Div2; 3: Tc Offset Div2;]
 #endif
+  std::thread                     m_metricsWorker;            ///< computes the structural metrics of a picture while its PSNR is computed, kept for the whole sequence
+  std::mutex                      m_metricsMutex;
+  std::condition_variable         m_metricsCond;              ///< signals a new job, its completion or the stop of the worker
+  std::function<Void()>           m_metricsJob;
+  Bool                            m_metricsStop;
 
   // members needed for adaptive max BT size
   UInt                    m_uiBlkSize[10];
@@ -158,11 +178,9 @@ public:
   PicList*   getListPic()      { return m_pcListPic; }
 
   Void  printOutSummary      ( UInt uiNumAllPicCoded, Bool isField, const Bool printMSEBasedSNR, const Bool printSequenceMSE, const BitDepths &bitDepths );
-#if W0038_DB_OPT
-  UInt64  preLoopFilterPicAndCalcDist( Picture* pcPic );
-#endif
   EncSlice*  getSliceEncoder()   { return m_pcSliceEncoder; }
   NalUnitType getNalUnitType( Int pocCurr, Int lastIdr, Bool isField );
+  Bool  isSceneCutIntra   ( Int pocCurr ) const { return m_sceneCutPOCs.find( pocCurr ) != m_sceneCutPOCs.end(); }
   Void arrangeLongtermPicturesInRPS(Slice *, PicList& );
 
 protected:
@@ -171,6 +189,8 @@ protected:
 protected:
 
   Void  xInitGOP          ( Int iPOCLast, Int iNumPicRcvd, Bool isField );
+  Void  xDetectSceneCut   ( Int iPOCLast, Int iNumPicRcvd );
+  Void  xGetPropagationPictures( Int iPOCLast, Int iNumPicRcvd, Int iGOPid, Int pocCurr, std::vector<std::pair<Int, std::vector<Int> > >& codedAfter );
   Void  xGetBuffer        ( PicList& rcListPic, std::list<PelUnitBuf*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, Picture*& rpcPic, Int pocCurr, Bool isField );
 
   Void  xCalculateAddPSNRs         ( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, Picture* pcPic, const AccessUnit&accessUnit, PicList &rcListPic, Double dEncTime, const InputColourSpaceConversion snr_conversion, const Bool printFrameMSE, Double* PSNR_Y );
@@ -214,7 +234,10 @@ protected:
   Void applyDeblockingFilterMetric( Picture* pcPic, UInt uiNumSlices );
 #if W0038_DB_OPT
   Void applyDeblockingFilterParameterSelection( Picture* pcPic, const UInt numSlices, const Int gopID );
+  Void xEvalDeblockingFilterParams( Picture* pcPic, const std::vector<Area> ( &rows )[MAX_NUM_COMPONENT], const std::vector<std::pair<Int, Int> >& offsets, UInt64* dists );
+  Void xDeblockingWorker          ( PelStorage* scratch );
 #endif
+  Void xMetricsWorker             ();
 };// END CLASS DEFINITION EncGOP
 
 //! \}
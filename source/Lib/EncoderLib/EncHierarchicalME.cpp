@@ -0,0 +1,356 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     EncHierarchicalME.cpp
+    \brief    coarse motion estimation on downsampled pictures seeding the integer motion search
+*/
+
+#include "EncHierarchicalME.h"
+
+//! \ingroup EncoderLib
+//! \{
+
+EncHierarchicalME::EncHierarchicalME()
+  : m_pcRdCost     ( nullptr )
+  , m_iSearchRange ( 0 )
+  , m_iPOC         ( MAX_INT )
+  , m_iFieldWidth  ( 0 )
+  , m_iFieldHeight ( 0 )
+{
+}
+
+EncHierarchicalME::~EncHierarchicalME()
+{
+  destroy();
+}
+
+Void EncHierarchicalME::init( RdCost* pcRdCost, const Int iSearchRange )
+{
+  m_pcRdCost     = pcRdCost;
+  m_iSearchRange = iSearchRange;
+  m_iPOC         = MAX_INT;
+}
+
+Void EncHierarchicalME::destroy()
+{
+  for( auto& pyramid : m_pyramids )
+  {
+    pyramid.second->level[0].destroy();
+    pyramid.second->level[1].destroy();
+    delete pyramid.second;
+  }
+  m_pyramids.clear();
+  m_iPOC = MAX_INT;
+}
+
+/** Get the downsampled luma of a picture, creating it on first use
+ * \param pic picture holding the original samples
+ */
+const EncHierarchicalME::Pyramid& EncHierarchicalME::xGetPyramid( const Picture& pic )
+{
+  Pyramid*& pyramid = m_pyramids[pic.getPOC()];
+
+  if( pyramid )
+  {
+    return *pyramid;
+  }
+
+  pyramid = new Pyramid;
+
+  CPelBuf src = pic.getOrigBuf().Y();
+
+  for( Int l = 0; l < 2; l++ )
+  {
+    pyramid->level[l].create( CHROMA_400, Area( 0, 0, std::max<Int>( src.width >> 1, 1 ), std::max<Int>( src.height >> 1, 1 ) ) );
+
+    PelBuf dst = pyramid->level[l].Y();
+
+    for( Int y = 0; y < dst.height; y++ )
+    {
+      const Pel* src0 = src.bufAt( 0, std::min<Int>( 2 * y,     src.height - 1 ) );
+      const Pel* src1 = src.bufAt( 0, std::min<Int>( 2 * y + 1, src.height - 1 ) );
+      Pel*       pDst = dst.bufAt( 0, y );
+
+      for( Int x = 0; x < dst.width; x++ )
+      {
+        const Int x0 = std::min<Int>( 2 * x,     src.width - 1 );
+        const Int x1 = std::min<Int>( 2 * x + 1, src.width - 1 );
+        pDst[x] = ( src0[x0] + src0[x1] + src1[x0] + src1[x1] + 2 ) >> 2;
+      }
+    }
+
+    src = dst;
+  }
+
+  return *pyramid;
+}
+
+/** Integer block matching at one pyramid level
+ * \param cDistParam distortion parameters set up for the block
+ * \param cRefBuf    reference picture at the same level
+ * \param pos        top-left position of the block
+ * \param iRange     range of the full search around the first candidate
+ * \param pcCands    candidate vectors, the first one is the center of the full search
+ * \param iNumCands  number of candidate vectors
+ * \param rcMv       returns the best vector
+ */
+Void EncHierarchicalME::xSearchBlock( DistParam& cDistParam, const CPelBuf& cRefBuf, const Position& pos, const Int iRange, const Mv* pcCands, const Int iNumCands, Mv& rcMv )
+{
+  const Int iMinX = -pos.x;
+  const Int iMinY = -pos.y;
+  const Int iMaxX = cRefBuf.width  - cDistParam.org.width  - pos.x;
+  const Int iMaxY = cRefBuf.height - cDistParam.org.height - pos.y;
+
+  Distortion uiBestDist = std::numeric_limits<Distortion>::max();
+
+  auto checkPoint = [&]( const Int iX, const Int iY )
+  {
+    if( iX < iMinX || iX > iMaxX || iY < iMinY || iY > iMaxY )
+    {
+      return;
+    }
+    cDistParam.cur.buf = cRefBuf.bufAt( pos.x + iX, pos.y + iY );
+    cDistParam.maximumDistortionForEarlyExit = uiBestDist;
+    const Distortion uiDist = cDistParam.distFunc( cDistParam );
+    if( uiDist < uiBestDist )
+    {
+      uiBestDist = uiDist;
+      rcMv.set( iX, iY );
+    }
+  };
+
+  rcMv.setZero();
+
+  for( Int i = 0; i < iNumCands; i++ )
+  {
+    checkPoint( pcCands[i].getHor(), pcCands[i].getVer() );
+  }
+
+  const Int iCenterX = pcCands[0].getHor();
+  const Int iCenterY = pcCands[0].getVer();
+
+  for( Int iY = iCenterY - iRange; iY <= iCenterY + iRange; iY++ )
+  {
+    for( Int iX = iCenterX - iRange; iX <= iCenterX + iRange; iX++ )
+    {
+      checkPoint( iX, iY );
+    }
+  }
+
+  // refine a candidate which won from outside of the search window
+  if( abs( rcMv.getHor() - iCenterX ) > iRange || abs( rcMv.getVer() - iCenterY ) > iRange )
+  {
+    const Mv cBest = rcMv;
+
+    for( Int iY = cBest.getVer() - 1; iY <= cBest.getVer() + 1; iY++ )
+    {
+      for( Int iX = cBest.getHor() - 1; iX <= cBest.getHor() + 1; iX++ )
+      {
+        checkPoint( iX, iY );
+      }
+    }
+  }
+}
+
+/** Estimate the motion field of a picture towards one reference
+ * \param cur      downsampled current picture
+ * \param ref      downsampled reference picture
+ * \param bitDepth luma bit depth
+ * \param mvField  returns the full-pel vectors of the BLK_SIZE x BLK_SIZE blocks
+ */
+Void EncHierarchicalME::xEstimateField( const Pyramid& cur, const Pyramid& ref, const Int bitDepth, std::vector<Mv>& mvField )
+{
+  DistParam cDistParam;
+
+  // 4:1 level, blocks covering 2x2 blocks of the field, full search around zero and the causal neighbours
+  const CPelBuf cCur4 = cur.level[1].Y();
+  const CPelBuf cRef4 = ref.level[1].Y();
+  const Int     iBlk4 = BLK_SIZE >> 1;
+  const Int     iNumX = ( cCur4.width  + iBlk4 - 1 ) / iBlk4;
+  const Int     iNumY = ( cCur4.height + iBlk4 - 1 ) / iBlk4;
+  const Int     iRange4 = Clip3( 2, 16, ( m_iSearchRange + 3 ) >> 2 );
+
+  std::vector<Mv> mvField4( iNumX * iNumY );
+
+  for( Int by = 0; by < iNumY; by++ )
+  {
+    for( Int bx = 0; bx < iNumX; bx++ )
+    {
+      const Position pos( bx * iBlk4, by * iBlk4 );
+      const CPelBuf  cOrg( cCur4.bufAt( pos ), cCur4.stride, Size( std::min<Int>( iBlk4, cCur4.width - pos.x ), std::min<Int>( iBlk4, cCur4.height - pos.y ) ) );
+
+      Mv  acCands[4];
+      Int iNumCands = 0;
+      acCands[iNumCands++].setZero();
+      if( bx > 0 )                    acCands[iNumCands++] = mvField4[by * iNumX + bx - 1];
+      if( by > 0 )                    acCands[iNumCands++] = mvField4[( by - 1 ) * iNumX + bx];
+      if( by > 0 && bx + 1 < iNumX )  acCands[iNumCands++] = mvField4[( by - 1 ) * iNumX + bx + 1];
+
+      m_pcRdCost->setDistParam( cDistParam, cOrg, cRef4.buf, cRef4.stride, bitDepth, COMPONENT_Y, 0, 1, false );
+      xSearchBlock( cDistParam, cRef4, pos, iRange4, acCands, iNumCands, mvField4[by * iNumX + bx] );
+    }
+  }
+
+  // 2:1 level, blocks of the field, small window around the scaled vector of the covering 4:1 block
+  const CPelBuf cCur2 = cur.level[0].Y();
+  const CPelBuf cRef2 = ref.level[0].Y();
+  const Int     iBlk2 = BLK_SIZE >> 1;
+
+  for( Int by = 0; by < m_iFieldHeight; by++ )
+  {
+    for( Int bx = 0; bx < m_iFieldWidth; bx++ )
+    {
+      const Position pos( bx * iBlk2, by * iBlk2 );
+      Mv acCands[2];
+      acCands[0] = mvField4[std::min( by >> 1, iNumY - 1 ) * iNumX + std::min( bx >> 1, iNumX - 1 )];
+      acCands[0] <<= 1;
+      acCands[1].setZero();
+
+      Mv& rcMv = mvField[by * m_iFieldWidth + bx];
+
+      if( pos.x >= Int( cCur2.width ) || pos.y >= Int( cCur2.height ) )
+      {
+        rcMv = acCands[0];
+      }
+      else
+      {
+        const CPelBuf cOrg( cCur2.bufAt( pos ), cCur2.stride, Size( std::min<Int>( iBlk2, cCur2.width - pos.x ), std::min<Int>( iBlk2, cCur2.height - pos.y ) ) );
+
+        m_pcRdCost->setDistParam( cDistParam, cOrg, cRef2.buf, cRef2.stride, bitDepth, COMPONENT_Y, 0, 1, false );
+        xSearchBlock( cDistParam, cRef2, pos, 2, acCands, 2, rcMv );
+      }
+
+      rcMv <<= 1;
+    }
+  }
+}
+
+Void EncHierarchicalME::estimate( const Slice& slice )
+{
+  const Picture& pic = *slice.getPic();
+
+  Bool bValid = m_iPOC == pic.getPOC();
+
+  for( Int iList = 0; iList < NUM_REF_PIC_LIST_01 && bValid; iList++ )
+  {
+    for( Int iRefIdx = 0; iRefIdx < slice.getNumRefIdx( RefPicList( iList ) ) && bValid; iRefIdx++ )
+    {
+      bValid = m_aiRefPOC[iList][iRefIdx] == slice.getRefPic( RefPicList( iList ), iRefIdx )->getPOC();
+    }
+  }
+
+  if( bValid )
+  {
+    // already estimated, e.g. for a previous slice or QP of the same picture
+    return;
+  }
+
+  m_iPOC         = pic.getPOC();
+  m_iFieldWidth  = ( pic.lumaSize().width  + BLK_SIZE - 1 ) / BLK_SIZE;
+  m_iFieldHeight = ( pic.lumaSize().height + BLK_SIZE - 1 ) / BLK_SIZE;
+
+  const Pyramid& cur      = xGetPyramid( pic );
+  const Int      bitDepth = slice.getSPS()->getBitDepth( CHANNEL_TYPE_LUMA );
+
+  std::vector<Int> usedPOCs( 1, pic.getPOC() );
+
+  for( Int iList = 0; iList < NUM_REF_PIC_LIST_01; iList++ )
+  {
+    for( Int iRefIdx = 0; iRefIdx < MAX_NUM_REF; iRefIdx++ )
+    {
+      m_aiRefPOC[iList][iRefIdx] = MAX_INT;
+    }
+
+    for( Int iRefIdx = 0; iRefIdx < slice.getNumRefIdx( RefPicList( iList ) ); iRefIdx++ )
+    {
+      const Picture& refPic = *slice.getRefPic( RefPicList( iList ), iRefIdx );
+
+      m_aiRefPOC[iList][iRefIdx] = refPic.getPOC();
+      m_acMvField[iList][iRefIdx].resize( m_iFieldWidth * m_iFieldHeight );
+      usedPOCs.push_back( refPic.getPOC() );
+
+      // pictures in both lists only need to be searched once
+      Int iRefIdxL0 = -1;
+      for( Int i = 0; iList == REF_PIC_LIST_1 && i < slice.getNumRefIdx( REF_PIC_LIST_0 ); i++ )
+      {
+        if( m_aiRefPOC[REF_PIC_LIST_0][i] == refPic.getPOC() )
+        {
+          iRefIdxL0 = i;
+          break;
+        }
+      }
+
+      if( iRefIdxL0 >= 0 )
+      {
+        m_acMvField[iList][iRefIdx] = m_acMvField[REF_PIC_LIST_0][iRefIdxL0];
+      }
+      else
+      {
+        xEstimateField( cur, xGetPyramid( refPic ), bitDepth, m_acMvField[iList][iRefIdx] );
+      }
+    }
+  }
+
+  // drop pictures not referenced any more
+  for( auto it = m_pyramids.begin(); it != m_pyramids.end(); )
+  {
+    if( std::find( usedPOCs.begin(), usedPOCs.end(), it->first ) == usedPOCs.end() )
+    {
+      it->second->level[0].destroy();
+      it->second->level[1].destroy();
+      delete it->second;
+      it = m_pyramids.erase( it );
+    }
+    else
+    {
+      it++;
+    }
+  }
+}
+
+Bool EncHierarchicalME::getMv( const Slice& slice, const RefPicList eRefPicList, const Int iRefIdx, const Position& pos, Mv& rcMv ) const
+{
+  if( m_iPOC != slice.getPic()->getPOC() || m_aiRefPOC[eRefPicList][iRefIdx] != slice.getRefPic( eRefPicList, iRefIdx )->getPOC() )
+  {
+    return false;
+  }
+
+  const Int bx = std::min( pos.x / BLK_SIZE, m_iFieldWidth  - 1 );
+  const Int by = std::min( pos.y / BLK_SIZE, m_iFieldHeight - 1 );
+
+  rcMv = m_acMvField[eRefPicList][iRefIdx][by * m_iFieldWidth + bx];
+
+  return true;
+}
+
+//! \}
@@ -0,0 +1,97 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     EncHierarchicalME.h
+    \brief    coarse motion estimation on downsampled pictures seeding the integer motion search (header)
+*/
+
+#ifndef __ENCHIERARCHICALME__
+#define __ENCHIERARCHICALME__
+
+#include "CommonLib/CommonDef.h"
+#include "CommonLib/Picture.h"
+#include "CommonLib/RdCost.h"
+
+#include <map>
+
+//! \ingroup EncoderLib
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// Block matching on 2:1 and 4:1 downsampled luma of the original pictures. The resulting motion field of a
+/// picture is used by InterSearch as additional start point of the integer motion search.
+class EncHierarchicalME
+{
+public:
+  static const Int BLK_SIZE = 16;                   ///< luma block size of the motion field
+
+private:
+  struct Pyramid
+  {
+    PelStorage level[2];                            ///< luma downsampled by 2:1 and 4:1
+  };
+
+  RdCost*                  m_pcRdCost;
+  Int                      m_iSearchRange;          ///< full-pel search range of the regular motion search
+  std::map<Int, Pyramid*>  m_pyramids;              ///< downsampled pictures by POC
+
+  Int                      m_iPOC;                  ///< POC of the picture the motion fields belong to
+  Int                      m_aiRefPOC  [NUM_REF_PIC_LIST_01][MAX_NUM_REF];
+  std::vector<Mv>          m_acMvField [NUM_REF_PIC_LIST_01][MAX_NUM_REF];
+  Int                      m_iFieldWidth;
+  Int                      m_iFieldHeight;
+
+  const Pyramid& xGetPyramid    ( const Picture& pic );
+  Void           xEstimateField ( const Pyramid& cur, const Pyramid& ref, const Int bitDepth, std::vector<Mv>& mvField );
+  Void           xSearchBlock   ( DistParam& cDistParam, const CPelBuf& cRefBuf, const Position& pos, const Int iRange, const Mv* pcCands, const Int iNumCands, Mv& rcMv );
+
+public:
+  EncHierarchicalME();
+  virtual ~EncHierarchicalME();
+
+  Void init    ( RdCost* pcRdCost, const Int iSearchRange );
+  Void destroy ();
+
+  /// estimate the coarse motion of the slice's picture towards all of its reference pictures
+  Void estimate( const Slice& slice );
+
+  /// integer-pel start point of the motion search for the block at the given luma position
+  Bool getMv   ( const Slice& slice, const RefPicList eRefPicList, const Int iRefIdx, const Position& pos, Mv& rcMv ) const;
+};
+
+//! \}
+
+#endif // __ENCHIERARCHICALME__
@@ -96,6 +96,14 @@ Void EncLib::create ()
 
   m_cLoopFilter.create( m_maxTotalCUDepth );
 
+  if( m_lookaheadFrames > 0 )
+  {
+    m_cLookahead.create( getSourceWidth(), getSourceHeight(), m_bitDepth[CHANNEL_TYPE_LUMA], m_sceneCutThreshold );
+  }
+
+  m_cPreanalysis.create( m_preanalysisThreads, m_maxCUHeight, m_useWeightedPred || m_useWeightedBiPred,
+                         m_weightedPredictionMethod >= WP_PER_PICTURE_WITH_HISTOGRAM_AND_PER_COMPONENT );
+
   if( m_ALF )
   {
     const UInt widthInCtus   = (getSourceWidth()  + m_maxCUWidth  - 1) / m_maxCUWidth;
@@ -115,6 +123,7 @@ Void EncLib::create ()
 Void EncLib::destroy ()
 {
   // destroy processing unit classes
+  m_cPreanalysis.       destroy();
   m_cGOPEncoder.        destroy();
   m_cSliceEncoder.      destroy();
   m_cCuEncoder.         destroy();
@@ -123,6 +132,7 @@ Void EncLib::destroy ()
   m_cEncSAO.            destroy();
   m_cLoopFilter.        destroy();
   m_cRateCtrl.          destroy();
+  m_cLookahead.         destroy();
   m_cInterSearch.       destroy();
   m_cIntraSearch.       destroy();
 
@@ -342,10 +352,7 @@ Void EncLib::encode( Bool flush, PelStorage* pcPicYuvOrg, PelStorage* cPicYuvTru
     pcPicCurr->poc = m_iPOCLast;
 
     // compute image characteristics
-    if ( getUseAdaptiveQP() )
-    {
-      AQpPreanalyzer::preanalyze( pcPicCurr );
-    }
+    m_cPreanalysis.addPicture( pcPicCurr );
   }
 
   if ((m_iNumPicRcvd == 0) || (!flush && (m_iPOCLast != 0) && (m_iNumPicRcvd != m_iGOPSize) && (m_iGOPSize != 0)))
@@ -356,7 +363,16 @@ Void EncLib::encode( Bool flush, PelStorage* pcPicYuvOrg, PelStorage* cPicYuvTru
 
   if ( m_RCEnableRateControl )
   {
-    m_cRateCtrl.initRCGOP( m_iNumPicRcvd );
+    if ( m_RCLookahead > 0 )
+    {
+      TRCLookahead rcLookahead;
+      xInitRCLookahead( rcLookahead );
+      m_cRateCtrl.initRCGOP( m_iNumPicRcvd, &rcLookahead );
+    }
+    else
+    {
+      m_cRateCtrl.initRCGOP( m_iNumPicRcvd );
+    }
   }
 
   // compress GOP
@@ -446,10 +462,7 @@ Void EncLib::encode(Bool flush, PelStorage* pcPicYuvOrg, PelStorage* pcPicYuvTru
       pcField->topField = isTopField;                  // interlaced requirement
 
       // compute image characteristics
-      if ( getUseAdaptiveQP() )
-      {
-        AQpPreanalyzer::preanalyze( pcField );
-      }
+      m_cPreanalysis.addPicture( pcField );
     }
 
     if ( m_iNumPicRcvd && ((flush&&fieldNum==1) || (m_iPOCLast/2)==0 || m_iNumPicRcvd==m_iGOPSize ) )
@@ -468,6 +481,118 @@ Void EncLib::encode(Bool flush, PelStorage* pcPicYuvOrg, PelStorage* pcPicYuvTru
 // Protected member functions
 // ====================================================================================================================
 
+/** Derive the bit allocation of the next GOP from the lookahead estimates
+ * The complexity of a picture is its estimated cost compressed by g_RCLookaheadQComp, the intra cost for the pictures
+ * coded as intra picture and the inter cost for the others. The GOP gets bits in
+ * proportion of its complexity to the complexity of the known pictures of the smoothing window, and the pictures of
+ * the GOP in proportion of their complexity. With the two-pass mode the complexity of the whole sequence is known.
+ * \param rcLookahead complexity ratios passed to the GOP rate control
+ */
+Void EncLib::xInitRCLookahead( TRCLookahead& rcLookahead )
+{
+  const Bool twoPass      = m_RCLookahead == 2;
+  const Int  firstPOC     = m_iPOCLast - m_iNumPicRcvd + 1;
+  const Int  lastKnownPOC = twoPass ? (Int)m_RCSeqCosts.size() - 1 : m_cLookahead.getNumPicsAdded() - 1;
+  const Int  intraPeriod  = (Int)getIntraPeriod();
+
+  auto picCost = [&]( const Int poc ) -> const LookaheadCost&
+  {
+    return twoPass ? m_RCSeqCosts[poc] : m_cLookahead.getCost( poc );
+  };
+
+  // the first picture, the periodic intra pictures and, with the scene cut detection of the encoder lookahead, the key
+  // picture of a GOP containing a scene cut (see EncGOP::xDetectSceneCut())
+  auto isIntraPic = [&]( const Int poc ) -> Bool
+  {
+    if ( poc == 0 || ( intraPeriod > 0 && poc % intraPeriod == 0 ) )
+    {
+      return true;
+    }
+    if ( !m_cLookahead.isActive() || poc % m_iGOPSize != 0 )
+    {
+      return false;
+    }
+    for ( Int scPOC = poc - m_iGOPSize + 1; scPOC <= poc; scPOC++ )
+    {
+      if ( picCost( scPOC ).sceneCut )
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  auto picComplexity = [&]( const Int poc ) -> Double
+  {
+    const LookaheadCost& cost = picCost( poc );
+    return pow( std::max<Double>( Double( isIntraPic( poc ) ? cost.intraCost : cost.interCost ), 1.0 ), 1.0 - g_RCLookaheadQComp );
+  };
+
+  // the pictures of the GOP in the coding order of the rate control
+  rcLookahead.m_picWeight.clear();
+  rcLookahead.m_GOPIdx.clear();
+  Double GOPComplexity = 0.0;
+  if ( m_iPOCLast == 0 )
+  {
+    rcLookahead.m_picWeight.push_back( picComplexity( 0 ) );
+    rcLookahead.m_GOPIdx.push_back( 0 );
+  }
+  else
+  {
+    for ( Int i = 0; i < m_iGOPSize && (Int)rcLookahead.m_picWeight.size() < m_iNumPicRcvd; i++ )
+    {
+      const Int poc = firstPOC - 1 + m_GOPList[i].m_POC;
+      if ( poc <= m_iPOCLast )
+      {
+        rcLookahead.m_picWeight.push_back( picComplexity( poc ) );
+        rcLookahead.m_GOPIdx.push_back( i );
+      }
+    }
+  }
+  while ( (Int)rcLookahead.m_picWeight.size() < m_iNumPicRcvd )
+  {
+    rcLookahead.m_GOPIdx.push_back( (Int)rcLookahead.m_picWeight.size() );
+    rcLookahead.m_picWeight.push_back( 1.0 );
+  }
+  for ( Int i = 0; i < m_iNumPicRcvd; i++ )
+  {
+    GOPComplexity += rcLookahead.m_picWeight[i];
+  }
+  GOPComplexity /= m_iNumPicRcvd;
+  for ( Int i = 0; i < m_iNumPicRcvd; i++ )
+  {
+    rcLookahead.m_picWeight[i] /= GOPComplexity;
+  }
+
+  // the known pictures of the smoothing window
+  const Int windowSize    = std::min( g_RCSmoothWindowSize, m_cRateCtrl.getRCSeq()->getFramesLeft() );
+  const Int lastWindowPOC = std::min( firstPOC + windowSize - 1, lastKnownPOC );
+  Double windowComplexity = 0.0;
+  for ( Int poc = firstPOC; poc <= lastWindowPOC; poc++ )
+  {
+    windowComplexity += picComplexity( poc );
+  }
+  rcLookahead.m_GOPRatio = lastWindowPOC >= firstPOC ? GOPComplexity * ( lastWindowPOC - firstPOC + 1 ) / windowComplexity : 1.0;
+
+  // two-pass: the pictures after the window are reserved their complexity share of the total target bits
+  rcLookahead.m_beyondWindowShare = -1.0;
+  if ( twoPass )
+  {
+    Double totalComplexity  = 0.0;
+    Double beyondComplexity = 0.0;
+    for ( Int poc = 0; poc <= lastKnownPOC; poc++ )
+    {
+      const Double complexity = picComplexity( poc );
+      totalComplexity += complexity;
+      if ( poc >= firstPOC + windowSize )
+      {
+        beyondComplexity += complexity;
+      }
+    }
+    rcLookahead.m_beyondWindowShare = beyondComplexity / totalComplexity;
+  }
+}
+
 /**
  - Application has picture buffer list with size of GOP + 1
  - Picture buffer list acts like as ring buffer
@@ -525,6 +650,10 @@ Void EncLib::xGetNewPicBuffer ( std::list<PelUnitBuf*>& rcListPicYuvRecOut, Pict
     rpcPic = new Picture;
 
     rpcPic->create( sps.getChromaFormatIdc(), Size( sps.getPicWidthInLumaSamples(), sps.getPicHeightInLumaSamples()), sps.getMaxCUWidth(), sps.getMaxCUWidth()+16, false );
+    if( m_bSubPelMECache )
+    {
+      rpcPic->createSubPelBuffers( sps.getMaxCUWidth() );
+    }
 
     if ( getUseAdaptiveQP() )
     {
@@ -55,6 +55,8 @@
 #include "EncSampleAdaptiveOffset.h"
 #include "EncAdaptiveLoopFilter.h"
 #include "RateCtrl.h"
+#include "EncLookahead.h"
+#include "EncPreanalysis.h"
 //! \ingroup EncoderLib
 //! \{
 
@@ -96,6 +98,9 @@ private:
 
   // quality control
   RateCtrl                  m_cRateCtrl;                    ///< Rate control class
+  EncLookahead              m_cLookahead;                   ///< analysis of the upcoming input pictures
+  EncPreanalysis            m_cPreanalysis;                 ///< analysis of the original pictures for adaptive QP and weighted prediction
+  std::vector<LookaheadCost> m_RCSeqCosts;                  ///< picture costs of the whole sequence by POC for two-pass rate control
 
 protected:
   Void  xGetNewPicBuffer  ( std::list<PelUnitBuf*>& rcListPicYuvRecOut, Picture*& rpcPic, Int ppsId ); ///< get picture buffer which will be processed. If ppsId<0, then the ppsMap will be queried for the first match.
@@ -107,6 +112,7 @@ protected:
 
   Void  xInitPPSforTiles  (PPS &pps);
   Void  xInitRPS          (SPS &sps, Bool isFieldCoding);           ///< initialize PPS from encoder options
+  Void  xInitRCLookahead  ( TRCLookahead& rcLookahead );    ///< GOP bit allocation from the lookahead estimates
 
 public:
   EncLib();
@@ -138,6 +144,8 @@ public:
   RdCost*                 getRdCost             ()            { return  &m_cRdCost;              }
   CtxCache*               getCtxCache           ()            { return  &m_CtxCache;             }
   RateCtrl*               getRateCtrl           ()            { return  &m_cRateCtrl;            }
+  EncLookahead*           getLookahead          ()            { return  &m_cLookahead;           }
+  EncPreanalysis*         getPreanalysis        ()            { return  &m_cPreanalysis;         }
   Void selectReferencePictureSet(Slice* slice, Int POCCurr, Int GOPid );
   Int getReferencePictureSetIdxForSOP(Int POCCurr, Int GOPid );
 
@@ -148,6 +156,12 @@ public:
   // encoder function
   // -------------------------------------------------------------------------------------------------------------------
 
+  /// pass the next input picture to the lookahead, before it is passed to encode()
+  Void addLookaheadPicture( const PelStorage& cPicYuvOrg ) { m_cLookahead.addPicture( cPicYuvOrg.get( COMPONENT_Y ) ); }
+
+  /// lookahead picture costs of the whole sequence for the two-pass rate control, before the first call of encode()
+  Void setRCSeqCosts( const std::vector<LookaheadCost>& costs ) { m_RCSeqCosts = costs; }
+
   /// encode several number of pictures until end-of-sequence
   Void encode( Bool bEos,
                PelStorage* pcPicYuvOrg,
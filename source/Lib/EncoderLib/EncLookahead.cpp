@@ -0,0 +1,475 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     EncLookahead.cpp
+    \brief    analysis of the upcoming input pictures on downsampled luma
+*/
+
+#include "EncLookahead.h"
+
+//! \ingroup EncoderLib
+//! \{
+
+EncLookahead::EncLookahead()
+  : m_bitDepth          ( 8 )
+  , m_sceneCutThreshold ( 0 )
+  , m_numBlkX           ( 0 )
+  , m_numBlkY           ( 0 )
+  , m_lowResWidth       ( 0 )
+  , m_lowResHeight      ( 0 )
+  , m_numPicsAdded      ( 0 )
+  , m_firstPOC          ( 0 )
+  , m_stop              ( false )
+  , m_prevPic           ( nullptr )
+{
+}
+
+EncLookahead::~EncLookahead()
+{
+  destroy();
+}
+
+/** Start the analysis thread
+ * \param width             luma width of the input pictures
+ * \param height            luma height of the input pictures
+ * \param bitDepth          internal luma bit depth
+ * \param sceneCutThreshold sensitivity of the scene cut detection in percent, 0 disables it
+ */
+Void EncLookahead::create( const Int width, const Int height, const Int bitDepth, const Int sceneCutThreshold )
+{
+  destroy();
+
+  m_bitDepth          = bitDepth;
+  m_sceneCutThreshold = sceneCutThreshold;
+  m_numBlkX           = ( width  + BLK_SIZE - 1 ) / BLK_SIZE;
+  m_numBlkY           = ( height + BLK_SIZE - 1 ) / BLK_SIZE;
+  m_lowResWidth       = std::max( width  >> 1, 1 );
+  m_lowResHeight      = std::max( height >> 1, 1 );
+  m_numPicsAdded      = 0;
+  m_firstPOC          = 0;
+  m_stop              = false;
+
+  m_worker = std::thread( &EncLookahead::xWorker, this );
+}
+
+Void EncLookahead::destroy()
+{
+  if( m_worker.joinable() )
+  {
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      m_stop = true;
+    }
+    m_cond.notify_all();
+    m_worker.join();
+  }
+
+  for( auto pic : m_queue )
+  {
+    pic->lowRes.destroy();
+    delete pic;
+  }
+  m_queue.clear();
+  m_costs.clear();
+
+  if( m_prevPic )
+  {
+    m_prevPic->lowRes.destroy();
+    delete m_prevPic;
+    m_prevPic = nullptr;
+  }
+}
+
+Void EncLookahead::addPicture( const CPelBuf& cOrgLuma )
+{
+  LookaheadPic* pic = new LookaheadPic;
+  pic->poc = m_numPicsAdded++;
+  pic->lowRes.create( CHROMA_400, Area( 0, 0, std::max<Int>( cOrgLuma.width >> 1, 1 ), std::max<Int>( cOrgLuma.height >> 1, 1 ) ) );
+
+  PelBuf dst = pic->lowRes.Y();
+
+  for( Int y = 0; y < dst.height; y++ )
+  {
+    const Pel* src0 = cOrgLuma.bufAt( 0, std::min<Int>( 2 * y,     cOrgLuma.height - 1 ) );
+    const Pel* src1 = cOrgLuma.bufAt( 0, std::min<Int>( 2 * y + 1, cOrgLuma.height - 1 ) );
+    Pel*       pDst = dst.bufAt( 0, y );
+
+    for( Int x = 0; x < dst.width; x++ )
+    {
+      const Int x0 = std::min<Int>( 2 * x,     cOrgLuma.width - 1 );
+      const Int x1 = std::min<Int>( 2 * x + 1, cOrgLuma.width - 1 );
+      pDst[x] = ( src0[x0] + src0[x1] + src1[x0] + src1[x1] + 2 ) >> 2;
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_cond.wait( lock, [&]() { return m_queue.size() < MAX_QUEUED; } );
+    m_queue.push_back( pic );
+  }
+  m_cond.notify_all();
+}
+
+const LookaheadCost& EncLookahead::getCost( const Int poc )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  CHECK( poc < m_firstPOC || poc >= m_numPicsAdded, "Picture not available in the lookahead" );
+  m_cond.wait( lock, [&]() { return m_costs.find( poc ) != m_costs.end(); } );
+
+  return m_costs[poc];
+}
+
+/** Propagation of the inter prediction benefit of the blocks backwards through the pictures coded after the given one,
+ *  in reverse coding order. Each block passes the predicted part of its cost evenly to the references of its picture.
+ *  The motion towards a reference is the motion towards the previous picture scaled by the POC distance, and the
+ *  predicted part is the one estimated for the previous picture. A block which serves as reference of much of the
+ *  following content gets a negative QP offset.
+ * \param poc        picture to get the offsets for
+ * \param codedAfter POCs of the pictures coded after it and their references, in coding order, all available in the lookahead
+ * \param strength   QP offset per doubling of the cost of a block by the propagated cost
+ * \param qpOffsets  returns the offsets per BLK_SIZE x BLK_SIZE block
+ */
+Void EncLookahead::getPropagationQpOffsets( const Int poc, const std::vector<std::pair<Int, std::vector<Int> > >& codedAfter, const Double strength, std::vector<Double>& qpOffsets )
+{
+  const Int iSize   = BLK_SIZE >> 1;
+  const Int numBlks = m_numBlkX * m_numBlkY;
+
+  // propagated cost per block of the pictures which can still receive it
+  std::map<Int, std::vector<Double> > propagateIn;
+  propagateIn[poc].assign( numBlks, 0.0 );
+  for( const auto& pic : codedAfter )
+  {
+    propagateIn[pic.first].assign( numBlks, 0.0 );
+  }
+
+  for( auto it = codedAfter.rbegin(); it != codedAfter.rend(); it++ )
+  {
+    const Int                   p    = it->first;
+    const std::vector<Double>&  in   = propagateIn[p];
+    const LookaheadCost&        cost = getCost( p );
+
+    // the share of the references coded before the given picture is dropped
+    std::vector<std::pair<Int, std::vector<Double>*> > refs;
+    for( const Int refPoc : it->second )
+    {
+      auto ref = propagateIn.find( refPoc );
+      if( ref != propagateIn.end() && refPoc != p )
+      {
+        refs.push_back( std::make_pair( p - refPoc, &ref->second ) );
+      }
+    }
+
+    for( Int by = 0; by < m_numBlkY && !cost.blockMv.empty() && !refs.empty(); by++ )
+    {
+      for( Int bx = 0; bx < m_numBlkX; bx++ )
+      {
+        const Int        idx         = by * m_numBlkX + bx;
+        const Distortion uiIntraCost = cost.blockIntraCost[idx];
+        const Distortion uiInterCost = cost.blockInterCost[idx];
+
+        if( uiInterCost >= uiIntraCost )
+        {
+          continue;
+        }
+
+        // the part of the block's own and propagated cost which is predicted, shared by the references
+        const Double amount = ( uiIntraCost + in[idx] ) * ( uiIntraCost - uiInterCost ) / uiIntraCost / it->second.size();
+
+        for( const auto& ref : refs )
+        {
+          // distribute it over the reference blocks covered by the displaced block, same positions as in xAnalyze()
+          const Int x  = Clip3( 0, m_lowResWidth  - iSize, std::min( bx * iSize, m_lowResWidth  - iSize ) + cost.blockMv[idx].getHor() * ref.first );
+          const Int y  = Clip3( 0, m_lowResHeight - iSize, std::min( by * iSize, m_lowResHeight - iSize ) + cost.blockMv[idx].getVer() * ref.first );
+          const Int ix = x / iSize, fx = x % iSize;
+          const Int iy = y / iSize, fy = y % iSize;
+
+          const Int aiWeight[4] = { ( iSize - fx ) * ( iSize - fy ), fx * ( iSize - fy ), ( iSize - fx ) * fy, fx * fy };
+
+          for( Int i = 0; i < 4; i++ )
+          {
+            const Int rx = ix + ( i & 1 );
+            const Int ry = iy + ( i >> 1 );
+
+            if( aiWeight[i] > 0 && rx < m_numBlkX && ry < m_numBlkY )
+            {
+              ( *ref.second )[ry * m_numBlkX + rx] += amount * aiWeight[i] / ( iSize * iSize );
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const LookaheadCost&       cost = getCost( poc );
+  const std::vector<Double>& in   = propagateIn[poc];
+
+  qpOffsets.resize( numBlks );
+
+  for( Int idx = 0; idx < numBlks; idx++ )
+  {
+    const Distortion uiIntraCost = cost.blockIntraCost[idx];
+    qpOffsets[idx] = uiIntraCost > 0 ? -strength * log2( ( uiIntraCost + in[idx] ) / uiIntraCost ) : 0.0;
+  }
+}
+
+Void EncLookahead::release( const Int poc )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  m_costs.erase( m_costs.begin(), m_costs.lower_bound( poc ) );
+  m_firstPOC = std::max( m_firstPOC, poc );
+}
+
+Void EncLookahead::xWorker()
+{
+  while( true )
+  {
+    LookaheadPic* pic = nullptr;
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      m_cond.wait( lock, [&]() { return m_stop || !m_queue.empty(); } );
+      if( m_stop )
+      {
+        return;
+      }
+      pic = m_queue.front();
+      m_queue.pop_front();
+    }
+
+    LookaheadCost cost;
+    xAnalyze( *pic, m_prevPic, cost );
+
+    if( m_prevPic )
+    {
+      m_prevPic->lowRes.destroy();
+      delete m_prevPic;
+    }
+    m_prevPic = pic;
+
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      if( pic->poc >= m_firstPOC )
+      {
+        m_costs[pic->poc] = std::move( cost );
+      }
+    }
+    m_cond.notify_all();
+  }
+}
+
+/** Cost of the best of DC, horizontal and vertical prediction from the neighbouring downsampled original samples
+ * \param cLowRes downsampled picture
+ * \param pos     top-left position of the block in the downsampled picture
+ */
+Distortion EncLookahead::xIntraCost( const CPelBuf& cLowRes, const Position& pos )
+{
+  const Int   iSize = BLK_SIZE >> 1;
+  const CPelBuf cOrg( cLowRes.bufAt( pos ), cLowRes.stride, Size( iSize, iSize ) );
+  const Pel*  pTop  = pos.y > 0 ? cLowRes.bufAt( pos.x, pos.y - 1 ) : nullptr;
+  const Pel*  pLeft = pos.x > 0 ? cLowRes.bufAt( pos.x - 1, pos.y ) : nullptr;
+
+  Pel       acPred[( BLK_SIZE >> 1 ) * ( BLK_SIZE >> 1 )];
+  DistParam cDistParam;
+
+  // DC
+  Int iSum = 0, iNum = 0;
+  for( Int i = 0; i < iSize; i++ )
+  {
+    if( pTop )
+    {
+      iSum += pTop[i];
+      iNum++;
+    }
+    if( pLeft )
+    {
+      iSum += pLeft[i * cLowRes.stride];
+      iNum++;
+    }
+  }
+  const Pel iDC = iNum ? Pel( ( iSum + ( iNum >> 1 ) ) / iNum ) : Pel( 1 << ( m_bitDepth - 1 ) );
+  std::fill_n( acPred, iSize * iSize, iDC );
+
+  m_cRdCost.setDistParam( cDistParam, cOrg, acPred, iSize, m_bitDepth, COMPONENT_Y, 0, 1, true );
+  Distortion uiCost = cDistParam.distFunc( cDistParam );
+
+  // vertical
+  if( pTop )
+  {
+    for( Int y = 0; y < iSize; y++ )
+    {
+      std::copy_n( pTop, iSize, acPred + y * iSize );
+    }
+    uiCost = std::min( uiCost, cDistParam.distFunc( cDistParam ) );
+  }
+
+  // horizontal
+  if( pLeft )
+  {
+    for( Int y = 0; y < iSize; y++ )
+    {
+      std::fill_n( acPred + y * iSize, iSize, pLeft[y * cLowRes.stride] );
+    }
+    uiCost = std::min( uiCost, cDistParam.distFunc( cDistParam ) );
+  }
+
+  return uiCost;
+}
+
+/** Cost of the prediction from the previous picture, the vector is found by a SAD diamond search
+ * \param cLowRes   downsampled picture
+ * \param cRef      downsampled previous picture
+ * \param pos       top-left position of the block in the downsampled picture
+ * \param pcCands   start candidates
+ * \param iNumCands number of start candidates
+ * \param rcMv      returns the best vector
+ */
+Distortion EncLookahead::xInterCost( const CPelBuf& cLowRes, const CPelBuf& cRef, const Position& pos, const Mv* pcCands, const Int iNumCands, Mv& rcMv )
+{
+  const Int     iSize  = BLK_SIZE >> 1;
+  const Int     iRange = 32;
+  const CPelBuf cOrg( cLowRes.bufAt( pos ), cLowRes.stride, Size( iSize, iSize ) );
+
+  const Int iMinX = std::max<Int>( -iRange, -pos.x );
+  const Int iMinY = std::max<Int>( -iRange, -pos.y );
+  const Int iMaxX = std::min<Int>(  iRange, cRef.width  - iSize - pos.x );
+  const Int iMaxY = std::min<Int>(  iRange, cRef.height - iSize - pos.y );
+
+  DistParam cDistParam;
+  m_cRdCost.setDistParam( cDistParam, cOrg, cRef.buf, cRef.stride, m_bitDepth, COMPONENT_Y, 0, 1, false );
+
+  Distortion uiBestDist = std::numeric_limits<Distortion>::max();
+
+  auto checkPoint = [&]( const Int iX, const Int iY )
+  {
+    if( iX < iMinX || iX > iMaxX || iY < iMinY || iY > iMaxY )
+    {
+      return false;
+    }
+    cDistParam.cur.buf = cRef.bufAt( pos.x + iX, pos.y + iY );
+    cDistParam.maximumDistortionForEarlyExit = uiBestDist;
+    const Distortion uiDist = cDistParam.distFunc( cDistParam );
+    if( uiDist < uiBestDist )
+    {
+      uiBestDist = uiDist;
+      rcMv.set( iX, iY );
+      return true;
+    }
+    return false;
+  };
+
+  rcMv.setZero();
+
+  for( Int i = 0; i < iNumCands; i++ )
+  {
+    checkPoint( pcCands[i].getHor(), pcCands[i].getVer() );
+  }
+
+  // small diamond refinement until the center is the best point
+  for( Int iIter = 0; iIter < iRange; iIter++ )
+  {
+    const Int iX = rcMv.getHor();
+    const Int iY = rcMv.getVer();
+
+    Bool bMoved = false;
+    bMoved |= checkPoint( iX - 1, iY );
+    bMoved |= checkPoint( iX + 1, iY );
+    bMoved |= checkPoint( iX, iY - 1 );
+    bMoved |= checkPoint( iX, iY + 1 );
+
+    if( !bMoved )
+    {
+      break;
+    }
+  }
+
+  m_cRdCost.setDistParam( cDistParam, cOrg, cRef.bufAt( pos.x + rcMv.getHor(), pos.y + rcMv.getVer() ), cRef.stride, m_bitDepth, COMPONENT_Y, 0, 1, true );
+
+  return cDistParam.distFunc( cDistParam );
+}
+
+/** Block costs of a picture and the scene cut decision
+ * \param pic     picture to analyse
+ * \param prevPic previous picture in display order, NULL for the first picture
+ * \param cost    returns the estimates
+ */
+Void EncLookahead::xAnalyze( const LookaheadPic& pic, const LookaheadPic* prevPic, LookaheadCost& cost )
+{
+  const CPelBuf cLowRes = pic.lowRes.Y();
+  const Int     iSize   = BLK_SIZE >> 1;
+
+  cost.blockIntraCost.resize( m_numBlkX * m_numBlkY, 0 );
+  cost.blockInterCost.resize( m_numBlkX * m_numBlkY, 0 );
+
+  if( cLowRes.width < iSize || cLowRes.height < iSize )
+  {
+    return;
+  }
+
+  std::vector<Mv> mvField( m_numBlkX * m_numBlkY );
+
+  for( Int by = 0; by < m_numBlkY; by++ )
+  {
+    for( Int bx = 0; bx < m_numBlkX; bx++ )
+    {
+      // blocks at the right and bottom border are shifted inside the picture
+      const Position pos( std::min<Int>( bx * iSize, cLowRes.width - iSize ), std::min<Int>( by * iSize, cLowRes.height - iSize ) );
+      const Int      idx = by * m_numBlkX + bx;
+
+      const Distortion uiIntraCost = xIntraCost( cLowRes, pos );
+      Distortion       uiInterCost = uiIntraCost;
+
+      if( prevPic )
+      {
+        Mv  acCands[4];
+        Int iNumCands = 0;
+        acCands[iNumCands++].setZero();
+        if( bx > 0 )                      acCands[iNumCands++] = mvField[idx - 1];
+        if( by > 0 )                      acCands[iNumCands++] = mvField[idx - m_numBlkX];
+        if( by > 0 && bx + 1 < m_numBlkX ) acCands[iNumCands++] = mvField[idx - m_numBlkX + 1];
+
+        uiInterCost = std::min( uiInterCost, xInterCost( cLowRes, prevPic->lowRes.Y(), pos, acCands, iNumCands, mvField[idx] ) );
+      }
+
+      cost.blockIntraCost[idx] = uiIntraCost;
+      cost.blockInterCost[idx] = uiInterCost;
+      cost.intraCost          += uiIntraCost;
+      cost.interCost          += uiInterCost;
+    }
+  }
+
+  cost.blockMv.swap( mvField );
+
+  // a picture poorly predicted from its predecessor starts a new scene
+  cost.sceneCut = m_sceneCutThreshold > 0 && prevPic && cost.interCost * 100 > Distortion( 100 - m_sceneCutThreshold ) * cost.intraCost;
+}
+
+//! \}
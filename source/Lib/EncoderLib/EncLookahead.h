@@ -0,0 +1,137 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     EncLookahead.h
+    \brief    analysis of the upcoming input pictures on downsampled luma (header)
+*/
+
+#ifndef __ENCLOOKAHEAD__
+#define __ENCLOOKAHEAD__
+
+#include "CommonLib/CommonDef.h"
+#include "CommonLib/Unit.h"
+#include "CommonLib/RdCost.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+//! \ingroup EncoderLib
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// lookahead estimates of one input picture, all costs are Hadamard costs of the 2:1 downsampled luma
+struct LookaheadCost
+{
+  Distortion              intraCost;                ///< sum of the block costs of the best of DC, horizontal and vertical prediction
+  Distortion              interCost;                ///< sum of the block costs of prediction from the previous picture, or intra where cheaper
+  Bool                    sceneCut;                 ///< picture starts a new scene
+  std::vector<Distortion> blockIntraCost;           ///< per BLK_SIZE x BLK_SIZE block of the full resolution picture
+  std::vector<Distortion> blockInterCost;
+  std::vector<Mv>         blockMv;                  ///< full-pel vectors towards the previous picture in the downsampled picture
+
+  LookaheadCost() : intraCost( 0 ), interCost( 0 ), sceneCut( false ) {}
+};
+
+/// Analyses the input pictures in display order ahead of the encoder on a worker thread. The estimates are used to
+/// place IRAP pictures at scene cuts and are available to rate control and adaptive QP.
+class EncLookahead
+{
+public:
+  static const Int BLK_SIZE   = 16;                 ///< full resolution luma block size of the block costs
+  static const Int MAX_QUEUED = 16;                 ///< pictures waiting for the analysis before addPicture() blocks
+
+private:
+  struct LookaheadPic
+  {
+    Int         poc;
+    PelStorage  lowRes;                             ///< 2:1 downsampled luma
+  };
+
+  RdCost                           m_cRdCost;
+  Int                              m_bitDepth;
+  Int                              m_sceneCutThreshold;
+  Int                              m_numBlkX;
+  Int                              m_numBlkY;
+  Int                              m_lowResWidth;
+  Int                              m_lowResHeight;
+  Int                              m_numPicsAdded;
+  Int                              m_firstPOC;       ///< first POC with estimates not yet released
+
+  std::thread                      m_worker;
+  std::mutex                       m_mutex;
+  std::condition_variable          m_cond;
+  Bool                             m_stop;
+  std::deque<LookaheadPic*>        m_queue;          ///< pictures waiting for the analysis
+  std::map<Int, LookaheadCost>     m_costs;          ///< finished analyses by POC
+  LookaheadPic*                    m_prevPic;        ///< last analysed picture, reference of the next one
+
+  Void       xWorker        ();
+  Void       xAnalyze       ( const LookaheadPic& pic, const LookaheadPic* prevPic, LookaheadCost& cost );
+  Distortion xIntraCost     ( const CPelBuf& cLowRes, const Position& pos );
+  Distortion xInterCost     ( const CPelBuf& cLowRes, const CPelBuf& cRef, const Position& pos, const Mv* pcCands, const Int iNumCands, Mv& rcMv );
+
+public:
+  EncLookahead();
+  virtual ~EncLookahead();
+
+  Void create  ( const Int width, const Int height, const Int bitDepth, const Int sceneCutThreshold );
+  Void destroy ();
+  Bool isActive() const { return m_worker.joinable(); }
+
+  /// queue the next input picture in display order, the downsampling is done in the calling thread
+  Void addPicture ( const CPelBuf& cOrgLuma );
+
+  /// estimates of a queued picture, waits for the analysis to finish
+  const LookaheadCost& getCost( const Int poc );
+
+  Bool isSceneCut ( const Int poc ) { return getCost( poc ).sceneCut; }
+
+  /// number of pictures passed to addPicture(), the POC of the last one is one less
+  Int  getNumPicsAdded() const { return m_numPicsAdded; }
+
+  /// block QP offsets of a picture from the importance of its blocks as reference of the pictures coded after it
+  Void getPropagationQpOffsets( const Int poc, const std::vector<std::pair<Int, std::vector<Int> > >& codedAfter, const Double strength, std::vector<Double>& qpOffsets );
+
+  /// drop the estimates of the pictures before the given POC
+  Void release    ( const Int poc );
+};
+
+//! \}
+
+#endif // __ENCLOOKAHEAD__
@@ -0,0 +1,202 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     EncPreanalysis.cpp
+    \brief    analysis of the original pictures for adaptive QP and weighted prediction on worker threads
+*/
+
+#include "EncPreanalysis.h"
+#include "AQp.h"
+#include "WeightPredAnalysis.h"
+
+//! \ingroup EncoderLib
+//! \{
+
+EncPreanalysis::EncPreanalysis()
+  : m_ctuHeight      ( 0 )
+  , m_useWP          ( false )
+  , m_useWPHistogram ( false )
+  , m_stop           ( false )
+{
+}
+
+EncPreanalysis::~EncPreanalysis()
+{
+  destroy();
+}
+
+/** Start the worker threads
+ * \param numThreads     number of worker threads, 0 to analyse in the thread adding the pictures
+ * \param ctuHeight      luma height of the CTU rows of the adaptive QP analysis
+ * \param useWP          compute the statistics of weighted prediction
+ * \param useWPHistogram compute the histograms of weighted prediction
+ */
+Void EncPreanalysis::create( const Int numThreads, const Int ctuHeight, const Bool useWP, const Bool useWPHistogram )
+{
+  destroy();
+
+  m_ctuHeight      = ctuHeight;
+  m_useWP          = useWP;
+  m_useWPHistogram = useWP && useWPHistogram;
+  m_stop           = false;
+
+  for( Int i = 0; i < numThreads; i++ )
+  {
+    m_workers.push_back( std::thread( &EncPreanalysis::xWorker, this ) );
+  }
+}
+
+Void EncPreanalysis::destroy()
+{
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_stop = true;
+  }
+  m_taskCond.notify_all();
+
+  for( auto& worker : m_workers )
+  {
+    worker.join();
+  }
+  m_workers.clear();
+  m_tasks.clear();
+  m_numPendingTasks.clear();
+}
+
+Void EncPreanalysis::addPicture( Picture* pic )
+{
+  std::vector<Task> tasks;
+  if( !pic->aqlayer.empty() )
+  {
+    const Int numCtuRows = ( pic->getOrigBuf().Y().height + m_ctuHeight - 1 ) / m_ctuHeight;
+    for( Int ctuRow = 0; ctuRow < numCtuRows; ctuRow++ )
+    {
+      tasks.push_back( Task{ pic, ctuRow } );
+    }
+  }
+  if( m_useWP )
+  {
+    tasks.push_back( Task{ pic, -1 } );
+  }
+
+  if( tasks.empty() )
+  {
+    return;
+  }
+
+  if( m_workers.empty() )
+  {
+    for( const auto& task : tasks )
+    {
+      xRunTask( task );
+    }
+    if( !pic->aqlayer.empty() )
+    {
+      AQpPreanalyzer::finishPreanalysis( pic );
+    }
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    CHECK( m_numPendingTasks.find( pic ) != m_numPendingTasks.end(), "Picture added twice to the pre-analysis" );
+    m_numPendingTasks[pic] = Int( tasks.size() );
+    m_tasks.insert( m_tasks.end(), tasks.begin(), tasks.end() );
+  }
+  m_taskCond.notify_all();
+}
+
+Void EncPreanalysis::waitPicture( Picture* pic )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  m_doneCond.wait( lock, [&]() { return m_numPendingTasks.find( pic ) == m_numPendingTasks.end(); } );
+}
+
+Void EncPreanalysis::xWorker()
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+
+  while( true )
+  {
+    m_taskCond.wait( lock, [&]() { return m_stop || !m_tasks.empty(); } );
+    if( m_stop )
+    {
+      return;
+    }
+
+    const Task task = m_tasks.front();
+    m_tasks.pop_front();
+
+    lock.unlock();
+    xRunTask( task );
+    lock.lock();
+
+    if( --m_numPendingTasks[task.pic] == 0 )
+    {
+      // the last task of the picture, all activities are known
+      if( !task.pic->aqlayer.empty() )
+      {
+        lock.unlock();
+        AQpPreanalyzer::finishPreanalysis( task.pic );
+        lock.lock();
+      }
+      m_numPendingTasks.erase( task.pic );
+      m_doneCond.notify_all();
+    }
+  }
+}
+
+Void EncPreanalysis::xRunTask( const Task& task )
+{
+  if( task.ctuRow >= 0 )
+  {
+    AQpPreanalyzer::preanalyzeArea( task.pic, task.ctuRow * m_ctuHeight, ( task.ctuRow + 1 ) * m_ctuHeight );
+  }
+  else
+  {
+    WeightPredAnalysis::xCalcACDCParamPicture( task.pic );
+    if( m_useWPHistogram )
+    {
+      WeightPredAnalysis::xCalcHistogramPicture( task.pic );
+    }
+    else
+    {
+      for( auto& histogram : task.pic->orgHistogram )
+      {
+        histogram.clear();
+      }
+    }
+  }
+}
+
+//! \}
@@ -0,0 +1,100 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     EncPreanalysis.h
+    \brief    analysis of the original pictures for adaptive QP and weighted prediction on worker threads (header)
+*/
+
+#ifndef __ENCPREANALYSIS__
+#define __ENCPREANALYSIS__
+
+#include "CommonLib/CommonDef.h"
+#include "CommonLib/Picture.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+//! \ingroup EncoderLib
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// Computes the activities of the adaptive QP and the reference independent weighted prediction statistics of the
+/// original pictures. The pictures are analysed as they are received by the encoder, which runs several pictures ahead
+/// of the coding, so that the analysis is off the coding thread. The adaptive QP analysis is split into CTU rows.
+class EncPreanalysis
+{
+private:
+  struct Task
+  {
+    Picture*  pic;
+    Int       ctuRow;                               ///< CTU row of the adaptive QP analysis, -1 for the weighted prediction analysis
+  };
+
+  Int                              m_ctuHeight;
+  Bool                             m_useWP;
+  Bool                             m_useWPHistogram;
+
+  std::vector<std::thread>         m_workers;
+  std::mutex                       m_mutex;
+  std::condition_variable          m_taskCond;       ///< signals new tasks or the stop of the workers
+  std::condition_variable          m_doneCond;       ///< signals finished pictures
+  Bool                             m_stop;
+  std::deque<Task>                 m_tasks;
+  std::map<Picture*, Int>          m_numPendingTasks; ///< unfinished tasks by picture
+
+  Void xWorker  ();
+  Void xRunTask ( const Task& task );
+
+public:
+  EncPreanalysis();
+  virtual ~EncPreanalysis();
+
+  Void create  ( const Int numThreads, const Int ctuHeight, const Bool useWP, const Bool useWPHistogram );
+  Void destroy ();
+
+  /// start the analysis of a received original picture, without worker threads it is done in the calling thread
+  Void addPicture ( Picture* pic );
+
+  /// wait until the analysis of a picture is finished, must be called before the picture is coded
+  Void waitPicture( Picture* pic );
+};
+
+//! \}
+
+#endif // __ENCPREANALYSIS__
@@ -235,11 +235,11 @@ Void EncSlice::initEncSlice( Picture* pcPic, const Int pocLast, const Int pocCur
   {
     if(m_pcCfg->getDecodingRefreshType() == 3)
     {
-      eSliceType = (pocLast == 0 || pocCurr % m_pcCfg->getIntraPeriod() == 0             || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+      eSliceType = (pocLast == 0 || pocCurr % m_pcCfg->getIntraPeriod() == 0             || m_pcGOPEncoder->isSceneCutIntra(pocCurr) || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
     }
     else
     {
-      eSliceType = (pocLast == 0 || (pocCurr - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+      eSliceType = (pocLast == 0 || (pocCurr - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->isSceneCutIntra(pocCurr) || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
     }
   }
 
@@ -457,11 +457,11 @@ Void EncSlice::initEncSlice( Picture* pcPic, const Int pocLast, const Int pocCur
     {
       if(m_pcCfg->getDecodingRefreshType() == 3)
       {
-        eSliceType = (pocLast == 0 || (pocCurr)                     % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+        eSliceType = (pocLast == 0 || (pocCurr)                     % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->isSceneCutIntra(pocCurr) || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
       }
       else
       {
-        eSliceType = (pocLast == 0 || (pocCurr - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+        eSliceType = (pocLast == 0 || (pocCurr - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->isSceneCutIntra(pocCurr) || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
       }
     }
 
@@ -889,13 +889,19 @@ Void EncSlice::compressSlice( Picture* pcPic, const Bool bCompressEntireSlice, c
   m_pcCuEncoder->getModeCtrl()->setFastDeltaQp(bFastDeltaQP);
   m_pcCuEncoder->getModeCtrl()->initSlice( *pcSlice );
 
+  // coarse motion pre-pass providing start points for the integer motion search
+  if( m_pcCfg->getUseHierarchicalME() && !pcSlice->isIntra() )
+  {
+    m_pcInterSearch->getHierarchicalME().estimate( *pcSlice );
+  }
+
   //------------------------------------------------------------------------------
   //  Weighted Prediction parameters estimation.
   //------------------------------------------------------------------------------
-  // calculate AC/DC values for current picture
+  // AC/DC values for current picture, computed by the pre-analysis
   if( pcSlice->getPPS()->getUseWP() || pcSlice->getPPS()->getWPBiPred() )
   {
-    xCalcACDCParamSlice(pcSlice);
+    pcSlice->setWpAcDcParam( pcSlice->getPic()->wpAcDcParam );
   }
 
   const Bool bWp_explicit = (pcSlice->getSliceType()==P_SLICE && pcSlice->getPPS()->getUseWP()) || (pcSlice->getSliceType()==B_SLICE && pcSlice->getPPS()->getWPBiPred());
@@ -46,6 +46,7 @@
 #include "CommonLib/dtrace_next.h"
 #include "CommonLib/dtrace_buffer.h"
 #include "CommonLib/BilateralFilter.h"
+#include "CommonLib/Profiler.h"
 
 
 #include "EncModeCtrl.h"
@@ -125,6 +126,8 @@ Void InterSearch::destroy()
 
   m_pSaveCS = nullptr;
 
+  m_cHierarchicalME.destroy();
+
   for(UInt i = 0; i < NUM_REF_PIC_LIST_01; i++)
   {
     m_tmpPredStorage[i].destroy();
@@ -188,6 +191,8 @@ Void InterSearch::init( EncCfg*        pcEncCfg,
   m_CABACEstimator               = CABACEstimator;
   m_CtxCache                     = ctxCache;
 
+  m_cHierarchicalME.init( pcRdCost, iSearchRange );
+
   for( UInt iDir = 0; iDir < MAX_NUM_REF_LIST_ADAPT_SR; iDir++ )
   {
     for( UInt iRefIdx = 0; iRefIdx < MAX_IDX_ADAPT_SR; iRefIdx++ )
@@ -233,7 +238,7 @@ Void InterSearch::init( EncCfg*        pcEncCfg,
 }
 
 
-inline Void InterSearch::xTZSearchHelp( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
+inline Void InterSearch::xTZSearchHelp( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance, const Distortion* puiSad )
 {
   Distortion  uiSad = 0;
 
@@ -251,7 +256,7 @@ inline Void InterSearch::xTZSearchHelp( IntTZSearchStruct& rcStruct, const Int i
     // Skip search if bit cost is already larger than best SAD
     if (uiBitCost < rcStruct.uiBestSad)
     {
-      Distortion uiTempSad = m_cDistParam.distFunc( m_cDistParam );
+      Distortion uiTempSad = puiSad ? *puiSad : m_cDistParam.distFunc( m_cDistParam );
 
       if((uiTempSad + uiBitCost) < rcStruct.uiBestSad)
       {
@@ -300,7 +305,7 @@ inline Void InterSearch::xTZSearchHelp( IntTZSearchStruct& rcStruct, const Int i
   }
   else
   {
-    uiSad = m_cDistParam.distFunc( m_cDistParam );
+    uiSad = puiSad ? *puiSad : m_cDistParam.distFunc( m_cDistParam );
 
     // only add motion cost if uiSad is smaller than best. Otherwise pointless
     // to add motion cost.
@@ -323,6 +328,56 @@ inline Void InterSearch::xTZSearchHelp( IntTZSearchStruct& rcStruct, const Int i
   }
 }
 
+// queues a search point; the distortion of up to four queued points is computed by one
+// call of the multi-candidate distortion function. The points are then checked in queuing
+// order, so the search result is identical to calling xTZSearchHelp for each of them.
+inline Void InterSearch::xTZSearchHelpX4( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
+{
+  const Int n = rcStruct.iNumCand++;
+
+  rcStruct.aiCandX       [n] = iSearchX;
+  rcStruct.aiCandY       [n] = iSearchY;
+  rcStruct.aucCandPointNr[n] = ucPointNr;
+  rcStruct.auiCandDist   [n] = uiDistance;
+
+  if( rcStruct.iNumCand == 4 )
+  {
+    xTZSearchFlushX4( rcStruct );
+  }
+}
+
+inline Void InterSearch::xTZSearchFlushX4( IntTZSearchStruct& rcStruct )
+{
+  const Int iNumCand = rcStruct.iNumCand;
+  rcStruct.iNumCand  = 0;
+
+  if( iNumCand <= 1 )
+  {
+    if( iNumCand == 1 )
+    {
+      xTZSearchHelp( rcStruct, rcStruct.aiCandX[0], rcStruct.aiCandY[0], rcStruct.aucCandPointNr[0], rcStruct.auiCandDist[0] );
+    }
+    return;
+  }
+
+  const Pel* apCur[4];
+  Distortion auiSad[4];
+
+  for( Int i = 0; i < 4; i++ )
+  {
+    // unused slots repeat the first point
+    const Int j = i < iNumCand ? i : 0;
+    apCur[i] = rcStruct.piRefY + rcStruct.aiCandY[j] * rcStruct.iRefStride + rcStruct.aiCandX[j];
+  }
+
+  m_cDistParam.distFuncX4( m_cDistParam, apCur, auiSad );
+
+  for( Int i = 0; i < iNumCand; i++ )
+  {
+    xTZSearchHelp( rcStruct, rcStruct.aiCandX[i], rcStruct.aiCandY[i], rcStruct.aucCandPointNr[i], rcStruct.auiCandDist[i], &auiSad[i] );
+  }
+}
+
 
 
 inline Void InterSearch::xTZ2PointSearch( IntTZSearchStruct& rcStruct )
@@ -343,13 +398,15 @@ inline Void InterSearch::xTZ2PointSearch( IntTZSearchStruct& rcStruct )
 
   if( iX1 >= sr.left && iX1 <= sr.right && iY1 >= sr.top && iY1 <= sr.bottom )
   {
-    xTZSearchHelp( rcStruct, iX1, iY1, 0, 2 );
+    xTZSearchHelpX4( rcStruct, iX1, iY1, 0, 2 );
   }
 
   if( iX2 >= sr.left && iX2 <= sr.right && iY2 >= sr.top && iY2 <= sr.bottom )
   {
-    xTZSearchHelp( rcStruct, iX2, iY2, 0, 2 );
+    xTZSearchHelpX4( rcStruct, iX2, iY2, 0, 2 );
   }
+
+  xTZSearchFlushX4( rcStruct );
 }
 
 
@@ -370,38 +427,40 @@ inline Void InterSearch::xTZ8PointSquareSearch( IntTZSearchStruct& rcStruct, con
   {
     if ( iLeft >= sr.left ) // check top left
     {
-      xTZSearchHelp( rcStruct, iLeft, iTop, 1, iDist );
+      xTZSearchHelpX4( rcStruct, iLeft, iTop, 1, iDist );
     }
     // top middle
-    xTZSearchHelp( rcStruct, iStartX, iTop, 2, iDist );
+    xTZSearchHelpX4( rcStruct, iStartX, iTop, 2, iDist );
 
     if ( iRight <= sr.right ) // check top right
     {
-      xTZSearchHelp( rcStruct, iRight, iTop, 3, iDist );
+      xTZSearchHelpX4( rcStruct, iRight, iTop, 3, iDist );
     }
   } // check top
   if ( iLeft >= sr.left ) // check middle left
   {
-    xTZSearchHelp( rcStruct, iLeft, iStartY, 4, iDist );
+    xTZSearchHelpX4( rcStruct, iLeft, iStartY, 4, iDist );
   }
   if ( iRight <= sr.right ) // check middle right
   {
-    xTZSearchHelp( rcStruct, iRight, iStartY, 5, iDist );
+    xTZSearchHelpX4( rcStruct, iRight, iStartY, 5, iDist );
   }
   if ( iBottom <= sr.bottom ) // check bottom
   {
     if ( iLeft >= sr.left ) // check bottom left
     {
-      xTZSearchHelp( rcStruct, iLeft, iBottom, 6, iDist );
+      xTZSearchHelpX4( rcStruct, iLeft, iBottom, 6, iDist );
     }
     // check bottom middle
-    xTZSearchHelp( rcStruct, iStartX, iBottom, 7, iDist );
+    xTZSearchHelpX4( rcStruct, iStartX, iBottom, 7, iDist );
 
     if ( iRight <= sr.right ) // check bottom right
     {
-      xTZSearchHelp( rcStruct, iRight, iBottom, 8, iDist );
+      xTZSearchHelpX4( rcStruct, iRight, iBottom, 8, iDist );
     }
   } // check bottom
+
+  xTZSearchFlushX4( rcStruct );
 }
 
 
@@ -432,26 +491,26 @@ inline Void InterSearch::xTZ8PointDiamondSearch( IntTZSearchStruct& rcStruct,
       {
         if ( iLeft >= sr.left) // check top-left
         {
-          xTZSearchHelp( rcStruct, iLeft, iTop, 1, iDist );
+          xTZSearchHelpX4( rcStruct, iLeft, iTop, 1, iDist );
         }
-        xTZSearchHelp( rcStruct, iStartX, iTop, 2, iDist );
+        xTZSearchHelpX4( rcStruct, iStartX, iTop, 2, iDist );
         if ( iRight <= sr.right ) // check middle right
         {
-          xTZSearchHelp( rcStruct, iRight, iTop, 3, iDist );
+          xTZSearchHelpX4( rcStruct, iRight, iTop, 3, iDist );
         }
       }
       else
       {
-        xTZSearchHelp( rcStruct, iStartX, iTop, 2, iDist );
+        xTZSearchHelpX4( rcStruct, iStartX, iTop, 2, iDist );
       }
     }
     if ( iLeft >= sr.left ) // check middle left
     {
-      xTZSearchHelp( rcStruct, iLeft, iStartY, 4, iDist );
+      xTZSearchHelpX4( rcStruct, iLeft, iStartY, 4, iDist );
     }
     if ( iRight <= sr.right ) // check middle right
     {
-      xTZSearchHelp( rcStruct, iRight, iStartY, 5, iDist );
+      xTZSearchHelpX4( rcStruct, iRight, iStartY, 5, iDist );
     }
     if ( iBottom <= sr.bottom ) // check bottom
     {
@@ -459,17 +518,17 @@ inline Void InterSearch::xTZ8PointDiamondSearch( IntTZSearchStruct& rcStruct,
       {
         if ( iLeft >= sr.left) // check top-left
         {
-          xTZSearchHelp( rcStruct, iLeft, iBottom, 6, iDist );
+          xTZSearchHelpX4( rcStruct, iLeft, iBottom, 6, iDist );
         }
-        xTZSearchHelp( rcStruct, iStartX, iBottom, 7, iDist );
+        xTZSearchHelpX4( rcStruct, iStartX, iBottom, 7, iDist );
         if ( iRight <= sr.right ) // check middle right
         {
-          xTZSearchHelp( rcStruct, iRight, iBottom, 8, iDist );
+          xTZSearchHelpX4( rcStruct, iRight, iBottom, 8, iDist );
         }
       }
       else
       {
-        xTZSearchHelp( rcStruct, iStartX, iBottom, 7, iDist );
+        xTZSearchHelpX4( rcStruct, iStartX, iBottom, 7, iDist );
       }
     }
   }
@@ -485,54 +544,54 @@ inline Void InterSearch::xTZ8PointDiamondSearch( IntTZSearchStruct& rcStruct,
       if (  iTop >= sr.top && iLeft >= sr.left &&
            iRight <= sr.right && iBottom <= sr.bottom ) // check border
       {
-        xTZSearchHelp( rcStruct, iStartX,  iTop,      2, iDist    );
-        xTZSearchHelp( rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
-        xTZSearchHelp( rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
-        xTZSearchHelp( rcStruct, iLeft,    iStartY,   4, iDist    );
-        xTZSearchHelp( rcStruct, iRight,   iStartY,   5, iDist    );
-        xTZSearchHelp( rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
-        xTZSearchHelp( rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
-        xTZSearchHelp( rcStruct, iStartX,  iBottom,   7, iDist    );
+        xTZSearchHelpX4( rcStruct, iStartX,  iTop,      2, iDist    );
+        xTZSearchHelpX4( rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
+        xTZSearchHelpX4( rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
+        xTZSearchHelpX4( rcStruct, iLeft,    iStartY,   4, iDist    );
+        xTZSearchHelpX4( rcStruct, iRight,   iStartY,   5, iDist    );
+        xTZSearchHelpX4( rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
+        xTZSearchHelpX4( rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
+        xTZSearchHelpX4( rcStruct, iStartX,  iBottom,   7, iDist    );
       }
       else // check border
       {
         if ( iTop >= sr.top ) // check top
         {
-          xTZSearchHelp( rcStruct, iStartX, iTop, 2, iDist );
+          xTZSearchHelpX4( rcStruct, iStartX, iTop, 2, iDist );
         }
         if ( iTop_2 >= sr.top ) // check half top
         {
           if ( iLeft_2 >= sr.left ) // check half left
           {
-            xTZSearchHelp( rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
+            xTZSearchHelpX4( rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
           }
           if ( iRight_2 <= sr.right ) // check half right
           {
-            xTZSearchHelp( rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
+            xTZSearchHelpX4( rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
           }
         } // check half top
         if ( iLeft >= sr.left ) // check left
         {
-          xTZSearchHelp( rcStruct, iLeft, iStartY, 4, iDist );
+          xTZSearchHelpX4( rcStruct, iLeft, iStartY, 4, iDist );
         }
         if ( iRight <= sr.right ) // check right
         {
-          xTZSearchHelp( rcStruct, iRight, iStartY, 5, iDist );
+          xTZSearchHelpX4( rcStruct, iRight, iStartY, 5, iDist );
         }
         if ( iBottom_2 <= sr.bottom ) // check half bottom
         {
           if ( iLeft_2 >= sr.left ) // check half left
           {
-            xTZSearchHelp( rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
+            xTZSearchHelpX4( rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
           }
           if ( iRight_2 <= sr.right ) // check half right
           {
-            xTZSearchHelp( rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
+            xTZSearchHelpX4( rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
           }
         } // check half bottom
         if ( iBottom <= sr.bottom ) // check bottom
         {
-          xTZSearchHelp( rcStruct, iStartX, iBottom, 7, iDist );
+          xTZSearchHelpX4( rcStruct, iStartX, iBottom, 7, iDist );
         }
       } // check border
     }
@@ -541,39 +600,39 @@ inline Void InterSearch::xTZ8PointDiamondSearch( IntTZSearchStruct& rcStruct,
       if ( iTop >= sr.top && iLeft >= sr.left &&
            iRight <= sr.right && iBottom <= sr.bottom ) // check border
       {
-        xTZSearchHelp( rcStruct, iStartX, iTop,    0, iDist );
-        xTZSearchHelp( rcStruct, iLeft,   iStartY, 0, iDist );
-        xTZSearchHelp( rcStruct, iRight,  iStartY, 0, iDist );
-        xTZSearchHelp( rcStruct, iStartX, iBottom, 0, iDist );
+        xTZSearchHelpX4( rcStruct, iStartX, iTop,    0, iDist );
+        xTZSearchHelpX4( rcStruct, iLeft,   iStartY, 0, iDist );
+        xTZSearchHelpX4( rcStruct, iRight,  iStartY, 0, iDist );
+        xTZSearchHelpX4( rcStruct, iStartX, iBottom, 0, iDist );
         for ( Int index = 1; index < 4; index++ )
         {
           const Int iPosYT = iTop    + ((iDist>>2) * index);
           const Int iPosYB = iBottom - ((iDist>>2) * index);
           const Int iPosXL = iStartX - ((iDist>>2) * index);
           const Int iPosXR = iStartX + ((iDist>>2) * index);
-          xTZSearchHelp( rcStruct, iPosXL, iPosYT, 0, iDist );
-          xTZSearchHelp( rcStruct, iPosXR, iPosYT, 0, iDist );
-          xTZSearchHelp( rcStruct, iPosXL, iPosYB, 0, iDist );
-          xTZSearchHelp( rcStruct, iPosXR, iPosYB, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iPosXL, iPosYT, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iPosXR, iPosYT, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iPosXL, iPosYB, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iPosXR, iPosYB, 0, iDist );
         }
       }
       else // check border
       {
         if ( iTop >= sr.top ) // check top
         {
-          xTZSearchHelp( rcStruct, iStartX, iTop, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iStartX, iTop, 0, iDist );
         }
         if ( iLeft >= sr.left ) // check left
         {
-          xTZSearchHelp( rcStruct, iLeft, iStartY, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iLeft, iStartY, 0, iDist );
         }
         if ( iRight <= sr.right ) // check right
         {
-          xTZSearchHelp( rcStruct, iRight, iStartY, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iRight, iStartY, 0, iDist );
         }
         if ( iBottom <= sr.bottom ) // check bottom
         {
-          xTZSearchHelp( rcStruct, iStartX, iBottom, 0, iDist );
+          xTZSearchHelpX4( rcStruct, iStartX, iBottom, 0, iDist );
         }
         for ( Int index = 1; index < 4; index++ )
         {
@@ -586,44 +645,51 @@ inline Void InterSearch::xTZ8PointDiamondSearch( IntTZSearchStruct& rcStruct,
           {
             if ( iPosXL >= sr.left ) // check left
             {
-              xTZSearchHelp( rcStruct, iPosXL, iPosYT, 0, iDist );
+              xTZSearchHelpX4( rcStruct, iPosXL, iPosYT, 0, iDist );
             }
             if ( iPosXR <= sr.right ) // check right
             {
-              xTZSearchHelp( rcStruct, iPosXR, iPosYT, 0, iDist );
+              xTZSearchHelpX4( rcStruct, iPosXR, iPosYT, 0, iDist );
             }
           } // check top
           if ( iPosYB <= sr.bottom ) // check bottom
           {
             if ( iPosXL >= sr.left ) // check left
             {
-              xTZSearchHelp( rcStruct, iPosXL, iPosYB, 0, iDist );
+              xTZSearchHelpX4( rcStruct, iPosXL, iPosYB, 0, iDist );
             }
             if ( iPosXR <= sr.right ) // check right
             {
-              xTZSearchHelp( rcStruct, iPosXR, iPosYB, 0, iDist );
+              xTZSearchHelpX4( rcStruct, iPosXR, iPosYB, 0, iDist );
             }
           } // check bottom
         } // for ...
       } // check border
     } // iDist <= 8
   } // iDist == 1
+
+  xTZSearchFlushX4( rcStruct );
 }
 
 Distortion InterSearch::xPatternRefinement( const CPelBuf* pcPatternKey,
                                             Mv baseRefMv,
                                             Int iFrac, Mv& rcMvFrac,
-                                            Bool bAllowUseOfHadamard )
+                                            Bool bAllowUseOfHadamard,
+                                            const Pel* apcSubPelRef[4][4],
+                                            Int iSubPelStride )
 {
   Distortion  uiDist;
   Distortion  uiDistBest  = std::numeric_limits<Distortion>::max();
   UInt        uiDirecBest = 0;
 
-  Pel*  piRefPos;
-  Int iRefStride = pcPatternKey->width + 1;
-  m_pcRdCost->setDistParam( m_cDistParam, *pcPatternKey, m_filteredBlock[0][0][0], iRefStride, m_lumaClpRng.bd, COMPONENT_Y, 0, 1, m_pcEncCfg->getUseHADME() && bAllowUseOfHadamard );
+  const Pel* piRefPos;
+  Int iRefStride = apcSubPelRef ? iSubPelStride : pcPatternKey->width + 1;
+  m_pcRdCost->setDistParam( m_cDistParam, *pcPatternKey, apcSubPelRef ? apcSubPelRef[0][0] : m_filteredBlock[0][0][0], iRefStride, m_lumaClpRng.bd, COMPONENT_Y, 0, 1, m_pcEncCfg->getUseHADME() && bAllowUseOfHadamard );
 
   const Mv* pcMvRefine = (iFrac == 2 ? s_acMvRefineH : s_acMvRefineQ);
+  const Pel* apRefPos[9];
+  Distortion auiDist [9];
+
   for (UInt i = 0; i < 9; i++)
   {
     Mv cMvTest = pcMvRefine[i];
@@ -631,6 +697,14 @@ Distortion InterSearch::xPatternRefinement( const CPelBuf* pcPatternKey,
 
     Int horVal = cMvTest.getHor() * iFrac;
     Int verVal = cMvTest.getVer() * iFrac;
+
+    if( apcSubPelRef )
+    {
+      // full-picture planes: the integer part of the offset addresses the sample directly
+      apRefPos[i] = apcSubPelRef[verVal & 3][horVal & 3] + ( verVal >> 2 ) * iRefStride + ( horVal >> 2 );
+      continue;
+    }
+
     piRefPos = m_filteredBlock[verVal & 3][horVal & 3][0];
 
     if (horVal == 2 && (verVal & 1) == 0)
@@ -641,19 +715,27 @@ Distortion InterSearch::xPatternRefinement( const CPelBuf* pcPatternKey,
     {
       piRefPos += iRefStride;
     }
-    cMvTest = pcMvRefine[i];
-    cMvTest += rcMvFrac;
+    apRefPos[i] = piRefPos;
+  }
 
+  // distortion of the first 8 refinement positions in groups of four
+  m_cDistParam.distFuncX4( m_cDistParam, &apRefPos[0], &auiDist[0] );
+  m_cDistParam.distFuncX4( m_cDistParam, &apRefPos[4], &auiDist[4] );
+  m_cDistParam.cur.buf = apRefPos[8];
+  auiDist[8]           = m_cDistParam.distFunc( m_cDistParam );
 
-    m_cDistParam.cur.buf   = piRefPos;
-    uiDist = m_cDistParam.distFunc( m_cDistParam );
+  for (UInt i = 0; i < 9; i++)
+  {
+    Mv cMvTest = pcMvRefine[i];
+    cMvTest += rcMvFrac;
+
+    uiDist = auiDist[i];
     uiDist += m_pcRdCost->getCostOfVectorWithPredictor( cMvTest.getHor(), cMvTest.getVer(), 0 );
 
     if ( uiDist < uiDistBest )
     {
       uiDistBest  = uiDist;
       uiDirecBest = i;
-      m_cDistParam.maximumDistortionForEarlyExit = uiDist;
     }
   }
 
@@ -1618,6 +1700,8 @@ Distortion InterSearch::xGetAffineTemplateCost( PredictionUnit& pu, PelUnitBuf&
 
 Void InterSearch::xMotionEstimation(PredictionUnit& pu, PelUnitBuf& origBuf, RefPicList eRefPicList, Mv& rcMvPred, Int iRefIdxPred, Mv& rcMv, Int& riMVPIdx, UInt& ruiBits, Distortion& ruiCost, const AMVPInfo& amvpInfo, Bool bBi)
 {
+  PROFILE_SCOPE_SIZE( PROF_ENC_MOTION_ESTIMATION, pu.lwidth(), pu.lheight() );
+
   Mv cMvHalf, cMvQter;
 
   CHECK(eRefPicList >= MAX_NUM_REF_LIST_ADAPT_SR || iRefIdxPred>=Int(MAX_IDX_ADAPT_SR), "Invalid reference picture list");
@@ -1657,6 +1741,10 @@ Void InterSearch::xMotionEstimation(PredictionUnit& pu, PelUnitBuf& origBuf, Ref
   cStruct.iRefStride    = buf.stride;
   cStruct.piRefY        = buf.buf;
   cStruct.imvShift      = pu.cu->imv << 1;
+  cStruct.iNumCand      = 0;
+  cStruct.pcRefPic      = m_pcEncCfg->getSubPelMECache() && pu.cu->slice->getRefPic( eRefPicList, iRefIdxPred )->hasSubPelBuffers() ? pu.cu->slice->getRefPic( eRefPicList, iRefIdxPred ) : nullptr;
+  cStruct.cBlkPos       = pu.Y().pos();
+  cStruct.bHierMv       = m_pcEncCfg->getUseHierarchicalME() && m_cHierarchicalME.getMv( *pu.cu->slice, eRefPicList, iRefIdxPred, pu.Y().center(), cStruct.cHierMv );
 
   bool bQTBTMV  = false;
   bool bQTBTMV2 = false;
@@ -1732,7 +1820,10 @@ Void InterSearch::xMotionEstimation(PredictionUnit& pu, PelUnitBuf& origBuf, Ref
   // sub-pel refinement for sub-pel resolution
   if( pu.cu->imv == 0 )
   {
-    xPatternSearchFracDIF( pu.cu->transQuantBypass, cStruct, rcMv, cMvHalf, cMvQter, ruiCost );
+    {
+      PROFILE_SCOPE_SIZE( PROF_ENC_FRAC_SEARCH, pu.lwidth(), pu.lheight() );
+      xPatternSearchFracDIF( pu.cu->transQuantBypass, cStruct, rcMv, cMvHalf, cMvQter, ruiCost );
+    }
     m_pcRdCost->setCostScale( 0 );
     rcMv <<= 2;
     rcMv  += ( cMvHalf <<= 1 );
@@ -1926,11 +2017,30 @@ Void InterSearch::xTZSearch( const PredictionUnit& pu,
       xTZSearchHelp( cStruct, integerMv2Nx2NPred.getHor(), integerMv2Nx2NPred.getVer(), 0, 0);
     }
   }
+
+  if( cStruct.bHierMv )
+  {
+    Mv cHierMv = cStruct.cHierMv;
+    cHierMv <<= 2;
+    clipMv( cHierMv, pu.cu->lumaPos(), *pu.cs->sps );
+    cHierMv.divideByPowerOf2( 2 );
+
+    if( cHierMv.getHor() != cStruct.iBestX || cHierMv.getVer() != cStruct.iBestY )
+    {
+      xTZSearchHelp( cStruct, cHierMv.getHor(), cHierMv.getVer(), 0, 0 );
+    }
+
+    // the coarse search already covered the large displacements
+    if( m_pcEncCfg->getHierarchicalMESearchRange() > 0 )
+    {
+      iSearchRange = std::min( iSearchRange, m_pcEncCfg->getHierarchicalMESearchRange() );
+    }
+  }
   {
     // set search range
     Mv currBestMv(cStruct.iBestX, cStruct.iBestY );
     currBestMv <<= 2;
-    xSetSearchRange( pu, currBestMv, m_iSearchRange>>(bFastSettings?1:0), sr );
+    xSetSearchRange( pu, currBestMv, iSearchRange>>(bFastSettings?1:0), sr );
   }
 
   // start search
@@ -2024,9 +2134,10 @@ Void InterSearch::xTZSearch( const PredictionUnit& pu,
     {
       for ( iStartX = localsr.left; iStartX <= localsr.right; iStartX += iWindowSize )
       {
-        xTZSearchHelp( cStruct, iStartX, iStartY, 0, iWindowSize );
+        xTZSearchHelpX4( cStruct, iStartX, iStartY, 0, iWindowSize );
       }
     }
+    xTZSearchFlushX4( cStruct );
   }
   else
   {
@@ -2037,9 +2148,10 @@ Void InterSearch::xTZSearch( const PredictionUnit& pu,
       {
         for ( iStartX = sr.left; iStartX <= sr.right; iStartX += iRaster )
         {
-          xTZSearchHelp( cStruct, iStartX, iStartY, 0, iRaster );
+          xTZSearchHelpX4( cStruct, iStartX, iStartY, 0, iRaster );
         }
       }
+      xTZSearchFlushX4( cStruct );
     }
   }
 
@@ -2133,7 +2245,7 @@ Void InterSearch::xTZSearchSelective( const PredictionUnit& pu,
   const Bool bStarRefinementDiamond   = true;   // 1 = xTZ8PointDiamondSearch   0 = xTZ8PointSquareSearch
   const Bool bStarRefinementStop      = false;
   const UInt uiStarRefinementRounds   = 2;  // star refinement stop X rounds after best match (must be >=1)
-  const Int  iSearchRange             = m_iSearchRange;
+  Int        iSearchRange             = m_iSearchRange;
   const Int  iSearchRangeInitial      = m_iSearchRange >> 2;
   const Int  uiSearchStep             = 4;
   const Int  iMVDistThresh            = 8;
@@ -2176,11 +2288,27 @@ Void InterSearch::xTZSearchSelective( const PredictionUnit& pu,
     xTZSearchHelp( cStruct, integerMv2Nx2NPred.getHor(), integerMv2Nx2NPred.getVer(), 0, 0);
 
   }
+
+  if( cStruct.bHierMv )
+  {
+    Mv cHierMv = cStruct.cHierMv;
+    cHierMv <<= 2;
+    clipMv( cHierMv, pu.cu->lumaPos(), *pu.cs->sps );
+    cHierMv.divideByPowerOf2( 2 );
+
+    xTZSearchHelp( cStruct, cHierMv.getHor(), cHierMv.getVer(), 0, 0 );
+
+    // the coarse search already covered the large displacements
+    if( m_pcEncCfg->getHierarchicalMESearchRange() > 0 )
+    {
+      iSearchRange = std::min( iSearchRange, m_pcEncCfg->getHierarchicalMESearchRange() );
+    }
+  }
   {
     // set search range
     Mv currBestMv(cStruct.iBestX, cStruct.iBestY );
     currBestMv <<= 2;
-    xSetSearchRange( pu, currBestMv, m_iSearchRange, sr );
+    xSetSearchRange( pu, currBestMv, iSearchRange, sr );
   }
 
   // Initial search
@@ -2210,9 +2338,10 @@ Void InterSearch::xTZSearchSelective( const PredictionUnit& pu,
     {
       for ( iStartX = sr.left; iStartX <= sr.right; iStartX += 1 )
       {
-        xTZSearchHelp( cStruct, iStartX, iStartY, 0, 1 );
+        xTZSearchHelpX4( cStruct, iStartX, iStartY, 0, 1 );
       }
     }
+    xTZSearchFlushX4( cStruct );
   }
   //Smaller MV, refine around predictor
   else if ( bStarRefinementEnable && cStruct.uiBestDistance > 0 )
@@ -2375,23 +2504,33 @@ Void InterSearch::xPatternSearchFracDIF(
     return;
   }
 
+  // use the precomputed sub-pel planes of the reference if available, otherwise interpolate around the block
+  const Pel* apcSubPelRef[4][4];
+  const Bool bSubPelRef = cStruct.pcRefPic && xGetSubPelRef( cStruct, rcMvInt, apcSubPelRef );
+
   //  Half-pel refinement
   m_pcRdCost->setCostScale(1);
-  xExtDIFUpSamplingH ( &cPatternRoi );
+  if( !bSubPelRef )
+  {
+    xExtDIFUpSamplingH ( &cPatternRoi );
+  }
 
   rcMvHalf = rcMvInt;   rcMvHalf <<= 1;    // for mv-cost
   Mv baseRefMv(0, 0);
-  ruiCost = xPatternRefinement(cStruct.pcPatternKey, baseRefMv, 2, rcMvHalf, !bIsLosslessCoded);
+  ruiCost = xPatternRefinement(cStruct.pcPatternKey, baseRefMv, 2, rcMvHalf, !bIsLosslessCoded, bSubPelRef ? apcSubPelRef : nullptr, cStruct.iRefStride);
 
   //  quarter-pel refinement
   m_pcRdCost->setCostScale( 0 );
-  xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf );
+  if( !bSubPelRef )
+  {
+    xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf );
+  }
   baseRefMv = rcMvHalf;
   baseRefMv <<= 1;
 
   rcMvQter = rcMvInt;    rcMvQter <<= 1;    // for mv-cost
   rcMvQter += rcMvHalf;  rcMvQter <<= 1;
-  ruiCost = xPatternRefinement( cStruct.pcPatternKey, baseRefMv, 1, rcMvQter, !bIsLosslessCoded );
+  ruiCost = xPatternRefinement( cStruct.pcPatternKey, baseRefMv, 1, rcMvQter, !bIsLosslessCoded, bSubPelRef ? apcSubPelRef : nullptr, cStruct.iRefStride );
 }
 
 Void InterSearch::xPredAffineInterSearch( PredictionUnit&       pu,
@@ -3485,6 +3624,103 @@ Void InterSearch::xExtDIFUpSamplingQ( CPelBuf* pattern, Mv halfPelRef )
   m_if.filterVer(COMPONENT_Y, intPtr, intStride, dstPtr, dstStride, width, height, 3 << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE, false, true, chFmt, clpRng);
 }
 
+/**
+* \brief Get the sub-pel planes of the reference picture around an integer position
+*
+* Fills the rows of the planes needed by the refinement on first use. Fails if the refinement would read
+* outside the area covered by the planes, in which case the block is interpolated locally.
+*
+* \param cStruct      Search structure holding the reference picture and block position
+* \param rcMvInt      Integer-pel mv
+* \param apcSubPelRef Returns the sample at the integer position for each phase [fracY][fracX]
+*/
+Bool InterSearch::xGetSubPelRef( const IntTZSearchStruct& cStruct, const Mv& rcMvInt, const Pel* apcSubPelRef[4][4] )
+{
+  const Picture& refPic = *cStruct.pcRefPic;
+  const Int iExt        = refPic.margin - ( NTAPS_LUMA >> 1 );
+  const Int iPosX       = cStruct.cBlkPos.x + rcMvInt.getHor();
+  const Int iPosY       = cStruct.cBlkPos.y + rcMvInt.getVer();
+  const Int iWidth      = cStruct.pcPatternKey->width;
+  const Int iHeight     = cStruct.pcPatternKey->height;
+
+  // the refinement reads at most one sample beyond the block on each side
+  if( iPosX - 1 < -iExt || iPosX + iWidth + 1 > Int( refPic.lumaSize().width  ) + iExt ||
+      iPosY - 1 < -iExt || iPosY + iHeight + 1 > Int( refPic.lumaSize().height ) + iExt )
+  {
+    return false;
+  }
+
+  xFillSubPelPlanes( refPic, iPosY - 1, iHeight + 2 );
+
+  const Int iOffset = iPosY * cStruct.iRefStride + iPosX;
+
+  for( Int fracY = 0; fracY < 4; fracY++ )
+  {
+    for( Int fracX = 0; fracX < 4; fracX++ )
+    {
+      apcSubPelRef[fracY][fracX] = ( fracX || fracY ) ? refPic.m_subPelBufs[fracY][fracX].Y().buf + iOffset : cStruct.piRefY + rcMvInt.getHor() + rcMvInt.getVer() * cStruct.iRefStride;
+    }
+  }
+
+  return true;
+}
+
+/**
+* \brief Interpolate the CTU rows of the sub-pel planes covering the given luma rows, if not done yet
+*
+* Uses the same separable filtering as xExtDIFUpSamplingH/Q, so the planes hold exactly the samples the
+* per-block interpolation would produce.
+*
+* \param refPic  Reference picture
+* \param iPosY   First luma row needed
+* \param iHeight Number of luma rows needed
+*/
+Void InterSearch::xFillSubPelPlanes( const Picture& refPic, Int iPosY, Int iHeight )
+{
+  const Int iMargin     = refPic.margin;
+  const Int iRowHeight  = refPic.cs->sps->getMaxCUWidth();
+  const Int iExt        = iMargin - ( NTAPS_LUMA >> 1 );
+  const Int iPlaneWidth = refPic.lumaSize().width + 2 * iExt;
+  const Int iPicHeight  = refPic.lumaSize().height;
+  const Int iFirstRow   = ( iPosY + iMargin ) / iRowHeight;
+  const Int iLastRow    = ( iPosY + iHeight - 1 + iMargin ) / iRowHeight;
+
+  const ChromaFormat chFmt = m_currChromaFormat;
+  const CPelBuf      recBuf = refPic.getRecoBuf().Y();
+
+  for( Int iRow = iFirstRow; iRow <= iLastRow; iRow++ )
+  {
+    if( refPic.m_subPelRowValid[iRow] )
+    {
+      continue;
+    }
+
+    const Int iStartY    = std::max( iRow * iRowHeight - iMargin, -iExt );
+    const Int iEndY      = std::min( ( iRow + 1 ) * iRowHeight - iMargin, iPicHeight + iExt );
+    const Int iRows      = iEndY - iStartY;
+    const Int iTmpStride = iPlaneWidth;
+    const Pel* srcPtr    = recBuf.buf + ( iStartY - ( NTAPS_LUMA >> 1 ) + 1 ) * recBuf.stride - iExt;
+
+    m_subPelTmp.resize( iTmpStride * ( iRows + NTAPS_LUMA - 1 ) );
+
+    for( Int fracX = 0; fracX < 4; fracX++ )
+    {
+      m_if.filterHor( COMPONENT_Y, srcPtr, recBuf.stride, m_subPelTmp.data(), iTmpStride, iPlaneWidth, iRows + NTAPS_LUMA - 1, fracX << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE, false, chFmt, m_lumaClpRng );
+
+      for( Int fracY = 0; fracY < 4; fracY++ )
+      {
+        if( fracX || fracY )
+        {
+          PelBuf dstBuf = refPic.m_subPelBufs[fracY][fracX].Y();
+          m_if.filterVer( COMPONENT_Y, m_subPelTmp.data() + ( ( NTAPS_LUMA >> 1 ) - 1 ) * iTmpStride, iTmpStride, dstBuf.buf + iStartY * dstBuf.stride - iExt, dstBuf.stride, iPlaneWidth, iRows, fracY << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE, false, true, chFmt, m_lumaClpRng );
+        }
+      }
+    }
+
+    refPic.m_subPelRowValid[iRow] = true;
+  }
+}
+
 
 
 
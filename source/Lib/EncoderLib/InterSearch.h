@@ -41,6 +41,7 @@
 // Include files
 #include "CABACWriter.h"
 #include "EncCfg.h"
+#include "EncHierarchicalME.h"
 
 #include "CommonLib/MotionInfo.h"
 #include "CommonLib/InterPrediction.h"
@@ -83,6 +84,10 @@ private:
 
   PelStorage      m_obmcOrgMod;
 
+  std::vector<Pel> m_subPelTmp;   // horizontally filtered rows while filling the sub-pel planes of a reference
+
+  EncHierarchicalME m_cHierarchicalME;
+
 protected:
   // interface to option
   EncCfg*         m_pcEncCfg;
@@ -139,7 +144,7 @@ public:
 protected:
 
   /// sub-function for motion vector refinement used in fractional-pel accuracy
-  Distortion  xPatternRefinement    ( const CPelBuf* pcPatternKey, Mv baseRefMv, Int iFrac, Mv& rcMvFrac, Bool bAllowUseOfHadamard );
+  Distortion  xPatternRefinement    ( const CPelBuf* pcPatternKey, Mv baseRefMv, Int iFrac, Mv& rcMvFrac, Bool bAllowUseOfHadamard, const Pel* apcSubPelRef[4][4] = nullptr, Int iSubPelStride = 0 );
 
    typedef struct
    {
@@ -163,10 +168,24 @@ protected:
     UChar       ucPointNr;
     Int         subShiftMode;
     unsigned    imvShift;
+    // reference picture providing precomputed sub-pel planes (nullptr if not used) and luma block position
+    const Picture* pcRefPic;
+    Position    cBlkPos;
+    // integer-pel start point from the hierarchical ME pre-pass
+    Bool        bHierMv;
+    Mv          cHierMv;
+    // search points queued for the multi-candidate distortion (see xTZSearchHelpX4)
+    Int         iNumCand;
+    Int         aiCandX       [4];
+    Int         aiCandY       [4];
+    UChar       aucCandPointNr[4];
+    UInt        auiCandDist   [4];
   } IntTZSearchStruct;
 
   // sub-functions for ME
-  inline Void xTZSearchHelp         ( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  inline Void xTZSearchHelp         ( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance, const Distortion* puiSad = nullptr );
+  inline Void xTZSearchHelpX4       ( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  inline Void xTZSearchFlushX4      ( IntTZSearchStruct& rcStruct );
   inline Void xTZ2PointSearch       ( IntTZSearchStruct& rcStruct );
   inline Void xTZ8PointSquareSearch ( IntTZSearchStruct& rcStruct, const Int iStartX, const Int iStartY, const Int iDist );
   inline Void xTZ8PointDiamondSearch( IntTZSearchStruct& rcStruct, const Int iStartX, const Int iStartY, const Int iDist, const Bool bCheckCornersAtDist1 );
@@ -184,6 +203,8 @@ public:
   Void predInterSearch(CodingUnit& cu, Partitioner& partitioner );
 #endif
 
+  EncHierarchicalME& getHierarchicalME() { return m_cHierarchicalME; }
+
   /// set ME search range
   Void setAdaptiveSearchRange       ( Int iDir, Int iRefIdx, Int iSearchRange) { CHECK(iDir >= MAX_NUM_REF_LIST_ADAPT_SR || iRefIdx>=Int(MAX_IDX_ADAPT_SR), "Invalid index"); m_aaiAdaptSR[iDir][iRefIdx] = iSearchRange; }
 
@@ -352,6 +373,9 @@ protected:
   Void xExtDIFUpSamplingH         ( CPelBuf* pcPattern );
   Void xExtDIFUpSamplingQ         ( CPelBuf* pcPatternKey, Mv halfPelRef );
 
+  Bool xGetSubPelRef              ( const IntTZSearchStruct& cStruct, const Mv& rcMvInt, const Pel* apcSubPelRef[4][4] );
+  Void xFillSubPelPlanes          ( const Picture& refPic, Int iPosY, Int iHeight );
+
   // -------------------------------------------------------------------------------------------------------------------
   // compute symbol bits
   // -------------------------------------------------------------------------------------------------------------------
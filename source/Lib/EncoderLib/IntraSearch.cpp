@@ -42,6 +42,7 @@
 #include "CommonLib/Picture.h"
 #include "CommonLib/UnitTools.h"
 #include "CommonLib/BilateralFilter.h"
+#include "CommonLib/Profiler.h"
 
 #include "CommonLib/dtrace_next.h"
 #include "CommonLib/dtrace_buffer.h"
@@ -268,6 +269,8 @@ Void IntraSearch::init( EncCfg*        pcEncCfg,
 
 Void IntraSearch::estIntraPredLumaQT(CodingUnit &cu, Partitioner &partitioner)
 {
+  PROFILE_SCOPE_SIZE( PROF_ENC_INTRA_SEARCH_LUMA, cu.lwidth(), cu.lheight() );
+
   CodingStructure       &cs            = *cu.cs;
   const SPS             &sps           = *cs.sps;
   const UInt             uiWidthBit    = cs.pcv->rectCUs ? g_aucLog2[partitioner.currArea().lwidth() ] : CU::getIntraSizeIdx(cu);
@@ -810,6 +813,8 @@ Void IntraSearch::estIntraPredLumaQT(CodingUnit &cu, Partitioner &partitioner)
 
 Void IntraSearch::estIntraPredChromaQT(CodingUnit &cu, Partitioner &partitioner)
 {
+  PROFILE_SCOPE_SIZE( PROF_ENC_INTRA_SEARCH_CHROMA, cu.lwidth(), cu.lheight() );
+
   const ChromaFormat format   = cu.chromaFormat;
   const UInt    uiNumPU       = enable4ChromaPUsInIntraNxNCU( cu.chromaFormat ) ? CU::getNumPUs( cu ) : 1;
   const UInt    numberValidComponents = getNumberValidComponents(format);
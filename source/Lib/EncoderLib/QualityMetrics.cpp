@@ -0,0 +1,250 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     QualityMetrics.cpp
+    \brief    objective quality metrics of reconstructed pictures
+*/
+
+#include "QualityMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//! \ingroup EncoderLib
+//! \{
+
+UInt64 calcPlaneSSE( const CPelBuf& pic0, const CPelBuf& pic1 )
+{
+  CHECK( pic0.width != pic1.width || pic0.height != pic1.height, "Plane sizes differ" );
+
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+  return g_pelBufOP.sse( pic0.buf, pic0.stride, pic1.buf, pic1.stride, pic0.width, pic0.height );
+#else
+  return sseCore( pic0.buf, pic0.stride, pic1.buf, pic1.stride, pic0.width, pic0.height );
+#endif
+}
+
+// ====================================================================================================================
+// SSIM
+// ====================================================================================================================
+
+static const Int    MSSSIM_NUM_SCALES                   = 5;
+static const Double MSSSIM_WEIGHTS[MSSSIM_NUM_SCALES]   = { 0.0448, 0.2856, 0.3001, 0.2363, 0.1333 };
+
+/// sample sums of a block: both planes, squares of both planes and products
+struct SSIMSums
+{
+  Int64 s1;
+  Int64 s2;
+  Int64 ss;
+  Int64 s12;
+
+  SSIMSums& operator+=( const SSIMSums& other ) { s1 += other.s1; s2 += other.s2; ss += other.ss; s12 += other.s12; return *this; }
+};
+
+static inline Void xGetBlockSums( const Pel* org, const Int orgStride, const Pel* rec, const Int recStride, const Int width, const Int height, SSIMSums& sums )
+{
+  Int   s1  = 0;
+  Int   s2  = 0;
+  Int64 ss  = 0;
+  Int64 s12 = 0;
+
+  for( Int y = 0; y < height; y++ )
+  {
+    for( Int x = 0; x < width; x++ )
+    {
+      const Int o = org[x];
+      const Int r = rec[x];
+      s1  += o;
+      s2  += r;
+      ss  += o * o + r * r;
+      s12 += o * r;
+    }
+    org += orgStride;
+    rec += recStride;
+  }
+
+  sums.s1  = s1;
+  sums.s2  = s2;
+  sums.ss  = ss;
+  sums.s12 = s12;
+}
+
+/// SSIM and its contrast-structure term for a window, the constants are scaled by numSamples^2 instead of normalizing the sums
+static inline Void xGetWindowSSIM( const SSIMSums& sums, const Double numSamples, const Double c1, const Double c2, Double& ssim, Double& cs )
+{
+  const Double n   = numSamples;
+  const Double s1  = Double( sums.s1 );
+  const Double s2  = Double( sums.s2 );
+  const Double nC1 = c1 * n * n;
+  const Double nC2 = c2 * n * n;
+
+  const Double luminance = ( 2.0 * s1 * s2 + nC1 ) / ( s1 * s1 + s2 * s2 + nC1 );
+  cs   = ( 2.0 * ( n * Double( sums.s12 ) - s1 * s2 ) + nC2 ) / ( n * Double( sums.ss ) - s1 * s1 - s2 * s2 + nC2 );
+  ssim = luminance * cs;
+}
+
+static Void xGetPlaneSSIM( const CPelBuf& org, const CPelBuf& rec, const Int bitDepth, Double& ssim, Double& cs )
+{
+  const Double maxVal     = Double( ( 1 << bitDepth ) - 1 );
+  const Double c1         = 0.01 * 0.01 * maxVal * maxVal;
+  const Double c2         = 0.03 * 0.03 * maxVal * maxVal;
+  const Int    numBlocksX = org.width  >> 2;
+  const Int    numBlocksY = org.height >> 2;
+
+  if( numBlocksX < 2 || numBlocksY < 2 )
+  {
+    SSIMSums sums;
+    xGetBlockSums( org.buf, org.stride, rec.buf, rec.stride, org.width, org.height, sums );
+    xGetWindowSSIM( sums, Double( org.width * org.height ), c1, c2, ssim, cs );
+    return;
+  }
+
+  // 4x4 block sums of the current and the previous block row
+  std::vector<SSIMSums> blockSums[2] = { std::vector<SSIMSums>( numBlocksX ), std::vector<SSIMSums>( numBlocksX ) };
+  Double sumSSIM = 0.0;
+  Double sumCS   = 0.0;
+
+  for( Int by = 0; by < numBlocksY; by++ )
+  {
+    std::vector<SSIMSums>& curr = blockSums[by & 1];
+    const Pel* o = org.bufAt( 0, by << 2 );
+    const Pel* r = rec.bufAt( 0, by << 2 );
+
+    for( Int bx = 0; bx < numBlocksX; bx++ )
+    {
+      xGetBlockSums( o + ( bx << 2 ), org.stride, r + ( bx << 2 ), rec.stride, 4, 4, curr[bx] );
+    }
+
+    if( by == 0 )
+    {
+      continue;
+    }
+
+    const std::vector<SSIMSums>& prev = blockSums[( by - 1 ) & 1];
+
+    for( Int bx = 0; bx + 1 < numBlocksX; bx++ )
+    {
+      SSIMSums window = prev[bx];
+      window += prev[bx + 1];
+      window += curr[bx];
+      window += curr[bx + 1];
+
+      Double windowSSIM, windowCS;
+      xGetWindowSSIM( window, 64.0, c1, c2, windowSSIM, windowCS );
+      sumSSIM += windowSSIM;
+      sumCS   += windowCS;
+    }
+  }
+
+  const Double numWindows = Double( numBlocksX - 1 ) * Double( numBlocksY - 1 );
+  ssim = sumSSIM / numWindows;
+  cs   = sumCS   / numWindows;
+}
+
+/// 2x2 average of a plane
+static CPelBuf xDownsample( const CPelBuf& src, std::vector<Pel>& dst )
+{
+  const Int width  = src.width  >> 1;
+  const Int height = src.height >> 1;
+
+  dst.resize( width * height );
+
+  for( Int y = 0; y < height; y++ )
+  {
+    const Pel* s0 = src.bufAt( 0, 2 * y     );
+    const Pel* s1 = src.bufAt( 0, 2 * y + 1 );
+    Pel*       d  = &dst[y * width];
+
+    for( Int x = 0; x < width; x++ )
+    {
+      d[x] = Pel( ( s0[2 * x] + s0[2 * x + 1] + s1[2 * x] + s1[2 * x + 1] + 2 ) >> 2 );
+    }
+  }
+
+  return CPelBuf( dst.data(), width, height );
+}
+
+Double calcPlaneSSIM( const CPelBuf& org, const CPelBuf& rec, const Int bitDepth )
+{
+  CHECK( org.width != rec.width || org.height != rec.height, "Plane sizes differ" );
+
+  Double ssim, cs;
+  xGetPlaneSSIM( org, rec, bitDepth, ssim, cs );
+
+  return ssim;
+}
+
+Double calcPlaneMSSSIM( const CPelBuf& org, const CPelBuf& rec, const Int bitDepth )
+{
+  CHECK( org.width != rec.width || org.height != rec.height, "Plane sizes differ" );
+
+  // the coarsest scale still has to cover a window, the weights of the remaining scales are renormalized
+  Int numScales = 1;
+  while( numScales < MSSSIM_NUM_SCALES && ( org.width >> numScales ) >= 8 && ( org.height >> numScales ) >= 8 )
+  {
+    numScales++;
+  }
+
+  Double weightSum = 0.0;
+  for( Int scale = 0; scale < numScales; scale++ )
+  {
+    weightSum += MSSSIM_WEIGHTS[scale];
+  }
+
+  std::vector<Pel> scaledBufs[2][2];
+  CPelBuf          o      = org;
+  CPelBuf          r      = rec;
+  Double           msssim = 1.0;
+
+  for( Int scale = 0; scale < numScales; scale++ )
+  {
+    Double ssim, cs;
+    xGetPlaneSSIM( o, r, bitDepth, ssim, cs );
+
+    // contrast-structure at the finer scales, the full SSIM including luminance at the coarsest scale
+    const Double term = scale + 1 < numScales ? cs : ssim;
+    msssim *= pow( std::max( term, 0.0 ), MSSSIM_WEIGHTS[scale] / weightSum );
+
+    if( scale + 1 < numScales )
+    {
+      o = xDownsample( o, scaledBufs[0][scale & 1] );
+      r = xDownsample( r, scaledBufs[1][scale & 1] );
+    }
+  }
+
+  return msssim;
+}
+
+//! \}
@@ -0,0 +1,63 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2017, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     QualityMetrics.h
+    \brief    objective quality metrics of reconstructed pictures (header)
+*/
+
+#ifndef __QUALITYMETRICS__
+#define __QUALITYMETRICS__
+
+#include "CommonLib/CommonDef.h"
+#include "CommonLib/Unit.h"
+
+//! \ingroup EncoderLib
+//! \{
+
+/// sum of squared differences of two planes of equal size
+UInt64 calcPlaneSSE   ( const CPelBuf& pic0, const CPelBuf& pic1 );
+
+/**
+  Mean SSIM of a plane.
+
+  The statistics are taken over 8x8 windows on a grid of 4 samples, each window is assembled from the sums of four
+  4x4 blocks, so every sample is read once. Planes smaller than a window are measured as a single window.
+*/
+Double calcPlaneSSIM  ( const CPelBuf& org, const CPelBuf& rec, const Int bitDepth );
+
+/// multi-scale SSIM of a plane over up to 5 dyadic scales, with the weights of Wang et al., 2003
+Double calcPlaneMSSSIM( const CPelBuf& org, const CPelBuf& rec, const Int bitDepth );
+
+//! \}
+
+#endif // __QUALITYMETRICS__
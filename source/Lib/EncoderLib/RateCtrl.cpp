@@ -287,6 +287,7 @@ EncRCGOP::EncRCGOP()
 {
   m_encRCSeq  = NULL;
   m_picTargetBitInGOP = NULL;
+  m_picRatio   = NULL;
   m_numPic     = 0;
   m_targetBits = 0;
   m_picLeft    = 0;
@@ -298,10 +299,10 @@ EncRCGOP::~EncRCGOP()
   destroy();
 }
 
-Void EncRCGOP::create( EncRCSeq* encRCSeq, Int numPic )
+Void EncRCGOP::create( EncRCSeq* encRCSeq, Int numPic, const TRCLookahead* lookahead )
 {
   destroy();
-  Int targetBits = xEstGOPTargetBits( encRCSeq, numPic );
+  Int targetBits = xEstGOPTargetBits( encRCSeq, numPic, lookahead );
 
   if ( encRCSeq->getAdaptiveBits() > 0 && encRCSeq->getLastLambda() > 0.1 )
   {
@@ -364,17 +365,19 @@ Void EncRCGOP::create( EncRCSeq* encRCSeq, Int numPic )
   }
 
   m_picTargetBitInGOP = new Int[numPic];
+  m_picRatio          = new Double[numPic];
   Int i;
-  Int totalPicRatio = 0;
-  Int currPicRatio = 0;
+  Double totalPicRatio = 0;
   for ( i=0; i<numPic; i++ )
   {
-    totalPicRatio += encRCSeq->getBitRatio( i );
+    // with the lookahead the bit ratio is taken from the GOP position of the picture, which differs from its coding
+    // position in a truncated last GOP
+    m_picRatio[i] = lookahead ? encRCSeq->getBitRatio( lookahead->m_GOPIdx[i] ) * lookahead->m_picWeight[i] : encRCSeq->getBitRatio( i );
+    totalPicRatio += m_picRatio[i];
   }
   for ( i=0; i<numPic; i++ )
   {
-    currPicRatio = encRCSeq->getBitRatio( i );
-    m_picTargetBitInGOP[i] = (Int)( ((Double)targetBits) * currPicRatio / totalPicRatio );
+    m_picTargetBitInGOP[i] = (Int)( ((Double)targetBits) * m_picRatio[i] / totalPicRatio );
   }
 
   m_encRCSeq    = encRCSeq;
@@ -438,6 +441,11 @@ Void EncRCGOP::destroy()
     delete[] m_picTargetBitInGOP;
     m_picTargetBitInGOP = NULL;
   }
+  if ( m_picRatio != NULL )
+  {
+    delete[] m_picRatio;
+    m_picRatio = NULL;
+  }
 }
 
 Void EncRCGOP::updateAfterPicture( Int bitsCost )
@@ -446,13 +454,32 @@ Void EncRCGOP::updateAfterPicture( Int bitsCost )
   m_picLeft--;
 }
 
-Int EncRCGOP::xEstGOPTargetBits( EncRCSeq* encRCSeq, Int GOPSize )
+Int EncRCGOP::xEstGOPTargetBits( EncRCSeq* encRCSeq, Int GOPSize, const TRCLookahead* lookahead )
 {
   Int realInfluencePicture = min( g_RCSmoothWindowSize, encRCSeq->getFramesLeft() );
   Int averageTargetBitsPerPic = (Int)( encRCSeq->getTargetBits() / encRCSeq->getTotalFrames() );
-  Int currentTargetBitsPerPic = (Int)( ( encRCSeq->getBitsLeft() - averageTargetBitsPerPic * (encRCSeq->getFramesLeft() - realInfluencePicture) ) / realInfluencePicture );
+  Int currentTargetBitsPerPic;
+  if ( lookahead && lookahead->m_beyondWindowShare >= 0.0 )
+  {
+    // two-pass: the pictures after the window keep their complexity share of the total target bits
+    Int64 beyondWindowBits = (Int64)( encRCSeq->getTargetBits() * lookahead->m_beyondWindowShare );
+    currentTargetBitsPerPic = (Int)( ( encRCSeq->getBitsLeft() - beyondWindowBits ) / realInfluencePicture );
+  }
+  else
+  {
+    currentTargetBitsPerPic = (Int)( ( encRCSeq->getBitsLeft() - averageTargetBitsPerPic * (encRCSeq->getFramesLeft() - realInfluencePicture) ) / realInfluencePicture );
+  }
   Int targetBits = currentTargetBitsPerPic * GOPSize;
 
+  if ( lookahead && realInfluencePicture > GOPSize )
+  {
+    // the GOP must leave the other pictures of the window at least the minimum ratio of their share, a GOP which ends
+    // the sequence gets all bits left
+    Double maxRatio = ( realInfluencePicture - g_RCMinComplexityRatio * ( realInfluencePicture - GOPSize ) ) / GOPSize;
+    maxRatio = min( maxRatio, g_RCMaxComplexityRatio );
+    targetBits = (Int)( targetBits * Clip3( g_RCMinComplexityRatio, maxRatio, lookahead->m_GOPRatio ) );
+  }
+
   if ( targetBits < 200 )
   {
     targetBits = 200;   // at least allocate 200 bits for one GOP
@@ -498,11 +525,11 @@ Int EncRCPic::xEstPicTargetBits( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP )
 
   Int i;
   Int currPicPosition = encRCGOP->getNumPic()-encRCGOP->getPicLeft();
-  Int currPicRatio    = encRCSeq->getBitRatio( currPicPosition );
-  Int totalPicRatio   = 0;
+  Double currPicRatio = encRCGOP->getPicRatio( currPicPosition );
+  Double totalPicRatio = 0;
   for ( i=currPicPosition; i<encRCGOP->getNumPic(); i++ )
   {
-    totalPicRatio += encRCSeq->getBitRatio( i );
+    totalPicRatio += encRCGOP->getPicRatio( i );
   }
 
   targetBits  = Int( ((Double)GOPbitsLeft) * currPicRatio / totalPicRatio );
@@ -551,12 +578,12 @@ Int EncRCPic::xEstPicLowerBound(EncRCSeq* encRCSeq, EncRCGOP* encRCGOP)
   Int GOPbitsLeft = encRCGOP->getBitsLeft();
 
   const Int nextPicPosition = (encRCGOP->getNumPic() - encRCGOP->getPicLeft() + 1) % encRCGOP->getNumPic();
-  const Int nextPicRatio = encRCSeq->getBitRatio(nextPicPosition);
+  const Double nextPicRatio = encRCGOP->getPicRatio(nextPicPosition);
 
-  Int totalPicRatio = 0;
+  Double totalPicRatio = 0;
   for (Int i = nextPicPosition; i < encRCGOP->getNumPic(); i++)
   {
-    totalPicRatio += encRCSeq->getBitRatio(i);
+    totalPicRatio += encRCGOP->getPicRatio(i);
   }
 
   if (nextPicPosition == 0)
@@ -645,6 +672,7 @@ Void EncRCPic::create( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP, Int frameLevel, l
       m_LCUs[LCUIdx].m_lambda     = 0.0;
       m_LCUs[LCUIdx].m_targetBits = 0;
       m_LCUs[LCUIdx].m_bitWeight  = 1.0;
+      m_LCUs[LCUIdx].m_qpOffset   = 0.0;
       Int currWidth  = ( (i == picWidthInLCU -1) ? picWidth  - LCUWidth *(picWidthInLCU -1) : LCUWidth  );
       Int currHeight = ( (j == picHeightInLCU-1) ? picHeight - LCUHeight*(picHeightInLCU-1) : LCUHeight );
       m_LCUs[LCUIdx].m_numberOfPixel = currWidth * currHeight;
@@ -745,7 +773,7 @@ Double EncRCPic::estimatePicLambda( list<EncRCPic*>& listPreviousPictures, Slice
       betaLCU  = m_encRCSeq->getPicPara( m_frameLevel ).m_beta;
     }
 
-    m_LCUs[i].m_bitWeight =  m_LCUs[i].m_numberOfPixel * pow( estLambda/alphaLCU, 1.0/betaLCU );
+    m_LCUs[i].m_bitWeight =  m_LCUs[i].m_numberOfPixel * pow( estLambda * pow( 2.0, m_LCUs[i].m_qpOffset / 3.0 ) / alphaLCU, 1.0/betaLCU );
 
     if ( m_LCUs[i].m_bitWeight < 0.01 )
     {
@@ -863,7 +891,7 @@ Double EncRCPic::getLCUEstLambda( Double bpp )
 
   Double estLambda = alpha * pow( bpp, beta );
   //for Lambda clip, picture level clip
-  Double clipPicLambda = m_estPicLambda;
+  Double clipPicLambda = m_estPicLambda * pow( 2.0, m_LCUs[LCUIdx].m_qpOffset / 3.0 );
 
   //for Lambda clip, LCU level clip
   Double clipNeighbourLambda = -1.0;
@@ -871,7 +899,7 @@ Double EncRCPic::getLCUEstLambda( Double bpp )
   {
     if ( m_LCUs[i].m_lambda > 0 )
     {
-      clipNeighbourLambda = m_LCUs[i].m_lambda;
+      clipNeighbourLambda = m_LCUs[i].m_lambda * pow( 2.0, ( m_LCUs[LCUIdx].m_qpOffset - m_LCUs[i].m_qpOffset ) / 3.0 );
       break;
     }
   }
@@ -902,6 +930,7 @@ Int EncRCPic::getLCUEstQP( Double lambda, Int clipPicQP )
 {
   Int LCUIdx = getLCUCoded();
   Int estQP = Int( 4.2005 * log( lambda ) + 13.7122 + 0.5 );
+  Int QPOffset = Int( floor( m_LCUs[LCUIdx].m_qpOffset + 0.5 ) );
 
   //for Lambda clip, LCU level clip
   Int clipNeighbourQP = g_RCInvalidQPValue;
@@ -909,7 +938,7 @@ Int EncRCPic::getLCUEstQP( Double lambda, Int clipPicQP )
   {
     if ( (getLCU(i)).m_QP > g_RCInvalidQPValue )
     {
-      clipNeighbourQP = getLCU(i).m_QP;
+      clipNeighbourQP = getLCU(i).m_QP + QPOffset - Int( floor( getLCU(i).m_qpOffset + 0.5 ) );
       break;
     }
   }
@@ -919,7 +948,7 @@ Int EncRCPic::getLCUEstQP( Double lambda, Int clipPicQP )
     estQP = Clip3( clipNeighbourQP - 1, clipNeighbourQP + 1, estQP );
   }
 
-  estQP = Clip3( clipPicQP - 2, clipPicQP + 2, estQP );
+  estQP = Clip3( clipPicQP + QPOffset - 2, clipPicQP + QPOffset + 2, estQP );
 
   return estQP;
 }
@@ -1158,6 +1187,48 @@ Void EncRCPic::getLCUInitTargetBits()
 }
 
 
+/** Set the CTU QP offsets from QP offsets of a block grid, the offsets are relative to the picture QP
+ * \param blockQPOffsets offsets of the blocks in raster order
+ * \param blockSize      luma size of the blocks, a divisor of the CTU size
+ */
+Void EncRCPic::setLCUQPOffsets( const std::vector<Double>& blockQPOffsets, Int blockSize )
+{
+  Int picWidth       = m_encRCSeq->getPicWidth();
+  Int picHeight      = m_encRCSeq->getPicHeight();
+  Int LCUWidth       = m_encRCSeq->getLCUWidth();
+  Int LCUHeight      = m_encRCSeq->getLCUHeight();
+  Int picWidthInLCU  = ( picWidth  + LCUWidth  - 1 ) / LCUWidth;
+  Int numBlkX        = ( picWidth  + blockSize - 1 ) / blockSize;
+  Int numBlkY        = ( picHeight + blockSize - 1 ) / blockSize;
+
+  Double totalOffset = 0.0;
+  for ( Int i=0; i<m_numberOfLCU; i++ )
+  {
+    Int blkX0 = ( i % picWidthInLCU ) * LCUWidth  / blockSize;
+    Int blkY0 = ( i / picWidthInLCU ) * LCUHeight / blockSize;
+    Int blkX1 = min( blkX0 + LCUWidth  / blockSize, numBlkX );
+    Int blkY1 = min( blkY0 + LCUHeight / blockSize, numBlkY );
+
+    Double sum = 0.0;
+    for ( Int y=blkY0; y<blkY1; y++ )
+    {
+      for ( Int x=blkX0; x<blkX1; x++ )
+      {
+        sum += blockQPOffsets[y * numBlkX + x];
+      }
+    }
+    m_LCUs[i].m_qpOffset = sum / ( ( blkX1 - blkX0 ) * ( blkY1 - blkY0 ) );
+    totalOffset += m_LCUs[i].m_qpOffset * m_LCUs[i].m_numberOfPixel;
+  }
+
+  // the picture level bit allocation is done by the picture QP, only the distribution inside the picture is changed
+  Double meanOffset = totalOffset / m_numberOfPixel;
+  for ( Int i=0; i<m_numberOfLCU; i++ )
+  {
+    m_LCUs[i].m_qpOffset -= meanOffset;
+  }
+}
+
 Double EncRCPic::getLCUEstLambdaAndQP(Double bpp, Int clipPicQP, Int *estQP)
 {
   Int   LCUIdx = getLCUCoded();
@@ -1167,20 +1238,21 @@ Double EncRCPic::getLCUEstLambdaAndQP(Double bpp, Int clipPicQP, Int *estQP)
 
   Double costPerPixel = getLCU(LCUIdx).m_costIntra/(Double)getLCU(LCUIdx).m_numberOfPixel;
   costPerPixel = pow(costPerPixel, BETA1);
-  Double estLambda = calculateLambdaIntra(alpha, beta, costPerPixel, bpp);
+  Double estLambda = calculateLambdaIntra(alpha, beta, costPerPixel, bpp) * pow( 2.0, getLCU(LCUIdx).m_qpOffset / 3.0 );
+  Int QPOffset = Int( floor( getLCU(LCUIdx).m_qpOffset + 0.5 ) );
 
   Int clipNeighbourQP = g_RCInvalidQPValue;
   for (Int i=LCUIdx-1; i>=0; i--)
   {
     if ((getLCU(i)).m_QP > g_RCInvalidQPValue)
     {
-      clipNeighbourQP = getLCU(i).m_QP;
+      clipNeighbourQP = getLCU(i).m_QP + QPOffset - Int( floor( getLCU(i).m_qpOffset + 0.5 ) );
       break;
     }
   }
 
-  Int minQP = clipPicQP - 2;
-  Int maxQP = clipPicQP + 2;
+  Int minQP = clipPicQP + QPOffset - 2;
+  Int maxQP = clipPicQP + QPOffset + 2;
 
   if ( clipNeighbourQP > g_RCInvalidQPValue )
   {
@@ -1437,10 +1509,10 @@ Void RateCtrl::initRCPic( Int frameLevel )
   m_encRCPic->create( m_encRCSeq, m_encRCGOP, frameLevel, m_listRCPictures );
 }
 
-Void RateCtrl::initRCGOP( Int numberOfPictures )
+Void RateCtrl::initRCGOP( Int numberOfPictures, const TRCLookahead* lookahead )
 {
   m_encRCGOP = new EncRCGOP;
-  m_encRCGOP->create( m_encRCSeq, numberOfPictures );
+  m_encRCGOP->create( m_encRCSeq, numberOfPictures, lookahead );
 }
 
 #if U0132_TARGET_BITS_SATURATION
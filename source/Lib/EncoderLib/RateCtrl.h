@@ -69,6 +69,10 @@ const Double g_RCAlphaMinValue = 0.05;
 const Double g_RCAlphaMaxValue = 500.0;
 const Double g_RCBetaMinValue  = -3.0;
 const Double g_RCBetaMaxValue  = -0.1;
+const Double g_RCLookaheadQComp = 0.6;                                  // compression of the complexity differences in the lookahead bit allocation
+const Double g_RCPropagationStrength = 5.0 * ( 1.0 - g_RCLookaheadQComp ); // CTU QP offset per doubling of the propagated cost
+const Double g_RCMinComplexityRatio = 0.5;                              // range of the GOP bits relative to the share of the GOP in the smoothing window
+const Double g_RCMaxComplexityRatio = 2.0;
 
 #define ALPHA     6.7542;
 #define BETA1     1.2517
@@ -84,6 +88,15 @@ struct TRCLCU
   Int m_numberOfPixel;
   Double m_costIntra;
   Int m_targetBitsLeft;
+  Double m_qpOffset;    // QP offset of the CTU relative to the picture, from the lookahead
+};
+
+struct TRCLookahead
+{
+  Double m_GOPRatio;            // mean complexity of the GOP relative to the pictures of the smoothing window
+  Double m_beyondWindowShare;   // share of the sequence complexity after the smoothing window, negative when unknown
+  std::vector<Double> m_picWeight;  // complexity of the pictures relative to the GOP mean, in coding order
+  std::vector<Int>    m_GOPIdx;     // GOP index of the pictures in coding order, pictures beyond the sequence end are skipped
 };
 
 struct TRCParameter
@@ -186,12 +199,12 @@ public:
   ~EncRCGOP();
 
 public:
-  Void create( EncRCSeq* encRCSeq, Int numPic );
+  Void create( EncRCSeq* encRCSeq, Int numPic, const TRCLookahead* lookahead = NULL );
   Void destroy();
   Void updateAfterPicture( Int bitsCost );
 
 private:
-  Int  xEstGOPTargetBits( EncRCSeq* encRCSeq, Int GOPSize );
+  Int  xEstGOPTargetBits( EncRCSeq* encRCSeq, Int GOPSize, const TRCLookahead* lookahead );
   Void   xCalEquaCoeff( EncRCSeq* encRCSeq, Double* lambdaRatio, Double* equaCoeffA, Double* equaCoeffB, Int GOPSize );
   Double xSolveEqua( Double targetBpp, Double* equaCoeffA, Double* equaCoeffB, Int GOPSize );
 
@@ -202,10 +215,12 @@ public:
   Int  getPicLeft()               { return m_picLeft; }
   Int  getBitsLeft()              { return m_bitsLeft; }
   Int  getTargetBitInGOP( Int i ) { return m_picTargetBitInGOP[i]; }
+  Double getPicRatio( Int i )     { return m_picRatio[i]; }
 
 private:
   EncRCSeq* m_encRCSeq;
   Int* m_picTargetBitInGOP;
+  Double* m_picRatio;
   Int m_numPic;
   Int m_targetBits;
   Int m_picLeft;
@@ -274,6 +289,7 @@ public:
   Void setTargetBits( Int bits )                          { m_targetBits = bits; m_bitsLeft = bits;}
   Void setTotalIntraCost(Double cost)                     { m_totalCostIntra = cost; }
   Void getLCUInitTargetBits();
+  Void setLCUQPOffsets( const std::vector<Double>& blockQPOffsets, Int blockSize );
 
   Int  getPicActualBits()                                 { return m_picActualBits; }
   Int  getPicActualQP()                                   { return m_picQP; }
@@ -321,7 +337,7 @@ public:
   Void init( Int totalFrames, Int targetBitrate, Int frameRate, Int GOPSize, Int picWidth, Int picHeight, Int LCUWidth, Int LCUHeight, Int keepHierBits, Bool useLCUSeparateModel, GOPEntry GOPList[MAX_GOP] );
   Void destroy();
   Void initRCPic( Int frameLevel );
-  Void initRCGOP( Int numberOfPictures );
+  Void initRCGOP( Int numberOfPictures, const TRCLookahead* lookahead = NULL );
   Void destroyRCGOP();
 
 public:
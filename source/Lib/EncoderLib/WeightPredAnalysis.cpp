@@ -87,6 +87,9 @@ Void xCalcHistogram(const Pel  *pPel,
 {
   histogram.clear();
   histogram.resize(maxPel);
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+  g_pelBufOP.histogram(pPel, stride, width, height, histogram.data(), maxPel);
+#else
   for( Int y = 0; y < height; y++ )
   {
     for( Int x = 0; x < width; x++ )
@@ -96,6 +99,7 @@ Void xCalcHistogram(const Pel  *pPel,
     }
     pPel += stride;
   }
+#endif
 }
 
 static
@@ -242,13 +246,12 @@ WeightPredAnalysis::WeightPredAnalysis()
 
 
 //! calculate AC and DC values for current original image
-Void WeightPredAnalysis::xCalcACDCParamSlice(Slice *const slice)
+Void WeightPredAnalysis::xCalcACDCParamPicture(Picture *const pic)
 {
   //===== calculate AC/DC value =====
-//  PicYuv*   pPic = slice->getPic()->getPicYuvOrg();
-  const CPelUnitBuf pPic = slice->getPic()->getOrigBuf();
+  const CPelUnitBuf pPic = pic->getOrigBuf();
 
-  WPACDCParam weightACDCParam[MAX_NUM_COMPONENT];
+  WPACDCParam *weightACDCParam = pic->wpAcDcParam;
 
   for(Int componentIndex = 0; componentIndex < ::getNumberValidComponents(pPic.chromaFormat); componentIndex++)
   {
@@ -265,6 +268,13 @@ Void WeightPredAnalysis::xCalcACDCParamSlice(Slice *const slice)
     const Int sample = width*height;
 
     Int64 orgDC = 0;
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+    {
+      UInt64 sum, sumSqr;
+      g_pelBufOP.sumAndSqr( compBuf.buf, stride, width, height, sum, sumSqr );
+      orgDC = Int64( sum );
+    }
+#else
     {
       const Pel *pPel = compBuf.buf;
 
@@ -276,10 +286,15 @@ Void WeightPredAnalysis::xCalcACDCParamSlice(Slice *const slice)
         }
       }
     }
+#endif
 
     const Int64 orgNormDC = ((orgDC+(sample>>1)) / sample);
 
     Int64 orgAC = 0;
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+    // the sum of the absolute differences to the DC, as weighted SAD with a zero weight
+    orgAC = g_pelBufOP.sadWeighted( compBuf.buf, stride, compBuf.buf, stride, width, height, 0, 0, Int( orgNormDC ) );
+#else
     {
       const Pel *pPel = compBuf.buf;
 
@@ -291,13 +306,27 @@ Void WeightPredAnalysis::xCalcACDCParamSlice(Slice *const slice)
         }
       }
     }
+#endif
 
-    const Int fixedBitShift = (slice->getSPS()->getSpsRangeExtension().getHighPrecisionOffsetsEnabledFlag())?RExt__PREDICTION_WEIGHTING_ANALYSIS_DC_PRECISION:0;
+    const Int fixedBitShift = (pic->cs->sps->getSpsRangeExtension().getHighPrecisionOffsetsEnabledFlag())?RExt__PREDICTION_WEIGHTING_ANALYSIS_DC_PRECISION:0;
     weightACDCParam[compID].iDC = (((orgDC<<fixedBitShift)+(sample>>1)) / sample);
     weightACDCParam[compID].iAC = orgAC;
   }
+}
+
+
+//! calculate the histograms of the current original image
+Void WeightPredAnalysis::xCalcHistogramPicture(Picture *const pic)
+{
+  const CPelUnitBuf pPic = pic->getOrigBuf();
 
-  slice->setWpAcDcParam(weightACDCParam);
+  for(Int componentIndex = 0; componentIndex < ::getNumberValidComponents(pPic.chromaFormat); componentIndex++)
+  {
+    const ComponentID compID  = ComponentID(componentIndex);
+    const CPelBuf     compBuf = pPic.get( compID );
+
+    xCalcHistogram(compBuf.buf, pic->orgHistogram[compID], compBuf.width, compBuf.height, compBuf.stride, 1 << pic->cs->sps->getBitDepth(toChannelType(compID)));
+  }
 }
 
 
@@ -520,12 +549,15 @@ Bool WeightPredAnalysis::xSelectWPHistExtClip(Slice *const slice, const Int log2
 
           if (bUseHistogram)
           {
-            std::vector<Int> histogramOrg;// = pPic->getHistogram(compID);
+            std::vector<Int> histogramOrg = slice->getPic()->orgHistogram[compID];
             std::vector<Int> histogramRef;// = slice->getRefPic(eRefPicList, refIdxTemp)->getPicYuvRec()->getHistogram(compID);
             std::vector<Int> searchedHistogram;
 
-            // Compute histograms
-            xCalcHistogram(pOrg, histogramOrg, width, height, orgStride, 1 << bitDepth);
+            // Compute histograms, the one of the original picture is normally computed by the pre-analysis
+            if (histogramOrg.empty())
+            {
+              xCalcHistogram(pOrg, histogramOrg, width, height, orgStride, 1 << bitDepth);
+            }
             xCalcHistogram(pRef, histogramRef, width, height, refStride, 1 << bitDepth);
 
             // Do a histogram search around DC WP parameters; resulting distortion and 'searchedHistogram' is discarded
@@ -666,6 +698,13 @@ Int64 xCalcSADvalueWP(const Int   bitDepth,
   const Int64 realLog2Denom = useHighPrecision ? log2Denom : (log2Denom + (bitDepth - 8));
   const Int64 realOffset    = ((Int64)offset)<<realLog2Denom;
 
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+  if( bitDepth <= 12 ) // the kernel computes the weighted samples in 32 bit
+  {
+    return g_pelBufOP.sadWeighted(pOrgPel, orgStride, pRefPel, refStride, width, height, log2Denom, weight, Int(realOffset));
+  }
+#endif
+
   Int64 SAD = 0;
   for( Int y = 0; y < height; y++ )
   {
@@ -704,6 +743,13 @@ Int64 xCalcSADvalueWPOptionalClip(const Int   bitDepth,
     const Int64 minValue = 0;
     const Int64 maxValue = (1 << bitDepth) - 1;
 
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+    if( bitDepth <= 12 ) // the kernel computes the weighted samples in 32 bit
+    {
+      return g_pelBufOP.sadWeightedClip(pOrgPel, orgStride, pRefPel, refStride, width, height, log2Denom, weight, Int(realOffset), Int(maxValue));
+    }
+#endif
+
     for( Int y = 0; y < height; y++ )
     {
       for( Int x = 0; x < width; x++ )
@@ -721,6 +767,13 @@ Int64 xCalcSADvalueWPOptionalClip(const Int   bitDepth,
     const Int64 realLog2Denom = useHighPrecision ? log2Denom : (log2Denom + (bitDepth - 8));
     const Int64 realOffset    = ((Int64)offset)<<realLog2Denom;
 
+#if HHI_SIMD_OPT_BUFFER && defined( TARGET_SIMD_X86 )
+    if( bitDepth <= 12 ) // the kernel computes the weighted samples in 32 bit
+    {
+      return g_pelBufOP.sadWeighted(pOrgPel, orgStride, pRefPel, refStride, width, height, log2Denom, weight, Int(realOffset));
+    }
+#endif
+
     for( Int y = 0; y < height; y++ )
     {
       for( Int x = 0; x < width; x++ )
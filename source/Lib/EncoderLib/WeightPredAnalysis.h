@@ -58,8 +58,11 @@ public:
 
   WeightPredAnalysis();
 
+  // WP analysis of the original picture, independent of the references :
+  static Void xCalcACDCParamPicture(Picture *const pic);
+  static Void xCalcHistogramPicture(Picture *const pic);
+
   // WP analysis :
-  Void  xCalcACDCParamSlice  (Slice *const slice);
   Void  xEstimateWPParamSlice(Slice *const slice, const WeightedPredictionMethod method);
   Void  xCheckWPEnable       (Slice *const slice);
 };
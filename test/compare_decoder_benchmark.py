@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+#
+# Compares two sets of decoder benchmark results written by DecoderApp --BenchmarkFile, e.g. the DecoderBenchmark
+# directories of two build trees after "ctest -L benchmark", and flags the regressions beyond a threshold:
+#
+#   compare_decoder_benchmark.py <reference dir or file> <test dir or file> [--threshold 3] [--min-seconds 0.02]
+#
+# The median frame rate of the measured runs, the decoding time per stage of the run with the median total time and the
+# peak memory usage are compared. Stages taking less than --min-seconds in both results are not checked, their timing is too
+# noisy. The exit code is 1 if any regression is found, 2 if the results cannot be compared.
+
+import argparse
+import json
+import os
+import sys
+
+STAGES = [ "parse", "reconstruct", "deblock", "sao", "alf", "other" ]
+
+
+def load_results( path ):
+  files = [ path ]
+  if os.path.isdir( path ):
+    files = sorted( os.path.join( path, f ) for f in os.listdir( path ) if f.endswith( ".json" ) )
+  results = {}
+  for fileName in files:
+    with open( fileName ) as f:
+      result = json.load( f )
+    results[os.path.basename( result["bitstream"] )] = result
+  return results
+
+
+def relative_change( ref, test ):
+  return ( test - ref ) / ref * 100.0 if ref > 0 else 0.0
+
+
+def main():
+  parser = argparse.ArgumentParser( description = "Compare decoder benchmark results and flag regressions" )
+  parser.add_argument( "reference", help = "reference result file or directory" )
+  parser.add_argument( "test",      help = "test result file or directory" )
+  parser.add_argument( "--threshold",   type = float, default = 3.0,  help = "allowed slow down / memory increase in percent (default: 3)" )
+  parser.add_argument( "--min-seconds", type = float, default = 0.02, help = "do not check stages shorter than this in both results (default: 0.02)" )
+  args = parser.parse_args()
+
+  reference = load_results( args.reference )
+  test      = load_results( args.test )
+  common    = sorted( set( reference ) & set( test ) )
+
+  if not common:
+    print( "no common bitstreams in the reference and the test results" )
+    return 2
+
+  for name in sorted( set( reference ) ^ set( test ) ):
+    print( "%s: only in one of the results, skipped" % name )
+
+  regressions = 0
+
+  def check( name, what, ref, tst, higherIsBetter, unit ):
+    nonlocal regressions
+    change     = relative_change( ref, tst )
+    regression = ( -change if higherIsBetter else change ) > args.threshold
+    regressions += regression
+    print( "  %-14s %12.3f %12.3f %s %+7.2f%%%s" % ( what, ref, tst, unit, change, "  REGRESSION" if regression else "" ) )
+
+  for name in common:
+    ref = reference[name]
+    tst = test[name]
+    print( "%s (%s -> %s)" % ( name, ref.get( "simd", "-" ), tst.get( "simd", "-" ) ) )
+
+    if tst.get( "hashMismatches", 0 ) != 0:
+      print( "  decoded picture hash mismatches: %d  REGRESSION" % tst["hashMismatches"] )
+      regressions += 1
+    if ref.get( "frames" ) != tst.get( "frames" ):
+      print( "  number of frames differs: %s -> %s" % ( ref.get( "frames" ), tst.get( "frames" ) ) )
+
+    check( name, "fps", ref["fps"]["median"], tst["fps"]["median"], True, "fps" )
+    for stage in STAGES:
+      refTime = ref["seconds"].get( stage, 0.0 )
+      tstTime = tst["seconds"].get( stage, 0.0 )
+      if max( refTime, tstTime ) >= args.min_seconds:
+        check( name, stage, refTime, tstTime, False, "s  " )
+    check( name, "peak RSS", ref["peakRssKiB"] / 1024.0, tst["peakRssKiB"] / 1024.0, False, "MiB" )
+
+  print( "%d regression(s) beyond %.1f%%" % ( regressions, args.threshold ) )
+  return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+  sys.exit( main() )